@@ -1440,9 +1440,11 @@ func_exit:
 				mtr, page, index, type,
 				page_zip ? 1 : 0);
 
-		/* For compressed pages write the compression level. */
+		/* For compressed pages write the compression level
+		and the codec. */
 		if (log_ptr && page_zip) {
-			mach_write_to_1(log_ptr, z_level);
+			mach_write_to_1(log_ptr,
+					page_zip_level_encode(z_level, index));
 			mlog_close(mtr, log_ptr + 1);
 		}
 
@@ -1536,7 +1538,7 @@ btr_parse_page_reorganize(
 			return(NULL);
 		}
 
-		level = mach_read_from_1(ptr);
+		level = page_zip_level_decode(mach_read_from_1(ptr), index);
 
 		ut_a(level <= 9);
 		++ptr;
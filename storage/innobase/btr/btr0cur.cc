@@ -3867,14 +3867,14 @@ btr_cur_update_in_place(
 			btr_search_update_hash_on_delete(cursor);
 		}
 
-		rw_lock_x_lock(btr_get_search_latch(index));
+		btr_search_x_lock(index);
 	}
 
 	assert_block_ahi_valid(block);
 	row_upd_rec_in_place(rec, index, offsets, update, page_zip);
 
 	if (is_hashed) {
-		rw_lock_x_unlock(btr_get_search_latch(index));
+		btr_search_x_unlock(index);
 	}
 
 	btr_cur_update_in_place_log(flags, rec, index, update,
@@ -60,6 +60,10 @@ char		btr_search_enabled	= true;
 /** Number of adaptive hash index partition. */
 ulong		btr_ahi_parts		= 8;
 
+/** Whether adaptive hash index lookups may be attempted without
+acquiring the partition latch. */
+char		btr_search_lock_free	= false;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 ulint		btr_search_n_succ	= 0;
@@ -80,6 +84,13 @@ indexes. We will allocate the latches from dynamic memory to get it to the
 same DRAM page as other hotspot semaphores */
 rw_lock_t**	btr_search_latches;
 
+/** Versions of the adaptive hash index partitions, allowing lookups
+that do not acquire btr_search_latches */
+btr_search_version_t*	btr_search_versions;
+
+/** Lookups in progress that do not hold btr_search_latches */
+btr_search_readers_t*	btr_search_readers;
+
 /** padding to prevent other memory update hotspots from residing on
 the same memory cache line */
 byte		btr_sea_pad2[64];
@@ -203,6 +214,15 @@ btr_search_sys_create(ulint hash_size)
 			       btr_search_latches[i], SYNC_SEARCH_SYS);
 	}
 
+	btr_search_versions = static_cast<btr_search_version_t*>(
+		ut_zalloc(sizeof(btr_search_version_t) * btr_ahi_parts,
+			  mem_key_ahi));
+
+	btr_search_readers = static_cast<btr_search_readers_t*>(
+		ut_zalloc(sizeof(btr_search_readers_t)
+			  * BTR_SEARCH_READER_SLOTS * btr_ahi_parts,
+			  mem_key_ahi));
+
 	/* Step-2: Allocate hash tablees. */
 	btr_search_sys = reinterpret_cast<btr_search_sys_t*>(
 		ut_malloc(sizeof(btr_search_sys_t), mem_key_ahi));
@@ -288,6 +308,45 @@ btr_search_sys_free()
 
 	ut_free(btr_search_latches);
 	btr_search_latches = NULL;
+
+	ut_free(btr_search_versions);
+	btr_search_versions = NULL;
+
+	ut_free(btr_search_readers);
+	btr_search_readers = NULL;
+}
+
+/** Wait until the lookups of an adaptive hash index partition that do
+not hold the partition latch have completed. This must be done before
+freeing any memory of the hash table of the partition. Lookups that start
+meanwhile see the partition being modified and fall back to the latch.
+@param[in]	part	partition number, X-latched by the caller */
+void
+btr_search_wait_for_readers(ulint part)
+{
+	ut_ad(rw_lock_own(btr_search_latches[part], RW_LOCK_X));
+	ut_ad(btr_search_versions[part].n & 1);
+
+	const btr_search_readers_t*	slots
+		= &btr_search_readers[part * BTR_SEARCH_READER_SLOTS];
+
+	for (ulint i = 0; i < BTR_SEARCH_READER_SLOTS; i++) {
+
+		/* A lookup visits at most BTR_SEARCH_LOCK_FREE_MAX_CHAIN
+		nodes, and no new lookup enters the hash table while the
+		version is odd, so this wait is short. */
+		for (ulint j = 0; slots[i].n != 0; j++) {
+
+			if (j < srv_n_spin_wait_rounds) {
+				ut_delay(ut_rnd_interval(
+						 0, srv_spin_wait_delay));
+			} else {
+				os_thread_yield();
+			}
+		}
+	}
+
+	os_rmb;
 }
 
 /** Set index->ref_count = 0 on all indexes of a table.
@@ -360,6 +419,7 @@ btr_search_disable(
 
 	/* Clear the adaptive hash index. */
 	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		btr_search_wait_for_readers(i);
 		hash_table_clear(btr_search_sys->hash_tables[i]);
 		mem_heap_empty(btr_search_sys->hash_tables[i]->heap);
 	}
@@ -923,6 +983,136 @@ btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
 	info->last_hash_succ = FALSE;
 }
 
+/** Maximum number of hash chain nodes visited by a lookup that does not
+hold the partition latch, before it falls back to acquiring the latch */
+#define BTR_SEARCH_LOCK_FREE_MAX_CHAIN	64
+
+/** Outcome of btr_search_guess_lock_free() */
+enum btr_search_lock_free_t {
+	/** the record was found and its page is latched */
+	BTR_SEARCH_LOCK_FREE_HIT,
+	/** the fold value is not in the adaptive hash index */
+	BTR_SEARCH_LOCK_FREE_MISS,
+	/** the partition was modified concurrently; the lookup
+	must be retried while holding the partition latch */
+	BTR_SEARCH_LOCK_FREE_RETRY
+};
+
+/** Walk the hash chain of an adaptive hash index partition without
+acquiring the partition latch. The result must be validated with
+btr_search_version_validate(), because the partition may be modified
+concurrently; but no memory that is being read is freed meanwhile.
+@param[in]	part	partition number
+@param[in]	fold	fold value of the search tuple
+@param[out]	rec	record the hash index points to, or NULL
+@param[out]	version	version of the partition before the walk
+@return false if the lookup must be retried under the partition latch */
+bool
+btr_search_lookup_lock_free(
+	ulint		part,
+	ulint		fold,
+	const rec_t**	rec,
+	ulint*		version)
+{
+	btr_search_readers_t*	slot = btr_search_reader_enter(part);
+
+	*version = btr_search_version_read(part);
+
+	/* Nodes and heap blocks of the hash table are only freed after
+	btr_search_wait_for_readers(), which waits for this walk until
+	btr_search_reader_exit(). btr_search_disable() modifies all
+	partitions, so a walk that overlaps it fails the version check.
+	The hash tables themselves are only freed by
+	btr_search_sys_resize(), while the adaptive hash index is disabled
+	during a buffer pool resize. */
+	const bool	complete = !(*version & 1) && btr_search_enabled
+		&& ha_search_and_get_data_nowait(
+			btr_search_sys->hash_tables[part], fold,
+			BTR_SEARCH_LOCK_FREE_MAX_CHAIN, rec);
+
+	btr_search_reader_exit(slot);
+
+	return(complete);
+}
+
+/** Look up the adaptive hash index without acquiring the partition latch.
+The partition version is sampled before the hash chain is walked and
+checked again after the page has been buffer-fixed and latched; if the
+partition was modified in between, nothing that was read is trusted.
+@param[in]	index		index
+@param[in]	fold		fold value of the search tuple
+@param[in]	latch_mode	BTR_SEARCH_LEAF or BTR_MODIFY_LEAF
+@param[out]	block		page containing rec, latched in latch_mode
+@param[out]	rec		record the hash index points to
+@param[in]	mtr		mini transaction
+@return outcome of the lookup */
+static
+btr_search_lock_free_t
+btr_search_guess_lock_free(
+	const dict_index_t*	index,
+	ulint			fold,
+	ulint			latch_mode,
+	buf_block_t**		block,
+	const rec_t**		rec,
+	mtr_t*			mtr)
+{
+	const ulint	part = btr_get_search_part(index);
+	ulint		version;
+
+	if (!btr_search_lookup_lock_free(part, fold, rec, &version)
+	    || !btr_search_version_validate(part, version)) {
+
+		return(BTR_SEARCH_LOCK_FREE_RETRY);
+	}
+
+	if (*rec == NULL) {
+		return(BTR_SEARCH_LOCK_FREE_MISS);
+	}
+
+	*block = buf_block_from_ahi(*rec);
+
+	/* The block may have been evicted and reused since the version
+	was validated. Because the hash index entries of a page are dropped
+	before the block leaves the BUF_BLOCK_FILE_PAGE state, an unchanged
+	version observed under the block mutex means that the block still
+	contains the page, and the buffer-fix keeps it there. */
+	buf_page_mutex_enter(*block);
+
+	if (buf_block_get_state(*block) != BUF_BLOCK_FILE_PAGE
+	    || !btr_search_version_validate(part, version)) {
+
+		buf_page_mutex_exit(*block);
+
+		return(BTR_SEARCH_LOCK_FREE_RETRY);
+	}
+
+	buf_block_fix(*block);
+
+	buf_page_mutex_exit(*block);
+
+	ibool	success = buf_page_get_known_nowait(
+		latch_mode, *block, BUF_MAKE_YOUNG, __FILE__, __LINE__, mtr);
+
+	buf_block_unfix(*block);
+
+	if (!success) {
+		return(BTR_SEARCH_LOCK_FREE_RETRY);
+	}
+
+	/* Now that the page is latched, the record can only be moved if
+	its hash index entry is dropped first. */
+	if (!btr_search_version_validate(part, version)) {
+
+		btr_leaf_page_release(*block, latch_mode, mtr);
+
+		return(BTR_SEARCH_LOCK_FREE_RETRY);
+	}
+
+	buf_block_dbg_add_level(*block, SYNC_TREE_NODE_FROM_HASH);
+
+	return(BTR_SEARCH_LOCK_FREE_HIT);
+}
+
 /** Tries to guess the right search position based on the hash search info
 of the index. Note that if mode is PAGE_CUR_LE, which is used in inserts,
 and the function returns TRUE, then cursor->up_match and cursor->low_match
@@ -999,6 +1189,24 @@ btr_search_guess_on_hash(
 	cursor->fold = fold;
 	cursor->flag = BTR_CUR_HASH;
 
+	buf_block_t*	block;
+
+	if (!has_search_latch && btr_search_lock_free) {
+		switch (btr_search_guess_lock_free(index, fold, latch_mode,
+						   &block, &rec, mtr)) {
+		case BTR_SEARCH_LOCK_FREE_HIT:
+			MONITOR_INC(MONITOR_ADAPTIVE_HASH_SEARCH_LOCK_FREE);
+			goto block_latched;
+		case BTR_SEARCH_LOCK_FREE_MISS:
+			MONITOR_INC(MONITOR_ADAPTIVE_HASH_SEARCH_LOCK_FREE);
+			btr_search_failure(info, cursor);
+			return(FALSE);
+		case BTR_SEARCH_LOCK_FREE_RETRY:
+			MONITOR_INC(MONITOR_ADAPTIVE_HASH_LOCK_FREE_RETRY);
+			break;
+		}
+	}
+
 	if (!has_search_latch) {
 		btr_search_s_lock(index);
 
@@ -1028,7 +1236,7 @@ btr_search_guess_on_hash(
 		return(FALSE);
 	}
 
-	buf_block_t*	block = buf_block_from_ahi(rec);
+	block = buf_block_from_ahi(rec);
 
 	if (!has_search_latch) {
 
@@ -1050,6 +1258,7 @@ btr_search_guess_on_hash(
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 	}
 
+block_latched:
 	if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE) {
 
 		ut_ad(buf_block_get_state(block) == BUF_BLOCK_REMOVE_HASH);
@@ -1304,7 +1513,7 @@ next_rec:
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(latch);
+	btr_search_part_x_lock(ahi_slot);
 
 	if (UNIV_UNLIKELY(!block->index)) {
 		/* Someone else has meanwhile dropped the hash index */
@@ -1320,7 +1529,7 @@ next_rec:
 		/* Someone else has meanwhile built a new hash index on the
 		page, with different parameters */
 
-		rw_lock_x_unlock(latch);
+		btr_search_part_x_unlock(ahi_slot);
 
 		ut_free(folds);
 		goto retry;
@@ -1344,7 +1553,7 @@ next_rec:
 
 cleanup:
 	assert_block_ahi_valid(block);
-	rw_lock_x_unlock(latch);
+	btr_search_part_x_unlock(ahi_slot);
 
 	ut_free(folds);
 }
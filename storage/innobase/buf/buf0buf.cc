@@ -128,6 +128,32 @@ struct set_numa_interleave_t
 #define NUMA_MEMPOLICY_INTERLEAVE_IN_SCOPE
 #endif /* HAVE_LIBNUMA */
 
+#ifdef HAVE_LIBNUMA
+/** Get the NUMA node of a buffer pool instance. With
+innodb_page_cleaner_per_instance, the page frames of the instance are
+preferably allocated on this node, and its page cleaner runs there.
+@param[in]	instance_no	buffer pool instance number
+@return NUMA node, or -1 if the instance is not placed on a node */
+int
+buf_pool_numa_node(
+	ulint	instance_no)
+{
+	if (!srv_page_cleaner_per_instance
+	    || srv_numa_interleave
+	    || numa_available() == -1) {
+		return(-1);
+	}
+
+	int	n_nodes = numa_num_configured_nodes();
+
+	if (n_nodes < 2) {
+		return(-1);
+	}
+
+	return(static_cast<int>(instance_no % n_nodes));
+}
+#endif /* HAVE_LIBNUMA */
+
 /*
 		IMPLEMENTATION OF THE BUFFER POOL
 		=================================
@@ -397,6 +423,49 @@ buf_pool_register_chunk(
 		chunk->blocks->frame, chunk));
 }
 
+/** Gets the smallest oldest_modification lsn of the pages in a buffer pool
+instance, not counting the pages of the system temporary tablespace.
+@param[in,out]	buf_pool	buffer pool instance
+@return oldest modification in the instance, zero if none */
+lsn_t
+buf_pool_get_oldest_modification_low(
+	buf_pool_t*	buf_pool)
+{
+	ut_ad(buf_flush_list_mutex_own(buf_pool));
+
+	lsn_t		lsn = 0;
+	buf_page_t*	bpage;
+
+	/* We don't let log-checkpoint halt because pages from system
+	temporary are not yet flushed to the disk. Anyway, object
+	residing in system temporary doesn't generate REDO logging. */
+	bpage = buf_pool->oldest_hp.get();
+	if (bpage != NULL) {
+		ut_ad(bpage->in_flush_list);
+	} else {
+		bpage = UT_LIST_GET_LAST(buf_pool->flush_list);
+	}
+
+	for (; bpage != NULL
+		&& fsp_is_system_temporary(bpage->id.space());
+	     bpage = UT_LIST_GET_PREV(list, bpage)) {
+		/* Do nothing. */
+	}
+
+	if (bpage != NULL) {
+		ut_ad(bpage->in_flush_list);
+		lsn = buf_flush_list_oldest_lsn(buf_pool, bpage);
+		buf_pool->oldest_hp.set(bpage);
+	} else {
+		/* The last scanned page as entry point,
+		or nullptr. */
+		buf_pool->oldest_hp.set(
+			UT_LIST_GET_FIRST(buf_pool->flush_list));
+	}
+
+	return(lsn);
+}
+
 /********************************************************************//**
 Gets the smallest oldest_modification lsn for any page in the pool. Returns
 zero if all modified pages have been flushed to disk.
@@ -405,12 +474,15 @@ lsn_t
 buf_pool_get_oldest_modification(void)
 /*==================================*/
 {
-	lsn_t		lsn = 0;
 	lsn_t		oldest_lsn = 0;
 
 	/* When we traverse all the flush lists we don't want another
-	thread to add a dirty page to any flush list. */
-	log_flush_order_mutex_enter();
+	thread to add a dirty page to any flush list. In the relaxed
+	flush list order, log_buf_pool_get_oldest_modification() bounds
+	the pages that are being added by log_sys->order_closed_lsn. */
+	if (!srv_flush_list_relaxed_order) {
+		log_flush_order_mutex_enter();
+	}
 
 	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
 		buf_pool_t*	buf_pool;
@@ -419,43 +491,18 @@ buf_pool_get_oldest_modification(void)
 
 		buf_flush_list_mutex_enter(buf_pool);
 
-		buf_page_t*	bpage;
-
-		/* We don't let log-checkpoint halt because pages from system
-		temporary are not yet flushed to the disk. Anyway, object
-		residing in system temporary doesn't generate REDO logging. */
-		bpage = buf_pool->oldest_hp.get();
-		if (bpage != NULL) {
-			ut_ad(bpage->in_flush_list);
-		} else {
-			bpage = UT_LIST_GET_LAST(buf_pool->flush_list);
-		}
-
-		for (; bpage != NULL
-			&& fsp_is_system_temporary(bpage->id.space());
-		     bpage = UT_LIST_GET_PREV(list, bpage)) {
-			/* Do nothing. */
-		}
-
-		if (bpage != NULL) {
-			ut_ad(bpage->in_flush_list);
-			lsn = bpage->oldest_modification;
-			buf_pool->oldest_hp.set(bpage);
-		} else {
-			/* The last scanned page as entry point,
-			or nullptr. */
-			buf_pool->oldest_hp.set(
-				UT_LIST_GET_FIRST(buf_pool->flush_list));
-		}
+		lsn_t	lsn = buf_pool_get_oldest_modification_low(buf_pool);
 
 		buf_flush_list_mutex_exit(buf_pool);
 
-		if (!oldest_lsn || oldest_lsn > lsn) {
+		if (lsn != 0 && (!oldest_lsn || oldest_lsn > lsn)) {
 			oldest_lsn = lsn;
 		}
 	}
 
-	log_flush_order_mutex_exit();
+	if (!srv_flush_list_relaxed_order) {
+		log_flush_order_mutex_exit();
+	}
 
 	/* The returned answer may be out of date: the flush_list can
 	change after the mutex has been released. */
@@ -1538,6 +1585,21 @@ buf_chunk_init(
 				" (error: " << strerror(errno) << ").";
 		}
 		numa_bitmask_free(numa_nodes);
+	} else if (buf_pool_numa_node(buf_pool->instance_no) != -1) {
+		struct	bitmask* numa_node = numa_allocate_nodemask();
+		numa_bitmask_setbit(numa_node,
+				    buf_pool_numa_node(buf_pool->instance_no));
+		int	st = mbind(chunk->mem, chunk->mem_size(),
+				   MPOL_PREFERRED,
+				   numa_node->maskp,
+				   numa_node->size,
+				   MPOL_MF_MOVE);
+		if (st != 0) {
+			ib::warn() << "Failed to set NUMA memory policy of"
+				" buffer pool page frames to MPOL_PREFERRED"
+				" (error: " << strerror(errno) << ").";
+		}
+		numa_bitmask_free(numa_node);
 	}
 #endif /* HAVE_LIBNUMA */
 
@@ -1780,6 +1842,7 @@ buf_pool_init_instance(
 		}
 
 		buf_pool->curr_size = 0;
+		buf_pool->instance_no = instance_no;
 		chunk = buf_pool->chunks;
 
 		do {
@@ -1807,7 +1870,6 @@ buf_pool_init_instance(
 			buf_pool->curr_size += chunk->size;
 		} while (++chunk < buf_pool->chunks + buf_pool->n_chunks);
 
-		buf_pool->instance_no = instance_no;
 		buf_pool->read_ahead_area =
 			ut_min(BUF_READ_AHEAD_PAGES,
 			       ut_2_power_up(buf_pool->curr_size /
@@ -1943,6 +2005,30 @@ buf_pool_free_instance(
 	buf_pool->allocator.~ut_allocator();
 }
 
+/** Register the memory of all the buffer pool chunks with the asynchronous
+i/o system, replacing the chunks that were registered before. */
+static
+void
+buf_pool_register_io_buffers()
+{
+	std::vector<byte*, ut_allocator<byte*> >	areas;
+	std::vector<ulint, ut_allocator<ulint> >	sizes;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		const buf_chunk_t*	chunk = buf_pool->chunks;
+
+		for (ulint j = 0; j < buf_pool->n_chunks; ++j, ++chunk) {
+			areas.push_back(chunk->mem);
+			sizes.push_back(chunk->mem_size());
+		}
+	}
+
+	if (!areas.empty()) {
+		os_aio_register_buffers(&areas[0], &sizes[0], areas.size());
+	}
+}
+
 /********************************************************************//**
 Creates the buffer pool.
 @return DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -1987,6 +2073,8 @@ buf_pool_init(
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_pool_register_io_buffers();
+
 	return(DB_SUCCESS);
 }
 
@@ -2725,6 +2813,11 @@ withdraw_retry:
 		return;
 	}
 
+	/* The chunks that are freed must not stay registered for i/o.
+	Until they are registered again, pages are read and written
+	without registered buffers. */
+	os_aio_unregister_buffers();
+
 	/* Indicate critical path */
 	buf_pool_resizing = true;
 
@@ -2950,6 +3043,8 @@ calc_buf_pool_size:
 
 	buf_pool_resizing = false;
 
+	buf_pool_register_io_buffers();
+
 	/* Normalize other components, if the new size is too different */
 	if (!warning && new_size_too_diff) {
 		srv_buf_pool_base_size = srv_buf_pool_size;
@@ -6546,6 +6641,9 @@ buf_stats_aggregate_pool_info(
 	total_info->n_pages_read += pool_info->n_pages_read;
 	total_info->n_pages_created += pool_info->n_pages_created;
 	total_info->n_pages_written += pool_info->n_pages_written;
+	total_info->flush_lag = ut_max(total_info->flush_lag,
+				       pool_info->flush_lag);
+	total_info->n_single_page_flushes += pool_info->n_single_page_flushes;
 	total_info->n_page_gets += pool_info->n_page_gets;
 	total_info->n_ra_pages_read_rnd += pool_info->n_ra_pages_read_rnd;
 	total_info->n_ra_pages_read += pool_info->n_ra_pages_read;
@@ -6588,6 +6686,8 @@ buf_stats_get_pool_info(
 	/* Find appropriate pool_info to store stats for this buffer pool */
 	pool_info = &all_pool_info[pool_id];
 
+	const lsn_t	cur_lsn = log_get_lsn();
+
 	buf_pool_mutex_enter(buf_pool);
 	buf_flush_list_mutex_enter(buf_pool);
 
@@ -6619,6 +6719,12 @@ buf_stats_get_pool_info(
 		 (buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]
 		  + buf_pool->init_flush[BUF_FLUSH_SINGLE_PAGE]);
 
+	const lsn_t	oldest_lsn = buf_pool_get_oldest_modification_low(
+		buf_pool);
+
+	pool_info->flush_lag = oldest_lsn != 0 && oldest_lsn < cur_lsn
+		? cur_lsn - oldest_lsn : 0;
+
 	buf_flush_list_mutex_exit(buf_pool);
 
 	current_time = time(NULL);
@@ -6638,6 +6744,9 @@ buf_stats_get_pool_info(
 
 	pool_info->n_page_gets = buf_pool->stat.n_page_gets;
 
+	pool_info->n_single_page_flushes =
+		buf_pool->stat.n_single_page_flushes;
+
 	pool_info->n_ra_pages_read_rnd = buf_pool->stat.n_ra_pages_read_rnd;
 	pool_info->n_ra_pages_read = buf_pool->stat.n_ra_pages_read;
 
@@ -6787,6 +6896,13 @@ buf_print_io_instance(
 		pool_info->lru_len, pool_info->unzip_lru_len,
 		pool_info->io_sum, pool_info->io_cur,
 		pool_info->unzip_sum, pool_info->unzip_cur);
+
+	/* Show how far the flushing of the pool lags behind the redo log,
+	and how often user threads had to flush a page themselves because
+	the page cleaner did not keep the free list filled. */
+	fprintf(file,
+		"Flush list lag " LSN_PF ", single page flushes " ULINTPF "\n",
+		pool_info->flush_lag, pool_info->n_single_page_flushes);
 }
 
 /*********************************************************************//**
@@ -87,6 +87,46 @@ buf_calc_page_crc32(
 	return(c1 ^ c2);
 }
 
+/** Calculates the CRC32 checksums of several uncompressed pages, as
+buf_calc_page_crc32() would calculate them. The pages are checksummed
+together with ut_crc32_batch(), which is faster than checksumming them
+one by one.
+@param[in]	pages		buffer pages
+@param[in]	n		number of pages
+@param[out]	checksums	checksum of each page */
+void
+buf_calc_page_crc32_batch(
+	const byte* const*	pages,
+	ulint			n,
+	uint32_t*		checksums)
+{
+	/* Number of pages to checksum at a time */
+	static const ulint	BATCH = 12;
+
+	const byte*	data[BATCH];
+	uint32_t	crcs[BATCH];
+
+	for (ulint i = 0; i < n; i += BATCH) {
+		const ulint	n_batch = ut_min(n - i, BATCH);
+
+		for (ulint j = 0; j < n_batch; j++) {
+			data[j] = pages[i + j] + FIL_PAGE_DATA;
+		}
+
+		ut_crc32_batch(
+			data, n_batch,
+			UNIV_PAGE_SIZE - FIL_PAGE_DATA
+			- FIL_PAGE_END_LSN_OLD_CHKSUM,
+			crcs);
+
+		for (ulint j = 0; j < n_batch; j++) {
+			checksums[i + j] = crcs[j] ^ ut_crc32(
+				pages[i + j] + FIL_PAGE_OFFSET,
+				FIL_PAGE_FILE_FLUSH_LSN - FIL_PAGE_OFFSET);
+		}
+	}
+}
+
 /********************************************************************//**
 Calculates a page checksum which is stored to the page when it is written
 to a file. Note that we must be careful to calculate the same value on
@@ -53,6 +53,21 @@ buf_dblwr_t*	buf_dblwr = NULL;
 /** Set to TRUE when the doublewrite buffer is being created */
 ibool	buf_dblwr_being_created = FALSE;
 
+/** With innodb_doublewrite_files, the doublewrite buffers that are written
+to the doublewrite files instead of buf_dblwr */
+static buf_dblwr_t*	buf_dblwr_files = NULL;
+
+/** Number of elements of buf_dblwr_files */
+static ulint		buf_dblwr_n_files = 0;
+
+/** Memory of the pages that were loaded from the doublewrite files for
+recovery, indexed by file number */
+static byte*		buf_dblwr_loaded[MAX_BUFFER_POOLS];
+
+/** Number of doublewrite batch pages whose CRC32 checksums are computed
+together */
+static const ulint	BUF_DBLWR_CRC32_BATCH = 24;
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -122,20 +137,19 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
 }
 
-/****************************************************************//**
-Creates or initialializes the doublewrite buffer at a database start. */
+/** Initialize the memory structure of a doublewrite buffer.
+@param[out]	dblwr	doublewrite buffer
+@param[in]	block1	page number of the first block
+@param[in]	block2	page number of the second block */
 static
 void
-buf_dblwr_init(
-/*===========*/
-	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
-				header on trx sys page */
+buf_dblwr_init_low(
+	buf_dblwr_t*	dblwr,
+	ulint		block1,
+	ulint		block2)
 {
 	ulint	buf_size;
 
-	buf_dblwr = static_cast<buf_dblwr_t*>(
-		ut_zalloc_nokey(sizeof(buf_dblwr_t)));
-
 	/* There are two blocks of same size in the doublewrite
 	buffer. */
 	buf_size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
@@ -145,31 +159,411 @@ buf_dblwr_init(
 	ut_a(srv_doublewrite_batch_size > 0
 	     && srv_doublewrite_batch_size < buf_size);
 
-	mutex_create(LATCH_ID_BUF_DBLWR, &buf_dblwr->mutex);
+	mutex_create(LATCH_ID_BUF_DBLWR, &dblwr->mutex);
 
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
-	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
-	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
+	dblwr->b_event = os_event_create("dblwr_batch_event");
+	dblwr->s_event = os_event_create("dblwr_single_event");
+	dblwr->first_free = 0;
+	dblwr->s_reserved = 0;
+	dblwr->b_reserved = 0;
 
-	buf_dblwr->block1 = mach_read_from_4(
-		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
-	buf_dblwr->block2 = mach_read_from_4(
-		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+	dblwr->block1 = block1;
+	dblwr->block2 = block2;
 
-	buf_dblwr->in_use = static_cast<bool*>(
+	dblwr->in_use = static_cast<bool*>(
 		ut_zalloc_nokey(buf_size * sizeof(bool)));
 
-	buf_dblwr->write_buf_unaligned = static_cast<byte*>(
+	dblwr->write_buf_unaligned = static_cast<byte*>(
 		ut_malloc_nokey((1 + buf_size) * UNIV_PAGE_SIZE));
 
-	buf_dblwr->write_buf = static_cast<byte*>(
-		ut_align(buf_dblwr->write_buf_unaligned,
+	dblwr->write_buf = static_cast<byte*>(
+		ut_align(dblwr->write_buf_unaligned,
 			 UNIV_PAGE_SIZE));
 
-	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
+	dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		ut_zalloc_nokey(buf_size * sizeof(void*)));
+
+	dblwr->crc32_pending = static_cast<bool*>(
+		ut_zalloc_nokey(buf_size * sizeof(bool)));
+}
+
+/** Free the memory structure of a doublewrite buffer.
+@param[in,out]	dblwr	doublewrite buffer */
+static
+void
+buf_dblwr_free_low(
+	buf_dblwr_t*	dblwr)
+{
+	ut_ad(dblwr->s_reserved == 0);
+	ut_ad(dblwr->b_reserved == 0);
+
+	os_event_destroy(dblwr->b_event);
+	os_event_destroy(dblwr->s_event);
+	ut_free(dblwr->write_buf_unaligned);
+	dblwr->write_buf_unaligned = NULL;
+
+	ut_free(dblwr->buf_block_arr);
+	dblwr->buf_block_arr = NULL;
+
+	ut_free(dblwr->crc32_pending);
+	dblwr->crc32_pending = NULL;
+
+	ut_free(dblwr->in_use);
+	dblwr->in_use = NULL;
+
+	mutex_free(&dblwr->mutex);
+}
+
+/** Get the path of a doublewrite file.
+@param[in]	file_no	number of the doublewrite file
+@return own: path of the file; must be freed with ut_free() */
+char*
+buf_dblwr_file_path(
+	ulint	file_no)
+{
+	char	name[32];
+
+	ut_snprintf(name, sizeof(name), "#ib_" ULINTPF ".dblwr", file_no);
+
+	return(fil_make_filepath(srv_doublewrite_dir, name, NO_EXT, false));
+}
+
+/** Open a doublewrite file, or create it, and initialize the memory
+structure of its doublewrite buffer. A valid existing file is reused as is,
+so that the copies in it are not lost if the recovery is interrupted. Its
+pages must have been loaded by buf_dblwr_load_files() before.
+@param[out]	dblwr	doublewrite buffer
+@param[in]	file_no	number of the doublewrite file
+@return true if successful */
+static
+bool
+buf_dblwr_file_create(
+	buf_dblwr_t*	dblwr,
+	ulint		file_no)
+{
+	const ulint		n_slots = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+	const os_offset_t	size = (1 + n_slots) * UNIV_PAGE_SIZE;
+	bool			success;
+
+	ut_ad(!srv_read_only_mode);
+
+	dblwr->path = buf_dblwr_file_path(file_no);
+
+	if (dblwr->path == NULL) {
+		return(false);
+	}
+
+	dblwr->file = os_file_create(
+		innodb_data_file_key, dblwr->path,
+		OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT
+		| OS_FILE_ON_ERROR_SILENT,
+		OS_FILE_NORMAL, OS_DATA_FILE, false, &success);
+
+	if (success
+	    && (buf_dblwr_loaded[file_no] == NULL
+		|| os_file_get_size(dblwr->file) != size)) {
+		/* Not a valid doublewrite file of this page size */
+		os_file_close(dblwr->file);
+		success = false;
+	}
+
+	if (!success) {
+		dblwr->file = os_file_create(
+			innodb_data_file_key, dblwr->path,
+			OS_FILE_OVERWRITE | OS_FILE_ON_ERROR_NO_EXIT,
+			OS_FILE_NORMAL, OS_DATA_FILE, false, &success);
+
+		if (!success) {
+			ib::error() << "Cannot create doublewrite file "
+				<< dblwr->path;
+			ut_free(dblwr->path);
+			dblwr->path = NULL;
+			return(false);
+		}
+
+		success = os_file_set_size(dblwr->path, dblwr->file, size,
+					   false);
+
+		if (success) {
+			byte*	buf = static_cast<byte*>(
+				ut_zalloc_nokey(2 * UNIV_PAGE_SIZE));
+			byte*	header = static_cast<byte*>(
+				ut_align(buf, UNIV_PAGE_SIZE));
+
+			mach_write_to_4(header + DBLWR_FILE_MAGIC,
+					DBLWR_FILE_MAGIC_N);
+			mach_write_to_4(header + DBLWR_FILE_PAGE_SIZE,
+					UNIV_PAGE_SIZE);
+			mach_write_to_4(header + DBLWR_FILE_N_SLOTS,
+					n_slots);
+
+			IORequest	request(IORequest::WRITE);
+
+			success = os_file_write(
+				request, dblwr->path, dblwr->file, header,
+				0, UNIV_PAGE_SIZE) == DB_SUCCESS
+				&& os_file_flush(dblwr->file);
+
+			ut_free(buf);
+		}
+
+		if (!success) {
+			ib::error() << "Cannot initialize doublewrite file "
+				<< dblwr->path;
+			os_file_close(dblwr->file);
+			ut_free(dblwr->path);
+			dblwr->path = NULL;
+			return(false);
+		}
+	}
+
+#ifndef _WIN32
+	/* The doublewrite file is written only once and read only at
+	recovery: do not let the pages take space in the file cache. */
+	os_file_set_nocache(dblwr->file.m_file, dblwr->path, "open");
+#endif /* !_WIN32 */
+
+	/* The slots follow the header page. */
+	buf_dblwr_init_low(dblwr, 1, 1 + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
+
+	return(true);
+}
+
+/** Load the pages of all doublewrite files into memory for recovery, and
+add them to recv_sys->dblwr. Files that do not exist, or that were written
+with another page size, are skipped. */
+static
+void
+buf_dblwr_load_files(void)
+{
+	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
+
+	/* Scan the numbers of all possible files, in case
+	innodb_doublewrite_files was reduced at the restart. */
+	for (ulint file_no = 0; file_no < MAX_BUFFER_POOLS; file_no++) {
+		char*		path = buf_dblwr_file_path(file_no);
+		bool		exists;
+		os_file_type_t	type;
+		bool		success;
+
+		ut_ad(buf_dblwr_loaded[file_no] == NULL);
+
+		if (path == NULL
+		    || !os_file_status(path, &exists, &type)
+		    || !exists) {
+			ut_free(path);
+			continue;
+		}
+
+		pfs_os_file_t	file = os_file_create_simple_no_error_handling(
+			innodb_data_file_key, path, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, true, &success);
+
+		if (!success) {
+			ib::warn() << "Cannot open doublewrite file " << path;
+			ut_free(path);
+			continue;
+		}
+
+		IORequest	request(IORequest::READ);
+
+		request.disable_compression();
+
+		byte*	buf = static_cast<byte*>(
+			ut_malloc_nokey(2 * UNIV_PAGE_SIZE));
+		byte*	header = static_cast<byte*>(
+			ut_align(buf, UNIV_PAGE_SIZE));
+		ulint	n_slots = 0;
+
+		if (os_file_read_no_error_handling(
+			    request, file, header, 0, UNIV_PAGE_SIZE, NULL)
+		    != DB_SUCCESS
+		    || mach_read_from_4(header + DBLWR_FILE_MAGIC)
+		    != DBLWR_FILE_MAGIC_N) {
+
+			ib::warn() << "Ignoring doublewrite file " << path
+				<< " without a valid header";
+
+		} else if (mach_read_from_4(header + DBLWR_FILE_PAGE_SIZE)
+			   != UNIV_PAGE_SIZE) {
+
+			ib::warn() << "Ignoring doublewrite file " << path
+				<< " of page size "
+				<< mach_read_from_4(
+					header + DBLWR_FILE_PAGE_SIZE);
+		} else {
+			n_slots = mach_read_from_4(
+				header + DBLWR_FILE_N_SLOTS);
+		}
+
+		ut_free(buf);
+
+		if (n_slots > 0) {
+			buf = static_cast<byte*>(
+				ut_malloc_nokey((1 + n_slots)
+						* UNIV_PAGE_SIZE));
+
+			byte*	pages = static_cast<byte*>(
+				ut_align(buf, UNIV_PAGE_SIZE));
+
+			if (os_file_read_no_error_handling(
+				    request, file, pages, UNIV_PAGE_SIZE,
+				    n_slots * UNIV_PAGE_SIZE, NULL)
+			    != DB_SUCCESS) {
+
+				ib::warn() << "Failed to read doublewrite"
+					" file " << path;
+
+				ut_free(buf);
+				n_slots = 0;
+			} else {
+				buf_dblwr_loaded[file_no] = buf;
+			}
+
+			for (ulint i = 0; i < n_slots; i++) {
+				const byte*	page = pages
+					+ i * UNIV_PAGE_SIZE;
+
+				/* Skip the slots that were never
+				written to. */
+				if (!buf_page_is_zeroes(page,
+							univ_page_size)) {
+					recv_dblwr.add(page);
+				}
+			}
+		}
+
+		os_file_close(file);
+		ut_free(path);
+	}
+}
+
+/****************************************************************//**
+Creates or initialializes the doublewrite buffer at a database start. */
+static
+void
+buf_dblwr_init(
+/*===========*/
+	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
+				header on trx sys page */
+{
+	buf_dblwr = static_cast<buf_dblwr_t*>(
+		ut_zalloc_nokey(sizeof(buf_dblwr_t)));
+
+	buf_dblwr_init_low(
+		buf_dblwr,
+		mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1),
+		mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2));
+
+	if (!srv_use_doublewrite_buf
+	    || srv_read_only_mode
+	    || srv_doublewrite_files == 0) {
+		return;
+	}
+
+	ut_ad(srv_doublewrite_files <= srv_buf_pool_instances);
+
+	buf_dblwr_files = static_cast<buf_dblwr_t*>(
+		ut_zalloc_nokey(srv_doublewrite_files * sizeof(buf_dblwr_t)));
+
+	for (ulint i = 0; i < srv_doublewrite_files; i++) {
+		if (!buf_dblwr_file_create(&buf_dblwr_files[i], i)) {
+			break;
+		}
+
+		buf_dblwr_n_files++;
+	}
+
+	if (buf_dblwr_n_files < srv_doublewrite_files) {
+		/* Fall back to the doublewrite buffer in the system
+		tablespace. */
+		ib::warn() << "Using the doublewrite buffer in the system"
+			" tablespace instead of innodb_doublewrite_files="
+			<< srv_doublewrite_files;
+
+		for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+			buf_dblwr_t*	dblwr = &buf_dblwr_files[i];
+
+			os_file_close(dblwr->file);
+			ut_free(dblwr->path);
+			buf_dblwr_free_low(dblwr);
+		}
+
+		ut_free(buf_dblwr_files);
+		buf_dblwr_files = NULL;
+		buf_dblwr_n_files = 0;
+		return;
+	}
+
+	ib::info() << "Using " << buf_dblwr_n_files << " doublewrite"
+		" file(s) in " << srv_doublewrite_dir;
+}
+
+/** Get the doublewrite buffer that a page is written through.
+@param[in]	bpage	page to be written
+@return the doublewrite file of the buffer pool instance of the page, or
+buf_dblwr if the doublewrite buffer is in the system tablespace */
+static
+buf_dblwr_t*
+buf_dblwr_get_for(
+	const buf_page_t*	bpage)
+{
+	if (buf_dblwr_n_files == 0) {
+		return(buf_dblwr);
+	}
+
+	return(&buf_dblwr_files[buf_pool_index(buf_pool_from_bpage(bpage))
+				% buf_dblwr_n_files]);
+}
+
+/** Write pages to the slots of a doublewrite buffer on disk. The pages
+become durable with buf_dblwr_flush_to_disk().
+@param[in]	dblwr	doublewrite buffer
+@param[in]	page_no	page number of the first slot to write
+@param[in]	len	number of bytes to write
+@param[in]	buf	pages to write, aligned to UNIV_PAGE_SIZE */
+static
+void
+buf_dblwr_write_to_disk(
+	const buf_dblwr_t*	dblwr,
+	ulint			page_no,
+	ulint			len,
+	void*			buf)
+{
+	if (dblwr->path == NULL) {
+		fil_io(IORequestWrite, true,
+		       page_id_t(TRX_SYS_SPACE, page_no), univ_page_size,
+		       0, len, buf, NULL);
+		return;
+	}
+
+	IORequest	request(IORequest::WRITE);
+
+	request.disable_compression();
+
+	dberr_t	err = os_file_write(
+		request, dblwr->path, dblwr->file, buf,
+		static_cast<os_offset_t>(page_no) * UNIV_PAGE_SIZE, len);
+
+	if (err != DB_SUCCESS) {
+		ib::fatal() << "Cannot write to doublewrite file "
+			<< dblwr->path << ": " << ut_strerr(err);
+	}
+}
+
+/** Flush the writes to a doublewrite buffer to disk.
+@param[in]	dblwr	doublewrite buffer */
+static
+void
+buf_dblwr_flush_to_disk(
+	const buf_dblwr_t*	dblwr)
+{
+	if (dblwr->path == NULL) {
+		fil_flush(TRX_SYS_SPACE);
+	} else if (!os_file_flush(dblwr->file)) {
+		ib::fatal() << "Cannot flush doublewrite file "
+			<< dblwr->path;
+	}
 }
 
 /****************************************************************//**
@@ -406,7 +800,11 @@ buf_dblwr_init_or_load_pages(
 
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_MAGIC)
 	    == TRX_SYS_DOUBLEWRITE_MAGIC_N) {
-		/* The doublewrite buffer has been created */
+		/* The doublewrite buffer has been created. Load the
+		doublewrite files before buf_dblwr_init() overwrites
+		them. */
+
+		buf_dblwr_load_files();
 
 		buf_dblwr_init(doublewrite);
 
@@ -552,6 +950,7 @@ buf_dblwr_process(void)
 
 		const byte*	page		= *i;
 		ulint		page_no		= page_get_page_no(page);
+		const byte*	newest;
 		ulint		space_id	= page_get_space_id(page);
 
 		fil_space_t*	space = fil_space_get(space_id);
@@ -616,6 +1015,16 @@ buf_dblwr_process(void)
 					<< ". Trying to recover it from the"
 					<< " doublewrite buffer.";
 
+				/* The page may have been written through
+				more than one doublewrite file: recover the
+				newest copy. */
+				newest = recv_dblwr.find_page(
+					space_id, page_no);
+
+				if (newest != NULL) {
+					page = newest;
+				}
+
 				if (buf_page_is_corrupted(
 					true, page, page_size,
 					fsp_is_checksum_disabled(space_id))) {
@@ -695,6 +1104,19 @@ buf_dblwr_process(void)
 
 	fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
 	ut_free(unaligned_read_buf);
+
+	buf_dblwr_free_loaded_pages();
+}
+
+/** Free the pages that were loaded from the doublewrite files for
+recovery. They must not be referenced by recv_sys->dblwr any more. */
+void
+buf_dblwr_free_loaded_pages(void)
+{
+	for (ulint i = 0; i < MAX_BUFFER_POOLS; i++) {
+		ut_free(buf_dblwr_loaded[i]);
+		buf_dblwr_loaded[i] = NULL;
+	}
 }
 
 /****************************************************************//**
@@ -705,23 +1127,24 @@ buf_dblwr_free(void)
 {
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
-	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_destroy(buf_dblwr->b_event);
-	os_event_destroy(buf_dblwr->s_event);
-	ut_free(buf_dblwr->write_buf_unaligned);
-	buf_dblwr->write_buf_unaligned = NULL;
+	for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+		buf_dblwr_t*	dblwr = &buf_dblwr_files[i];
 
-	ut_free(buf_dblwr->buf_block_arr);
-	buf_dblwr->buf_block_arr = NULL;
+		os_file_close(dblwr->file);
+		ut_free(dblwr->path);
+		buf_dblwr_free_low(dblwr);
+	}
 
-	ut_free(buf_dblwr->in_use);
-	buf_dblwr->in_use = NULL;
+	ut_free(buf_dblwr_files);
+	buf_dblwr_files = NULL;
+	buf_dblwr_n_files = 0;
 
-	mutex_free(&buf_dblwr->mutex);
+	buf_dblwr_free_low(buf_dblwr);
 	ut_free(buf_dblwr);
 	buf_dblwr = NULL;
+
+	buf_dblwr_free_loaded_pages();
 }
 
 /********************************************************************//**
@@ -740,42 +1163,44 @@ buf_dblwr_update(
 
 	ut_ad(!srv_read_only_mode);
 
+	buf_dblwr_t*	dblwr = buf_dblwr_get_for(bpage);
+
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		mutex_enter(&dblwr->mutex);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+		ut_ad(dblwr->batch_running);
+		ut_ad(dblwr->b_reserved > 0);
+		ut_ad(dblwr->b_reserved <= dblwr->first_free);
 
-		buf_dblwr->b_reserved--;
+		dblwr->b_reserved--;
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
+		if (dblwr->b_reserved == 0) {
+			mutex_exit(&dblwr->mutex);
 			/* This will finish the batch. Sync data files
 			to the disk. */
 			fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&dblwr->mutex);
 
 			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
+			dblwr->first_free = 0;
+			dblwr->batch_running = false;
+			os_event_set(dblwr->b_event);
 		}
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&dblwr->mutex);
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
 			const ulint size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 			ulint i;
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&dblwr->mutex);
 			for (i = srv_doublewrite_batch_size; i < size; ++i) {
-				if (buf_dblwr->buf_block_arr[i] == bpage) {
-					buf_dblwr->s_reserved--;
-					buf_dblwr->buf_block_arr[i] = NULL;
-					buf_dblwr->in_use[i] = false;
+				if (dblwr->buf_block_arr[i] == bpage) {
+					dblwr->s_reserved--;
+					dblwr->buf_block_arr[i] = NULL;
+					dblwr->in_use[i] = false;
 					break;
 				}
 			}
@@ -784,8 +1209,8 @@ buf_dblwr_update(
 			reserved block. */
 			ut_a(i < size);
 		}
-		os_event_set(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
+		os_event_set(dblwr->s_event);
+		mutex_exit(&dblwr->mutex);
 		break;
 	case BUF_FLUSH_N_TYPES:
 		ut_error;
@@ -936,38 +1361,107 @@ buf_dblwr_write_block_to_datafile(
 	}
 }
 
-/********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+/** Write the CRC32 checksums of doublewrite batch pages.
+@param[in,out]	dblwr		doublewrite buffer
+@param[in]	slots		positions of the pages in write_buf
+@param[in]	n		number of pages */
+static
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_write_batch_checksums(
+	buf_dblwr_t*	dblwr,
+	const ulint*	slots,
+	ulint		n)
 {
-	byte*		write_buf;
-	ulint		first_free;
-	ulint		len;
+	const byte*	pages[BUF_DBLWR_CRC32_BATCH];
+	uint32_t	checksums[BUF_DBLWR_CRC32_BATCH];
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		return;
+	ut_ad(n <= BUF_DBLWR_CRC32_BATCH);
+
+	for (ulint i = 0; i < n; i++) {
+		pages[i] = dblwr->write_buf + slots[i] * UNIV_PAGE_SIZE;
 	}
 
-	ut_ad(!srv_read_only_mode);
+	buf_calc_page_crc32_batch(pages, n, checksums);
+
+	for (ulint i = 0; i < n; i++) {
+		buf_block_t*	block = reinterpret_cast<buf_block_t*>(
+			dblwr->buf_block_arr[slots[i]]);
+		byte*		page = const_cast<byte*>(pages[i]);
+
+		ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+		ut_ad(block->page.zip.data == NULL);
+
+		mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM,
+				checksums[i]);
+		mach_write_to_4(page + UNIV_PAGE_SIZE
+				- FIL_PAGE_END_LSN_OLD_CHKSUM,
+				checksums[i]);
+
+		mach_write_to_4(block->frame + FIL_PAGE_SPACE_OR_CHKSUM,
+				checksums[i]);
+		mach_write_to_4(block->frame + UNIV_PAGE_SIZE
+				- FIL_PAGE_END_LSN_OLD_CHKSUM,
+				checksums[i]);
+
+		dblwr->crc32_pending[slots[i]] = false;
+	}
+}
+
+/** Compute the CRC32 checksums that buf_flush_init_for_writing() left
+for the batch, several pages at a time. The checksums are written to the
+copies of the pages in write_buf as well as to the pages in the buffer
+pool, which are written to the data files after the batch.
+@param[in,out]	dblwr		doublewrite buffer
+@param[in]	first_free	number of pages in the batch */
+static
+void
+buf_dblwr_calc_batch_checksums(
+	buf_dblwr_t*	dblwr,
+	ulint		first_free)
+{
+	ulint	slots[BUF_DBLWR_CRC32_BATCH];
+	ulint	n = 0;
+
+	for (ulint i = 0; i < first_free; i++) {
+		if (!dblwr->crc32_pending[i]) {
+			continue;
+		}
+
+		slots[n++] = i;
+
+		if (n == BUF_DBLWR_CRC32_BATCH) {
+			buf_dblwr_write_batch_checksums(dblwr, slots, n);
+			n = 0;
+		}
+	}
+
+	if (n > 0) {
+		buf_dblwr_write_batch_checksums(dblwr, slots, n);
+	}
+}
+
+/** Flushes possible buffered writes from one doublewrite memory buffer to
+disk. See buf_dblwr_flush_buffered_writes().
+@param[in,out]	dblwr	doublewrite buffer */
+static
+void
+buf_dblwr_flush_buffered_writes_low(
+	buf_dblwr_t*	dblwr)
+{
+	byte*		write_buf;
+	ulint		first_free;
+	ulint		len;
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&dblwr->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (dblwr->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&dblwr->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -978,39 +1472,39 @@ try_again:
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (dblwr->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(dblwr->b_event);
+		mutex_exit(&dblwr->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(dblwr->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!dblwr->batch_running);
+	ut_ad(dblwr->first_free == dblwr->b_reserved);
 
 	/* Disallow anyone else to post to doublewrite buffer or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	dblwr->batch_running = true;
+	first_free = dblwr->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&dblwr->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	write_buf = dblwr->write_buf;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < dblwr->first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) dblwr->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -1028,57 +1522,55 @@ try_again:
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
+	buf_dblwr_calc_batch_checksums(dblwr, first_free);
+
 	/* Write out the first block of the doublewrite buffer */
 	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
+		     dblwr->first_free) * UNIV_PAGE_SIZE;
 
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
+	buf_dblwr_write_to_disk(dblwr, dblwr->block1, len, write_buf);
 
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+	if (dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
 		/* No unwritten pages in the second block. */
 		goto flush;
 	}
 
 	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+	len = (dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
 	       * UNIV_PAGE_SIZE;
 
-	write_buf = buf_dblwr->write_buf
+	write_buf = dblwr->write_buf
 		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
 
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
+	buf_dblwr_write_to_disk(dblwr, dblwr->block2, len, write_buf);
 
 flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(dblwr->first_free);
 	srv_stats.dblwr_writes.inc();
 
 	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	buf_dblwr_flush_to_disk(dblwr);
 
 	/* We know that the writes have been flushed to disk now
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and dblwr->first_free are
+	same because we have set the dblwr->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access dblwr->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting dblwr->first_free to a higher value.
+	If this happens and we are using dblwr->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == dblwr->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			dblwr->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -1088,6 +1580,42 @@ flush:
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur.
+@param[in]	buf_pool	with innodb_doublewrite_files, flush only the
+doublewrite file of this buffer pool instance; NULL to flush all */
+void
+buf_dblwr_flush_buffered_writes(
+	const buf_pool_t*	buf_pool)
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	ut_ad(!srv_read_only_mode);
+
+	if (buf_dblwr_n_files == 0) {
+		buf_dblwr_flush_buffered_writes_low(buf_dblwr);
+
+	} else if (buf_pool != NULL) {
+		/* Do not wait for the batches of the other files. */
+		buf_dblwr_flush_buffered_writes_low(
+			&buf_dblwr_files[buf_pool_index(buf_pool)
+					 % buf_dblwr_n_files]);
+	} else {
+		for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+			buf_dblwr_flush_buffered_writes_low(
+				&buf_dblwr_files[i]);
+		}
+	}
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -1095,16 +1623,22 @@ space to appear. */
 void
 buf_dblwr_add_to_batch(
 /*====================*/
-	buf_page_t*	bpage)	/*!< in: buffer block to write */
+	buf_page_t*	bpage,	/*!< in: buffer block to write */
+	bool		crc32_pending)/*!< in: whether the CRC32
+				checksum of the page is to be computed
+				when the batch is written, see
+				buf_flush_init_for_writing() */
 {
 	ut_a(buf_page_in_file(bpage));
 
+	buf_dblwr_t*	dblwr = buf_dblwr_get_for(bpage);
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&dblwr->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(dblwr->first_free <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->batch_running) {
+	if (dblwr->batch_running) {
 
 		/* This not nearly as bad as it looks. There is only
 		page_cleaner thread which does background flushing
@@ -1112,23 +1646,23 @@ try_again:
 		point. The only exception is when a user thread is
 		forced to do a flush batch because of a sync
 		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(dblwr->b_event);
+		mutex_exit(&dblwr->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(dblwr->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (dblwr->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&(dblwr->mutex));
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes_low(dblwr);
 
 		goto try_again;
 	}
 
-	byte*	p = buf_dblwr->write_buf
-		+ univ_page_size.physical() * buf_dblwr->first_free;
+	byte*	p = dblwr->write_buf
+		+ univ_page_size.physical() * dblwr->first_free;
 
 	if (bpage->size.is_compressed()) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, bpage->size.physical());
@@ -1147,24 +1681,25 @@ try_again:
 		memcpy(p, ((buf_block_t*) bpage)->frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	dblwr->buf_block_arr[dblwr->first_free] = bpage;
+	dblwr->crc32_pending[dblwr->first_free] = crc32_pending;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	dblwr->first_free++;
+	dblwr->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!dblwr->batch_running);
+	ut_ad(dblwr->first_free == dblwr->b_reserved);
+	ut_ad(dblwr->b_reserved <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (dblwr->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&(dblwr->mutex));
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes_low(dblwr);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&(dblwr->mutex));
 }
 
 /********************************************************************//**
@@ -1190,6 +1725,8 @@ buf_dblwr_write_single_page(
 	ut_a(srv_use_doublewrite_buf);
 	ut_a(buf_dblwr != NULL);
 
+	buf_dblwr_t*	dblwr = buf_dblwr_get_for(bpage);
+
 	/* total number of slots available for single page flushes
 	starts from srv_doublewrite_batch_size to the end of the
 	buffer. */
@@ -1212,82 +1749,77 @@ buf_dblwr_write_single_page(
 	}
 
 retry:
-	mutex_enter(&buf_dblwr->mutex);
-	if (buf_dblwr->s_reserved == n_slots) {
+	mutex_enter(&dblwr->mutex);
+	if (dblwr->s_reserved == n_slots) {
 
 		/* All slots are reserved. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
-		os_event_wait_low(buf_dblwr->s_event, sig_count);
+		int64_t	sig_count = os_event_reset(dblwr->s_event);
+		mutex_exit(&dblwr->mutex);
+		os_event_wait_low(dblwr->s_event, sig_count);
 
 		goto retry;
 	}
 
 	for (i = srv_doublewrite_batch_size; i < size; ++i) {
 
-		if (!buf_dblwr->in_use[i]) {
+		if (!dblwr->in_use[i]) {
 			break;
 		}
 	}
 
 	/* We are guaranteed to find a slot. */
 	ut_a(i < size);
-	buf_dblwr->in_use[i] = true;
-	buf_dblwr->s_reserved++;
-	buf_dblwr->buf_block_arr[i] = bpage;
+	dblwr->in_use[i] = true;
+	dblwr->s_reserved++;
+	dblwr->buf_block_arr[i] = bpage;
 
 	/* increment the doublewrite flushed pages counter */
 	srv_stats.dblwr_pages_written.inc();
 	srv_stats.dblwr_writes.inc();
 
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&dblwr->mutex);
 
 	/* Lets see if we are going to write in the first or second
 	block of the doublewrite buffer. */
 	if (i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		offset = buf_dblwr->block1 + i;
+		offset = dblwr->block1 + i;
 	} else {
-		offset = buf_dblwr->block2 + i
+		offset = dblwr->block2 + i
 			 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 	}
 
 	/* We deal with compressed and uncompressed pages a little
 	differently here. In case of uncompressed pages we can
 	directly write the block to the allocated slot in the
-	doublewrite buffer in the system tablespace and then after
-	syncing the system table space we can proceed to write the page
-	in the datafile.
+	doublewrite buffer (in the system tablespace or in the
+	doublewrite file) and then after syncing it we can proceed
+	to write the page in the datafile.
 	In case of compressed page we first do a memcpy of the block
 	to the in-memory buffer of doublewrite before proceeding to
 	write it. This is so because we want to pad the remaining
 	bytes in the doublewrite page with zeros. */
 
 	if (bpage->size.is_compressed()) {
-		memcpy(buf_dblwr->write_buf + univ_page_size.physical() * i,
+		memcpy(dblwr->write_buf + univ_page_size.physical() * i,
 		       bpage->zip.data, bpage->size.physical());
 
-		memset(buf_dblwr->write_buf + univ_page_size.physical() * i
+		memset(dblwr->write_buf + univ_page_size.physical() * i
 		       + bpage->size.physical(), 0x0,
 		       univ_page_size.physical() - bpage->size.physical());
 
-		fil_io(IORequestWrite, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) (buf_dblwr->write_buf
-				+ univ_page_size.physical() * i),
-		       NULL);
+		buf_dblwr_write_to_disk(
+			dblwr, offset, univ_page_size.physical(),
+			dblwr->write_buf + univ_page_size.physical() * i);
 	} else {
 		/* It is a regular page. Write it directly to the
 		doublewrite buffer */
-		fil_io(IORequestWrite, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) ((buf_block_t*) bpage)->frame,
-		       NULL);
+		buf_dblwr_write_to_disk(
+			dblwr, offset, univ_page_size.physical(),
+			((buf_block_t*) bpage)->frame);
 	}
 
 	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	buf_dblwr_flush_to_disk(dblwr);
 
 	/* We know that the write has been flushed to disk now
 	and during recovery we will find it in the doublewrite buffer
@@ -42,7 +42,9 @@ Created April 08, 2011 Vasil Dimov
 
 #include "buf0buf.h"
 #include "buf0dump.h"
+#include "buf0rea.h"
 #include "dict0dict.h"
+#include "ibuf0ibuf.h"
 #include "os0file.h"
 #include "os0thread.h"
 #include "srv0srv.h"
@@ -78,6 +80,41 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/* How hot a page was when it was dumped. The dump file holds one
+"space,page,heat" line per page; files written by older versions lack the
+heat column and their pages are loaded as BUF_DUMP_HEAT_COLD. */
+enum buf_dump_heat_t {
+	BUF_DUMP_HEAT_COLD = 0,	/*!< the page was never accessed */
+	BUF_DUMP_HEAT_WARM = 1,	/*!< the page was accessed, but it is in
+				the old sublist of the LRU list */
+	BUF_DUMP_HEAT_HOT = 2	/*!< the page is in the young sublist */
+};
+
+/** A page of a buffer pool dump */
+struct buf_dump_entry_t {
+	/** BUF_DUMP_CREATE(space, page) */
+	buf_dump_t	id;
+
+	/** buf_dump_heat_t of the page */
+	ulint		heat;
+
+	/** Order the pages by decreasing heat and then by (space, page),
+	which is the order in which buf_load() reads them. */
+	bool operator<(const buf_dump_entry_t& other) const
+	{
+		if (heat != other.heat) {
+			return(heat > other.heat);
+		}
+
+		return(id < other.id);
+	}
+};
+
+/** Maximum number of pages in a batch of a buffer pool load. The pages of
+a batch are in the same tablespace and they have the same heat; each run
+of adjacent pages of a batch is read with one request. */
+static const ulint	BUF_LOAD_BATCH_SIZE = BUF_READ_PAGE_RANGE_MAX;
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -268,8 +305,11 @@ static
 void
 buf_dump(
 /*=====*/
-	ibool	obey_shutdown)	/*!< in: quit if we are in a shutting down
-				state */
+	ibool			obey_shutdown,	/*!< in: quit if we are in a
+						shutting down state */
+	enum status_severity	severity)	/*!< in: severity of the
+						start and completion
+						messages */
 {
 #define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
 
@@ -285,7 +325,7 @@ buf_dump(
 	ut_snprintf(tmp_filename, sizeof(tmp_filename),
 		    "%s.incomplete", full_filename);
 
-	buf_dump_status(STATUS_INFO, "Dumping buffer pool(s) to %s",
+	buf_dump_status(severity, "Dumping buffer pool(s) to %s",
 			full_filename);
 
 	f = fopen(tmp_filename, "w");
@@ -301,7 +341,7 @@ buf_dump(
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
-		buf_dump_t*		dump;
+		buf_dump_entry_t*	dump;
 		ulint			n_pages;
 		ulint			j;
 
@@ -329,7 +369,7 @@ buf_dump(
 			}
 		}
 
-		dump = static_cast<buf_dump_t*>(ut_malloc_nokey(
+		dump = static_cast<buf_dump_entry_t*>(ut_malloc_nokey(
 				n_pages * sizeof(*dump)));
 
 		if (dump == NULL) {
@@ -349,8 +389,16 @@ buf_dump(
 
 			ut_a(buf_page_in_file(bpage));
 
-			dump[j] = BUF_DUMP_CREATE(bpage->id.space(),
-						  bpage->id.page_no());
+			dump[j].id = BUF_DUMP_CREATE(bpage->id.space(),
+						     bpage->id.page_no());
+
+			if (!bpage->old) {
+				dump[j].heat = BUF_DUMP_HEAT_HOT;
+			} else if (buf_page_is_accessed(bpage)) {
+				dump[j].heat = BUF_DUMP_HEAT_WARM;
+			} else {
+				dump[j].heat = BUF_DUMP_HEAT_COLD;
+			}
 		}
 
 		ut_a(j == n_pages);
@@ -358,9 +406,10 @@ buf_dump(
 		buf_pool_mutex_exit(buf_pool);
 
 		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+			ret = fprintf(f, ULINTPF "," ULINTPF "," ULINTPF "\n",
+				      BUF_DUMP_SPACE(dump[j].id),
+				      BUF_DUMP_PAGE(dump[j].id),
+				      dump[j].heat);
 			if (ret < 0) {
 				ut_free(dump);
 				fclose(f);
@@ -419,40 +468,58 @@ buf_dump(
 
 	ut_sprintf_timestamp(now);
 
-	buf_dump_status(STATUS_INFO,
+	buf_dump_status(severity,
 			"Buffer pool(s) dump completed at %s", now);
 }
 
+/** @return number of pages that have been read or created in the buffer
+pool since the server was started */
+static
+ulint
+buf_dump_n_pages_in()
+{
+	buf_pool_stat_t	stat;
+
+	buf_get_total_stat(&stat);
+
+	return(stat.n_pages_read + stat.n_pages_created);
+}
+
 /** Artificially delay the buffer pool loading if necessary. The idea of this
 function is to prevent hogging the server with IO and slowing down too much
 normal client queries.
 @param[in,out]	last_check_time		milliseconds since epoch of the last
                                         time we did check if throttling is
                                         needed, we do the check every
-                                        srv_io_capacity IO ops.
-@param[in]	last_activity_count	activity count
-@param[in]	n_io			number of IO ops done since buffer
-                                        pool load has started */
+                                        io_capacity IO ops.
+@param[in,out]	last_activity_count	activity count
+@param[in,out]	n_io			number of IO ops done since the last
+					check, reset when we check
+@param[in]	io_capacity		number of IO ops per second that the
+					calling thread may perform */
 UNIV_INLINE
 void
 buf_load_throttle_if_needed(
 /*========================*/
 	ib_time_monotonic_ms_t*	last_check_time,
 	ulint*			last_activity_count,
-	ulint 			n_io)
+	ulint*			n_io,
+	ulint			io_capacity)
 {
-	if (n_io % srv_io_capacity < srv_io_capacity - 1) {
+	if (*n_io < io_capacity) {
 		return;
 	}
 
+	*n_io = 0;
+
 	if (*last_check_time == 0 || *last_activity_count == 0) {
 		*last_check_time = ut_time_monotonic_ms();
 		*last_activity_count = srv_get_activity_count();
 		return;
 	}
 
-	/* srv_io_capacity IO operations have been performed by buffer pool
-	load since the last time we were here. */
+	/* io_capacity IO operations have been performed by this thread
+	since the last time we were here. */
 
 	/* If no other activity, then keep going without any delay. */
 	if (srv_get_activity_count() == *last_activity_count) {
@@ -465,19 +532,19 @@ buf_load_throttle_if_needed(
 	ulint	elapsed_time = now - *last_check_time;
 
 	/* Notice that elapsed_time is not the time for the last
-	srv_io_capacity IO operations performed by BP load. It is the
+	io_capacity IO operations performed by BP load. It is the
 	time elapsed since the last time we detected that there has been
 	other activity. This has a small and acceptable deficiency, e.g.:
 	1. BP load runs and there is no other activity.
 	2. Other activity occurs, we run N IO operations after that and
-	   enter here (where 0 <= N < srv_io_capacity).
+	   enter here (where 0 <= N < io_capacity).
 	3. last_check_time is very old and we do not sleep at this time, but
 	   only update last_check_time and last_activity_count.
-	4. We run srv_io_capacity more IO operations and call this function
+	4. We run io_capacity more IO operations and call this function
 	   again.
 	5. There has been more other activity and thus we enter here.
 	6. Now last_check_time is recent and we sleep if necessary to prevent
-	   more than srv_io_capacity IO operations per second.
+	   more than io_capacity IO operations per second.
 	The deficiency is that we could have slept at 3., but for this we
 	would have to update last_check_time before the
 	"cur_activity_count == *last_activity_count" check and calling
@@ -491,27 +558,284 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Read the next page from a buffer pool dump file. The heat column is
+optional, so that the files that were written before it was added can
+still be loaded.
+@param[in,out]	f		dump file
+@param[out]	space_id	tablespace identifier
+@param[out]	page_no		page number
+@param[out]	heat		buf_dump_heat_t of the page
+@return true if a page was read; false at the end of the file or on error,
+which the caller tells apart with feof() */
+static
+bool
+buf_load_read_entry(
+	FILE*	f,
+	ulint*	space_id,
+	ulint*	page_no,
+	ulint*	heat)
+{
+	if (fscanf(f, ULINTPF "," ULINTPF, space_id, page_no) != 2) {
+		return(false);
+	}
+
+	int	c = fgetc(f);
+
+	if (c != ',') {
+		if (c != EOF) {
+			ungetc(c, f);
+		}
+
+		*heat = BUF_DUMP_HEAT_COLD;
+		return(true);
+	}
+
+	if (fscanf(f, ULINTPF, heat) != 1) {
+		return(false);
+	}
+
+	/* Treat unknown heat values of newer versions as the hottest. */
+	*heat = ut_min(*heat, static_cast<ulint>(BUF_DUMP_HEAT_HOT));
+
+	return(true);
+}
+
+/** State of a buffer pool load that is shared by the threads that read
+the pages */
+struct buf_load_ctx_t {
+	/** The pages to read, sorted */
+	const buf_dump_entry_t*	dump;
+
+	/** Position of the first page of each batch in dump[], followed by
+	the number of pages */
+	const ulint*		batches;
+
+	/** Number of batches */
+	ulint			n_batches;
+
+	/** Next batch to read, updated atomically */
+	ulint			next;
+
+	/** Number of pages of the batches that have been read, updated
+	atomically */
+	ulint			n_loaded;
+
+	/** Number of IO operations per second that each thread may
+	perform */
+	ulint			io_capacity;
+
+	/** Number of threads that have not finished, updated
+	atomically */
+	ulint			n_running;
+
+	/** Set when the last thread has finished */
+	os_event_t		done_event;
+};
+
+/** Read a batch of pages of a buffer pool load. Each run of adjacent pages
+is read synchronously with one request into buf, from which the pages are
+copied into their buffer pool frames. The pages of the system tablespace,
+which holds the change buffer, and of tablespaces of several files are read
+in the background one by one.
+@param[in]	dump	first page of the batch
+@param[in]	n_pages	number of pages in the batch, which are all in the
+same tablespace
+@param[in,out]	buf	buffer of BUF_LOAD_BATCH_SIZE * UNIV_PAGE_SIZE bytes,
+aligned to UNIV_PAGE_SIZE */
+static
+void
+buf_load_read_batch(
+	const buf_dump_entry_t*	dump,
+	ulint			n_pages,
+	byte*			buf)
+{
+	const ulint	space_id = BUF_DUMP_SPACE(dump[0].id);
+
+	/* Avoid calling the expensive fil_space_acquire_silent() for each
+	page of the batch. */
+	fil_space_t*	space = fil_space_acquire_silent(space_id);
+
+	if (space == NULL) {
+		return;
+	}
+
+	const page_size_t	page_size(space->flags);
+
+	if (space_id == TRX_SYS_SPACE
+	    || UT_LIST_GET_LEN(space->chain) != 1) {
+
+		for (ulint i = 0; i < n_pages; i++) {
+			buf_read_page_background(
+				page_id_t(space_id,
+					  BUF_DUMP_PAGE(dump[i].id)),
+				page_size, false);
+		}
+
+		/* The reads were posted with IORequest::DO_NOT_WAKE. */
+		os_aio_simulated_wake_handler_threads();
+
+		fil_space_release(space);
+		return;
+	}
+
+	/* This opens the file if needed. A read request must not go
+	past the end of the file. */
+	const ulint	space_size = fil_space_get_size(space_id);
+
+	for (ulint i = 0; i < n_pages; ) {
+		const page_id_t	page_id(space_id, BUF_DUMP_PAGE(dump[i].id));
+
+		if (page_id.page_no() >= space_size) {
+			/* The page was freed after the dump. */
+			i++;
+			continue;
+		}
+
+		/* A run must not contain a change buffer bitmap page
+		after its first page; see buf_read_page_range(). */
+		ulint	n = 1;
+
+		while (i + n < n_pages
+		       && BUF_DUMP_PAGE(dump[i + n].id)
+		       == page_id.page_no() + n
+		       && page_id.page_no() + n < space_size
+		       && !ibuf_bitmap_page(
+			       page_id_t(space_id, page_id.page_no() + n),
+			       page_size)) {
+			n++;
+		}
+
+		buf_read_page_range(page_id, n, page_size, buf);
+
+		i += n;
+	}
+
+	fil_space_release(space);
+}
+
+/** Read batches of a buffer pool load until none is left or the load is
+aborted. This is the body of the threads that buf_load() starts.
+@param[in,out]	ctx	buffer pool load */
+static
+void
+buf_load_worker(
+	buf_load_ctx_t*	ctx)
+{
+	ib_time_monotonic_ms_t	last_check_time = 0;
+	ulint			last_activity_cnt = 0;
+	ulint			n_io = 0;
+	byte*			buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey((1 + BUF_LOAD_BATCH_SIZE) * UNIV_PAGE_SIZE));
+	byte*			buf = static_cast<byte*>(
+		ut_align(buf_unaligned, UNIV_PAGE_SIZE));
+
+	while (!buf_load_abort_flag && !SHUTTING_DOWN()) {
+		ulint	batch = os_atomic_increment_ulint(&ctx->next, 1) - 1;
+
+		if (batch >= ctx->n_batches) {
+			break;
+		}
+
+		const ulint	first = ctx->batches[batch];
+		const ulint	n_pages = ctx->batches[batch + 1] - first;
+
+		buf_load_read_batch(ctx->dump + first, n_pages, buf);
+
+		os_atomic_increment_ulint(&ctx->n_loaded, n_pages);
+
+		n_io += n_pages;
+
+		buf_load_throttle_if_needed(
+			&last_check_time, &last_activity_cnt, &n_io,
+			ctx->io_capacity);
+	}
+
+	ut_free(buf_unaligned);
+
+	if (os_atomic_decrement_ulint(&ctx->n_running, 1) == 0) {
+		os_event_set(ctx->done_event);
+	}
+}
+
+/*********************************************************************//**
+Thread that reads batches of pages for buf_load().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_load_thread)(
+/*============================*/
+	void*	arg)	/*!< in: buf_load_ctx_t */
+{
+	buf_load_worker(static_cast<buf_load_ctx_t*>(arg));
+
+	os_thread_exit(false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Wait until the reads that a buffer pool load posted have completed.
+@param[in]	dump	the pages of the load
+@param[in]	dump_n	number of pages */
+static
+void
+buf_load_wait_for_reads(
+	const buf_dump_entry_t*	dump,
+	ulint			dump_n)
+{
+	for (ulint i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+		const page_id_t	page_id(BUF_DUMP_SPACE(dump[i].id),
+					BUF_DUMP_PAGE(dump[i].id));
+		buf_pool_t*	buf_pool = buf_pool_get(page_id);
+
+		for (;;) {
+			rw_lock_t*	hash_lock;
+			buf_page_t*	bpage = buf_page_hash_get_s_locked(
+				buf_pool, page_id, &hash_lock);
+
+			if (bpage == NULL) {
+				break;
+			}
+
+			bool	reading = buf_page_get_io_fix(bpage)
+				== BUF_IO_READ;
+
+			rw_lock_s_unlock(hash_lock);
+
+			if (!reading) {
+				break;
+			}
+
+			os_thread_sleep(1000);
+		}
+	}
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
 The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+SET GLOBAL innodb_buffer_pool_filename='filename';
+The pages are read hottest first, in batches of pages of one tablespace
+that innodb_buffer_pool_load_threads threads read, one request for each run
+of adjacent pages. */
 static
 void
 buf_load()
 /*======*/
 {
-	char		full_filename[OS_FILE_MAX_PATH];
-	char		now[32];
-	FILE*		f;
-	buf_dump_t*	dump;
-	ulint		dump_n;
-	ulint		total_buffer_pools_pages;
-	ulint		i;
-	ulint		space_id;
-	ulint		page_no;
-	int		fscanf_ret;
+	char			full_filename[OS_FILE_MAX_PATH];
+	char			now[32];
+	FILE*			f;
+	buf_dump_entry_t*	dump;
+	ulint*			batches;
+	ulint			dump_n;
+	ulint			n_batches;
+	ulint			total_buffer_pools_pages;
+	ulint			i;
+	ulint			space_id;
+	ulint			page_no;
+	ulint			heat;
 
 	/* Ignore any leftovers from before */
 	buf_load_abort_flag = FALSE;
@@ -534,13 +858,13 @@ buf_load()
 	This file is tiny (approx 500KB per 1GB buffer pool), reading it
 	two times is fine. */
 	dump_n = 0;
-	while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2
+	while (buf_load_read_entry(f, &space_id, &page_no, &heat)
 	       && !SHUTTING_DOWN()) {
 		dump_n++;
 	}
 
 	if (!SHUTTING_DOWN() && !feof(f)) {
-		/* fscanf() returned != 2 */
+		/* buf_load_read_entry() failed */
 		const char*	what;
 		if (ferror(f)) {
 			what = "reading";
@@ -564,8 +888,10 @@ buf_load()
 	}
 
 	if(dump_n != 0) {
-		dump = static_cast<buf_dump_t*>(ut_malloc_nokey(
+		dump = static_cast<buf_dump_entry_t*>(ut_malloc_nokey(
 				dump_n * sizeof(*dump)));
+		batches = static_cast<ulint*>(ut_malloc_nokey(
+				(dump_n + 1) * sizeof(*batches)));
 	} else {
 		fclose(f);
 		ut_sprintf_timestamp(now);
@@ -575,11 +901,14 @@ buf_load()
 		return;
 	}
 
-	if (dump == NULL) {
+	if (dump == NULL || batches == NULL) {
+		ut_free(dump);
+		ut_free(batches);
 		fclose(f);
 		buf_load_status(STATUS_ERR,
 				"Cannot allocate " ULINTPF " bytes: %s",
-				(ulint) (dump_n * sizeof(*dump)),
+				(ulint) (dump_n * (sizeof(*dump)
+						   + sizeof(*batches))),
 				strerror(errno));
 		return;
 	}
@@ -587,15 +916,13 @@ buf_load()
 	rewind(f);
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-		fscanf_ret = fscanf(f, ULINTPF "," ULINTPF,
-				    &space_id, &page_no);
-
-		if (fscanf_ret != 2) {
+		if (!buf_load_read_entry(f, &space_id, &page_no, &heat)) {
 			if (feof(f)) {
 				break;
 			}
 			/* else */
 
+			ut_free(batches);
 			ut_free(dump);
 			fclose(f);
 			buf_load_status(STATUS_ERR,
@@ -606,6 +933,7 @@ buf_load()
 		}
 
 		if (space_id > ULINT32_MASK || page_no > ULINT32_MASK) {
+			ut_free(batches);
 			ut_free(dump);
 			fclose(f);
 			buf_load_status(STATUS_ERR,
@@ -619,7 +947,8 @@ buf_load()
 			return;
 		}
 
-		dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].id = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].heat = heat;
 	}
 
 	/* Set dump_n to the actual number of initialized elements,
@@ -630,6 +959,7 @@ buf_load()
 	fclose(f);
 
 	if (dump_n == 0) {
+		ut_free(batches);
 		ut_free(dump);
 		ut_sprintf_timestamp(now);
 		buf_load_status(STATUS_INFO,
@@ -642,15 +972,22 @@ buf_load()
 		std::sort(dump, dump + dump_n);
 	}
 
-	ib_time_monotonic_ms_t		last_check_time = 0;
-	ulint		last_activity_cnt = 0;
+	/* Split the pages into batches of adjacent pages of the same
+	tablespace and heat. */
+	n_batches = 0;
 
-	/* Avoid calling the expensive fil_space_acquire_silent() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
-	ulint		cur_space_id = BUF_DUMP_SPACE(dump[0]);
-	fil_space_t*	space = fil_space_acquire_silent(cur_space_id);
-	page_size_t	page_size(space ? space->flags : 0);
+	for (i = 0; i < dump_n; i++) {
+		if (i == 0
+		    || i - batches[n_batches - 1] == BUF_LOAD_BATCH_SIZE
+		    || BUF_DUMP_SPACE(dump[i].id)
+		    != BUF_DUMP_SPACE(dump[i - 1].id)
+		    || dump[i].heat != dump[i - 1].heat) {
+
+			batches[n_batches++] = i;
+		}
+	}
+
+	batches[n_batches] = dump_n;
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
 	PSI_stage_progress*	pfs_stage_progress
@@ -660,78 +997,68 @@ buf_load()
 	mysql_stage_set_work_estimated(pfs_stage_progress, dump_n);
 	mysql_stage_set_work_completed(pfs_stage_progress, 0);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	const ulint	n_threads = ut_min(
+		static_cast<ulint>(srv_buf_load_threads), n_batches);
 
-		/* space_id for this iteration of the loop */
-		const ulint	this_space_id = BUF_DUMP_SPACE(dump[i]);
+	buf_load_ctx_t	ctx;
 
-		if (this_space_id != cur_space_id) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
+	ctx.dump = dump;
+	ctx.batches = batches;
+	ctx.n_batches = n_batches;
+	ctx.next = 0;
+	ctx.n_loaded = 0;
+	/* The threads share innodb_io_capacity. */
+	ctx.io_capacity = ut_max(srv_io_capacity / n_threads, 1UL);
+	ctx.n_running = n_threads;
+	ctx.done_event = os_event_create(0);
 
-			cur_space_id = this_space_id;
-			space = fil_space_acquire_silent(cur_space_id);
+	os_thread_id_t*	thread_ids = static_cast<os_thread_id_t*>(
+		ut_malloc_nokey(n_threads * sizeof(*thread_ids)));
 
-			if (space != NULL) {
-				const page_size_t	cur_page_size(
-					space->flags);
-				page_size.copy_from(cur_page_size);
-			}
-		}
+	for (i = 0; i < n_threads; i++) {
+		os_thread_create(buf_load_thread, &ctx, &thread_ids[i]);
+	}
 
-		if (space == NULL) {
-			continue;
-		}
+	/* Update the progress until the threads have finished. */
+	do {
+		const ulint	n_loaded = ctx.n_loaded;
 
-		buf_read_page_background(
-			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
+		buf_load_status(STATUS_VERBOSE,
+				"Loaded " ULINTPF "/" ULINTPF " pages",
+				n_loaded, dump_n);
+		mysql_stage_set_work_completed(pfs_stage_progress, n_loaded);
+	} while (os_event_wait_time(ctx.done_event, 100000)
+		 == OS_SYNC_TIME_EXCEEDED);
 
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
+	for (i = 0; i < n_threads; i++) {
+		os_thread_join(thread_ids[i]);
+	}
 
-		/* Update the progress every 32 MiB, which is every Nth page,
-		where N = 32*1024^2 / page_size. */
-		static const ulint	update_status_every_n_mb = 32;
-		static const ulint	update_status_every_n_pages
-			= update_status_every_n_mb * 1024 * 1024
-			/ page_size.physical();
-
-		if (i % update_status_every_n_pages == 0) {
-			buf_load_status(STATUS_VERBOSE,
-					"Loaded " ULINTPF "/" ULINTPF " pages",
-					i + 1, dump_n);
-			mysql_stage_set_work_completed(pfs_stage_progress, i);
-		}
+	ut_free(thread_ids);
+	os_event_destroy(ctx.done_event);
+	ut_free(batches);
 
-		if (buf_load_abort_flag) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_INFO,
-				"Buffer pool(s) load aborted on request");
-			/* Premature end, set estimated = completed = i and
-			end the current stage event. */
-			mysql_stage_set_work_estimated(pfs_stage_progress, i);
-			mysql_stage_set_work_completed(pfs_stage_progress, i);
+	if (buf_load_abort_flag) {
+		const ulint	n_loaded = ctx.n_loaded;
+
+		buf_load_abort_flag = FALSE;
+		ut_free(dump);
+		buf_load_status(
+			STATUS_INFO,
+			"Buffer pool(s) load aborted on request");
+		/* Premature end, set estimated = completed = n_loaded and
+		end the current stage event. */
+		mysql_stage_set_work_estimated(pfs_stage_progress, n_loaded);
+		mysql_stage_set_work_completed(pfs_stage_progress, n_loaded);
 #ifdef HAVE_PSI_STAGE_INTERFACE
-			mysql_end_stage();
+		mysql_end_stage();
 #endif /* HAVE_PSI_STAGE_INTERFACE */
-			return;
-		}
-
-		buf_load_throttle_if_needed(
-			&last_check_time, &last_activity_cnt, i);
+		return;
 	}
 
-	if (space != NULL) {
-		fil_space_release(space);
-	}
+	/* The load is complete when the pages are in the buffer pool,
+	not when their reads have been posted. */
+	buf_load_wait_for_reads(dump, dump_n);
 
 	ut_free(dump);
 
@@ -762,7 +1089,8 @@ buf_load_abort()
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
-again.
+again. It also makes a dump every innodb_buffer_pool_dump_interval
+seconds.
 @return this function does not return, it calls os_thread_exit() */
 extern "C"
 os_thread_ret_t
@@ -787,13 +1115,51 @@ DECLARE_THREAD(buf_dump_thread)(
 		buf_load();
 	}
 
+	/* When the last dump was made, and how many pages had been read
+	into the buffer pool by then */
+	ib_time_monotonic_t	last_dump_time = ut_time_monotonic();
+	ulint			last_dump_n_pages = buf_dump_n_pages_in();
+
 	while (!SHUTTING_DOWN()) {
 
-		os_event_wait(srv_buf_dump_event);
+		const ulint	interval = srv_buf_dump_interval;
+
+		if (interval == 0) {
+			os_event_wait(srv_buf_dump_event);
+		} else {
+			ib_time_monotonic_t	elapsed
+				= ut_time_monotonic() - last_dump_time;
+
+			if (elapsed >= 0
+			    && static_cast<ulint>(elapsed) < interval) {
+				os_event_wait_time(
+					srv_buf_dump_event,
+					(interval - elapsed) * 1000000);
+			}
+		}
 
 		if (buf_dump_should_start) {
 			buf_dump_should_start = FALSE;
-			buf_dump(TRUE /* quit on shutdown */);
+			buf_dump(TRUE /* quit on shutdown */, STATUS_INFO);
+			last_dump_time = ut_time_monotonic();
+			last_dump_n_pages = buf_dump_n_pages_in();
+		} else if (interval != 0
+			   && ut_time_monotonic() - last_dump_time
+			   >= static_cast<ib_time_monotonic_t>(interval)
+			   && !SHUTTING_DOWN()) {
+			/* Dump periodically, so that a recent dump can be
+			loaded after a crash. Skip the dump if no page has
+			been brought into the buffer pool since the last
+			one. */
+			const ulint	n_pages = buf_dump_n_pages_in();
+
+			if (n_pages != last_dump_n_pages) {
+				buf_dump(TRUE /* quit on shutdown */,
+					 STATUS_VERBOSE);
+				last_dump_n_pages = n_pages;
+			}
+
+			last_dump_time = ut_time_monotonic();
 		}
 
 		if (buf_load_should_start) {
@@ -806,7 +1172,8 @@ DECLARE_THREAD(buf_dump_thread)(
 
 	if (srv_buffer_pool_dump_at_shutdown && srv_fast_shutdown != 2) {
 		buf_dump(FALSE /* ignore shutdown down flag,
-		keep going even if we are in a shutdown state */);
+		keep going even if we are in a shutdown state */,
+			 STATUS_INFO);
 	}
 
 	srv_buf_dump_thread_active = FALSE;
@@ -69,6 +69,10 @@ Created 11/11/1995 Heikki Tuuri
 static const int buf_flush_page_cleaner_priority = -20;
 #endif /* UNIV_LINUX */
 
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif /* HAVE_LIBNUMA */
+
 /** Sleep time in microseconds for loop waiting for the oldest
 modification lsn */
 static const ulint buf_flush_wait_flushed_sleep_time = 10000;
@@ -116,6 +120,26 @@ enum page_cleaner_state_t {
 	PAGE_CLEANER_STATE_FINISHED
 };
 
+/** Kind of the request of a page cleaner array slot */
+enum page_cleaner_request_t {
+	/** Requested together with all slots by pc_request().
+	The coordinator waits for all slots in pc_wait_finished(). */
+	PAGE_CLEANER_REQUEST_ALL = 0,
+	/** With innodb_page_cleaner_per_instance: flush the tail
+	of the LRU list only, because user threads are short of
+	free blocks. */
+	PAGE_CLEANER_REQUEST_LRU,
+	/** With innodb_page_cleaner_per_instance: flush the
+	adaptive target of the instance, while the server is active. */
+	PAGE_CLEANER_REQUEST_ADAPTIVE,
+	/** With innodb_page_cleaner_per_instance: flush at
+	innodb_io_capacity, while the server is idle. */
+	PAGE_CLEANER_REQUEST_BACKGROUND,
+	/** With innodb_page_cleaner_per_instance: flush up to the LSN
+	of a synchronous preflush (buf_flush_request_force()). */
+	PAGE_CLEANER_REQUEST_SYNC
+};
+
 /** Page cleaner request state for each buffer pool instance */
 struct page_cleaner_slot_t {
 	page_cleaner_state_t	state;	/*!< state of the request.
@@ -124,10 +148,23 @@ struct page_cleaner_slot_t {
 					set to PAGE_CLEANER_STATE_FLUSHING,
 					n_flushed_lru and n_flushed_list can be
 					updated only by the worker thread */
-	/* This value is set during state==PAGE_CLEANER_STATE_NONE */
+	/* These values are set during state==PAGE_CLEANER_STATE_NONE */
 	ulint			n_pages_requested;
 					/*!< number of requested pages
 					for the slot */
+	bool			requested;
+					/*!< true if requested pages
+					to flush */
+	lsn_t			lsn_limit;
+					/*!< upper limit of LSN to be
+					flushed */
+	page_cleaner_request_t	request;
+					/*!< kind of the request */
+	os_event_t		is_requested;
+					/*!< with
+					innodb_page_cleaner_per_instance,
+					event to activate the worker thread
+					of the slot */
 	/* These values are updated during state==PAGE_CLEANER_STATE_FLUSHING,
 	and commited with state==PAGE_CLEANER_STATE_FINISHED.
 	The consistency is protected by the 'state' */
@@ -150,6 +187,34 @@ struct page_cleaner_slot_t {
 	ulint			flush_list_pass;
 					/*!< count to attempt flush_list
 					flushing */
+	/* These values are used only by the coordinator thread,
+	with innodb_page_cleaner_per_instance */
+	ib_time_monotonic_ms_t	next_loop_time;
+					/*!< time when the next adaptive
+					flushing of the instance is due */
+	ib_time_monotonic_t	prev_time;
+					/*!< time when avg_page_rate was
+					last updated */
+	ulint			n_iterations;
+					/*!< adaptive flushing requests
+					since avg_page_rate was last updated */
+	ulint			sum_pages;
+					/*!< pages flushed from the
+					flush_list since avg_page_rate
+					was last updated */
+	ulint			avg_page_rate;
+					/*!< average number of pages
+					flushed from the flush_list of
+					the instance per second */
+	ulint			n_single_flushes_seen;
+					/*!< number of single page flushes
+					in the instance when it was last
+					checked for free list starvation */
+	/* This value is used only by the coordinator thread */
+	ulint			n_single_flushes_mon;
+					/*!< number of single page flushes
+					in the instance when the monitor
+					counters were last updated */
 };
 
 /** Page cleaner structure common for all threads */
@@ -163,10 +228,6 @@ struct page_cleaner_t {
 						slots were finished. */
 	volatile ulint		n_workers;	/*!< number of worker threads
 						in existence */
-	bool			requested;	/*!< true if requested pages
-						to flush */
-	lsn_t			lsn_limit;	/*!< upper limit of LSN to be
-						flushed */
 	ulint			n_slots;	/*!< total number of slots */
 	ulint			n_slots_requested;
 						/*!< number of slots
@@ -431,14 +492,15 @@ buf_flush_insert_into_flush_list(
 	lsn_t		lsn)		/*!< in: oldest modification */
 {
 	ut_ad(!buf_pool_mutex_own(buf_pool));
-	ut_ad(log_flush_order_mutex_own());
+	ut_ad(srv_flush_list_relaxed_order || log_flush_order_mutex_own());
 	ut_ad(buf_page_mutex_own(block));
 
 	buf_flush_list_mutex_enter(buf_pool);
 
 	ut_ad((UT_LIST_GET_FIRST(buf_pool->flush_list) == NULL)
 	      || (UT_LIST_GET_FIRST(buf_pool->flush_list)->oldest_modification
-		  <= lsn));
+		  <= lsn + (srv_flush_list_relaxed_order
+			    ? LOG_FLUSH_ORDER_LAG : 0)));
 
 	/* If we are in the recovery then we need to update the flush
 	red-black tree as well. */
@@ -492,7 +554,7 @@ buf_flush_insert_sorted_into_flush_list(
 	buf_page_t*	b;
 
 	ut_ad(!buf_pool_mutex_own(buf_pool));
-	ut_ad(log_flush_order_mutex_own());
+	ut_ad(srv_flush_list_relaxed_order || log_flush_order_mutex_own());
 	ut_ad(buf_page_mutex_own(block));
 	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
 
@@ -846,14 +908,19 @@ buf_flush_update_zip_checksum(
 @param[in,out]	page		page frame
 @param[in,out]	page_zip_	compressed page, or NULL if uncompressed
 @param[in]	newest_lsn	newest modification LSN to the page
-@param[in]	skip_checksum	whether to disable the page checksum */
-void
+@param[in]	skip_checksum	whether to disable the page checksum
+@param[in]	defer_crc32	whether the caller computes a CRC32
+checksum later, together with the checksums of other pages
+@return true if the CRC32 checksum was not written because of
+defer_crc32 */
+bool
 buf_flush_init_for_writing(
 	const buf_block_t*	block,
 	byte*			page,
 	void*			page_zip_,
 	lsn_t			newest_lsn,
-	bool			skip_checksum)
+	bool			skip_checksum,
+	bool			defer_crc32)
 {
 	ib_uint32_t	checksum = BUF_NO_CHECKSUM_MAGIC;
 
@@ -890,7 +957,7 @@ buf_flush_init_for_writing(
 			buf_flush_update_zip_checksum(
 				page_zip->data, size, newest_lsn);
 
-			return;
+			return(false);
 		}
 
 		ib::error() << "The compressed page to be written"
@@ -966,6 +1033,12 @@ buf_flush_init_for_writing(
 		switch ((srv_checksum_algorithm_t) srv_checksum_algorithm) {
 		case SRV_CHECKSUM_ALGORITHM_CRC32:
 		case SRV_CHECKSUM_ALGORITHM_STRICT_CRC32:
+			if (defer_crc32) {
+				/* buf_dblwr_flush_buffered_writes()
+				will write the checksum to both fields. */
+				return(true);
+			}
+
 			checksum = buf_calc_page_crc32(page);
 			mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM,
 					checksum);
@@ -1004,6 +1077,8 @@ buf_flush_init_for_writing(
 
 	mach_write_to_4(page + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN_OLD_CHKSUM,
 			checksum);
+
+	return(false);
 }
 
 #ifndef UNIV_HOTBACKUP
@@ -1055,6 +1130,18 @@ buf_flush_write_block_low(
 		log_write_up_to(bpage->newest_modification, true);
 	}
 
+	/* Disable use of double-write buffer for temporary tablespace.
+	Given the nature and load of temporary tablespace doublewrite buffer
+	adds an overhead during flushing. */
+	const bool	use_dblwr = srv_use_doublewrite_buf
+		&& buf_dblwr != NULL
+		&& !srv_read_only_mode
+		&& !fsp_is_system_temporary(bpage->id.space());
+
+	/* Pages that are posted to a doublewrite batch are checksummed
+	together when the batch is written. */
+	bool	crc32_pending = false;
+
 	switch (buf_page_get_state(bpage)) {
 	case BUF_BLOCK_POOL_WATCH:
 	case BUF_BLOCK_ZIP_PAGE: /* The page should be dirty. */
@@ -1078,23 +1165,17 @@ buf_flush_write_block_low(
 			frame = ((buf_block_t*) bpage)->frame;
 		}
 
-		buf_flush_init_for_writing(
+		crc32_pending = buf_flush_init_for_writing(
 			reinterpret_cast<const buf_block_t*>(bpage),
 			reinterpret_cast<const buf_block_t*>(bpage)->frame,
 			bpage->zip.data ? &bpage->zip : NULL,
 			bpage->newest_modification,
-			fsp_is_checksum_disabled(bpage->id.space()));
+			fsp_is_checksum_disabled(bpage->id.space()),
+			use_dblwr && flush_type != BUF_FLUSH_SINGLE_PAGE);
 		break;
 	}
 
-	/* Disable use of double-write buffer for temporary tablespace.
-	Given the nature and load of temporary tablespace doublewrite buffer
-	adds an overhead during flushing. */
-
-	if (!srv_use_doublewrite_buf
-	    || buf_dblwr == NULL
-	    || srv_read_only_mode
-	    || fsp_is_system_temporary(bpage->id.space())) {
+	if (!use_dblwr) {
 
 		ut_ad(!srv_read_only_mode
 		      || fsp_is_system_temporary(bpage->id.space()));
@@ -1111,7 +1192,7 @@ buf_flush_write_block_low(
 		buf_dblwr_write_single_page(bpage, sync);
 	} else {
 		ut_ad(!sync);
-		buf_dblwr_add_to_batch(bpage);
+		buf_dblwr_add_to_batch(bpage, crc32_pending);
 	}
 
 	/* When doing single page flushing the IO is done synchronously
@@ -1216,7 +1297,7 @@ buf_flush_page(
 				/* avoiding deadlock possibility involves
 				doublewrite buffer, should flush it, because
 				it might hold the another block->lock. */
-				buf_dblwr_flush_buffered_writes();
+				buf_dblwr_flush_buffered_writes(buf_pool);
 			} else {
 				buf_dblwr_sync_datafiles();
 			}
@@ -1761,6 +1842,15 @@ buf_do_flush_list_batch(
 	ulint		count = 0;
 	ulint		scanned = 0;
 
+	/* In the relaxed flush list order, pages older than lsn_limit
+	can follow newer ones, but not after a page that is
+	LOG_FLUSH_ORDER_LAG newer than lsn_limit. */
+	const lsn_t	scan_limit = !srv_flush_list_relaxed_order
+		? lsn_limit
+		: lsn_limit > LSN_MAX - LOG_FLUSH_ORDER_LAG
+		? LSN_MAX
+		: lsn_limit + LOG_FLUSH_ORDER_LAG;
+
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
 	/* Start from the end of the list looking for a suitable
@@ -1775,7 +1865,7 @@ buf_do_flush_list_batch(
 	the same block then it must reset it. */
 	for (buf_page_t* bpage = UT_LIST_GET_LAST(buf_pool->flush_list);
 	     count < min_n && bpage != NULL && len > 0
-	     && bpage->oldest_modification < lsn_limit;
+	     && bpage->oldest_modification < scan_limit;
 	     bpage = buf_pool->flush_hp.get(),
 	     ++scanned) {
 
@@ -1786,6 +1876,12 @@ buf_do_flush_list_batch(
 
 		prev = UT_LIST_GET_PREV(list, bpage);
 		buf_pool->flush_hp.set(prev);
+
+		if (bpage->oldest_modification >= lsn_limit) {
+			--len;
+			continue;
+		}
+
 		buf_flush_list_mutex_exit(buf_pool);
 
 #ifdef UNIV_DEBUG
@@ -1963,7 +2059,7 @@ buf_flush_end(
 	buf_pool_mutex_exit(buf_pool);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -2074,7 +2170,8 @@ buf_flush_wait_flushed(
 
 			if (bpage != NULL) {
 				ut_ad(bpage->in_flush_list);
-				oldest = bpage->oldest_modification;
+				oldest = buf_flush_list_oldest_lsn(
+					buf_pool, bpage);
 			} else {
 				oldest = 0;
 			}
@@ -2093,6 +2190,49 @@ buf_flush_wait_flushed(
 	}
 }
 
+/** Get the smallest oldest_modification of the pages from a given page
+of a flush list towards the head, not counting the pages of the system
+temporary tablespace. When innodb_flush_list_relaxed_order is set, a flush
+list is ordered only up to LOG_FLUSH_ORDER_LAG, and the pages preceding
+bpage are scanned until the order guarantees that no older page follows.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	bpage		page in the flush list that does not belong
+to the system temporary tablespace, normally the last such page
+@return smallest oldest_modification */
+lsn_t
+buf_flush_list_oldest_lsn(
+	const buf_pool_t*	buf_pool,
+	const buf_page_t*	bpage)
+{
+	ut_ad(buf_flush_list_mutex_own(buf_pool));
+	ut_ad(bpage->in_flush_list);
+	ut_ad(!fsp_is_system_temporary(bpage->id.space()));
+
+	lsn_t	oldest = bpage->oldest_modification;
+
+	if (!srv_flush_list_relaxed_order) {
+		return(oldest);
+	}
+
+	/* Any page that was added after a page P has a bigger
+	oldest_modification than P minus LOG_FLUSH_ORDER_LAG. Once a
+	page at least LOG_FLUSH_ORDER_LAG newer than the oldest one
+	seen so far is found, the remaining pages cannot be older. */
+	for (bpage = UT_LIST_GET_PREV(list, bpage);
+	     bpage != NULL
+	     && bpage->oldest_modification < oldest + LOG_FLUSH_ORDER_LAG;
+	     bpage = UT_LIST_GET_PREV(list, bpage)) {
+
+		if (bpage->oldest_modification < oldest
+		    && !fsp_is_system_temporary(bpage->id.space())) {
+
+			oldest = bpage->oldest_modification;
+		}
+	}
+
+	return(oldest);
+}
+
 /** This utility flushes dirty blocks from the end of the flush list of all
 buffer pool instances.
 NOTE: The calling thread is not allowed to own any latches on pages!
@@ -2187,8 +2327,12 @@ buf_flush_single_page_from_LRU(
 	buf_page_t*	bpage;
 	ibool		freed;
 
+	MONITOR_INC(MONITOR_PC_SINGLE_PAGE_FLUSHES);
+
 	buf_pool_mutex_enter(buf_pool);
 
+	buf_pool->stat.n_single_page_flushes++;
+
 	for (bpage = buf_pool->single_scan_itr.start(), scanned = 0,
 	     freed = false;
 	     bpage != NULL;
@@ -2744,6 +2888,11 @@ buf_flush_page_cleaner_init(void)
 		ut_zalloc_nokey(page_cleaner->n_slots
 				* sizeof(*page_cleaner->slots)));
 
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner->slots[i].is_requested
+			= os_event_create("pc_slot_is_requested");
+	}
+
 	ut_d(page_cleaner->n_disabled_debug = 0);
 
 	page_cleaner->is_running = true;
@@ -2762,6 +2911,10 @@ buf_flush_page_cleaner_close(void)
 
 	mutex_destroy(&page_cleaner->mutex);
 
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		os_event_destroy(page_cleaner->slots[i].is_requested);
+	}
+
 	ut_free(page_cleaner->slots);
 
 	os_event_destroy(page_cleaner->is_finished);
@@ -2801,9 +2954,6 @@ pc_request(
 	ut_ad(page_cleaner->n_slots_flushing == 0);
 	ut_ad(page_cleaner->n_slots_finished == 0);
 
-	page_cleaner->requested = (min_n > 0);
-	page_cleaner->lsn_limit = lsn_limit;
-
 	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
 		page_cleaner_slot_t* slot = &page_cleaner->slots[i];
 
@@ -2818,7 +2968,12 @@ pc_request(
 		/* slot->n_pages_requested was already set by
 		page_cleaner_flush_pages_recommendation() */
 
+		slot->requested = (min_n > 0);
+		slot->lsn_limit = lsn_limit;
+		slot->request = PAGE_CLEANER_REQUEST_ALL;
 		slot->state = PAGE_CLEANER_STATE_REQUESTED;
+
+		os_event_set(slot->is_requested);
 	}
 
 	page_cleaner->n_slots_requested = page_cleaner->n_slots;
@@ -2832,21 +2987,39 @@ pc_request(
 
 /**
 Do flush for one slot.
+@param[in]	own	with innodb_page_cleaner_per_instance, the buffer pool
+instance of the calling worker thread, which treats only the slot of that
+instance; ULINT_UNDEFINED to treat any requested slot
 @return	the number of the slots which has not been treated yet. */
 static
 ulint
-pc_flush_slot(void)
+pc_flush_slot(
+	ulint	own = ULINT_UNDEFINED)
 {
 	ib_time_monotonic_ms_t	lru_tm = 0;
 	ib_time_monotonic_ms_t	list_tm = 0;
 	int	lru_pass = 0;
 	int	list_pass = 0;
+	page_cleaner_slot_t*	slot = NULL;
+	ulint			i;
 
 	mutex_enter(&page_cleaner->mutex);
 
-	if (page_cleaner->n_slots_requested > 0) {
-		page_cleaner_slot_t*	slot = NULL;
-		ulint			i;
+	if (own != ULINT_UNDEFINED) {
+		i = own;
+		slot = &page_cleaner->slots[i];
+
+		if (slot->state != PAGE_CLEANER_STATE_REQUESTED) {
+			/* Woken up for nothing, or the slot was
+			treated by the coordinator. Do not miss the
+			wake up by pc_wake_workers() at shutdown. */
+			if (page_cleaner->is_running) {
+				os_event_reset(slot->is_requested);
+			}
+			slot = NULL;
+		}
+
+	} else if (page_cleaner->n_slots_requested > 0) {
 
 		for (i = 0; i < page_cleaner->n_slots; i++) {
 			slot = &page_cleaner->slots[i];
@@ -2859,13 +3032,17 @@ pc_flush_slot(void)
 		/* slot should be found because
 		page_cleaner->n_slots_requested > 0 */
 		ut_a(i < page_cleaner->n_slots);
+	}
 
+	if (slot != NULL) {
 		buf_pool_t* buf_pool = buf_pool_from_array(i);
 
 		page_cleaner->n_slots_requested--;
 		page_cleaner->n_slots_flushing++;
 		slot->state = PAGE_CLEANER_STATE_FLUSHING;
 
+		os_event_reset(slot->is_requested);
+
 		if (page_cleaner->n_slots_requested == 0) {
 			os_event_reset(page_cleaner->is_requested);
 		}
@@ -2892,14 +3069,14 @@ pc_flush_slot(void)
 		}
 
 		/* Flush pages from flush_list if required */
-		if (page_cleaner->requested) {
+		if (slot->requested) {
 
 			list_tm = ut_time_monotonic_ms();
 
 			slot->succeeded_list = buf_flush_do_batch(
 				buf_pool, BUF_FLUSH_LIST,
 				slot->n_pages_requested,
-				page_cleaner->lsn_limit,
+				slot->lsn_limit,
 				&slot->n_flushed_list);
 
 			list_tm = ut_time_monotonic_ms() - list_tm;
@@ -2920,8 +3097,13 @@ finish_mutex:
 		slot->flush_lru_pass += lru_pass;
 		slot->flush_list_pass += list_pass;
 
-		if (page_cleaner->n_slots_requested == 0
-		    && page_cleaner->n_slots_flushing == 0) {
+		if (slot->request != PAGE_CLEANER_REQUEST_ALL) {
+			/* Let the coordinator schedule the instance
+			again. */
+			os_event_set(buf_flush_event);
+
+		} else if (page_cleaner->n_slots_requested == 0
+			   && page_cleaner->n_slots_flushing == 0) {
 			os_event_set(page_cleaner->is_finished);
 		}
 	}
@@ -2981,6 +3163,25 @@ pc_wait_finished(
 	return(all_succeeded);
 }
 
+/**
+Wake up all page_cleaner worker threads, whichever event they wait for.
+The events of the slots are set under page_cleaner->mutex, so that
+pc_flush_slot() cannot reset them afterwards. */
+static
+void
+pc_wake_workers(void)
+{
+	os_event_set(page_cleaner->is_requested);
+
+	mutex_enter(&page_cleaner->mutex);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		os_event_set(page_cleaner->slots[i].is_requested);
+	}
+
+	mutex_exit(&page_cleaner->mutex);
+}
+
 #ifdef UNIV_LINUX
 /**
 Set priority for page_cleaner threads.
@@ -3093,15 +3294,16 @@ buf_flush_page_cleaner_disabled_debug_update(
 
 		That's why we have sleep-loop instead of simply
 		waiting on some disabled_debug_event. */
-		os_event_set(page_cleaner->is_requested);
+		pc_wake_workers();
 
 		mutex_enter(&page_cleaner->mutex);
 
-		ut_ad(page_cleaner->n_disabled_debug
-		      <= srv_n_page_cleaners);
+		/* The workers and the coordinator */
+		const ulint	n_threads = page_cleaner->n_workers + 1;
+
+		ut_ad(page_cleaner->n_disabled_debug <= n_threads);
 
-		if (page_cleaner->n_disabled_debug
-		    == srv_n_page_cleaners) {
+		if (page_cleaner->n_disabled_debug == n_threads) {
 
 			mutex_exit(&page_cleaner->mutex);
 			break;
@@ -3114,6 +3316,506 @@ buf_flush_page_cleaner_disabled_debug_update(
 }
 #endif /* UNIV_DEBUG */
 
+/** Get the flush lag of a buffer pool instance.
+@param[in,out]	buf_pool	buffer pool instance
+@param[in]	cur_lsn		current LSN
+@param[out]	oldest_lsn	oldest modification in the instance,
+				or cur_lsn if none
+@return current LSN minus the oldest modification in the instance */
+static
+lsn_t
+pc_instance_lag(
+	buf_pool_t*	buf_pool,
+	lsn_t		cur_lsn,
+	lsn_t*		oldest_lsn)
+{
+	buf_flush_list_mutex_enter(buf_pool);
+	*oldest_lsn = buf_pool_get_oldest_modification_low(buf_pool);
+	buf_flush_list_mutex_exit(buf_pool);
+
+	if (*oldest_lsn == 0 || *oldest_lsn > cur_lsn) {
+		*oldest_lsn = cur_lsn;
+	}
+
+	return(cur_lsn - *oldest_lsn);
+}
+
+/** Update the page_cleaner monitor counters of the flush lag and of the
+free list starvation of the buffer pool instances. This is called by the
+coordinator thread approximately once a second. */
+static
+void
+pc_instance_monitor(void)
+{
+	const lsn_t	cur_lsn = log_get_lsn();
+	lsn_t		lag_max = 0;
+	lsn_t		lag_sum = 0;
+	ulint		lagging = 0;
+	ulint		n_single_max = 0;
+	lint		starved = -1;
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+		buf_pool_t*		buf_pool = buf_pool_from_array(i);
+		lsn_t			oldest_lsn;
+		const lsn_t		lag = pc_instance_lag(
+			buf_pool, cur_lsn, &oldest_lsn);
+
+		lag_sum += lag;
+
+		if (lag > lag_max) {
+			lag_max = lag;
+			lagging = i;
+		}
+
+		/* A dirty read is good enough for the monitor. */
+		const ulint	n_single = buf_pool->stat.n_single_page_flushes;
+
+		if (n_single - slot->n_single_flushes_mon > n_single_max) {
+			n_single_max = n_single - slot->n_single_flushes_mon;
+			starved = static_cast<lint>(i);
+		}
+
+		slot->n_single_flushes_mon = n_single;
+	}
+
+	MONITOR_SET(MONITOR_PC_INSTANCE_LAG_MAX, lag_max);
+	MONITOR_SET(MONITOR_PC_INSTANCE_LAG_AVG,
+		    lag_sum / page_cleaner->n_slots);
+	MONITOR_SET(MONITOR_PC_LAGGING_INSTANCE, lagging);
+	MONITOR_SET(MONITOR_PC_STARVED_INSTANCE, starved);
+}
+
+/** Calculate the number of pages to flush from the flush_list of one buffer
+pool instance in its next adaptive flushing, with
+innodb_page_cleaner_per_instance. This is what
+page_cleaner_flush_pages_recommendation() does for all instances together,
+except that the percent of io_capacity for the redo log space is derived
+from the age of the oldest modification in this instance only, so that an
+instance that lags behind flushes more, without holding back the others.
+@param[in]	i		buffer pool instance
+@param[in]	cur_lsn		current LSN
+@param[in]	pct_for_dirty	af_get_pct_for_dirty()
+@return number of pages recommended to be flushed */
+static
+ulint
+page_cleaner_instance_recommendation(
+	ulint	i,
+	lsn_t	cur_lsn,
+	ulint	pct_for_dirty)
+{
+	page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+	buf_pool_t*		buf_pool = buf_pool_from_array(i);
+	const ulint		n_instances = page_cleaner->n_slots;
+	const ib_time_monotonic_t	curr_time = ut_time_monotonic();
+	uint64_t		time_elapsed = curr_time - slot->prev_time;
+	const ulong		avg_loop = srv_flushing_avg_loops;
+
+	/* We update the page rate of the instance every
+	srv_flushing_avg_loops iterations to smooth out transition
+	in workload. */
+	if (++slot->n_iterations >= avg_loop
+	    || time_elapsed >= (uint64_t) avg_loop) {
+
+		if (time_elapsed < 1) {
+			time_elapsed = 1;
+		}
+
+		slot->avg_page_rate = static_cast<ulint>(
+			((static_cast<double>(slot->sum_pages)
+			  / time_elapsed)
+			 + slot->avg_page_rate) / 2);
+
+		slot->prev_time = curr_time;
+		slot->n_iterations = 0;
+		slot->sum_pages = 0;
+	}
+
+	/* Limit the scan of the instance based on its share of the
+	overall capacity. */
+	const ulint	pages_for_lsn_max =
+		(srv_max_io_capacity * 2 / n_instances)
+		* buf_flush_lsn_scan_factor * 2;
+	ulint		pages_for_lsn = 0;
+	lsn_t		oldest_lsn;
+	const lsn_t	age = pc_instance_lag(buf_pool, cur_lsn, &oldest_lsn);
+	const lsn_t	target_lsn = oldest_lsn
+				     + lsn_avg_rate * buf_flush_lsn_scan_factor;
+
+	/* Estimate pages to be flushed for the lsn progress */
+	buf_flush_list_mutex_enter(buf_pool);
+	for (buf_page_t* b = UT_LIST_GET_LAST(buf_pool->flush_list);
+	     b != NULL && pages_for_lsn < pages_for_lsn_max;
+	     b = UT_LIST_GET_PREV(list, b)) {
+		if (b->oldest_modification > target_lsn) {
+			break;
+		}
+		++pages_for_lsn;
+	}
+	buf_flush_list_mutex_exit(buf_pool);
+
+	pages_for_lsn /= buf_flush_lsn_scan_factor;
+
+	const ulint	pct_for_lsn = af_get_pct_for_lsn(age);
+	const ulint	pct_total = ut_max(pct_for_dirty, pct_for_lsn);
+
+	ulint	n_pages = (PCT_IO(pct_total) / n_instances
+			   + slot->avg_page_rate + pages_for_lsn) / 3 + 1;
+
+	/* Cap the instance at its share of max_io_capacity. If REDO is
+	short of free space, let an old instance catch up faster. */
+	ulint	n_pages_max = srv_max_io_capacity / n_instances + 1;
+
+	if (pct_for_lsn > 30) {
+		n_pages_max *= 2;
+	}
+
+	return(ut_min(n_pages, n_pages_max));
+}
+
+/** Check whether user threads are short of free blocks in a buffer pool
+instance, with innodb_page_cleaner_per_instance.
+@param[in,out]	slot		page_cleaner slot of the instance
+@param[in]	buf_pool	buffer pool instance
+@return true if the tail of the LRU list should be flushed before the
+next adaptive flushing of the instance */
+static
+bool
+pc_instance_is_starving(
+	page_cleaner_slot_t*	slot,
+	const buf_pool_t*	buf_pool)
+{
+	/* Dirty reads are good enough for this heuristic. */
+	const ulint	n_single = buf_pool->stat.n_single_page_flushes;
+	const bool	single_flushed = n_single != slot->n_single_flushes_seen;
+
+	slot->n_single_flushes_seen = n_single;
+
+	/* Keep flushing the LRU list while it makes progress or while
+	user threads have to flush single pages themselves. */
+	return(UT_LIST_GET_LEN(buf_pool->free) < srv_LRU_scan_depth
+	       && (single_flushed || slot->n_flushed_lru > 0));
+}
+
+/** Request a slot to flush its buffer pool instance, with
+innodb_page_cleaner_per_instance.
+@param[in]	i		buffer pool instance
+@param[in]	request		kind of the request
+@param[in]	min_n		wished minimum mumber of blocks flushed from
+the flush_list, or 0 to flush the LRU list only
+@param[in]	lsn_limit	all blocks whose oldest_modification is
+smaller than this should be flushed (if their number does not exceed
+min_n) */
+static
+void
+pc_instance_request(
+	ulint			i,
+	page_cleaner_request_t	request,
+	ulint			min_n,
+	lsn_t			lsn_limit)
+{
+	page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+
+	ut_ad(request != PAGE_CLEANER_REQUEST_ALL);
+
+	mutex_enter(&page_cleaner->mutex);
+
+	ut_ad(slot->state == PAGE_CLEANER_STATE_NONE);
+
+	slot->n_pages_requested = min_n;
+	slot->requested = (min_n > 0);
+	slot->lsn_limit = lsn_limit;
+	slot->request = request;
+	slot->state = PAGE_CLEANER_STATE_REQUESTED;
+
+	page_cleaner->n_slots_requested++;
+
+	os_event_set(slot->is_requested);
+
+	mutex_exit(&page_cleaner->mutex);
+
+	MONITOR_INC(MONITOR_PC_INSTANCE_REQUESTS);
+}
+
+/** Collect the results of the finished requests of the slots, with
+innodb_page_cleaner_per_instance, and make the slots available for new
+requests.
+@return number of slots that are requested or flushing */
+static
+ulint
+pc_instance_finished(void)
+{
+	ulint	n_flushed_lru = 0;
+	ulint	n_flushed_adaptive = 0;
+	ulint	n_flushed_background = 0;
+	ulint	n_flushed_sync = 0;
+
+	mutex_enter(&page_cleaner->mutex);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+
+		if (slot->state != PAGE_CLEANER_STATE_FINISHED) {
+			continue;
+		}
+
+		ut_ad(slot->request != PAGE_CLEANER_REQUEST_ALL);
+
+		n_flushed_lru += slot->n_flushed_lru;
+
+		switch (slot->request) {
+		case PAGE_CLEANER_REQUEST_ADAPTIVE:
+			n_flushed_adaptive += slot->n_flushed_list;
+			break;
+		case PAGE_CLEANER_REQUEST_BACKGROUND:
+			n_flushed_background += slot->n_flushed_list;
+			break;
+		case PAGE_CLEANER_REQUEST_SYNC:
+			n_flushed_sync += slot->n_flushed_list;
+			break;
+		default:
+			ut_ad(slot->n_flushed_list == 0);
+		}
+
+		slot->sum_pages += slot->n_flushed_list;
+
+		slot->state = PAGE_CLEANER_STATE_NONE;
+		slot->n_pages_requested = 0;
+
+		page_cleaner->n_slots_finished--;
+	}
+
+	const ulint	n_busy = page_cleaner->n_slots_requested
+		+ page_cleaner->n_slots_flushing;
+
+	mutex_exit(&page_cleaner->mutex);
+
+	const ulint	n_flushed_list = n_flushed_adaptive
+		+ n_flushed_background + n_flushed_sync;
+
+	if (n_flushed_list > 0 || n_flushed_lru > 0) {
+		buf_flush_stats(n_flushed_list, n_flushed_lru);
+	}
+
+	if (n_flushed_lru) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
+			MONITOR_LRU_BATCH_FLUSH_COUNT,
+			MONITOR_LRU_BATCH_FLUSH_PAGES,
+			n_flushed_lru);
+	}
+
+	if (n_flushed_adaptive) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_FLUSH_ADAPTIVE_TOTAL_PAGE,
+			MONITOR_FLUSH_ADAPTIVE_COUNT,
+			MONITOR_FLUSH_ADAPTIVE_PAGES,
+			n_flushed_adaptive);
+	}
+
+	if (n_flushed_background) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_FLUSH_BACKGROUND_TOTAL_PAGE,
+			MONITOR_FLUSH_BACKGROUND_COUNT,
+			MONITOR_FLUSH_BACKGROUND_PAGES,
+			n_flushed_background);
+	}
+
+	if (n_flushed_sync) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_FLUSH_SYNC_TOTAL_PAGE,
+			MONITOR_FLUSH_SYNC_COUNT,
+			MONITOR_FLUSH_SYNC_PAGES,
+			n_flushed_sync);
+	}
+
+	return(n_busy);
+}
+
+/** Schedule the buffer pool instances whose slots are not busy, with
+innodb_page_cleaner_per_instance. An instance is requested to flush up to
+the LSN of a synchronous preflush while it has older pages, to flush its
+adaptive target once a second, and to flush the tail of its LRU list in
+between while user threads are short of free blocks in it.
+@param[in]	active		true if the server has been active in the
+last second
+@param[in,out]	sync_lsn	LSN of the synchronous preflush, or 0;
+reset to 0 when all instances have been flushed up to it
+@return time when the next adaptive flushing of an idle instance is due */
+static
+ib_time_monotonic_ms_t
+pc_instance_schedule(
+	bool	active,
+	lsn_t*	sync_lsn)
+{
+	const ib_time_monotonic_ms_t	now = ut_time_monotonic_ms();
+	ib_time_monotonic_ms_t		next_time = now + 1000;
+	const lsn_t			cur_lsn = log_get_lsn();
+	ulint				pct_for_dirty = ULINT_UNDEFINED;
+	bool				sync_pending = false;
+
+	pc_instance_finished();
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+		buf_pool_t*		buf_pool = buf_pool_from_array(i);
+		bool			sync = false;
+
+		if (*sync_lsn > 0) {
+			lsn_t	oldest_lsn;
+
+			pc_instance_lag(buf_pool, cur_lsn, &oldest_lsn);
+
+			sync = oldest_lsn < *sync_lsn;
+			sync_pending |= sync;
+		}
+
+		/* Only the coordinator moves a slot out of
+		PAGE_CLEANER_STATE_NONE. */
+		mutex_enter(&page_cleaner->mutex);
+		const bool	idle = slot->state == PAGE_CLEANER_STATE_NONE;
+		mutex_exit(&page_cleaner->mutex);
+
+		if (!idle) {
+			/* The worker will wake us up when it finishes. */
+			continue;
+		}
+
+		if (sync) {
+			pc_instance_request(
+				i, PAGE_CLEANER_REQUEST_SYNC,
+				ULINT_MAX, *sync_lsn);
+
+		} else if (now >= slot->next_loop_time) {
+
+			if (!active) {
+				pc_instance_request(
+					i, PAGE_CLEANER_REQUEST_BACKGROUND,
+					PCT_IO(100) / page_cleaner->n_slots
+					+ 1, LSN_MAX);
+			} else {
+				if (pct_for_dirty == ULINT_UNDEFINED) {
+					pct_for_dirty = af_get_pct_for_dirty();
+				}
+
+				pc_instance_request(
+					i, PAGE_CLEANER_REQUEST_ADAPTIVE,
+					page_cleaner_instance_recommendation(
+						i, cur_lsn, pct_for_dirty),
+					LSN_MAX);
+			}
+
+			slot->next_loop_time = now + 1000;
+
+		} else if (pc_instance_is_starving(slot, buf_pool)) {
+			pc_instance_request(
+				i, PAGE_CLEANER_REQUEST_LRU, 0, LSN_MAX);
+
+		} else {
+			next_time = ut_min(next_time, slot->next_loop_time);
+		}
+	}
+
+	if (!sync_pending) {
+		*sync_lsn = 0;
+	}
+
+	return(next_time);
+}
+
+/** Main loop of the page_cleaner coordinator with
+innodb_page_cleaner_per_instance. Instead of requesting all buffer pool
+instances to flush together and waiting for the slowest one in
+pc_wait_finished(), the coordinator schedules each instance on its own,
+whenever the worker thread of the instance is idle. Returns at shutdown,
+when no slot is requested or flushing any more. */
+static
+void
+pc_instance_loop(void)
+{
+	ulint			last_activity = srv_get_activity_count();
+	bool			active = true;
+	lsn_t			sync_lsn = 0;
+	lsn_t			prev_lsn = log_get_lsn();
+	ib_time_monotonic_t	prev_time = ut_time_monotonic();
+	ulint			n_iterations = 0;
+	ib_time_monotonic_ms_t	next_loop_time = ut_time_monotonic_ms() + 1000;
+	int64_t			sig_count = os_event_reset(buf_flush_event);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		ib_time_monotonic_ms_t	cur_time = ut_time_monotonic_ms();
+
+		if (cur_time >= next_loop_time) {
+			/* Once a second, check the server activity and
+			update the LSN rate that all instances share. */
+			active = srv_check_activity(last_activity);
+			last_activity = srv_get_activity_count();
+
+			const lsn_t		cur_lsn = log_get_lsn();
+			const ib_time_monotonic_t	curr_time
+				= ut_time_monotonic();
+			uint64_t		time_elapsed
+				= curr_time - prev_time;
+			const ulong		avg_loop
+				= srv_flushing_avg_loops;
+
+			if (++n_iterations >= avg_loop
+			    || time_elapsed >= (uint64_t) avg_loop) {
+
+				if (time_elapsed < 1) {
+					time_elapsed = 1;
+				}
+
+				lsn_avg_rate = (lsn_avg_rate
+						+ (cur_lsn - prev_lsn)
+						/ time_elapsed) / 2;
+
+				MONITOR_SET(MONITOR_FLUSH_LSN_AVG_RATE,
+					    lsn_avg_rate);
+
+				prev_lsn = cur_lsn;
+				prev_time = curr_time;
+				n_iterations = 0;
+			}
+
+			pc_instance_monitor();
+
+			next_loop_time = cur_time + 1000;
+		}
+
+		if (srv_flush_sync) {
+			mutex_enter(&page_cleaner->mutex);
+			if (buf_flush_sync_lsn > sync_lsn) {
+				sync_lsn = buf_flush_sync_lsn;
+			}
+			buf_flush_sync_lsn = 0;
+			mutex_exit(&page_cleaner->mutex);
+		}
+
+		ib_time_monotonic_ms_t	next_time = ut_min(
+			pc_instance_schedule(active, &sync_lsn),
+			next_loop_time);
+
+		cur_time = ut_time_monotonic_ms();
+
+		if (next_time > cur_time) {
+			os_event_wait_time_low(
+				buf_flush_event,
+				(next_time - cur_time) * 1000, sig_count);
+		}
+
+		sig_count = os_event_reset(buf_flush_event);
+
+		ut_d(buf_flush_page_cleaner_disabled_loop());
+	}
+
+	/* Let the pending requests finish, so that the shutdown can
+	request all slots together again. */
+	while (pc_instance_finished() > 0) {
+		os_thread_sleep(10000);
+	}
+}
+
 /******************************************************************//**
 page_cleaner thread tasked with flushing dirty pages from the buffer
 pools. As of now we'll have only one coordinator.
@@ -3207,6 +3909,10 @@ DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
 	ulint		warn_count = 0;
 	int64_t		sig_count = os_event_reset(buf_flush_event);
 
+	if (srv_page_cleaner_per_instance) {
+		pc_instance_loop();
+	}
+
 	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 
 		/* The page_cleaner skips sleep if the server is
@@ -3264,6 +3970,8 @@ DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
 
 			next_loop_time = curr_time + 1000;
 			n_flushed_last = n_evicted = 0;
+
+			pc_instance_monitor();
 		}
 
 		if (ret_sleep != OS_SYNC_TIME_EXCEEDED
@@ -3490,7 +4198,7 @@ thread_exit:
 	and no more access to page_cleaner structure by them.
 	Wakes worker threads up just to make them exit. */
 	page_cleaner->is_running = false;
-	os_event_set(page_cleaner->is_requested);
+	pc_wake_workers();
 
 	buf_flush_page_cleaner_close();
 
@@ -3519,9 +4227,30 @@ DECLARE_THREAD(buf_flush_page_cleaner_worker)(
 	my_thread_init();
 
 	mutex_enter(&page_cleaner->mutex);
+	/* With innodb_page_cleaner_per_instance, the workers are numbered
+	by the buffer pool instance that they flush. */
+	const ulint	own = srv_page_cleaner_per_instance
+		? page_cleaner->n_workers : ULINT_UNDEFINED;
 	page_cleaner->n_workers++;
 	mutex_exit(&page_cleaner->mutex);
 
+	ut_ad(own == ULINT_UNDEFINED || own < page_cleaner->n_slots);
+
+#ifdef HAVE_LIBNUMA
+	if (own != ULINT_UNDEFINED && buf_pool_numa_node(own) != -1) {
+		/* Run on the NUMA node of the page frames
+		of the instance. */
+		const int	node = buf_pool_numa_node(own);
+
+		if (numa_run_on_node(node) != 0) {
+			ib::warn() << "Failed to bind the page_cleaner worker"
+				" of buffer pool instance " << own
+				<< " to NUMA node " << node << ": "
+				<< strerror(errno);
+		}
+	}
+#endif /* HAVE_LIBNUMA */
+
 #ifdef UNIV_LINUX
 	/* linux might be able to set different setting for each thread
 	worth to try to set high priority for page cleaner threads */
@@ -3533,8 +4262,12 @@ DECLARE_THREAD(buf_flush_page_cleaner_worker)(
 	}
 #endif /* UNIV_LINUX */
 
+	os_event_t	is_requested = own == ULINT_UNDEFINED
+		? page_cleaner->is_requested
+		: page_cleaner->slots[own].is_requested;
+
 	while (true) {
-		os_event_wait(page_cleaner->is_requested);
+		os_event_wait(is_requested);
 
 		ut_d(buf_flush_page_cleaner_disabled_loop());
 
@@ -3542,7 +4275,7 @@ DECLARE_THREAD(buf_flush_page_cleaner_worker)(
 			break;
 		}
 
-		pc_flush_slot();
+		pc_flush_slot(own);
 	}
 
 	mutex_enter(&page_cleaner->mutex);
@@ -3656,7 +4389,10 @@ buf_flush_validate_low(
 
 		bpage = UT_LIST_GET_NEXT(list, bpage);
 
-		ut_a(bpage == NULL || om >= bpage->oldest_modification);
+		ut_a(bpage == NULL
+		     || om + (srv_flush_list_relaxed_order
+			      ? LOG_FLUSH_ORDER_LAG : 0)
+		     >= bpage->oldest_modification);
 	}
 
 	/* By this time we must have exhausted the traversal of
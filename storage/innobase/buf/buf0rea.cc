@@ -429,6 +429,76 @@ read_ahead:
 	return(count);
 }
 
+/** Applies read-ahead to the undo log pages that precede a page that a
+consistent read is about to access. The undo logs of older transactions
+are usually allocated before the newer ones, so that the pages that a walk
+along a chain of roll pointers visits next mostly precede the current one.
+NOTE: the calling thread may own latches on pages: to avoid deadlocks
+this function must be written such that it cannot end up waiting for
+these latches!
+@param[in]	page_id		undo log page that is about to be read
+@param[in]	page_size	page size
+@param[in]	n_pages		maximum number of pages to read ahead
+@return number of page read requests issued */
+ulint
+buf_read_ahead_undo(
+	const page_id_t&	page_id,
+	const page_size_t&	page_size,
+	ulint			n_pages)
+{
+	buf_pool_t*	buf_pool = buf_pool_get(page_id);
+	ulint		count = 0;
+	ulint		low;
+	dberr_t		err;
+
+	if (n_pages == 0 || srv_startup_is_before_trx_rollback_phase) {
+		/* Disabled by user, or no read-ahead to avoid thread
+		deadlocks */
+		return(0);
+	}
+
+	if (buf_pool->n_pend_reads
+	    > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+
+		return(0);
+	}
+
+	low = page_id.page_no() > n_pages ? page_id.page_no() - n_pages : 1;
+
+	for (ulint i = page_id.page_no(); i-- > low; ) {
+
+		const page_id_t	cur_page_id(page_id.space(), i);
+
+		/* The ibuf bitmap pages and the trx sys header are not
+		read asynchronously, and the doublewrite buffer is not
+		read at all, see buf_read_page_low() */
+		if (ibuf_bitmap_page(cur_page_id, page_size)
+		    || trx_sys_hdr_page(cur_page_id)
+		    || (cur_page_id.space() == TRX_SYS_SPACE
+			&& buf_dblwr_page_inside(i))
+		    || buf_page_peek(cur_page_id)) {
+
+			continue;
+		}
+
+		count += buf_read_page_low(
+			&err, false,
+			IORequest::DO_NOT_WAKE | IORequest::IGNORE_MISSING,
+			BUF_READ_ANY_PAGE,
+			cur_page_id, page_size, false);
+
+		if (err == DB_TABLESPACE_DELETED) {
+			break;
+		}
+	}
+
+	os_aio_simulated_wake_handler_threads();
+
+	buf_pool->stat.n_ra_pages_read += count;
+	srv_stats.buf_pool_reads.add(count);
+	return(count);
+}
+
 /** High-level function which reads a page asynchronously from a file to the
 buffer buf_pool if it is not already there. Sets the io_fix flag and sets
 an exclusive lock on the buffer frame. The flag is cleared and the x-lock
@@ -502,6 +572,116 @@ buf_read_page_background(
 	return(count > 0);
 }
 
+/** Reads a range of adjacent pages synchronously to the buffer pool with
+one read request. The pages that already reside in the buffer pool are
+read but discarded. The pages that were stored in the file with
+transparent page compression or encryption are read again one by one,
+because the I/O layer only transforms the first page of a request.
+The pages are x-latched until all of them have been read. Completing the
+read of an index page may merge buffered changes, which latches the change
+buffer and the change buffer bitmap page. So that another thread that holds
+the change buffer cannot wait for a page of the range, only the first page
+may be a change buffer bitmap page, and the change buffer itself in the
+system tablespace is never read with this function.
+@param[in]	page_id		id of the first page, not in the system
+tablespace
+@param[in]	n_pages		number of pages, which must be in the first
+data file of the tablespace; only the first one may be a change buffer
+bitmap page
+@param[in]	page_size	page size
+@param[in,out]	buf		buffer of n_pages * page_size.physical()
+bytes, aligned to UNIV_PAGE_SIZE
+@return number of pages that were read into the buffer pool */
+ulint
+buf_read_page_range(
+	const page_id_t&	page_id,
+	ulint			n_pages,
+	const page_size_t&	page_size,
+	byte*			buf)
+{
+	buf_page_t*	bpages[BUF_READ_PAGE_RANGE_MAX];
+	ulint		count = 0;
+	dberr_t		err;
+
+	ut_ad(page_id.space() != TRX_SYS_SPACE);
+	ut_ad(n_pages > 0);
+	ut_ad(n_pages <= BUF_READ_PAGE_RANGE_MAX);
+	ut_ad(buf == ut_align(buf, UNIV_PAGE_SIZE));
+
+	for (ulint i = 0; i < n_pages; i++) {
+		const page_id_t	cur_page_id(
+			page_id.space(), page_id.page_no() + i);
+
+		ut_ad(i == 0 || !ibuf_bitmap_page(cur_page_id, page_size));
+
+		bpages[i] = buf_page_init_for_read(
+			&err, BUF_READ_ANY_PAGE, cur_page_id, page_size,
+			false);
+
+		if (bpages[i] != NULL) {
+			count++;
+		} else if (err == DB_TABLESPACE_DELETED) {
+			n_pages = i;
+			break;
+		}
+	}
+
+	if (count == 0) {
+		return(0);
+	}
+
+	const ulint	size = page_size.physical();
+	IORequest	request(IORequest::READ | IORequest::IGNORE_MISSING);
+
+	/* The pages are transformed one by one below. */
+	request.disable_compression();
+
+	thd_wait_begin(NULL, THD_WAIT_DISKIO);
+
+	err = fil_io(request, true, page_id, page_size, 0, n_pages * size,
+		     buf, NULL);
+
+	for (ulint i = 0; i < n_pages; i++) {
+		buf_page_t*	bpage = bpages[i];
+
+		if (bpage == NULL) {
+			continue;
+		}
+
+		const byte*	src = buf + i * size;
+		byte*		dst = page_size.is_compressed()
+			? bpage->zip.data
+			: reinterpret_cast<buf_block_t*>(bpage)->frame;
+
+		if (err == DB_SUCCESS
+		    && !Compression::is_compressed_page(src)
+		    && !Encryption::is_encrypted_page(src)) {
+
+			memcpy(dst, src, size);
+
+		} else if (err != DB_SUCCESS
+			   || fil_io(IORequest(IORequest::READ
+					       | IORequest::IGNORE_MISSING),
+				     true, bpage->id, page_size, 0, size,
+				     dst, bpage) != DB_SUCCESS) {
+
+			buf_read_page_handle_error(bpage);
+			count--;
+			continue;
+		}
+
+		if (!buf_page_io_complete(bpage)) {
+			count--;
+		}
+	}
+
+	thd_wait_end(NULL);
+
+	srv_stats.buf_pool_reads.add(count);
+
+	return(count);
+}
+
 /** Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
 Does not read any page if the read-ahead mechanism is not activated. Note
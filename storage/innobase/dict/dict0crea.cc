@@ -1668,6 +1668,11 @@ dict_create_index_step(
 					index_cache->words = 0;
 				}
 
+				if (index_cache->frozen_words) {
+					rbt_free(index_cache->frozen_words);
+					index_cache->frozen_words = 0;
+				}
+
 				ib_vector_remove(
 					node->table->fts->cache->indexes,
 					*reinterpret_cast<void**>(index_cache));
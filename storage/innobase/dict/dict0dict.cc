@@ -2772,6 +2772,7 @@ dict_index_add_to_cache_w_vcol(
 
 	new_index->stat_index_size = 1;
 	new_index->stat_n_leaf_pages = 1;
+	new_index->stat_modified_counter = 0;
 
 	/* Add the new index as the last index for the table */
 
@@ -7005,6 +7006,11 @@ dict_tf_to_fsp_flags(
 						   is_temp,
 						   is_encrypted);
 
+	if (DICT_TF_GET_ZIP_CODEC(table_flags)) {
+		ut_ad(!is_shared && !is_temp);
+		fsp_flags |= FSP_FLAGS_MASK_ZIP_CODEC;
+	}
+
 	return(fsp_flags);
 }
 
@@ -1449,6 +1449,21 @@ dict_check_sys_tables(
 			continue;
 		}
 
+		bool	is_temp = flags2 & DICT_TF2_TEMPORARY;
+		bool	is_encrypted = flags2 & DICT_TF2_ENCRYPTION;
+		ulint	fsp_flags = dict_tf_to_fsp_flags(flags,
+							 is_temp,
+							 is_encrypted);
+
+		/* If the tablespace directory cache knows the file,
+		register it without looking for it. */
+		if (shared_space_name == NULL
+		    && fil_ibd_open_cached(space_id, fsp_flags, space_name)) {
+			max_space_id = ut_max(max_space_id, space_id);
+			ut_free(table_name.m_name);
+			continue;
+		}
+
 		/* Set the expected filepath from the data dictionary.
 		If the file is found elsewhere (from an ISL or the default
 		location) or this path is the same file but looks different,
@@ -1457,12 +1472,6 @@ dict_check_sys_tables(
 		char*	filepath = dict_get_first_path(space_id);
 
 		/* Check that the .ibd file exists. */
-		bool	is_temp = flags2 & DICT_TF2_TEMPORARY;
-		bool	is_encrypted = flags2 & DICT_TF2_ENCRYPTION;
-		ulint	fsp_flags = dict_tf_to_fsp_flags(flags,
-							 is_temp,
-							 is_encrypted);
-
 		dberr_t	err = fil_ibd_open(
 			validate,
 			!srv_read_only_mode && srv_log_file_size != 0,
@@ -135,6 +135,8 @@ dict_mem_table_create(
 
 	table->flags = (unsigned int) flags;
 	table->flags2 = (unsigned int) flags2;
+	table->zip_codec = static_cast<page_zip_codec_t>(
+		DICT_TF_GET_ZIP_CODEC(flags));
 	table->name.m_name = mem_strdup(name);
 	table->space = (unsigned int) space;
 	table->n_t_cols = (unsigned int) (n_cols +
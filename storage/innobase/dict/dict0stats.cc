@@ -46,6 +46,8 @@ Created Jan 06, 2010 Vasil Dimov
 #include "ut0new.h"
 #include <mysql_com.h>
 #include "row0mysql.h"
+#include "os0thread.h"
+#include "srv0srv.h"
 
 #include <algorithm>
 #include <map>
@@ -1926,6 +1928,8 @@ dict_stats_analyze_index(
 
 	dict_stats_empty_index(index);
 
+	index->stat_modified_counter = 0;
+
 	mtr_start(&mtr);
 
 	mtr_s_lock(dict_index_get_lock(index), &mtr);
@@ -2197,16 +2201,152 @@ found_level:
 	DBUG_VOID_RETURN;
 }
 
+/** Number of threads that are analyzing indexes on behalf of
+dict_stats_update_persistent(), updated atomically */
+static ulint	dict_stats_n_analyze_threads;
+
+/** Indexes whose persistent statistics are calculated by several threads */
+struct dict_stats_analyze_ctx_t {
+	/** The table of the indexes */
+	const dict_table_t*	table;
+
+	/** The indexes to analyze, the clustered index first */
+	dict_index_t**		indexes;
+
+	/** Number of indexes */
+	ulint			n_indexes;
+
+	/** Next index to analyze, updated atomically */
+	ulint			next;
+};
+
+/** Analyze indexes until none is left. Secondary indexes are skipped
+(left empty) if the table is about to be dropped.
+@param[in,out]	ctx	indexes to analyze */
+static
+void
+dict_stats_analyze_worker(
+	dict_stats_analyze_ctx_t*	ctx)
+{
+	for (;;) {
+		ulint	i = os_atomic_increment_ulint(&ctx->next, 1) - 1;
+
+		if (i >= ctx->n_indexes) {
+			break;
+		}
+
+		if (i == 0 || !(ctx->table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
+			dict_stats_analyze_index(ctx->indexes[i]);
+		}
+	}
+}
+
 /*********************************************************************//**
-Calculates new estimates for table and index statistics. This function
+Thread that analyzes indexes for dict_stats_update_persistent().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(dict_stats_analyze_thread)(
+/*======================================*/
+	void*	arg)	/*!< in: dict_stats_analyze_ctx_t */
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(dict_stats_analyze_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	dict_stats_analyze_worker(static_cast<dict_stats_analyze_ctx_t*>(arg));
+
+	my_thread_end();
+
+	os_thread_exit(false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Analyze indexes, in innodb_stats_analyze_threads threads if there are
+several indexes. The calling thread is one of the threads; if other
+threads would exceed DICT_STATS_MAX_ANALYZE_THREADS, fewer are used.
+@param[in,out]	ctx	indexes to analyze */
+static
+void
+dict_stats_analyze_indexes(
+	dict_stats_analyze_ctx_t*	ctx)
+{
+	ulint	n_helpers = ut_min(static_cast<ulint>(srv_stats_analyze_threads),
+				   ctx->n_indexes);
+	ulint	i;
+
+	n_helpers = n_helpers > 0 ? n_helpers - 1 : 0;
+
+	for (i = 0; i < n_helpers; i++) {
+		if (os_atomic_increment_ulint(&dict_stats_n_analyze_threads, 1)
+		    > DICT_STATS_MAX_ANALYZE_THREADS) {
+
+			os_atomic_decrement_ulint(
+				&dict_stats_n_analyze_threads, 1);
+			break;
+		}
+	}
+
+	n_helpers = i;
+
+	os_thread_id_t*	thread_ids = NULL;
+
+	if (n_helpers > 0) {
+		thread_ids = static_cast<os_thread_id_t*>(
+			ut_malloc_nokey(n_helpers * sizeof(*thread_ids)));
+
+		for (i = 0; i < n_helpers; i++) {
+			os_thread_create(dict_stats_analyze_thread, ctx,
+					 &thread_ids[i]);
+		}
+	}
+
+	dict_stats_analyze_worker(ctx);
+
+	if (n_helpers > 0) {
+		for (i = 0; i < n_helpers; i++) {
+			os_thread_join(thread_ids[i]);
+		}
+
+		ut_free(thread_ids);
+
+		os_atomic_decrement_ulint(&dict_stats_n_analyze_threads,
+					  n_helpers);
+	}
+}
+
+/** Check whether enough records of a secondary index have been modified
+since its statistics were calculated to calculate them again, by the same
+10% rule that row_update_statistics_if_needed() applies to the table.
+@param[in]	index	secondary index
+@return true if the statistics should be calculated */
+static
+bool
+dict_stats_index_is_modified(
+	const dict_index_t*	index)
+{
+	return(!index->table->stat_initialized
+	       || index->stat_modified_counter
+	       > index->table->stat_n_rows / 10);
+}
+
+/** Calculates new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
-will be saved on disk.
+will be saved on disk. The indexes are analyzed in parallel by
+innodb_stats_analyze_threads threads.
+@param[in,out]	table		table
+@param[in]	only_modified	whether to keep the statistics of secondary
+indexes that were not modified much, see dict_stats_index_is_modified();
+the clustered index is always analyzed
 @return DB_SUCCESS or error code */
 static
 dberr_t
 dict_stats_update_persistent(
-/*=========================*/
-	dict_table_t*	table)		/*!< in/out: table */
+	dict_table_t*	table,
+	bool		only_modified)
 {
 	dict_index_t*	index;
 
@@ -2233,17 +2373,14 @@ dict_stats_update_persistent(
 
 	ut_ad(!dict_index_is_ibuf(index));
 
-	dict_stats_analyze_index(index);
+	dict_index_t**	indexes = static_cast<dict_index_t**>(
+		ut_malloc_nokey(UT_LIST_GET_LEN(table->indexes)
+				* sizeof(*indexes)));
+	ulint		n_indexes = 0;
 
-	ulint	n_unique = dict_index_get_n_unique(index);
+	indexes[n_indexes++] = index;
 
-	ib_uint64_t stat_n_rows_tmp = index->stat_n_diff_key_vals[n_unique - 1];
-
-	ib_uint64_t stat_clustered_index_size_tmp = index->stat_index_size;
-
-	/* analyze other indexes from the table, if any */
-
-	ib_uint64_t stat_sum_of_other_index_sizes_tmp = 0;
+	/* collect the other indexes from the table, if any */
 
 	for (index = dict_table_get_next_index(index);
 	     index != NULL;
@@ -2255,14 +2392,48 @@ dict_stats_update_persistent(
 			continue;
 		}
 
-		dict_stats_empty_index(index);
-
 		if (dict_stats_should_ignore_index(index)) {
+			dict_stats_empty_index(index);
 			continue;
 		}
 
-		if (!(table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
-			dict_stats_analyze_index(index);
+		if (only_modified && !dict_stats_index_is_modified(index)) {
+			continue;
+		}
+
+		dict_stats_empty_index(index);
+
+		indexes[n_indexes++] = index;
+	}
+
+	dict_stats_analyze_ctx_t	ctx;
+
+	ctx.table = table;
+	ctx.indexes = indexes;
+	ctx.n_indexes = n_indexes;
+	ctx.next = 0;
+
+	dict_stats_analyze_indexes(&ctx);
+
+	ut_free(indexes);
+
+	index = dict_table_get_first_index(table);
+
+	ulint	n_unique = dict_index_get_n_unique(index);
+
+	ib_uint64_t stat_n_rows_tmp = index->stat_n_diff_key_vals[n_unique - 1];
+
+	ib_uint64_t stat_clustered_index_size_tmp = index->stat_index_size;
+
+	ib_uint64_t stat_sum_of_other_index_sizes_tmp = 0;
+
+	for (index = dict_table_get_next_index(index);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (index->type & DICT_FTS || dict_index_is_spatial(index)
+		    || dict_stats_should_ignore_index(index)) {
+			continue;
 		}
 
 		stat_sum_of_other_index_sizes_tmp
@@ -3120,6 +3291,7 @@ dict_stats_update(
 
 	switch (stats_upd_option) {
 	case DICT_STATS_RECALC_PERSISTENT:
+	case DICT_STATS_RECALC_PERSISTENT_MODIFIED:
 
 		if (srv_read_only_mode) {
 			goto transient;
@@ -3148,7 +3320,9 @@ dict_stats_update(
 
 			dberr_t	err;
 
-			err = dict_stats_update_persistent(table);
+			err = dict_stats_update_persistent(
+				table, stats_upd_option
+				== DICT_STATS_RECALC_PERSISTENT_MODIFIED);
 
 			if (err != DB_SUCCESS) {
 				return(err);
@@ -123,16 +123,26 @@ from a file, versus reading from a raw disk.
 
 To have fast access to a tablespace or a log file, we put the data structures
 to a hash table. Each tablespace and log file is given an unique 32-bit
-identifier.
+identifier. The hash table is split into FIL_N_SHARDS shards by the space id,
+each with its own mutex. A space is inserted into or removed from its shard
+while holding both fil_system->mutex and the shard mutex, so that a lookup
+needs only one of them.
 
 Some operating systems do not support many open files at the same time,
 though NT seems to tolerate at least 900 open files. Therefore, we put the
-open files in an LRU-list. If we need to open another file, we may close the
-file at the end of the LRU-list. When an i/o-operation is pending on a file,
-the file cannot be closed. We take the file nodes with pending i/o-operations
-out of the LRU-list and keep a count of pending operations. When an operation
-completes, we decrement the count and return the file node to the LRU-list if
-the count drops to zero. */
+open files in an LRU-list. If we need to open another file, we may close a
+file near the end of the LRU-list. When an i/o-operation is pending on a file,
+the file cannot be closed. Each file node keeps an atomic count of pending
+operations.
+
+fil_io() does not need fil_system->mutex when the file is open: it looks up
+the space and increments the pending count of the file node while holding
+only the shard mutex, and a read completes by decrementing the count. A file
+is closed only while holding the shard mutex and when its count is zero, and
+a pending count can only become nonzero on an open file. Because the LRU-list
+is not updated on this path, open files stay in the list, and the file node
+is marked accessed instead; fil_try_to_close_file_in_LRU() gives accessed
+files a second chance. */
 
 /** This tablespace name is used internally during recovery to open a
 general tablespace before the data dictionary are recovered and available. */
@@ -161,6 +171,23 @@ ulint	fil_n_file_opened			= 0;
 /** The null file address */
 fil_addr_t	fil_addr_null = {FIL_NULL, 0};
 
+/** Number of shards of the hash table of spaces */
+#define FIL_N_SHARDS	64
+
+/** A shard of the hash table of spaces, selected by space id */
+struct fil_shard_t {
+	ib_mutex_t	mutex;		/*!< The mutex protecting spaces,
+					fil_node_t::is_open and the
+					transitions of fil_node_t::n_pending
+					from zero */
+
+	hash_table_t*	spaces;		/*!< The spaces whose id modulo
+					FIL_N_SHARDS is the shard; they are
+					hashed on the space id */
+
+	char		pad[64];	/*!< To avoid false sharing */
+};
+
 /** The tablespace memory cache; also the totality of logs (the log
 data space) is stored here; below we talk about tablespaces, but also
 the ib_logfiles form a 'space' and it is handled here */
@@ -168,22 +195,22 @@ struct fil_system_t {
 #ifndef UNIV_HOTBACKUP
 	ib_mutex_t	mutex;		/*!< The mutex protecting the cache */
 #endif /* !UNIV_HOTBACKUP */
-	hash_table_t*	spaces;		/*!< The hash table of spaces in the
-					system; they are hashed on the space
-					id */
+	fil_shard_t	shards[FIL_N_SHARDS];
+					/*!< The hash table of spaces in the
+					system, sharded on the space id */
 	hash_table_t*	name_hash;	/*!< hash table based on the space
 					name */
 	UT_LIST_BASE_NODE_T(fil_node_t) LRU;
 					/*!< base node for the LRU list of the
-					most recently used open files with no
-					pending i/o's; if we start an i/o on
-					the file, we first remove it from this
-					list, and return it to the start of
-					the list when the i/o ends;
-					log files and the system tablespace are
-					not put to this list: they are opened
-					after the startup, and kept open until
-					shutdown */
+					most recently used open files; a file
+					is moved to the start of the list when
+					fil_io() starts an i/o on it under this
+					mutex, and it is marked accessed when
+					the i/o is started under the shard
+					mutex only; log files and the system
+					tablespace are not put to this list:
+					they are opened after the startup, and
+					kept open until shutdown */
 	UT_LIST_BASE_NODE_T(fil_space_t) unflushed_spaces;
 					/*!< base node for the list of those
 					tablespaces whose files contain
@@ -219,6 +246,48 @@ struct fil_system_t {
 initialized. */
 static fil_system_t*	fil_system	= NULL;
 
+/** Get the shard of the hash table of spaces for a space id.
+@param[in]	space_id	tablespace identifier
+@return shard */
+UNIV_INLINE
+fil_shard_t*
+fil_shard_get(
+	ulint	space_id)
+{
+	return(&fil_system->shards[space_id % FIL_N_SHARDS]);
+}
+
+/** Allow new operations on a tablespace again at the end of a truncation.
+fil_io() reads the flags on its fast path under the shard mutex only.
+@param[in,out]	space	tablespace */
+static
+void
+fil_space_end_truncate(
+	fil_space_t*	space)
+{
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
+	space->stop_new_ops = false;
+	space->is_being_truncated = false;
+	mutex_exit(&shard->mutex);
+}
+
+/** Allow i/o on a tablespace again after fil_rename_tablespace() stopped
+it. fil_io() reads the flag on its fast path under the shard mutex only.
+@param[in,out]	space	tablespace */
+static
+void
+fil_space_resume_ios(
+	fil_space_t*	space)
+{
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
+	space->stop_ios = false;
+	mutex_exit(&shard->mutex);
+}
+
 #ifdef UNIV_HOTBACKUP
 static ulint	srv_data_read;
 static ulint	srv_data_written;
@@ -301,9 +370,9 @@ fil_space_belongs_in_lru(
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex.
+pending i/o's field in the node and the system appropriately. Moves the node
+to the start of the LRU list if it is in the LRU list. The caller must hold
+the fil_sys mutex.
 @return false if the file can't be opened, otherwise true */
 static
 bool
@@ -315,7 +384,8 @@ fil_node_prepare_for_io(
 
 /**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately.
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex if the i/o was a write.
 @param[in,out] node		file node
 @param[in,out] system		tablespace instance
 @param[in] type			IO context */
@@ -381,7 +451,8 @@ fil_write(
 }
 
 /*******************************************************************//**
-Returns the table space by a given id, NULL if not found. */
+Returns the table space by a given id, NULL if not found. The caller must
+hold fil_system->mutex or the mutex of the shard of the id. */
 UNIV_INLINE
 fil_space_t*
 fil_space_get_by_id(
@@ -389,10 +460,11 @@ fil_space_get_by_id(
 	ulint	id)	/*!< in: space id */
 {
 	fil_space_t*	space;
+	fil_shard_t*	shard = fil_shard_get(id);
 
-	ut_ad(mutex_own(&fil_system->mutex));
+	ut_ad(mutex_own(&fil_system->mutex) || mutex_own(&shard->mutex));
 
-	HASH_SEARCH(hash, fil_system->spaces, id,
+	HASH_SEARCH(hash, shard->spaces, id,
 		    fil_space_t*, space,
 		    ut_ad(space->magic_n == FIL_SPACE_MAGIC_N),
 		    space->id == id);
@@ -663,7 +735,13 @@ fil_node_create_low(
 
 	node->atomic_write = atomic_write;
 
+	/* fil_io() may walk the chain under the shard mutex. */
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
 	UT_LIST_ADD_LAST(space->chain, node);
+	mutex_exit(&shard->mutex);
+
 	mutex_exit(&fil_system->mutex);
 
 	return(node);
@@ -698,6 +776,34 @@ fil_node_create(
 	return(node == NULL ? NULL : node->name);
 }
 
+/** Publish the handle of a file node that was opened to fil_io() and put
+the node to the LRU list. The caller must hold fil_system->mutex.
+@param[in,out]	node	File node */
+static
+void
+fil_node_mark_open(
+	fil_node_t*	node)
+{
+	fil_shard_t*	shard = fil_shard_get(node->space->id);
+
+	ut_ad(mutex_own(&fil_system->mutex));
+	ut_ad(!node->is_open);
+
+	/* Publish the handle to fil_io() lookups under the shard mutex. */
+	mutex_enter(&shard->mutex);
+	node->is_open = true;
+	mutex_exit(&shard->mutex);
+
+	fil_system->n_open++;
+	fil_n_file_opened++;
+
+	if (fil_space_belongs_in_lru(node->space)) {
+
+		/* Put the node to the LRU list */
+		UT_LIST_ADD_FIRST(fil_system->LRU, node);
+	}
+}
+
 /** Open a file node of a tablespace.
 The caller must own the fil_system mutex.
 @param[in,out]	node	File node
@@ -725,6 +831,7 @@ fil_node_open_file(
 		&& srv_read_only_mode;
 
 	if (node->size == 0
+	    || node->unvalidated
 	    || (space->purpose == FIL_TYPE_TABLESPACE
 		&& node == UT_LIST_GET_FIRST(space->chain)
 		&& !undo::Truncate::was_tablespace_truncated(space->id)
@@ -792,6 +899,22 @@ retry:
 
 		os_file_close(node->handle);
 
+		if (node->unvalidated
+		    && (space_id != space->id || flags != space->flags)) {
+			/* The file was moved or replaced after the
+			tablespace directory cache was written. */
+			ib::error() << "Tablespace file " << node->name
+				<< " has the id " << space_id << " and flags "
+				<< ib::hex(flags) << ", but the tablespace"
+				" directory cache registered it with the id "
+				<< space->id << " and flags "
+				<< ib::hex(space->flags) << ". "
+				<< TROUBLESHOOT_DATADICT_MSG;
+
+			ut_free(buf2);
+			return(false);
+		}
+
 		const page_size_t	page_size(flags);
 
 		min_size = FIL_IBD_FILE_INITIAL_SIZE * page_size.physical();
@@ -877,6 +1000,14 @@ retry:
 			}
 		}
 
+		if (node->unvalidated) {
+			/* Replace the size that the tablespace directory
+			cache recorded with the size of the file. */
+			space->size -= node->size;
+			node->size = 0;
+			node->unvalidated = false;
+		}
+
 		if (node->size == 0) {
 			uint64_t	extent_size;
 
@@ -923,32 +1054,26 @@ add_size:
 
 	ut_a(success);
 
-	node->is_open = true;
-
-	fil_system->n_open++;
-	fil_n_file_opened++;
-
-	if (fil_space_belongs_in_lru(space)) {
-
-		/* Put the node to the LRU list */
-		UT_LIST_ADD_FIRST(fil_system->LRU, node);
-	}
+	fil_node_mark_open(node);
 
 	return(true);
 }
 
-/** Close a file node.
-@param[in,out]	node	File node */
+/** Close a file node unless an i/o is pending on it. fil_io() may start
+an i/o without holding fil_system->mutex, so the pending count is checked
+under the shard mutex.
+@param[in,out]	node	File node
+@return whether the file was closed */
 static
-void
-fil_node_close_file(
+bool
+fil_node_close_file_if_idle(
 	fil_node_t*	node)
 {
-	bool	ret;
+	bool		ret;
+	fil_shard_t*	shard = fil_shard_get(node->space->id);
 
 	ut_ad(mutex_own(&(fil_system->mutex)));
 	ut_a(node->is_open);
-	ut_a(node->n_pending == 0);
 	ut_a(node->n_pending_flushes == 0);
 	ut_a(!node->being_extended);
 #ifndef UNIV_HOTBACKUP
@@ -957,12 +1082,23 @@ fil_node_close_file(
 	     || srv_fast_shutdown == 2);
 #endif /* !UNIV_HOTBACKUP */
 
+	mutex_enter(&shard->mutex);
+
+	if (node->n_pending > 0) {
+		mutex_exit(&shard->mutex);
+		return(false);
+	}
+
+	/* No i/o can be started on the file from now on. */
+	node->is_open = false;
+
+	mutex_exit(&shard->mutex);
+
 	ret = os_file_close(node->handle);
 	ut_a(ret);
 
 	/* printf("Closing file %s\n", node->name); */
 
-	node->is_open = false;
 	ut_a(fil_system->n_open > 0);
 	fil_system->n_open--;
 	fil_n_file_opened--;
@@ -974,6 +1110,22 @@ fil_node_close_file(
 		/* The node is in the LRU list, remove it */
 		UT_LIST_REMOVE(fil_system->LRU, node);
 	}
+
+	return(true);
+}
+
+/** Close a file node. There must not be any pending i/o on it.
+@param[in,out]	node	File node */
+static
+void
+fil_node_close_file(
+	fil_node_t*	node)
+{
+	ut_a(node->n_pending == 0);
+
+	bool	closed = fil_node_close_file_if_idle(node);
+
+	ut_a(closed);
 }
 
 /** Tries to close a file in the LRU list. The caller must hold the fil_sys
@@ -1000,40 +1152,62 @@ fil_try_to_close_file_in_LRU(
 			<< UT_LIST_GET_LEN(fil_system->LRU);
 	}
 
-	for (node = UT_LIST_GET_LAST(fil_system->LRU);
-	     node != NULL;
-	     node = UT_LIST_GET_PREV(LRU, node)) {
+	/* The first pass skips the files on which an i/o was started
+	without moving them in the list, and clears their mark; the second
+	pass looks at all files. */
+	for (ulint pass = 0; pass < 2; pass++) {
 
-		if (node->modification_counter == node->flush_counter
-		    && node->n_pending_flushes == 0
-		    && !node->being_extended) {
+		for (node = UT_LIST_GET_LAST(fil_system->LRU);
+		     node != NULL;
+		     node = UT_LIST_GET_PREV(LRU, node)) {
 
-			fil_node_close_file(node);
+			if (pass == 0 && node->lru_accessed) {
+				node->lru_accessed = false;
+				continue;
+			}
 
-			return(true);
-		}
+			if (node->modification_counter == node->flush_counter
+			    && node->n_pending_flushes == 0
+			    && !node->being_extended
+			    && fil_node_close_file_if_idle(node)) {
 
-		if (!print_info) {
-			continue;
-		}
+				return(true);
+			}
 
-		if (node->n_pending_flushes > 0) {
+			if (!print_info || pass == 0) {
+				continue;
+			}
 
-			ib::info() << "Cannot close file " << node->name
-				<< ", because n_pending_flushes "
-				<< node->n_pending_flushes;
-		}
+			if (node->n_pending > 0) {
 
-		if (node->modification_counter != node->flush_counter) {
-			ib::warn() << "Cannot close file " << node->name
-				<< ", because modification count "
-				<< node->modification_counter <<
-				" != flush count " << node->flush_counter;
-		}
+				ib::info() << "Cannot close file "
+					<< node->name << ", because n_pending "
+					<< node->n_pending;
+			}
+
+			if (node->n_pending_flushes > 0) {
 
-		if (node->being_extended) {
-			ib::info() << "Cannot close file " << node->name
-				<< ", because it is being extended";
+				ib::info() << "Cannot close file "
+					<< node->name
+					<< ", because n_pending_flushes "
+					<< node->n_pending_flushes;
+			}
+
+			if (node->modification_counter
+			    != node->flush_counter) {
+				ib::warn() << "Cannot close file "
+					<< node->name
+					<< ", because modification count "
+					<< node->modification_counter
+					<< " != flush count "
+					<< node->flush_counter;
+			}
+
+			if (node->being_extended) {
+				ib::info() << "Cannot close file "
+					<< node->name
+					<< ", because it is being extended";
+			}
 		}
 	}
 
@@ -1217,7 +1391,11 @@ fil_space_detach(
 {
 	ut_ad(mutex_own(&fil_system->mutex));
 
-	HASH_DELETE(fil_space_t, hash, fil_system->spaces, space->id, space);
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
+	HASH_DELETE(fil_space_t, hash, shard->spaces, space->id, space);
+	mutex_exit(&shard->mutex);
 
 	fil_space_t*	fnamespace = fil_space_get_by_name(space->name);
 
@@ -1414,7 +1592,11 @@ fil_space_create(
 #endif /* !UNIV_HOTBACKUP */
 	}
 
-	HASH_INSERT(fil_space_t, hash, fil_system->spaces, id, space);
+	fil_shard_t*	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
+	HASH_INSERT(fil_space_t, hash, shard->spaces, id, space);
+	mutex_exit(&shard->mutex);
 
 	HASH_INSERT(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(name), space);
@@ -1758,7 +1940,14 @@ fil_init(
 
 	mutex_create(LATCH_ID_FIL_SYSTEM, &fil_system->mutex);
 
-	fil_system->spaces = hash_create(hash_size);
+	for (ulint i = 0; i < FIL_N_SHARDS; i++) {
+		fil_shard_t*	shard = &fil_system->shards[i];
+
+		mutex_create(LATCH_ID_FIL_SHARD, &shard->mutex);
+
+		shard->spaces = hash_create(hash_size / FIL_N_SHARDS + 1);
+	}
+
 	fil_system->name_hash = hash_create(hash_size);
 
 	UT_LIST_INIT(fil_system->LRU, &fil_node_t::LRU);
@@ -2603,10 +2792,18 @@ fil_check_pending_io(
 	case FIL_OPERATION_DELETE:
 	case FIL_OPERATION_CLOSE:
 		break;
-	case FIL_OPERATION_TRUNCATE:
+	case FIL_OPERATION_TRUNCATE: {
+		/* Set the flag under the shard mutex, so that no
+		i/o can be started by fil_io() on the fast path once
+		we have looked at n_pending below. */
+		fil_shard_t*	shard = fil_shard_get(space->id);
+
+		mutex_enter(&shard->mutex);
 		space->is_being_truncated = true;
+		mutex_exit(&shard->mutex);
 		break;
 	}
+	}
 
 	/* The following code must change when InnoDB supports
 	multiple datafiles per tablespace. */
@@ -2656,7 +2853,11 @@ fil_check_pending_operations(
 	mutex_enter(&fil_system->mutex);
 	fil_space_t* sp = fil_space_get_by_id(id);
 	if (sp) {
+		fil_shard_t*	shard = fil_shard_get(id);
+
+		mutex_enter(&shard->mutex);
 		sp->stop_new_ops = true;
+		mutex_exit(&shard->mutex);
 	}
 	mutex_exit(&fil_system->mutex);
 
@@ -2970,8 +3171,7 @@ fil_truncate_tablespace(
 			node->name, node->handle, size, srv_read_only_mode);
 
 		if (success) {
-			space->stop_new_ops = false;
-			space->is_being_truncated = false;
+			fil_space_end_truncate(space);
 		}
 	}
 
@@ -3377,21 +3577,21 @@ func_exit:
 	}
 
 	if (count > 25000) {
-		space->stop_ios = false;
+		fil_space_resume_ios(space);
 		goto func_exit;
 	}
 
 	if (space != fil_space_get_by_name(space->name)) {
 		ib::error() << "Cannot find " << space->name
 			<< " in tablespace memory cache";
-		space->stop_ios = false;
+		fil_space_resume_ios(space);
 		goto func_exit;
 	}
 
 	if (fil_space_get_by_name(new_name)) {
 		ib::error() << new_name
 			<< " is already in tablespace memory cache";
-		space->stop_ios = false;
+		fil_space_resume_ios(space);
 		goto func_exit;
 	}
 
@@ -3399,7 +3599,11 @@ func_exit:
 	operating systems can rename an open file. For the closing we have to
 	wait until there are no pending i/o's or flushes on the file. */
 
+	fil_shard_t*	shard = fil_shard_get(id);
+
+	mutex_enter(&shard->mutex);
 	space->stop_ios = true;
+	mutex_exit(&shard->mutex);
 
 	/* The following code must change when InnoDB supports
 	multiple datafiles per tablespace. */
@@ -3418,10 +3622,10 @@ func_exit:
 		/* Flush the space */
 		sleep = flush = true;
 
-	} else if (node->is_open) {
-		/* Close the file */
-
-		fil_node_close_file(node);
+	} else if (node->is_open && !fil_node_close_file_if_idle(node)) {
+		/* An i/o was started on the fast path before we
+		set stop_ios; wait for it to complete */
+		sleep = true;
 	}
 
 	mutex_exit(&fil_system->mutex);
@@ -3512,7 +3716,7 @@ func_exit:
 	}
 
 	ut_ad(space->stop_ios);
-	space->stop_ios = false;
+	fil_space_resume_ios(space);
 	mutex_exit(&fil_system->mutex);
 
 	ut_free(old_file_name);
@@ -4695,6 +4899,469 @@ fil_ibd_load(
 	return(FIL_LOAD_OK);
 }
 
+#ifndef UNIV_HOTBACKUP
+/** Name of the tablespace directory cache file in the data directory */
+static const char	fil_dir_cache_filename[] = "ib_tablespaces";
+
+/** A file-per-table tablespace in the tablespace directory cache */
+struct fil_dir_cache_entry_t {
+	/** tablespace flags */
+	ulint		flags;
+	/** size of the file in pages */
+	ulint		size;
+	/** tablespace name */
+	std::string	name;
+	/** path of the file */
+	std::string	path;
+};
+
+/** The tablespace directory cache, by space id */
+typedef std::map<
+	ulint,
+	fil_dir_cache_entry_t,
+	std::less<ulint>,
+	ut_allocator<std::pair<const ulint, fil_dir_cache_entry_t> > >
+	fil_dir_cache_t;
+
+/** Entries read by fil_dir_cache_load(), or NULL */
+static fil_dir_cache_t*		fil_dir_cache;
+
+/** Tablespaces registered by fil_ibd_open_cached(), to be validated by
+fil_dir_cache_thread() */
+typedef std::vector<ulint, ut_allocator<ulint> >	fil_space_ids_t;
+
+/** Tablespaces registered by fil_ibd_open_cached(); owned by
+fil_dir_cache_thread() once fil_dir_cache_free() has been called */
+static fil_space_ids_t*		fil_dir_cache_unvalidated;
+
+/** Parse a number and the comma that follows it.
+@param[in,out]	p	position in the line; advanced past the comma
+@param[out]	value	the number
+@return whether a number and a comma were found */
+static
+bool
+fil_dir_cache_parse_ulint(
+	char**	p,
+	ulint*	value)
+{
+	char*	end;
+
+	if (!isdigit(static_cast<unsigned char>(**p))) {
+		return(false);
+	}
+
+	*value = strtoul(*p, &end, 10);
+
+	if (*end != ',') {
+		return(false);
+	}
+
+	*p = end + 1;
+
+	return(true);
+}
+
+/** Parse a line "id,flags,size,name,path" of the tablespace directory
+cache. The path comes last, because it may contain commas; table names
+are in the file name encoding, which has no commas.
+@param[in,out]	line	the line; modified
+@param[out]	id	tablespace ID
+@param[out]	entry	the other fields
+@return whether the line is valid */
+static
+bool
+fil_dir_cache_parse_line(
+	char*			line,
+	ulint*			id,
+	fil_dir_cache_entry_t*	entry)
+{
+	char*	p = line;
+
+	if (!fil_dir_cache_parse_ulint(&p, id)
+	    || !fil_dir_cache_parse_ulint(&p, &entry->flags)
+	    || !fil_dir_cache_parse_ulint(&p, &entry->size)
+	    || !fsp_flags_is_valid(entry->flags)
+	    || entry->size == 0) {
+		return(false);
+	}
+
+	char*	comma = strchr(p, ',');
+
+	if (comma == NULL || comma == p) {
+		return(false);
+	}
+
+	*comma = '\0';
+
+	char*	path = comma + 1;
+
+	path[strcspn(path, "\n")] = '\0';
+
+	if (*path == '\0') {
+		return(false);
+	}
+
+	entry->name = p;
+	entry->path = path;
+
+	return(true);
+}
+
+/** Read the tablespace directory cache that fil_dir_cache_write() wrote
+at an earlier shutdown. fil_ibd_open_cached() looks up the entries until
+fil_dir_cache_free() is called. Unless the server is read-only, the file
+is removed, so that it is not used after a later crash or a shutdown that
+does not write it; it only describes the files at the shutdown that wrote
+it.
+@param[in]	use	whether to read the file; false if the redo log
+was applied or the cache is disabled, in which case the file is only
+removed
+@return number of tablespaces in the cache */
+ulint
+fil_dir_cache_load(
+	bool	use)
+{
+	ut_ad(fil_dir_cache == NULL);
+
+	char*	filename = fil_make_filepath(
+		NULL, fil_dir_cache_filename, NO_EXT, false);
+
+	if (!use) {
+		if (!srv_read_only_mode) {
+			os_file_delete_if_exists(
+				innodb_data_file_key, filename, NULL);
+		}
+
+		ut_free(filename);
+		return(0);
+	}
+
+	FILE*	f = fopen(filename, "r");
+
+	if (f == NULL) {
+		ib::info() << "Cannot open '" << filename << "' for reading: "
+			<< strerror(errno) << ". All tablespaces will be"
+			" looked for.";
+		ut_free(filename);
+		return(0);
+	}
+
+	fil_dir_cache = UT_NEW_NOKEY(fil_dir_cache_t());
+	fil_dir_cache_unvalidated = UT_NEW_NOKEY(fil_space_ids_t());
+
+	const ulint	line_size = 2 * OS_FILE_MAX_PATH + 64;
+	char*		line = static_cast<char*>(ut_malloc_nokey(line_size));
+	ulint		n_bad = 0;
+
+	while (fgets(line, static_cast<int>(line_size), f) != NULL) {
+		fil_dir_cache_entry_t	entry;
+		ulint			id;
+
+		if (!fil_dir_cache_parse_line(line, &id, &entry)) {
+			n_bad++;
+			continue;
+		}
+
+		(*fil_dir_cache)[id] = entry;
+	}
+
+	fclose(f);
+	ut_free(line);
+
+	if (!srv_read_only_mode) {
+		os_file_delete_if_exists(innodb_data_file_key, filename, NULL);
+	}
+
+	if (n_bad > 0) {
+		ib::warn() << "Ignored " << n_bad << " malformed lines in '"
+			<< filename << "'";
+	}
+
+	ib::info() << "Read " << fil_dir_cache->size() << " tablespaces"
+		" from '" << filename << "'";
+
+	ut_free(filename);
+
+	return(fil_dir_cache->size());
+}
+
+/** Register a file-per-table tablespace from the tablespace directory
+cache, without looking for or opening its file. The cache entry must
+match the id, name and flags. The first page of the file is checked when
+the file is opened for the first time, or by fil_dir_cache_thread(),
+whichever comes first.
+@param[in]	id		tablespace ID
+@param[in]	flags		tablespace flags
+@param[in]	space_name	tablespace name of the datafile
+@return whether the tablespace was registered */
+bool
+fil_ibd_open_cached(
+	ulint		id,
+	ulint		flags,
+	const char*	space_name)
+{
+	if (fil_dir_cache == NULL
+	    || FSP_FLAGS_GET_SHARED(flags)
+	    || FSP_FLAGS_GET_ENCRYPTION(flags)) {
+		return(false);
+	}
+
+	fil_dir_cache_t::const_iterator	it = fil_dir_cache->find(id);
+
+	if (it == fil_dir_cache->end()
+	    || it->second.flags != flags
+	    || it->second.name != space_name) {
+		return(false);
+	}
+
+	fil_space_t*	space = fil_space_create(
+		space_name, id, flags, FIL_TYPE_TABLESPACE);
+
+	if (space == NULL) {
+		return(false);
+	}
+
+	fil_node_t*	node = fil_node_create_low(
+		it->second.path.c_str(), it->second.size, space, false,
+		IORequest::is_punch_hole_supported(), false);
+
+	ut_a(node != NULL);
+
+	/* Nobody can open the file before we return. */
+	node->unvalidated = true;
+
+	fil_dir_cache_unvalidated->push_back(id);
+
+	return(true);
+}
+
+/** Free the entries read by fil_dir_cache_load().
+@return number of tablespaces that fil_ibd_open_cached() registered, which
+fil_dir_cache_thread() has to validate */
+ulint
+fil_dir_cache_free()
+{
+	if (fil_dir_cache == NULL) {
+		return(0);
+	}
+
+	ulint	n = fil_dir_cache_unvalidated->size();
+
+	ib::info() << "Registered " << n << " of " << fil_dir_cache->size()
+		<< " tablespaces from the tablespace directory cache";
+
+	UT_DELETE(fil_dir_cache);
+	fil_dir_cache = NULL;
+
+	if (n == 0) {
+		UT_DELETE(fil_dir_cache_unvalidated);
+		fil_dir_cache_unvalidated = NULL;
+	}
+
+	return(n);
+}
+
+/** Write the tablespace directory cache: the id, name, flags, size and
+path of each file-per-table tablespace in the tablespace memory cache. */
+void
+fil_dir_cache_write()
+{
+	ut_ad(!srv_read_only_mode);
+
+	char*	filename = fil_make_filepath(
+		NULL, fil_dir_cache_filename, NO_EXT, false);
+	char	tmp_filename[OS_FILE_MAX_PATH + 11];
+
+	ut_snprintf(tmp_filename, sizeof(tmp_filename),
+		    "%s.incomplete", filename);
+
+	FILE*	f = fopen(tmp_filename, "w");
+
+	if (f == NULL) {
+		ib::warn() << "Cannot open '" << tmp_filename
+			<< "' for writing: " << strerror(errno);
+		ut_free(filename);
+		return;
+	}
+
+	ulint	n = 0;
+	bool	failed = false;
+
+	mutex_enter(&fil_system->mutex);
+
+	for (const fil_space_t* space = UT_LIST_GET_FIRST(
+		     fil_system->space_list);
+	     space != NULL && !failed;
+	     space = UT_LIST_GET_NEXT(space_list, space)) {
+
+		const fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+
+		/* Only file-per-table tablespaces of known size can be
+		registered without opening the file. */
+		if (space->purpose != FIL_TYPE_TABLESPACE
+		    || !fsp_is_file_per_table(space->id, space->flags)
+		    || srv_is_undo_tablespace(space->id)
+		    || FSP_FLAGS_GET_ENCRYPTION(space->flags)
+		    || space->stop_new_ops
+		    || UT_LIST_GET_LEN(space->chain) != 1
+		    || node->size == 0
+		    || strchr(space->name, ',') != NULL
+		    || strchr(node->name, '\n') != NULL) {
+			continue;
+		}
+
+		failed = fprintf(f, ULINTPF "," ULINTPF "," ULINTPF ",%s,%s\n",
+				 space->id, space->flags, node->size,
+				 space->name, node->name) < 0;
+		n++;
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	if (fclose(f) != 0 || failed) {
+		ib::warn() << "Cannot write '" << tmp_filename << "': "
+			<< strerror(errno);
+	} else if (rename(tmp_filename, filename) != 0) {
+		ib::warn() << "Cannot rename '" << tmp_filename << "' to '"
+			<< filename << "': " << strerror(errno);
+	} else {
+		ib::info() << "Wrote " << n << " tablespaces to '"
+			<< filename << "'";
+	}
+
+	ut_free(filename);
+}
+
+/** Check the first page of a file registered by fil_ibd_open_cached(),
+unless the file was opened meanwhile.
+@param[in]	id	tablespace ID */
+static
+void
+fil_dir_cache_validate(
+	ulint	id)
+{
+	mutex_enter(&fil_system->mutex);
+
+	fil_space_t*	space = fil_space_get_by_id(id);
+
+	if (space == NULL
+	    || space->stop_new_ops
+	    || !UT_LIST_GET_FIRST(space->chain)->unvalidated) {
+		mutex_exit(&fil_system->mutex);
+		return;
+	}
+
+	const ulint	flags = space->flags;
+	char*		name = mem_strdup(space->name);
+	char*		path = mem_strdup(UT_LIST_GET_FIRST(space->chain)->name);
+
+	mutex_exit(&fil_system->mutex);
+
+	/* Read the first page of the file without registering it as
+	open, so that the file LRU is not disturbed. */
+	Datafile	df;
+
+	df.init(name, flags);
+	df.set_filepath(path);
+
+	dberr_t		err = df.open_read_only(false);
+	os_offset_t	size_bytes = 0;
+
+	if (err == DB_SUCCESS) {
+		err = df.validate_to_dd(id, flags, false);
+	}
+
+	if (err == DB_SUCCESS) {
+		size_bytes = os_file_get_size(df.handle());
+	}
+
+	df.close();
+
+	mutex_enter(&fil_system->mutex);
+
+	space = fil_space_get_by_id(id);
+
+	if (space != NULL) {
+		fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+
+		if (!node->unvalidated || node->is_open) {
+			/* fil_node_open_file() checked the file */
+		} else if (err != DB_SUCCESS
+			   || size_bytes == static_cast<os_offset_t>(-1)) {
+			ib::error() << "Cannot validate the file '" << path
+				<< "' of tablespace " << id_name_t(name)
+				<< " registered from the tablespace directory"
+				" cache. The tablespace will be inaccessible."
+				" " << TROUBLESHOOT_DATADICT_MSG;
+		} else {
+			const page_size_t	page_size(flags);
+			const ulint		size = static_cast<ulint>(
+				size_bytes / page_size.physical());
+
+			/* Round down like fil_node_open_file(). */
+			const ulint		extent = FSP_EXTENT_SIZE;
+
+			space->size -= node->size;
+			node->size = size >= extent
+				? ut_2pow_round(size, extent) : size;
+			space->size += node->size;
+			node->unvalidated = false;
+		}
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	ut_free(name);
+	ut_free(path);
+}
+
+/** Validate the tablespaces that fil_ibd_open_cached() registered, in the
+background. The thread exits when it is done or at shutdown.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(fil_dir_cache_thread)(
+	void*	arg MY_ATTRIBUTE((unused)))
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(fil_dir_cache_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	srv_fil_dir_cache_thread_active = true;
+
+	const fil_space_ids_t*	ids = fil_dir_cache_unvalidated;
+	ulint			n_done = 0;
+
+	ut_a(ids != NULL);
+
+	for (fil_space_ids_t::const_iterator it = ids->begin();
+	     it != ids->end()
+	     && srv_shutdown_state == SRV_SHUTDOWN_NONE;
+	     ++it, ++n_done) {
+
+		fil_dir_cache_validate(*it);
+	}
+
+	ib::info() << "Validated " << n_done << " of " << ids->size()
+		<< " tablespaces registered from the tablespace directory"
+		" cache";
+
+	UT_DELETE(fil_dir_cache_unvalidated);
+	fil_dir_cache_unvalidated = NULL;
+
+	srv_fil_dir_cache_thread_active = false;
+
+	my_thread_end();
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+#endif /* !UNIV_HOTBACKUP */
+
 /***********************************************************************//**
 A fault-tolerant function that tries to read the next file name in the
 directory. We retry 100 times if os_file_readdir_next_file() returns -1. The
@@ -5360,9 +6027,9 @@ fil_space_get_n_reserved_extents(
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex.
+pending i/o's field in the node and the system appropriately. Moves the node
+to the start of the LRU list if it is in the LRU list. The caller must hold
+the fil_sys mutex.
 @return false if the file can't be opened, otherwise true */
 static
 bool
@@ -5387,24 +6054,25 @@ fil_node_prepare_for_io(
 		if (!fil_node_open_file(node)) {
 			return(false);
 		}
-	}
 
-	if (node->n_pending == 0 && fil_space_belongs_in_lru(space)) {
-		/* The node is in the LRU list, remove it */
+	} else if (fil_space_belongs_in_lru(space)) {
+		/* The node is in the LRU list, move it to the start */
 
 		ut_a(UT_LIST_GET_LEN(system->LRU) > 0);
 
 		UT_LIST_REMOVE(system->LRU, node);
+		UT_LIST_ADD_FIRST(system->LRU, node);
 	}
 
-	node->n_pending++;
+	os_atomic_increment_ulint(&node->n_pending, 1);
 
 	return(true);
 }
 
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex if the i/o was a write. */
 static
 void
 fil_node_complete_io(
@@ -5414,15 +6082,13 @@ fil_node_complete_io(
 	const IORequest&type)	/*!< in: IO_TYPE_*, marks the node as
 				modified if TYPE_IS_WRITE() */
 {
-	ut_ad(mutex_own(&system->mutex));
 	ut_a(node->n_pending > 0);
-
-	--node->n_pending;
-
 	ut_ad(type.validate());
 
 	if (type.is_write()) {
 
+		ut_ad(mutex_own(&system->mutex));
+
 		ut_ad(!srv_read_only_mode
 		      || fsp_is_system_temporary(node->space->id));
 
@@ -5447,11 +6113,70 @@ fil_node_complete_io(
 		}
 	}
 
-	if (node->n_pending == 0 && fil_space_belongs_in_lru(node->space)) {
+	/* The node stays in the LRU list while the i/o is pending;
+	fil_node_close_file_if_idle() will not close it until the
+	count drops to zero. */
+	os_atomic_decrement_ulint(&node->n_pending, 1);
+}
 
-		/* The node must be put back to the LRU list */
-		UT_LIST_ADD_FIRST(system->LRU, node);
+/** Prepare for i/o on an open file without acquiring fil_system->mutex.
+Only the mutex of the shard of the tablespace is acquired. This fails if
+the tablespace is not in the cache, the file is not open, the page is
+not within the known bounds of the file, or if a DDL operation is in
+progress on the tablespace; the caller must then fall back to
+fil_mutex_enter_and_prepare_for_io() and fil_node_prepare_for_io().
+On success the node is marked as accessed for fil_try_to_close_file_in_LRU()
+instead of being moved in fil_system->LRU.
+@param[in]	page_id		page id
+@param[out]	space		tablespace
+@param[out]	node		file node containing the page
+@param[out]	cur_page_no	page number within the file
+@return whether the i/o can proceed on node */
+static
+bool
+fil_node_prepare_for_io_fast(
+	const page_id_t&	page_id,
+	fil_space_t**		space,
+	fil_node_t**		node,
+	ulint*			cur_page_no)
+{
+	fil_shard_t*	shard = fil_shard_get(page_id.space());
+	bool		success = false;
+
+	mutex_enter(&shard->mutex);
+
+	fil_space_t*	sp = fil_space_get_by_id(page_id.space());
+
+	if (sp != NULL
+	    && !sp->stop_new_ops
+	    && !sp->stop_ios
+	    && !sp->is_being_truncated) {
+
+		ulint		page_no = page_id.page_no();
+		fil_node_t*	nd = UT_LIST_GET_FIRST(sp->chain);
+
+		while (nd != NULL && nd->size != 0 && !nd->unvalidated
+		       && nd->size <= page_no) {
+			page_no -= nd->size;
+			nd = UT_LIST_GET_NEXT(chain, nd);
+		}
+
+		if (nd != NULL && nd->size != 0 && !nd->unvalidated
+		    && nd->is_open) {
+
+			os_atomic_increment_ulint(&nd->n_pending, 1);
+			nd->lru_accessed = true;
+
+			*space = sp;
+			*node = nd;
+			*cur_page_no = page_no;
+			success = true;
+		}
 	}
+
+	mutex_exit(&shard->mutex);
+
+	return(success);
 }
 
 /** Report information about an invalid page access. */
@@ -5607,12 +6332,25 @@ fil_io(
 	}
 #endif /* !UNIV_HOTBACKUP */
 
+	fil_space_t*	space;
+	fil_node_t*	node;
+	ulint		cur_page_no;
+
+	if (fil_node_prepare_for_io_fast(
+		    page_id, &space, &node, &cur_page_no)) {
+
+		ut_ad(mode != OS_AIO_IBUF
+		      || fil_type_is_data(space->purpose));
+
+		goto do_io;
+	}
+
 	/* Reserve the fil_system mutex and make sure that we can open at
 	least one file while holding it, if the file is not already open */
 
 	fil_mutex_enter_and_prepare_for_io(page_id.space());
 
-	fil_space_t*	space = fil_space_get_by_id(page_id.space());
+	space = fil_space_get_by_id(page_id.space());
 
 	/* If we are deleting a tablespace we don't allow async read operations
 	on that. However, we do allow write operations and sync read operations. */
@@ -5638,8 +6376,8 @@ fil_io(
 
 	ut_ad(mode != OS_AIO_IBUF || fil_type_is_data(space->purpose));
 
-	ulint		cur_page_no = page_id.page_no();
-	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+	cur_page_no = page_id.page_no();
+	node = UT_LIST_GET_FIRST(space->chain);
 
 	for (;;) {
 
@@ -5656,10 +6394,11 @@ fil_io(
 				req_type.is_read());
 
 		} else if (fil_is_user_tablespace_id(space->id)
-			   && node->size == 0) {
+			   && (node->size == 0 || node->unvalidated)) {
 
 			/* We do not know the size of a single-table tablespace
-			before we open the file */
+			before we open the file. The size that the tablespace
+			directory cache recorded may be stale. */
 			break;
 
 		} else if (node->size > cur_page_no) {
@@ -5739,6 +6478,7 @@ fil_io(
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
+do_io:
 	/* Calculate the low 32 bits and the high 32 bits of the file offset */
 
 	if (!page_size.is_compressed()) {
@@ -5852,11 +6592,15 @@ fil_io(
 		/* The i/o operation is already completed when we return from
 		os_aio: */
 
-		mutex_enter(&fil_system->mutex);
+		if (req_type.is_write()) {
+			mutex_enter(&fil_system->mutex);
 
-		fil_node_complete_io(node, fil_system, req_type);
+			fil_node_complete_io(node, fil_system, req_type);
 
-		mutex_exit(&fil_system->mutex);
+			mutex_exit(&fil_system->mutex);
+		} else {
+			fil_node_complete_io(node, fil_system, req_type);
+		}
 
 		ut_ad(fil_validate_skip());
 	}
@@ -5893,11 +6637,15 @@ fil_aio_wait(
 
 	srv_set_io_thread_op_info(segment, "complete io for fil node");
 
-	mutex_enter(&fil_system->mutex);
+	if (type.is_write()) {
+		mutex_enter(&fil_system->mutex);
 
-	fil_node_complete_io(node, fil_system, type);
+		fil_node_complete_io(node, fil_system, type);
 
-	mutex_exit(&fil_system->mutex);
+		mutex_exit(&fil_system->mutex);
+	} else {
+		fil_node_complete_io(node, fil_system, type);
+	}
 
 	ut_ad(fil_validate_skip());
 
@@ -6207,17 +6955,21 @@ fil_validate(void)
 
 	mutex_enter(&fil_system->mutex);
 
-	/* Look for spaces in the hash table */
+	/* Look for spaces in the hash tables of all shards */
 
-	for (ulint i = 0; i < hash_get_n_cells(fil_system->spaces); i++) {
+	for (ulint s = 0; s < FIL_N_SHARDS; s++) {
+		hash_table_t*	spaces = fil_system->shards[s].spaces;
 
-		for (space = static_cast<fil_space_t*>(
-				HASH_GET_FIRST(fil_system->spaces, i));
-		     space != 0;
-		     space = static_cast<fil_space_t*>(
-				HASH_GET_NEXT(hash, space))) {
+		for (ulint i = 0; i < hash_get_n_cells(spaces); i++) {
 
-			n_open += Check::validate(space);
+			for (space = static_cast<fil_space_t*>(
+					HASH_GET_FIRST(spaces, i));
+			     space != 0;
+			     space = static_cast<fil_space_t*>(
+					HASH_GET_NEXT(hash, space))) {
+
+				n_open += Check::validate(space);
+			}
 		}
 	}
 
@@ -6229,8 +6981,6 @@ fil_validate(void)
 	     fil_node != 0;
 	     fil_node = UT_LIST_GET_NEXT(LRU, fil_node)) {
 
-		ut_a(fil_node->n_pending == 0);
-		ut_a(!fil_node->being_extended);
 		ut_a(fil_node->is_open);
 		ut_a(fil_space_belongs_in_lru(fil_node->space));
 	}
@@ -6315,7 +7065,13 @@ void
 fil_close(void)
 /*===========*/
 {
-	hash_table_free(fil_system->spaces);
+	for (ulint i = 0; i < FIL_N_SHARDS; i++) {
+		fil_shard_t*	shard = &fil_system->shards[i];
+
+		hash_table_free(shard->spaces);
+
+		mutex_free(&shard->mutex);
+	}
 
 	hash_table_free(fil_system->name_hash);
 
@@ -7192,9 +7948,12 @@ truncate_t::truncate(
 
 		bool	ret;
 
-		node->handle = os_file_create_simple_no_error_handling(
-			innodb_data_file_key, path, OS_FILE_OPEN,
-			OS_FILE_READ_WRITE,
+		/* Open the file like fil_node_open_file() does, because
+		the handle is published to fil_io(). */
+		node->handle = os_file_create(
+			innodb_data_file_key, path,
+			OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT,
+			OS_FILE_AIO, OS_DATA_FILE,
 			fsp_is_system_temporary(space_id)
 			? false : srv_read_only_mode, &ret);
 
@@ -7208,7 +7967,7 @@ truncate_t::truncate(
 			return(DB_ERROR);
 		}
 
-		node->is_open = true;
+		fil_node_mark_open(node);
 	}
 
 	os_offset_t	trunc_size = trunc_to_default
@@ -7224,24 +7983,15 @@ truncate_t::truncate(
 		err = DB_ERROR;
 	}
 
-	space->stop_new_ops = false;
-	space->is_being_truncated = false;
-
-	/* If we opened the file in this function, close it. */
+	/* If we opened the file in this function, close it. If fil_io()
+	started an i/o on it on the fast path, the file stays open and is
+	closed from the LRU list like any other file. */
 	if (!already_open) {
-		bool	closed = os_file_close(node->handle);
-
-		if (!closed) {
-
-			ib::error() << "Failed to close tablespace file "
-				<< path << ".";
-
-			err = DB_ERROR;
-		} else {
-			node->is_open = false;
-		}
+		fil_node_close_file_if_idle(node);
 	}
 
+	fil_space_end_truncate(space);
+
 	mutex_exit(&fil_system->mutex);
 
 	ut_free(path);
@@ -214,6 +214,10 @@ fsp_flags_to_dict_tf(
 	ulint	flags = dict_tf_init(post_antelope | compact, zip_ssize,
 				     atomic_blobs, data_dir, shared_space);
 
+	if (FSP_FLAGS_GET_ZIP_CODEC(fsp_flags)) {
+		flags |= DICT_TF_MASK_ZIP_CODEC;
+	}
+
 	return(flags);
 }
 #endif /* !UNIV_HOTBACKUP */
@@ -237,6 +241,7 @@ fsp_flags_is_valid(
 	bool	is_shared = FSP_FLAGS_GET_SHARED(flags);
 	bool	is_temp = FSP_FLAGS_GET_TEMPORARY(flags);
 	bool	is_encryption = FSP_FLAGS_GET_ENCRYPTION(flags);
+	bool	zip_codec = FSP_FLAGS_GET_ZIP_CODEC(flags);
 
 	ulint	unused = FSP_FLAGS_GET_UNUSED(flags);
 
@@ -289,10 +294,16 @@ fsp_flags_is_valid(
 		return(false);
 	}
 
+	/* Only single-table and not temp tablespaces with compressed
+	pages are flagged with a codec. */
+	if (zip_codec && (zip_ssize == 0 || is_shared || is_temp)) {
+		return(false);
+	}
+
 #if UNIV_FORMAT_MAX != UNIV_FORMAT_B
 # error UNIV_FORMAT_MAX != UNIV_FORMAT_B, Add more validations.
 #endif
-#if FSP_FLAGS_POS_UNUSED != 14
+#if FSP_FLAGS_POS_UNUSED != 15
 # error You have added a new FSP_FLAG without adding a validation check.
 #endif
 
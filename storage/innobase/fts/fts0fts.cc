@@ -884,6 +884,11 @@ fts_drop_index(
 				rbt_free(index_cache->words);
 			}
 
+			if (index_cache->frozen_words) {
+				fts_words_free(index_cache->frozen_words);
+				rbt_free(index_cache->frozen_words);
+			}
+
 			ib_vector_remove(cache->indexes, *(void**) index_cache);
 		}
 
@@ -1060,6 +1065,56 @@ fts_words_free(
 	}
 }
 
+/** Free the words that were frozen for SYNC, and the query graphs
+that wrote them.
+@param[in,out]	cache	fts cache */
+static
+void
+fts_cache_free_frozen(
+	fts_cache_t*	cache)
+{
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		if (index_cache->frozen_words != NULL) {
+			fts_words_free(index_cache->frozen_words);
+			rbt_free(index_cache->frozen_words);
+			index_cache->frozen_words = NULL;
+		}
+
+		for (ulint j = 0; j < FTS_NUM_AUX_INDEX; ++j) {
+
+			if (index_cache->ins_graph[j] != NULL) {
+
+				fts_que_graph_free_check_lock(
+					NULL, index_cache,
+					index_cache->ins_graph[j]);
+
+				index_cache->ins_graph[j] = NULL;
+			}
+
+			if (index_cache->sel_graph[j] != NULL) {
+
+				fts_que_graph_free_check_lock(
+					NULL, index_cache,
+					index_cache->sel_graph[j]);
+
+				index_cache->sel_graph[j] = NULL;
+			}
+		}
+	}
+
+	if (cache->frozen_heap != NULL) {
+		mem_heap_free(cache->frozen_heap);
+		cache->frozen_heap = NULL;
+	}
+
+	cache->frozen_size = 0;
+}
+
 /** Clear cache.
 @param[in,out]	cache	fts cache */
 void
@@ -1108,6 +1163,8 @@ fts_cache_clear(
 	mem_heap_free(static_cast<mem_heap_t*>(cache->sync_heap->arg));
 	cache->sync_heap->arg = NULL;
 
+	fts_cache_free_frozen(cache);
+
 	fts_need_sync = false;
 
 	cache->total_size = 0;
@@ -1200,6 +1257,10 @@ fts_cache_destroy(
 		mem_heap_free(static_cast<mem_heap_t*>(cache->sync_heap->arg));
 	}
 
+	if (cache->frozen_heap) {
+		mem_heap_free(cache->frozen_heap);
+	}
+
 	mem_heap_free(cache->cache_heap);
 }
 
@@ -1451,6 +1512,11 @@ fts_cache_add_doc(
 	if (doc_id > cache->sync->max_doc_id) {
 		cache->sync->max_doc_id = doc_id;
 	}
+
+	if (cache->sync->min_doc_id == FTS_NULL_DOC_ID
+	    || doc_id < cache->sync->min_doc_id) {
+		cache->sync->min_doc_id = doc_id;
+	}
 }
 
 /****************************************************************//**
@@ -3664,6 +3730,7 @@ fts_add_doc_by_id(
 					doc_id, doc.tokens);
 
 				bool	need_sync = false;
+				bool	need_wait = false;
 				if ((cache->total_size -
 				    cache->total_size_before_sync >
 				    fts_max_cache_size / 10 || fts_need_sync)
@@ -3671,10 +3738,21 @@ fts_add_doc_by_id(
 					need_sync = true;
 					cache->total_size_before_sync =
 					    cache->total_size;
+				} else if (cache->sync->in_progress
+					   && cache->total_size
+					   > fts_max_cache_size) {
+					/* The documents added since the
+					SYNC froze the words have filled
+					the cache again. */
+					need_wait = true;
 				}
 
 				rw_lock_x_unlock(&table->fts->cache->lock);
 
+				if (need_wait) {
+					os_event_wait(cache->sync->event);
+				}
+
 				DBUG_EXECUTE_IF(
                                         "fts_instrument_sync_cache_wait",
 					srv_fatal_semaphore_wait_threshold = 25;
@@ -4082,6 +4160,8 @@ fts_sync_add_deleted_cache(
 /** Write the words and ilist to disk.
 @param[in,out]	trx		transaction
 @param[in]	index_cache	index cache
+@param[in]	words		index_cache->frozen_words, or
+				index_cache->words
 @param[in]	unlock_cache	whether unlock cache when write node
 				Also set this to true if sync takes
 				very long
@@ -4093,6 +4173,7 @@ dberr_t
 fts_sync_write_words(
 	trx_t*			trx,
 	fts_index_cache_t*	index_cache,
+	ib_rbt_t*		words,
 	bool			unlock_cache,
 	ib_time_t		sync_start_time)
 {
@@ -4117,13 +4198,13 @@ fts_sync_write_words(
 	FTS_INIT_INDEX_TABLE(
 		&fts_table, NULL, FTS_INDEX_TABLE, index_cache->index);
 
-	n_words = rbt_size(index_cache->words);
+	n_words = rbt_size(words);
 
 	/* We iterate over the entire tree, even if there is an error,
 	since we want to free the memory used during caching. */
-	for (rbt_node = rbt_first(index_cache->words);
+	for (rbt_node = rbt_first(words);
 	     rbt_node;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 
 		ulint			i;
 		ulint			selected;
@@ -4484,6 +4565,57 @@ fts_is_word_in_index(
 }
 #endif /* FTS_DOC_STATS_DEBUG */
 
+/** Freeze the words of the cache for SYNC. The words cached so far are
+set aside to be written to the INDEX tables, and the documents that are
+added meanwhile go to new words, so that SYNC need not hold the cache lock
+while it writes.
+@param[in,out]	sync	sync state */
+static
+void
+fts_sync_freeze(
+	fts_sync_t*	sync)
+{
+	fts_cache_t*	cache = sync->table->fts->cache;
+
+	ut_ad(rw_lock_own(&cache->lock, RW_LOCK_X));
+
+	/* The words of a SYNC that was rolled back are written again
+	first; the words added since are left for the next SYNC. */
+	if (cache->frozen_heap != NULL) {
+		return;
+	}
+
+	/* deleted_doc_ids stays in the frozen heap until
+	fts_sync_commit() replaces it. */
+	cache->frozen_heap = static_cast<mem_heap_t*>(cache->sync_heap->arg);
+	cache->sync_heap->arg = mem_heap_create(1024);
+
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		ut_ad(index_cache->frozen_words == NULL);
+
+		index_cache->frozen_words = index_cache->words;
+
+		index_cache->words = rbt_create_arg_cmp(
+			sizeof(fts_tokenizer_word_t), innobase_fts_text_cmp,
+			index_cache->charset);
+
+		index_cache->doc_stats = ib_vector_create(
+			cache->sync_heap, sizeof(fts_doc_stats_t), 4);
+	}
+
+	cache->frozen_size = cache->total_size;
+	cache->total_size = 0;
+	cache->total_size_before_sync = 0;
+
+	sync->frozen_max_doc_id = sync->max_doc_id;
+	sync->min_doc_id = FTS_NULL_DOC_ID;
+}
+
 /*********************************************************************//**
 Begin Sync, create transaction, acquire locks, etc. */
 static
@@ -4501,11 +4633,13 @@ fts_sync_begin(
 
 	sync->trx = trx_allocate_for_background();
 
+	fts_sync_freeze(sync);
+
 	if (fts_enable_diag_print) {
 		ib::info() << "FTS SYNC for table " << sync->table->name
 			<< ", deleted count: "
 			<< ib_vector_size(cache->deleted_doc_ids)
-			<< " size: " << cache->total_size << " bytes";
+			<< " size: " << cache->frozen_size << " bytes";
 	}
 }
 
@@ -4518,7 +4652,8 @@ dberr_t
 fts_sync_index(
 /*===========*/
 	fts_sync_t*		sync,		/*!< in: sync state */
-	fts_index_cache_t*	index_cache)	/*!< in: index cache */
+	fts_index_cache_t*	index_cache,	/*!< in: index cache */
+	ib_rbt_t*		words)		/*!< in: words to write */
 {
 	trx_t*		trx = sync->trx;
 	dberr_t		error = DB_SUCCESS;
@@ -4526,13 +4661,13 @@ fts_sync_index(
 	trx->op_info = "doing SYNC index";
 
 	if (fts_enable_diag_print) {
-		ib::info() << "SYNC words: " << rbt_size(index_cache->words);
+		ib::info() << "SYNC words: " << rbt_size(words);
 	}
 
-	ut_ad(rbt_validate(index_cache->words));
+	ut_ad(rbt_validate(words));
 
-	error = fts_sync_write_words(trx, index_cache, sync->unlock_cache,
-				     sync->start_time);
+	error = fts_sync_write_words(trx, index_cache, words,
+				     sync->unlock_cache, sync->start_time);
 
 #ifdef FTS_DOC_STATS_DEBUG
 	/* FTS_RESOLVE: the word counter info in auxiliary table "DOC_ID"
@@ -4549,18 +4684,18 @@ fts_sync_index(
 }
 
 /** Check if index cache has been synced completely
-@param[in,out]	index_cache	index cache
+@param[in]	words	words of the index cache
 @return true if index is synced, otherwise false. */
 static
 bool
 fts_sync_index_check(
-	fts_index_cache_t*	index_cache)
+	const ib_rbt_t*	words)
 {
 	const ib_rbt_node_t*	rbt_node;
 
-	for (rbt_node = rbt_first(index_cache->words);
+	for (rbt_node = rbt_first(words);
 	     rbt_node != NULL;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 
 		fts_tokenizer_word_t*	word;
 		word = rbt_value(fts_tokenizer_word_t, rbt_node);
@@ -4577,35 +4712,41 @@ fts_sync_index_check(
 }
 
 /** Reset synced flag in index cache when rollback
-@param[in,out]	index_cache	index cache */
+@param[in,out]	words	words of the index cache */
 static
 void
 fts_sync_index_reset(
-	fts_index_cache_t*	index_cache)
+	ib_rbt_t*	words)
 {
 	const ib_rbt_node_t*	rbt_node;
 
-	for (rbt_node = rbt_first(index_cache->words);
+	for (rbt_node = rbt_first(words);
 	     rbt_node != NULL;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 
 		fts_tokenizer_word_t*	word;
 		word = rbt_value(fts_tokenizer_word_t, rbt_node);
 
-		fts_node_t*	fts_node;
-		fts_node = static_cast<fts_node_t*>(ib_vector_last(word->nodes));
+		for (ulint i = 0; i < ib_vector_size(word->nodes); ++i) {
+			fts_node_t*	fts_node;
+			fts_node = static_cast<fts_node_t*>(
+				ib_vector_get(word->nodes, i));
 
-		fts_node->synced = false;
+			fts_node->synced = false;
+		}
 	}
 }
 
 /** Commit the SYNC, change state of processed doc ids etc.
 @param[in,out]	sync	sync state
+@param[in]	all	whether the words added after the words were
+			frozen were written too
 @return DB_SUCCESS if all OK */
 static  MY_ATTRIBUTE((nonnull, warn_unused_result))
 dberr_t
 fts_sync_commit(
-	fts_sync_t*	sync)
+	fts_sync_t*	sync,
+	bool		all)
 {
 	dberr_t		error;
 	trx_t*		trx = sync->trx;
@@ -4616,8 +4757,10 @@ fts_sync_commit(
 
 	/* After each Sync, update the CONFIG table about the max doc id
 	we just sync-ed to index table */
-	error = fts_cmp_set_sync_doc_id(sync->table, sync->max_doc_id, FALSE,
-					&last_doc_id);
+	error = fts_cmp_set_sync_doc_id(
+		sync->table,
+		all ? sync->max_doc_id : sync->frozen_max_doc_id,
+		FALSE, &last_doc_id);
 
 	/* Get the list of deleted documents that are either in the
 	cache or were headed there but were deleted before the add
@@ -4631,9 +4774,23 @@ fts_sync_commit(
 
 	/* We need to do this within the deleted lock since fts_delete() can
 	attempt to add a deleted doc id to the cache deleted id array. */
-	fts_cache_clear(cache);
-	DEBUG_SYNC_C("fts_deleted_doc_ids_clear");
-	fts_cache_init(cache);
+	if (all) {
+		fts_cache_clear(cache);
+		DEBUG_SYNC_C("fts_deleted_doc_ids_clear");
+		fts_cache_init(cache);
+	} else {
+		/* The words added after the words were frozen are left
+		for the next SYNC. The deleted doc ids were all written,
+		and their array may be in the frozen heap. */
+		mutex_enter(&cache->deleted_lock);
+		cache->deleted_doc_ids = ib_vector_create(
+			cache->sync_heap, sizeof(fts_update_t), 4);
+		mutex_exit(&cache->deleted_lock);
+		DEBUG_SYNC_C("fts_deleted_doc_ids_clear");
+
+		fts_cache_free_frozen(cache);
+		fts_need_sync = false;
+	}
 	rw_lock_x_unlock(&cache->lock);
 
 	if (error == DB_SUCCESS) {
@@ -4682,8 +4839,13 @@ fts_sync_rollback(
 			ib_vector_get(cache->indexes, i));
 
 		/* Reset synced flag so nodes will not be skipped
-		in the next sync, see fts_sync_write_words(). */
-		fts_sync_index_reset(index_cache);
+		in the next sync, see fts_sync_write_words(). The
+		frozen words are kept to be written by the next sync. */
+		fts_sync_index_reset(index_cache->words);
+
+		if (index_cache->frozen_words != NULL) {
+			fts_sync_index_reset(index_cache->frozen_words);
+		}
 
 		for (j = 0; fts_index_selector[j].value; ++j) {
 
@@ -4736,7 +4898,7 @@ fts_check_all_indexes_synced(
 
 		if (index_cache->index->to_be_dropped
 		    || index_cache->index->table->to_be_dropped
-		    || fts_sync_index_check(index_cache)) {
+		    || fts_sync_index_check(index_cache->words)) {
 			continue;
 		}
 
@@ -4746,6 +4908,53 @@ fts_check_all_indexes_synced(
 	return true;
 }
 
+/** Write the words of all the FTS indexes of the table.
+@param[in,out]	sync	sync state
+@param[in]	frozen	true to write the frozen words, false to write the
+			words added after they were frozen
+@return DB_SUCCESS if all OK */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+fts_sync_indexes(
+	fts_sync_t*	sync,
+	bool		frozen)
+{
+	dberr_t		error = DB_SUCCESS;
+	fts_cache_t*	cache = sync->table->fts->cache;
+
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+		ib_rbt_t*		words;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		words = frozen
+			? index_cache->frozen_words : index_cache->words;
+
+		/* An index that was created after the words were frozen
+		has no frozen words. */
+		if (words == NULL
+		    || index_cache->index->to_be_dropped
+		    || index_cache->index->table->to_be_dropped) {
+			continue;
+		}
+
+		DBUG_EXECUTE_IF("fts_instrument_sync_before_syncing",
+			os_thread_sleep(300000););
+
+		index_cache->index->index_fts_syncing = true;
+
+		error = fts_sync_index(sync, index_cache, words);
+
+		if (error != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	return(error);
+}
+
 /** Run SYNC on the table, i.e., write out data from the cache to the
 FTS auxiliary INDEX table and clear the cache at the end.
 @param[in,out]	sync		sync state
@@ -4784,6 +4993,11 @@ fts_sync(
 
 	sync->unlock_cache = unlock_cache;
 	sync->in_progress = true;
+	os_event_reset(sync->event);
+
+	/* Whether the frozen words of a SYNC that was rolled back are
+	written again */
+	const bool	retry = cache->frozen_heap != NULL;
 
 	DEBUG_SYNC_C("fts_sync_begin");
 	fts_sync_begin(sync);
@@ -4795,49 +5009,39 @@ fts_sync(
 		sync->trx->dict_operation_lock_mode = RW_S_LATCH;
 	}
 
-	do {
-		if (cache->total_size > fts_max_cache_size) {
-			/* Avoid the case: sync never finish when
-			insert/update keeps comming. */
-			ut_ad(sync->unlock_cache);
-			sync->unlock_cache = false;
-		}
-
-		for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
-			fts_index_cache_t*	index_cache;
+	/* The documents that are added while the frozen words are
+	written go to new words, so the frozen words are written in one
+	pass however long it takes. */
+	error = fts_sync_indexes(sync, true);
 
-			index_cache = static_cast<fts_index_cache_t*>(
-				ib_vector_get(cache->indexes, i));
-
-			if (index_cache->index->to_be_dropped
-			    || index_cache->index->table->to_be_dropped) {
-				continue;
-			}
-
-			DBUG_EXECUTE_IF("fts_instrument_sync_before_syncing",
-				os_thread_sleep(300000););
-
-			index_cache->index->index_fts_syncing = true;
-
-			error = fts_sync_index(sync, index_cache);
-
-			if (error != DB_SUCCESS) {
-				break;
-			}
-		}
+	DBUG_EXECUTE_IF("fts_instrument_sync_interrupted",
+			sync->interrupted = true;
+			error = DB_INTERRUPTED;
+	);
 
-		DBUG_EXECUTE_IF("fts_instrument_sync_interrupted",
-				sync->interrupted = true;
-				error = DB_INTERRUPTED;
-		);
+	/* A transaction that got its doc ids before the words were frozen
+	may have added its documents to the new words meanwhile. The
+	synced doc id is going to cover those documents, so write all the
+	new words too, as SYNC did before it froze the words. A retry
+	writes everything as well, so that the cache is not left behind. */
+	const bool	all = error == DB_SUCCESS && !sync->interrupted
+		&& (retry
+		    || (sync->min_doc_id != FTS_NULL_DOC_ID
+			&& sync->min_doc_id <= sync->frozen_max_doc_id));
+
+	if (all) {
+		/* Avoid the case: sync never finish when
+		insert/update keeps comming. */
+		sync->unlock_cache = false;
 
-		if (error != DB_SUCCESS) {
-			break;
-		}
-	} while (!fts_check_all_indexes_synced(sync));
+		do {
+			error = fts_sync_indexes(sync, false);
+		} while (error == DB_SUCCESS
+			 && !fts_check_all_indexes_synced(sync));
+	}
 
 	if (error == DB_SUCCESS && !sync->interrupted) {
-		error = fts_sync_commit(sync);
+		error = fts_sync_commit(sync, all);
 	} else {
 		fts_sync_rollback(sync);
 	}
@@ -5782,6 +5986,8 @@ const ib_vector_t*
 fts_cache_find_word(
 /*================*/
 	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const ib_rbt_t*		words,		/*!< in: index_cache->words or
+						index_cache->frozen_words */
 	const fts_string_t*	text)		/*!< in: word to search for */
 {
 	ib_rbt_bound_t		parent;
@@ -5794,7 +6000,7 @@ fts_cache_find_word(
 #endif /* UNIV_DEBUG */
 
 	/* Lookup the word in the rb tree */
-	if (rbt_search(index_cache->words, &parent, text) == 0) {
+	if (rbt_search(words, &parent, text) == 0) {
 		const fts_tokenizer_word_t*	word;
 
 		word = rbt_value(fts_tokenizer_word_t, parent.last);
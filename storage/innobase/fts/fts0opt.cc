@@ -2820,7 +2820,8 @@ fts_is_sync_needed(
 
 		if (slot->state != FTS_STATE_EMPTY && slot->table
 		    && slot->table->fts && slot->table->fts->cache) {
-			total_memory += slot->table->fts->cache->total_size;
+			total_memory += slot->table->fts->cache->total_size
+				+ slot->table->fts->cache->frozen_size;
 		}
 
 		if (total_memory > fts_max_total_cache_size) {
@@ -1025,6 +1025,8 @@ fts_cache_find_wildcard(
 /*====================*/
 	fts_query_t*		query,		/*!< in: query instance */
 	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const ib_rbt_t*		words,		/*!< in: index_cache->words or
+						index_cache->frozen_words */
 	const fts_string_t*	token)		/*!< in: token to search */
 {
 	ib_rbt_bound_t		parent;
@@ -1042,7 +1044,7 @@ fts_cache_find_wildcard(
 	srch_text.f_str = term;
 
 	/* Lookup the word in the rb tree */
-	if (rbt_search_cmp(index_cache->words, &parent, &srch_text, NULL,
+	if (rbt_search_cmp(words, &parent, &srch_text, NULL,
 			   innobase_fts_text_cmp_prefix) == 0) {
 		const fts_tokenizer_word_t*     word;
 		ulint				i;
@@ -1089,12 +1091,10 @@ fts_cache_find_wildcard(
 			num_word++;
 
 			if (!forward) {
-				cur_node = rbt_prev(
-					index_cache->words, cur_node);
+				cur_node = rbt_prev(words, cur_node);
 			} else {
 cont_search:
-				cur_node = rbt_next(
-					index_cache->words, cur_node);
+				cur_node = rbt_next(words, cur_node);
 			}
 
 			if (!cur_node) {
@@ -1114,6 +1114,51 @@ cont_search:
 	return(num_word);
 }
 
+/*****************************************************************//**
+Search the index cache for a token: both the words that SYNC is writing
+and the words that were added after SYNC froze them. */
+static
+void
+fts_query_search_cache(
+/*===================*/
+	fts_query_t*		query,		/*!< in/out: query instance */
+	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const fts_string_t*	token,		/*!< in: token to search */
+	bool			wildcard)	/*!< in: whether to match
+						the token as a prefix */
+{
+	const ib_rbt_t*	words[] = {
+		index_cache->frozen_words, index_cache->words
+	};
+
+	for (ulint j = 0; j < UT_ARR_SIZE(words)
+	     && query->error == DB_SUCCESS; ++j) {
+
+		if (words[j] == NULL) {
+			continue;
+		}
+
+		if (wildcard) {
+			fts_cache_find_wildcard(
+				query, index_cache, words[j], token);
+			continue;
+		}
+
+		const ib_vector_t*	nodes = fts_cache_find_word(
+			index_cache, words[j], token);
+
+		for (ulint i = 0; nodes && i < ib_vector_size(nodes)
+		     && query->error == DB_SUCCESS; ++i) {
+			const fts_node_t*	node;
+
+			node = static_cast<const fts_node_t*>(
+				ib_vector_get_const(nodes, i));
+
+			fts_query_check_node(query, token, node);
+		}
+	}
+}
+
 /*****************************************************************//**
 Set difference.
 @return DB_SUCCESS if all go well */
@@ -1145,9 +1190,7 @@ fts_query_difference(
 
 	/* There is nothing we can substract from an empty set. */
 	if (query->doc_ids && !rbt_empty(query->doc_ids)) {
-		ulint			i;
 		fts_fetch_t		fetch;
-		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
 		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
@@ -1161,23 +1204,11 @@ fts_query_difference(
 		ut_a(index_cache != NULL);
 
 		/* Search the cache for a matching word first. */
-		if (query->cur_node->term.wildcard
-		    && query->flags != FTS_PROXIMITY
-		    && query->flags != FTS_PHRASE) {
-			fts_cache_find_wildcard(query, index_cache, token);
-		} else {
-			nodes = fts_cache_find_word(index_cache, token);
-
-			for (i = 0; nodes && i < ib_vector_size(nodes)
-			     && query->error == DB_SUCCESS; ++i) {
-				const fts_node_t*	node;
-
-				node = static_cast<const fts_node_t*>(
-					ib_vector_get_const(nodes, i));
-
-				fts_query_check_node(query, token, node);
-			}
-		}
+		fts_query_search_cache(
+			query, index_cache, token,
+			query->cur_node->term.wildcard
+			&& query->flags != FTS_PROXIMITY
+			&& query->flags != FTS_PHRASE);
 
 		rw_lock_x_unlock(&cache->lock);
 
@@ -1238,9 +1269,7 @@ fts_query_intersect(
 	we know the intersection set is empty in advance. */
 	if (!(rbt_empty(query->doc_ids) && query->multi_exist)) {
 		ulint                   n_doc_ids = 0;
-		ulint			i;
 		fts_fetch_t		fetch;
-		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
 		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
@@ -1286,22 +1315,9 @@ fts_query_intersect(
 		/* Must find the index cache. */
 		ut_a(index_cache != NULL);
 
-		if (query->cur_node->term.wildcard) {
-			/* Wildcard search the index cache */
-			fts_cache_find_wildcard(query, index_cache, token);
-		} else {
-			nodes = fts_cache_find_word(index_cache, token);
-
-			for (i = 0; nodes && i < ib_vector_size(nodes)
-			     && query->error == DB_SUCCESS; ++i) {
-				const fts_node_t*	node;
-
-				node = static_cast<const fts_node_t*>(
-					ib_vector_get_const(nodes, i));
-
-				fts_query_check_node(query, token, node);
-			}
-		}
+		fts_query_search_cache(
+			query, index_cache, token,
+			query->cur_node->term.wildcard);
 
 		rw_lock_x_unlock(&cache->lock);
 
@@ -1365,27 +1381,11 @@ fts_query_cache(
 	/* Must find the index cache. */
 	ut_a(index_cache != NULL);
 
-	if (query->cur_node->term.wildcard
-	    && query->flags != FTS_PROXIMITY
-	    && query->flags != FTS_PHRASE) {
-		/* Wildcard search the index cache */
-		fts_cache_find_wildcard(query, index_cache, token);
-	} else {
-		const ib_vector_t*      nodes;
-		ulint			i;
-
-		nodes = fts_cache_find_word(index_cache, token);
-
-		for (i = 0; nodes && i < ib_vector_size(nodes)
-		     && query->error == DB_SUCCESS; ++i) {
-			const fts_node_t*	node;
-
-			node = static_cast<const fts_node_t*>(
-				ib_vector_get_const(nodes, i));
-
-			fts_query_check_node(query, token, node);
-		}
-	}
+	fts_query_search_cache(
+		query, index_cache, token,
+		query->cur_node->term.wildcard
+		&& query->flags != FTS_PROXIMITY
+		&& query->flags != FTS_PHRASE);
 
 	rw_lock_x_unlock(&cache->lock);
 
@@ -3233,6 +3233,7 @@ fts_query_filter_doc_ids(
 	ibool			calc_doc_count)	/*!< in: whether to remember doc count */
 {
 	byte*		ptr = static_cast<byte*>(data);
+	const byte*	end = ptr + len;
 	doc_id_t	doc_id = 0;
 	ulint		decoded = 0;
 	ib_rbt_t*	doc_freqs = word_freq->doc_freqs;
@@ -3242,6 +3243,13 @@ fts_query_filter_doc_ids(
 		return(DB_SUCCESS);
 	}
 
+	/* When intersecting, the doc ids outside of [lower_doc_id,
+	upper_doc_id] cannot match, see fts_query_check_node(). Their
+	positions are skipped without decoding them, and if the doc
+	count is not needed, the decoding stops after upper_doc_id. */
+	const bool	in_range_only = query->oper == FTS_EXIST
+		&& !query->collect_positions;
+
 	/* Decode the ilist and add the doc ids to the query doc_id set. */
 	while (decoded < len) {
 		ulint		freq = 0;
@@ -3262,6 +3270,25 @@ fts_query_filter_doc_ids(
 			word_freq->doc_count++;
 		}
 
+		if (in_range_only
+		    && ((query->upper_doc_id > 0
+			 && doc_id > query->upper_doc_id)
+			|| (query->lower_doc_id > 0
+			    && doc_id < query->lower_doc_id))) {
+
+			if (!calc_doc_count
+			    && query->upper_doc_id > 0
+			    && doc_id > query->upper_doc_id) {
+				goto func_exit;
+			}
+
+			fts_skip_vlc_positions(&ptr, end);
+
+			decoded = ptr - (byte*) data;
+
+			goto next_doc;
+		}
+
 		/* We simply collect the matching instances here. */
 		if (query->collect_positions) {
 			ib_alloc_t*	heap_alloc;
@@ -3285,24 +3312,29 @@ fts_query_filter_doc_ids(
 		}
 
 		/* Unpack the positions within the document. */
-		while (*ptr) {
-			last_pos += fts_decode_vlc(&ptr);
+		if (query->collect_positions) {
+			while (*ptr) {
+				last_pos += fts_decode_vlc(&ptr);
 
-			/* Collect the matching word positions, for phrase
-			matching later. */
-			if (query->collect_positions) {
+				/* Collect the matching word positions, for
+				phrase matching later. */
 				ib_vector_push(match->positions, &last_pos);
-			}
 
-			++freq;
-		}
+				++freq;
+			}
 
-		/* End of list marker. */
-		last_pos = (ulint) -1;
+			/* End of list marker. */
+			last_pos = (ulint) -1;
 
-		if (query->collect_positions) {
 			ut_a(match != NULL);
 			ib_vector_push(match->positions, &last_pos);
+
+			/* Skip the end of word position marker. */
+			++ptr;
+		} else {
+			/* Only the number of positions is needed. This
+			also skips the end of word position marker. */
+			freq = fts_skip_vlc_positions(&ptr, end);
 		}
 
 		/* Add the doc id to the doc freq rb tree, if the doc id
@@ -3314,9 +3346,6 @@ fts_query_filter_doc_ids(
 			doc_freq->freq = freq;
 		}
 
-		/* Skip the end of word position marker. */
-		++ptr;
-
 		/* Bytes decoded so far */
 		decoded = ptr - (byte*) data;
 
@@ -3330,6 +3359,7 @@ fts_query_filter_doc_ids(
 			fts_query_add_word_to_document(query, doc_id, word);
 		}
 
+next_doc:
 		if (query->limit != ULONG_UNDEFINED
 		    && query->limit <= ++query->n_docs) {
 			goto func_exit;
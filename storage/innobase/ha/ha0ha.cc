@@ -333,6 +333,38 @@ ha_btr_search_latch_x_locked(const hash_table_t* table)
 }
 #endif /* UNIV_DEBUG */
 
+/** Wait for the adaptive hash index lookups that do not hold the partition
+latch, if HASH_DELETE_AND_COMPACT() is about to free the last block of the
+heap of the partition.
+@param[in]	table	hash table of an adaptive hash index partition
+@param[in]	fold	fold value of the node to be deleted */
+static
+void
+ha_wait_for_readers_if_free_block(
+	hash_table_t*	table,
+	ulint		fold)
+{
+	mem_heap_t*		heap = hash_get_heap(table, fold);
+	mem_block_t*		block = UT_LIST_GET_LAST(heap->base);
+
+	/* See mem_heap_free_top() */
+	if (block == heap
+	    || mem_block_get_free(block) - MEM_SPACE_NEEDED(sizeof(ha_node_t))
+	    != mem_block_get_start(block)) {
+
+		return;
+	}
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		if (btr_search_sys->hash_tables[i] == table) {
+			btr_search_wait_for_readers(i);
+			return;
+		}
+	}
+
+	ut_ad(0);
+}
+
 /***********************************************************//**
 Deletes a hash node. */
 void
@@ -353,6 +385,8 @@ ha_delete_hash_node(
 	}
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
+	ha_wait_for_readers_if_free_block(table, del_node->fold);
+
 	HASH_DELETE_AND_COMPACT(ha_node_t, next, table, del_node);
 }
 
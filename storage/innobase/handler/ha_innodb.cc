@@ -308,6 +308,22 @@ static TYPELIB innodb_default_row_format_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_lock_schedule_algorithm". */
+static const char* innodb_lock_schedule_algorithm_names[] = {
+	"fcfs",
+	"cats",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_lock_schedule_algorithm. */
+static TYPELIB innodb_lock_schedule_algorithm_typelib = {
+	array_elements(innodb_lock_schedule_algorithm_names) - 1,
+	"innodb_lock_schedule_algorithm_typelib",
+	innodb_lock_schedule_algorithm_names,
+	NULL
+};
+
 /* The following counter is used to convey information to InnoDB
 about server activity: in case of normal DML ops it is not
 sensible to call srv_active_wake_master_thread after each
@@ -395,6 +411,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(recalc_pool_mutex),
 	PSI_KEY(file_format_max_mutex),
 	PSI_KEY(fil_system_mutex),
+	PSI_KEY(fil_shard_mutex),
 	PSI_KEY(flush_list_mutex),
 	PSI_KEY(fts_bg_threads_mutex),
 	PSI_KEY(fts_delete_mutex),
@@ -434,7 +451,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(trx_pool_mutex),
 	PSI_KEY(trx_pool_manager_mutex),
 	PSI_KEY(srv_sys_mutex),
-	PSI_KEY(lock_mutex),
+	PSI_KEY(lock_sys_shard_mutex),
 	PSI_KEY(lock_wait_mutex),
 	PSI_KEY(trx_mutex),
 	PSI_KEY(srv_threads_mutex),
@@ -447,6 +464,8 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(rtr_path_mutex),
 	PSI_KEY(rtr_ssn_mutex),
 	PSI_KEY(trx_sys_mutex),
+	PSI_KEY(mvcc_view_mutex),
+	PSI_KEY(trx_sys_shard_mutex),
 	PSI_KEY(thread_mutex),
 	PSI_KEY(sync_array_mutex),
 	PSI_KEY(zip_pad_mutex),
@@ -475,6 +494,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(fts_cache_init_rw_lock),
 	PSI_RWLOCK_KEY(trx_i_s_cache_lock),
 	PSI_RWLOCK_KEY(trx_purge_latch),
+	PSI_RWLOCK_KEY(lock_sys_latch),
 	PSI_RWLOCK_KEY(index_tree_rw_lock),
 	PSI_RWLOCK_KEY(index_online_log),
 	PSI_RWLOCK_KEY(dict_table_stats),
@@ -489,15 +509,22 @@ is defined */
 static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(buf_dump_thread),
 	PSI_KEY(dict_stats_thread),
+	PSI_KEY(dict_stats_analyze_thread),
+	PSI_KEY(fil_dir_cache_thread),
 	PSI_KEY(io_handler_thread),
 	PSI_KEY(io_ibuf_thread),
 	PSI_KEY(io_log_thread),
 	PSI_KEY(io_read_thread),
 	PSI_KEY(io_write_thread),
+	PSI_KEY(log_flusher_thread),
+	PSI_KEY(log_notifier_thread),
+	PSI_KEY(log_writer_thread),
 	PSI_KEY(page_cleaner_thread),
+	PSI_KEY(recv_apply_thread),
 	PSI_KEY(recv_writer_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_lock_timeout_thread),
+	PSI_KEY(srv_lock_deadlock_thread),
 	PSI_KEY(srv_master_thread),
 	PSI_KEY(srv_monitor_thread),
 	PSI_KEY(srv_purge_thread),
@@ -806,6 +833,17 @@ static MYSQL_THDVAR_STR(tmpdir,
   "Directory for temporary non-tablespace files.",
   innodb_tmpdir_validate, NULL, NULL);
 
+static MYSQL_THDVAR_ULONG(ddl_threads, PLUGIN_VAR_RQCMDARG,
+  "Maximum number of threads that read the table for, sort and load"
+  " the secondary indexes built by ALTER TABLE and OPTIMIZE TABLE"
+  " (default 1).",
+  NULL, NULL, 1, 1, 64, 0);
+
+static MYSQL_THDVAR_ULONG(parallel_read_threads, PLUGIN_VAR_RQCMDARG,
+  "Maximum number of threads that read the clustered index for"
+  " SELECT COUNT(*) and CHECK TABLE (default 1).",
+  NULL, NULL, 1, 1, 256, 0);
+
 static SHOW_VAR innodb_status_variables[]= {
   {"buffer_pool_dump_status",
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR, SHOW_SCOPE_GLOBAL},
@@ -1700,6 +1738,28 @@ thd_innodb_tmpdir(
 	return(tmp_dir);
 }
 
+/** Get the value of innodb_ddl_threads.
+@param[in]	thd	thread handle, or NULL to query
+			the global innodb_ddl_threads
+@return maximum number of threads that build the indexes of a table */
+ulint
+thd_ddl_threads(
+	THD*	thd)
+{
+	return(THDVAR(thd, ddl_threads));
+}
+
+/** Get the value of innodb_parallel_read_threads.
+@param[in]	thd	thread handle, or NULL to query
+			the global innodb_parallel_read_threads
+@return maximum number of threads that read a clustered index */
+ulint
+thd_parallel_read_threads(
+	THD*	thd)
+{
+	return(THDVAR(thd, parallel_read_threads));
+}
+
 /** Obtain the private handler of InnoDB session specific data.
 @param[in,out]	thd	MySQL thread handler.
 @return reference to private handler */
@@ -2793,6 +2853,24 @@ innobase_copy_frm_flags_from_create_info(
 	innodb_table->stats_sample_pages = create_info->stats_sample_pages;
 }
 
+/** Determine the codec of the pages of a ROW_FORMAT=COMPRESSED table.
+@param[in]	algorithm	COMPRESSION attribute of the table, or NULL
+@return the codec; PAGE_ZIP_CODEC_ZLIB unless LZ4 was requested */
+page_zip_codec_t
+innobase_zip_codec(
+	const char*	algorithm)
+{
+	Compression	compression;
+
+	if (Compression::check(algorithm, &compression) == DB_SUCCESS
+	    && compression.m_type == Compression::LZ4) {
+
+		return(PAGE_ZIP_CODEC_LZ4);
+	}
+
+	return(PAGE_ZIP_CODEC_ZLIB);
+}
+
 /*********************************************************************//**
 Copy table flags from MySQL's TABLE_SHARE into an InnoDB table object.
 Those flags are stored in .frm file and end up in the MySQL table object,
@@ -3759,6 +3837,13 @@ innobase_init(
 		DBUG_RETURN(innobase_init_abort());
 	}
 
+	/* ------------ Doublewrite files ---------------------------*/
+	if (!srv_doublewrite_dir) {
+		srv_doublewrite_dir = default_path;
+	}
+
+	os_normalize_path(srv_doublewrite_dir);
+
 	/* -------------- All log files ---------------------------*/
 
 	/* The default dir for log files is the datadir of MySQL */
@@ -4948,6 +5033,13 @@ ha_innobase::table_flags() const
 		flags &= ~(HA_INNOPART_DISABLED_TABLE_FLAGS);
 	}
 
+	/* Let records() count the rows for SELECT COUNT(*) when it can
+	use several threads; a single thread is no faster than the
+	table scan of the server. */
+	if (thd_parallel_read_threads(thd) > 1) {
+		flags |= HA_HAS_RECORDS;
+	}
+
 	/* Need to use tx_isolation here since table flags is (also)
 	called before prebuilt is inited. */
 
@@ -10327,7 +10419,9 @@ err_col:
 
 		if (!(m_flags2 & DICT_TF2_USE_FILE_PER_TABLE)
 		    && m_create_info->compress.length > 0
-		    && !Compression::is_none(algorithm)) {
+		    && !Compression::is_none(algorithm)
+		    && m_form->s->row_type != ROW_TYPE_COMPRESSED
+		    && m_create_info->key_block_size == 0) {
 
 			push_warning_printf(
 				m_thd,
@@ -10972,18 +11066,21 @@ create_table_info_t::create_option_compression_is_valid()
 		return(true);
 	}
 
-	static char intro[] = "InnoDB: Page Compression is not supported";
+	/* With ROW_FORMAT=COMPRESSED, the algorithm is the codec of the
+	compressed pages. Any tablespace supports zlib. The other codecs
+	are flagged in the tablespace, which must be file-per-table. */
+	const bool	zip = m_create_info->key_block_size != 0
+		|| m_create_info->row_type == ROW_TYPE_COMPRESSED;
 
-	if (m_create_info->key_block_size != 0
-	    || m_create_info->row_type == ROW_TYPE_COMPRESSED) {
-		push_warning_printf(
-			m_thd, Sql_condition::SL_WARNING,
-			ER_UNSUPPORTED_EXTENSION,
-			"%s with row_format=compressed or"
-			" key_block_size > 0", intro);
-		return(false);
+	if (zip && compression.m_type != Compression::LZ4) {
+		return(true);
 	}
 
+	const char*	intro = zip
+		? "InnoDB: COMPRESSION='lz4' with ROW_FORMAT=COMPRESSED"
+		  " is not supported"
+		: "InnoDB: Page Compression is not supported";
+
 	if (m_create_info->options & HA_LEX_CREATE_TMP_TABLE) {
 		push_warning_printf(
 			m_thd, Sql_condition::SL_WARNING,
@@ -11620,6 +11717,18 @@ index_bad:
 	dict_tf_set(&m_flags, innodb_row_format, zip_ssize,
 	            m_use_data_dir, m_use_shared_space);
 
+	/* With ROW_FORMAT=COMPRESSED, COMPRESSION chooses the codec of
+	the compressed pages. Other codecs than zlib are only used in
+	file-per-table tablespaces, which are flagged with the codec. */
+	if (zip_ssize != 0
+	    && m_use_file_per_table
+	    && !(m_create_info->options & HA_LEX_CREATE_TMP_TABLE)
+	    && innobase_zip_codec(m_create_info->compress.str)
+	    != PAGE_ZIP_CODEC_ZLIB) {
+
+		m_flags |= DICT_TF_MASK_ZIP_CODEC;
+	}
+
 	if (m_use_file_per_table) {
 		ut_ad(!m_use_shared_space);
 		m_flags2 |= DICT_TF2_USE_FILE_PER_TABLE;
@@ -13455,12 +13564,7 @@ ha_innobase::rename_table(
 
 
 
-#ifdef WL6742
-
 /*********************************************************************//**
-
-Removing WL6742  as part of Bug23046302
-
 Returns the exact number of records that this client can see using this
 handler object.
 @return Error code in case something goes wrong.
@@ -13528,16 +13632,30 @@ ha_innobase::records(
 		DBUG_RETURN(HA_ERR_TABLE_DEF_CHANGED);
 	}
 
-	/* (Re)Build the m_prebuilt->mysql_template if it is null to use
-	the clustered index and just the key, no off-record data. */
-	m_prebuilt->index = index;
-	dtuple_set_n_fields(m_prebuilt->search_tuple, 0);
-	m_prebuilt->read_just_key = 1;
-	build_template(false);
+	if (m_prebuilt->select_lock_type == LOCK_NONE) {
+		/* Count the records in the clustered index in the read
+		view of the transaction, using several threads. */
+		trx_start_if_not_started_xa(m_prebuilt->trx, false);
+
+		ret = row_scan_clust_index_parallel(
+			m_prebuilt->trx, index,
+			thd_parallel_read_threads(m_user_thd), false, &n_rows);
+	} else {
+		/* (Re)Build the m_prebuilt->mysql_template if it is null
+		to use the clustered index and just the key, no off-record
+		data. */
+		m_prebuilt->index = index;
+		dtuple_set_n_fields(m_prebuilt->search_tuple, 0);
+		m_prebuilt->read_just_key = 1;
+		build_template(false);
+
+		/* Count the records in the clustered index, acquiring
+		the locks of the statement. */
+		ret = row_scan_index_for_mysql(
+			m_prebuilt, index, false, &n_rows);
+		reset_template();
+	}
 
-	/* Count the records in the clustered index */
-	ret = row_scan_index_for_mysql(m_prebuilt, index, false, &n_rows);
-	reset_template();
 	switch (ret) {
 	case DB_SUCCESS:
 		break;
@@ -13567,7 +13685,6 @@ ha_innobase::records(
 	*num_rows= n_rows;
 	DBUG_RETURN(0);
 }
-#endif
 
 /*********************************************************************//**
 Estimates the number of index records in a range.
@@ -14771,9 +14888,18 @@ ha_innobase::check(
 		/* Scan this index. */
 		if (dict_index_is_spatial(index)) {
 			ret = row_count_rtree_recs(m_prebuilt, &n_rows);
+		} else if (dict_index_is_clust(index)
+			   && thd_parallel_read_threads(thd) > 1) {
+			/* The secondary indexes are scanned by a single
+			thread, in the same read view. */
+			trx_start_if_not_started_xa(m_prebuilt->trx, false);
+
+			ret = row_scan_clust_index_parallel(
+				m_prebuilt->trx, index,
+				thd_parallel_read_threads(thd), true, &n_rows);
 		} else {
 			ret = row_scan_index_for_mysql(
-				m_prebuilt, index, &n_rows);
+				m_prebuilt, index, true, &n_rows);
 		}
 
 		DBUG_EXECUTE_IF(
@@ -15880,11 +16006,7 @@ ha_innobase::external_lock(
 		} else if (trx->isolation_level <= TRX_ISO_READ_COMMITTED
 			   && MVCC::is_view_active(trx->read_view)) {
 
-			mutex_enter(&trx_sys->mutex);
-
 			trx_sys->mvcc->view_close(trx->read_view, true);
-
-			mutex_exit(&trx_sys->mutex);
 		}
 	}
 
@@ -16547,11 +16669,7 @@ ha_innobase::store_lock(
 			/* At low transaction isolation levels we let
 			each consistent read set its own snapshot */
 
-			mutex_enter(&trx_sys->mutex);
-
 			trx_sys->mvcc->view_close(trx->read_view, true);
-
-			mutex_exit(&trx_sys->mutex);
 		}
 	}
 
@@ -19298,6 +19416,29 @@ buffer_pool_load_abort(
 	}
 }
 
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_dump_interval and wake up
+the buffer pool dump/load thread, so that it waits for the new interval.
+This function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_dump_interval_update(
+/*====================================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	srv_buf_dump_interval = *static_cast<const ulong*>(save);
+
+	if (!srv_read_only_mode) {
+		os_event_set(srv_buf_dump_event);
+	}
+}
+
 /****************************************************************//**
 Update the system variable innodb_log_write_ahead_size using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -19444,6 +19585,19 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   " Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_files, srv_doublewrite_files,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of doublewrite files outside the system tablespace, each with"
+  " its own batch and single page segments. Buffer pool instances are"
+  " spread over the files, at most one file per instance. 0 (the default)"
+  " uses the doublewrite buffer in the system tablespace.",
+  NULL, NULL, 0, 0, MAX_BUFFER_POOLS, 0);
+
+static MYSQL_SYSVAR_STR(doublewrite_dir, srv_doublewrite_dir,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Directory where the doublewrite files live, this path can be absolute.",
+  NULL, NULL, NULL);
+
 static MYSQL_SYSVAR_BOOL(stats_include_delete_marked,
   srv_stats_include_delete_marked,
   PLUGIN_VAR_OPCMDARG,
@@ -19512,6 +19666,13 @@ static MYSQL_SYSVAR_ULONG(purge_batch_size, srv_purge_batch_size,
   1,			/* Minimum value */
   5000, 0);		/* Maximum value */
 
+static MYSQL_SYSVAR_BOOL(adaptive_purge_batch_size,
+  srv_adaptive_purge_batch_size,
+  PLUGIN_VAR_OPCMDARG,
+  "Purge up to 8 times innodb_purge_batch_size UNDO log pages in a batch"
+  " while the history list grows (default OFF).",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Purge threads can be from 1 to 32. Default is 4.",
@@ -19615,6 +19776,15 @@ static MYSQL_SYSVAR_ULONG(page_cleaners, srv_n_page_cleaners,
   "Page cleaner threads can be from 1 to 64. Default is 4.",
   NULL, NULL, 4, 1, 64, 0);
 
+static MYSQL_SYSVAR_BOOL(page_cleaner_per_instance,
+  srv_page_cleaner_per_instance,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use one page cleaner thread per buffer pool instance, each flushing"
+  " its instance with its own adaptive flushing target and placed on the"
+  " NUMA node of the instance, instead of flushing all instances in rounds"
+  " (overrides innodb_page_cleaners).",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_DOUBLE(max_dirty_pages_pct, srv_max_buf_pool_modified_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of dirty pages allowed in bufferpool.",
@@ -19703,6 +19873,20 @@ static MYSQL_SYSVAR_BOOL(stats_auto_recalc, srv_stats_auto_recalc,
   " new statistics)",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(stats_auto_recalc_incremental,
+  srv_stats_auto_recalc_incremental,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether the automatic recalculation of persistent statistics keeps the"
+  " statistics of the secondary indexes that were not modified much since"
+  " they were calculated",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONG(stats_analyze_threads, srv_stats_analyze_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that analyze the indexes of a table when calculating"
+  " persistent statistics",
+  NULL, NULL, 1, 1, DICT_STATS_MAX_ANALYZE_THREADS, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   srv_stats_persistent_sample_pages,
   PLUGIN_VAR_RQCMDARG,
@@ -19724,6 +19908,13 @@ static MYSQL_SYSVAR_ULONG(adaptive_hash_index_parts, btr_ahi_parts,
   "Number of InnoDB Adapative Hash Index Partitions. (default = 8). ",
   NULL, NULL, 8, 1, 512, 0);
 
+static MYSQL_SYSVAR_BOOL(adaptive_hash_index_lock_free, btr_search_lock_free,
+  PLUGIN_VAR_OPCMDARG,
+  "Look up the InnoDB adaptive hash index without acquiring the partition"
+  " latch, retrying under the latch only after a concurrent modification"
+  " (disabled by default).",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
   PLUGIN_VAR_RQCMDARG,
   "Replication thread delay (ms) on the slave server if"
@@ -19826,6 +20017,12 @@ static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
   "Dump only the hottest N% of each buffer pool, defaults to 25",
   NULL, NULL, 25, 1, 100, 0);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the buffer pool every N seconds, 0 (the default) disables"
+  " periodic dumps",
+  NULL, innodb_buffer_pool_dump_interval_update, 0, 0, 86400, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   PLUGIN_VAR_RQCMDARG,
@@ -19849,6 +20046,11 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_st
   "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_buf_load_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the pages of a buffer pool load",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(lru_scan_depth, srv_LRU_scan_depth,
   PLUGIN_VAR_RQCMDARG,
   "How deep to scan LRU to keep it clean",
@@ -19879,6 +20081,25 @@ static MYSQL_SYSVAR_BOOL(deadlock_detect, innobase_deadlock_detect,
   " and we rely on innodb_lock_wait_timeout in case of deadlock.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(deadlock_detect_async,
+  innobase_deadlock_detect_async,
+  PLUGIN_VAR_NOCMDARG,
+  "Enable/disable detecting deadlocks in a background thread (default OFF)."
+  " If set to ON, a transaction that has to wait for a lock does not search"
+  " for deadlocks itself, and a background thread periodically resolves"
+  " the deadlocks among the waiting transactions.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ENUM(lock_schedule_algorithm,
+  innobase_lock_schedule_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "The algorithm for granting a released record lock to the waiting"
+  " transactions. Possible values are FCFS (default), grant in the order"
+  " of the lock queue, and CATS, grant first to the transaction that"
+  " blocks the most other transactions.",
+  NULL, NULL, LOCK_SCHEDULE_FCFS,
+  &innodb_lock_schedule_algorithm_typelib);
+
 static MYSQL_SYSVAR_LONG(fill_factor, innobase_fill_factor,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of B-tree page filled during bulk insert",
@@ -19972,6 +20193,12 @@ static MYSQL_SYSVAR_ULONG(force_recovery_crash, srv_force_recovery_crash,
   NULL, NULL, 0, 0, 100, 0);
 #endif /* !NDEBUG */
 
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_recovery_apply_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that apply redo log records to pages during"
+  " crash recovery.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(page_size, srv_page_size,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Page size to use for all InnoDB tablespaces.",
@@ -20000,6 +20227,27 @@ static MYSQL_SYSVAR_ULONG(log_write_ahead_size, srv_log_write_ahead_size,
   NULL, innodb_log_write_ahead_size_update,
   8*1024L, OS_FILE_LOG_BLOCK_SIZE, UNIV_PAGE_SIZE_DEF, OS_FILE_LOG_BLOCK_SIZE);
 
+static MYSQL_SYSVAR_BOOL(log_concurrent_copy, srv_log_concurrent_copy,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether mini-transactions only reserve space in the redo log buffer"
+  " while holding the log mutex, and copy their log records after"
+  " releasing it.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Whether the redo log is written and flushed by dedicated log writer"
+  " and flusher threads, with committing threads only waiting for them.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(flush_list_relaxed_order,
+  srv_flush_list_relaxed_order,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Whether mini-transactions add their dirty pages to the flush lists"
+  " without serializing on the flush order mutex, keeping the flush lists"
+  " ordered by oldest modification only up to a bounded lag.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_UINT(old_blocks_pct, innobase_old_blocks_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of the buffer pool to reserve for 'old' blocks.",
@@ -20131,6 +20379,21 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO on Linux, if the kernel"
+  " supports it. The buffer pool memory is registered with io_uring if"
+  " the locked memory limit allows it.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(tablespace_cache, srv_tablespace_cache,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Write the id, name, flags, size and path of the file-per-table"
+  " tablespaces to the file ib_tablespaces at shutdown, and at startup"
+  " register the tablespaces found in it without opening their files."
+  " The files are validated on first access and by a background thread.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -20220,6 +20483,19 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   " trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(undo_read_ahead, srv_undo_read_ahead,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of undo log pages that a consistent read reads ahead when an"
+  " undo log page is not in the buffer pool (0 disables undo read-ahead).",
+  NULL, NULL, 0, 0, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(version_cache_size, srv_version_cache_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum size in bytes of the old record versions that each read view"
+  " caches for consistent reads (0 disables the cache). Takes effect for"
+  " read views that are created afterwards.",
+  NULL, NULL, 0, 0, 1024 * 1024 * 1024L, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
   PLUGIN_VAR_RQCMDARG,
   "Turn on a monitor counter",
@@ -20358,12 +20634,14 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
   MYSQL_SYSVAR(buffer_pool_load_now),
   MYSQL_SYSVAR(buffer_pool_load_abort),
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
   MYSQL_SYSVAR(lru_scan_depth),
   MYSQL_SYSVAR(flush_neighbors),
   MYSQL_SYSVAR(checksum_algorithm),
@@ -20376,6 +20654,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_files),
+  MYSQL_SYSVAR(doublewrite_dir),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(api_enable_binlog),
   MYSQL_SYSVAR(api_enable_mdl),
@@ -20394,6 +20674,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #ifndef NDEBUG
   MYSQL_SYSVAR(force_recovery_crash),
 #endif /* !NDEBUG */
+  MYSQL_SYSVAR(recovery_apply_threads),
   MYSQL_SYSVAR(fill_factor),
   MYSQL_SYSVAR(ft_cache_size),
   MYSQL_SYSVAR(ft_total_cache_size),
@@ -20408,11 +20689,16 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
   MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(deadlock_detect_async),
+  MYSQL_SYSVAR(lock_schedule_algorithm),
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_write_ahead_size),
+  MYSQL_SYSVAR(log_concurrent_copy),
+  MYSQL_SYSVAR(log_writer_threads),
+  MYSQL_SYSVAR(flush_list_relaxed_order),
   MYSQL_SYSVAR(log_group_home_dir),
   MYSQL_SYSVAR(log_compressed_pages),
   MYSQL_SYSVAR(max_dirty_pages_pct),
@@ -20439,8 +20725,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
   MYSQL_SYSVAR(stats_auto_recalc),
+  MYSQL_SYSVAR(stats_auto_recalc_incremental),
+  MYSQL_SYSVAR(stats_analyze_threads),
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(adaptive_hash_index_parts),
+  MYSQL_SYSVAR(adaptive_hash_index_lock_free),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
@@ -20455,9 +20744,13 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(adaptive_max_sleep_delay),
   MYSQL_SYSVAR(thread_sleep_delay),
   MYSQL_SYSVAR(tmpdir),
+  MYSQL_SYSVAR(ddl_threads),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
+  MYSQL_SYSVAR(tablespace_cache),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -20469,16 +20762,20 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(undo_read_ahead),
+  MYSQL_SYSVAR(version_cache_size),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(io_capacity),
   MYSQL_SYSVAR(io_capacity_max),
   MYSQL_SYSVAR(page_cleaners),
+  MYSQL_SYSVAR(page_cleaner_per_instance),
   MYSQL_SYSVAR(monitor_enable),
   MYSQL_SYSVAR(monitor_disable),
   MYSQL_SYSVAR(monitor_reset),
   MYSQL_SYSVAR(monitor_reset_all),
   MYSQL_SYSVAR(purge_threads),
   MYSQL_SYSVAR(purge_batch_size),
+  MYSQL_SYSVAR(adaptive_purge_batch_size),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(background_drop_list_empty),
   MYSQL_SYSVAR(purge_run_now),
@@ -213,10 +213,7 @@ public:
 
 	void position(uchar *record);
 
-#ifdef WL6742
-	/* Removing WL6742 as part of Bug #23046302 */
 	virtual int records(ha_rows* num_rows);
-#endif
 	ha_rows records_in_range(
 		uint			inx,
 		key_range*		min_key,
@@ -1012,6 +1009,13 @@ innobase_copy_frm_flags_from_table_share(
 	dict_table_t*		innodb_table,	/*!< in/out: InnoDB table */
 	const TABLE_SHARE*	table_share);	/*!< in: table share */
 
+/** Determine the codec of the pages of a ROW_FORMAT=COMPRESSED table.
+@param[in]	algorithm	COMPRESSION attribute of the table, or NULL
+@return the codec; PAGE_ZIP_CODEC_ZLIB unless LZ4 was requested */
+page_zip_codec_t
+innobase_zip_codec(
+	const char*	algorithm);
+
 /** Set up base columns for virtual column
 @param[in]	table	the InnoDB table
 @param[in]	field	MySQL field
@@ -587,7 +587,9 @@ public:
 	Table_flags
 	table_flags() const
 	{
-		return(ha_innobase::table_flags() | HA_CAN_REPAIR);
+		/* records() would count a single partition. */
+		return((ha_innobase::table_flags() | HA_CAN_REPAIR)
+		       & ~HA_HAS_RECORDS);
 	}
 
 	void
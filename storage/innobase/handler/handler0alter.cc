@@ -599,6 +599,20 @@ ha_innobase::check_if_supported_inplace_alter(
 	update_thd();
 	trx_search_latch_release_if_reserved(m_prebuilt->trx);
 
+	/* The codec of ROW_FORMAT=COMPRESSED pages is a table flag,
+	which can only be changed by rebuilding the table. */
+	const bool	zip_codec =
+		dict_table_page_size(m_prebuilt->table).is_compressed()
+		&& dict_table_is_file_per_table(m_prebuilt->table)
+		&& innobase_zip_codec(altered_table->s->compress.str)
+		!= PAGE_ZIP_CODEC_ZLIB;
+
+	if (zip_codec != !!DICT_TF_GET_ZIP_CODEC(m_prebuilt->table->flags)
+	    && !innobase_need_rebuild(ha_alter_info)) {
+
+		DBUG_RETURN(HA_ALTER_INPLACE_NOT_SUPPORTED);
+	}
+
 	if (ha_alter_info->handler_flags
 	    & ~(INNOBASE_INPLACE_IGNORE
 		| INNOBASE_ALTER_NOREBUILD
@@ -4684,7 +4698,11 @@ prepare_inplace_alter_table_dict(
 
 		compression = ha_alter_info->create_info->compress.str;
 
-		if (Compression::validate(compression) != DB_SUCCESS) {
+		/* With ROW_FORMAT=COMPRESSED, the algorithm is the codec
+		of the compressed pages, which is a table flag and not
+		the page compression attribute of the tablespace. */
+		if (Compression::validate(compression) != DB_SUCCESS
+		    || dict_table_page_size(ctx->new_table).is_compressed()) {
 			compression = NULL;
 		}
 
@@ -3324,6 +3324,7 @@ i_s_fts_index_cache_fill_one_index(
 	TABLE*			table = (TABLE*) tables->table;
 	Field**			fields;
 	CHARSET_INFO*		index_charset;
+	const ib_rbt_t*		words;
 	const ib_rbt_node_t*	rbt_node;
 	fts_string_t		conv_str;
 	uint			dummy_errors;
@@ -3339,10 +3340,14 @@ i_s_fts_index_cache_fill_one_index(
 	conv_str.f_str = static_cast<byte*>(ut_malloc_nokey(conv_str.f_len));
 	conv_str.f_n_char = 0;
 
-	/* Go through each word in the index cache */
-	for (rbt_node = rbt_first(index_cache->words);
+	/* Go through each word in the index cache, starting with the words
+	that SYNC is writing */
+	words = index_cache->frozen_words != NULL
+		? index_cache->frozen_words : index_cache->words;
+next_words:
+	for (rbt_node = rbt_first(words);
 	     rbt_node;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 		fts_tokenizer_word_t* word;
 
 		word = rbt_value(fts_tokenizer_word_t, rbt_node);
@@ -3416,6 +3421,11 @@ i_s_fts_index_cache_fill_one_index(
 		}
 	}
 
+	if (words != index_cache->words) {
+		words = index_cache->words;
+		goto next_words;
+	}
+
 	ut_free(conv_str.f_str);
 
 	DBUG_RETURN(0);
@@ -41,6 +41,7 @@ Created 2/17/1996 Heikki Tuuri
 #include "btr0types.h"
 #include "mtr0mtr.h"
 #include "ha0ha.h"
+#include "ut0counter.h"
 
 /** Creates and initializes the adaptive search system at a database start.
 @param[in]	hash_size	hash table size. */
@@ -200,6 +201,18 @@ UNIV_INLINE
 void
 btr_search_x_unlock(const dict_index_t* index);
 
+/** X-Lock the latch of an adaptive hash index partition.
+@param[in]	part	partition number */
+UNIV_INLINE
+void
+btr_search_part_x_lock(ulint part);
+
+/** X-Unlock the latch of an adaptive hash index partition.
+@param[in]	part	partition number */
+UNIV_INLINE
+void
+btr_search_part_x_unlock(ulint part);
+
 /** Lock all search latches in exclusive mode. */
 UNIV_INLINE
 void
@@ -250,6 +263,77 @@ UNIV_INLINE
 void
 btr_search_s_unlock_all();
 
+/** Get the adaptive hash index partition of an index.
+A partition is selected using pair of index-id, space-id.
+@param[in]	index	index handler
+@return partition number */
+UNIV_INLINE
+ulint
+btr_get_search_part(const dict_index_t* index);
+
+/** Read the version of an adaptive hash index partition before
+looking it up without holding its latch.
+@param[in]	part	partition number
+@return version; odd if the partition is being modified */
+UNIV_INLINE
+ulint
+btr_search_version_read(ulint part);
+
+/** Check that an adaptive hash index partition has not been modified
+since btr_search_version_read() returned the given version.
+@param[in]	part	partition number
+@param[in]	version	version returned by btr_search_version_read()
+@return true if nothing read from the partition since then is stale */
+UNIV_INLINE
+bool
+btr_search_version_validate(ulint part, ulint version);
+
+/** Number of slots per adaptive hash index partition that count the
+lookups not holding the partition latch */
+#define BTR_SEARCH_READER_SLOTS	16
+
+struct btr_search_readers_t;
+
+/** Register a lookup of an adaptive hash index partition that does not
+hold the partition latch. Until btr_search_reader_exit(), no memory of the
+hash table of the partition is freed.
+@param[in]	part	partition number
+@return slot to pass to btr_search_reader_exit() */
+UNIV_INLINE
+btr_search_readers_t*
+btr_search_reader_enter(ulint part);
+
+/** Note that a lookup registered with btr_search_reader_enter() no longer
+accesses the hash table of the partition.
+@param[in,out]	slot	slot returned by btr_search_reader_enter() */
+UNIV_INLINE
+void
+btr_search_reader_exit(btr_search_readers_t* slot);
+
+/** Walk the hash chain of an adaptive hash index partition without
+acquiring the partition latch. The result must be validated with
+btr_search_version_validate(), because the partition may be modified
+concurrently; but no memory that is being read is freed meanwhile.
+@param[in]	part	partition number
+@param[in]	fold	fold value of the search tuple
+@param[out]	rec	record the hash index points to, or NULL
+@param[out]	version	version of the partition before the walk
+@return false if the lookup must be retried under the partition latch */
+bool
+btr_search_lookup_lock_free(
+	ulint		part,
+	ulint		fold,
+	const rec_t**	rec,
+	ulint*		version);
+
+/** Wait until the lookups of an adaptive hash index partition that do
+not hold the partition latch have completed. This must be done before
+freeing any memory of the hash table of the partition. Lookups that start
+meanwhile see the partition being modified and fall back to the latch.
+@param[in]	part	partition number, X-latched by the caller */
+void
+btr_search_wait_for_readers(ulint part);
+
 /** Get the latch based on index attributes.
 A latch is selected from an array of latches using pair of index-id, space-id.
 @param[in]	index	index handler
@@ -328,9 +412,38 @@ struct btr_search_sys_t{
 					to rec_t pointers on index pages */
 };
 
+/** Modification counter of an adaptive hash index partition.
+It is incremented when the partition latch is acquired in exclusive mode
+and again before it is released, so that it is odd while the hash table
+of the partition may be changing. Readers that do not hold the latch
+sample it before and after the lookup, like a sequence lock. */
+struct btr_search_version_t {
+	/** the counter, protected by the partition latch in X mode */
+	volatile ulint	n;
+	/** padding to keep partitions on separate cache lines */
+	byte		pad[CACHE_LINE_SIZE - sizeof(ulint)];
+};
+
+/** Number of adaptive hash index lookups in progress that do not hold
+the partition latch, in one of the BTR_SEARCH_READER_SLOTS slots of a
+partition */
+struct btr_search_readers_t {
+	/** the number of lookups, updated atomically */
+	volatile ulint	n;
+	/** padding to keep slots on separate cache lines */
+	byte		pad[CACHE_LINE_SIZE - sizeof(ulint)];
+};
+
 /** Latches protecting access to adaptive hash index. */
 extern rw_lock_t**		btr_search_latches;
 
+/** Versions of the adaptive hash index partitions. */
+extern btr_search_version_t*	btr_search_versions;
+
+/** Lookups in progress that do not hold the partition latch,
+BTR_SEARCH_READER_SLOTS slots for each partition. */
+extern btr_search_readers_t*	btr_search_readers;
+
 /** The adaptive hash index */
 extern btr_search_sys_t*	btr_search_sys;
 
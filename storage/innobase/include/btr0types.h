@@ -55,6 +55,10 @@ extern char	btr_search_enabled;
 /** Number of adaptive hash index partition. */
 extern ulong	btr_ahi_parts;
 
+/** Whether adaptive hash index lookups may be attempted without
+acquiring the partition latch. */
+extern char	btr_search_lock_free;
+
 /** The size of a reference to data stored on a different page.
 The reference is stored at the end of the prefix of the field
 in the index record. */
@@ -176,6 +176,9 @@ struct buf_pool_info_t{
 					without access */
 	ulint	n_page_get_delta;	/*!< num of buffer pool page gets since
 					last printout */
+	lsn_t	flush_lag;		/*!< current LSN minus the oldest
+					modification in the flush_list */
+	ulint	n_single_page_flushes;	/*!< buf_pool->n_single_page_flushes */
 
 	/* Buffer pool access stats */
 	double	page_made_young_rate;	/*!< page made young rate in pages
@@ -435,6 +438,26 @@ lsn_t
 buf_pool_get_oldest_modification(void);
 /*==================================*/
 
+/** Gets the smallest oldest_modification lsn of the pages in a buffer pool
+instance, not counting the pages of the system temporary tablespace.
+The caller must hold the flush list mutex of the instance.
+@param[in,out]	buf_pool	buffer pool instance
+@return oldest modification in the instance, zero if none */
+lsn_t
+buf_pool_get_oldest_modification_low(
+	buf_pool_t*	buf_pool);
+
+#ifdef HAVE_LIBNUMA
+/** Get the NUMA node of a buffer pool instance. With
+innodb_page_cleaner_per_instance, the page frames of the instance are
+preferably allocated on this node, and its page cleaner runs there.
+@param[in]	instance_no	buffer pool instance number
+@return NUMA node, or -1 if the instance is not placed on a node */
+int
+buf_pool_numa_node(
+	ulint	instance_no);
+#endif /* HAVE_LIBNUMA */
+
 /********************************************************************//**
 Allocates a buf_page_t descriptor. This function must succeed. In case
 of failure we assert in this function. */
@@ -2038,6 +2061,11 @@ struct buf_pool_stat_t{
 				buf_page_peek_if_too_old() */
 	ulint	LRU_bytes;	/*!< LRU size in bytes */
 	ulint	flush_list_bytes;/*!< flush_list size in bytes */
+	ulint	n_single_page_flushes;
+				/*!< number of single page flushes
+				by user threads that found no free
+				block, in
+				buf_flush_single_page_from_LRU() */
 };
 
 /** Statistics of buddy blocks of a given size. */
@@ -56,6 +56,17 @@ buf_calc_page_crc32(
 	const byte*	page,
 	bool		use_legacy_big_endian = false);
 
+/** Calculates the CRC32 checksums of several uncompressed pages, as
+buf_calc_page_crc32() would calculate them, but faster.
+@param[in]	pages		buffer pages
+@param[in]	n		number of pages
+@param[out]	checksums	checksum of each page */
+void
+buf_calc_page_crc32_batch(
+	const byte* const*	pages,
+	ulint			n,
+	uint32_t*		checksums);
+
 /********************************************************************//**
 Calculates a page checksum which is stored to the page when it is written
 to a file. Note that we must be careful to calculate the same value on
@@ -47,6 +47,26 @@ extern buf_dblwr_t*	buf_dblwr;
 /** Set to TRUE when the doublewrite buffer is being created */
 extern ibool		buf_dblwr_being_created;
 
+/** @name Doublewrite file header (innodb_doublewrite_files)
+The first page of a doublewrite file is the header, and the
+2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE pages after it are the slots:
+the first innodb_doublewrite_batch_size slots for batch flushes,
+the rest for single page flushes. */
+/* @{ */
+#define DBLWR_FILE_MAGIC	0	/*!< DBLWR_FILE_MAGIC_N */
+#define DBLWR_FILE_PAGE_SIZE	4	/*!< UNIV_PAGE_SIZE */
+#define DBLWR_FILE_N_SLOTS	8	/*!< number of slots after the
+					header page */
+#define DBLWR_FILE_MAGIC_N	0x64626C77	/*!< magic number */
+/* @} */
+
+/** Get the path of a doublewrite file.
+@param[in]	file_no	number of the doublewrite file
+@return own: path of the file; must be freed with ut_free() */
+char*
+buf_dblwr_file_path(
+	ulint	file_no);
+
 /****************************************************************//**
 Creates the doublewrite buffer to a new InnoDB installation. The header of the
 doublewrite buffer is placed on the trx system header page.
@@ -72,6 +92,11 @@ buf_dblwr_init_or_load_pages(
 void
 buf_dblwr_process(void);
 
+/** Free the pages that were loaded from the doublewrite files for
+recovery. They must not be referenced by recv_sys->dblwr any more. */
+void
+buf_dblwr_free_loaded_pages(void);
+
 /****************************************************************//**
 frees doublewrite buffer. */
 void
@@ -99,7 +124,11 @@ space to appear. */
 void
 buf_dblwr_add_to_batch(
 /*====================*/
-	buf_page_t*	bpage);	/*!< in: buffer block to write */
+	buf_page_t*	bpage,	/*!< in: buffer block to write */
+	bool		crc32_pending);/*!< in: whether the CRC32
+				checksum of the page is to be computed
+				when the batch is written, see
+				buf_flush_init_for_writing() */
 
 /********************************************************************//**
 Flush a batch of writes to the datafiles that have already been
@@ -112,10 +141,12 @@ Flushes possible buffered writes from the doublewrite memory buffer to disk,
 and also wakes up the aio thread if simulated aio is used. It is very
 important to call this function after a batch of writes has been posted,
 and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+of threads can occur.
+@param[in]	buf_pool	with innodb_doublewrite_files, flush only the
+doublewrite file of this buffer pool instance; NULL to flush all */
 void
-buf_dblwr_flush_buffered_writes(void);
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+	const buf_pool_t*	buf_pool = NULL);
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -162,6 +193,16 @@ struct buf_dblwr_t{
 	buf_page_t**	buf_block_arr;/*!< array to store pointers to
 				the buffer blocks which have been
 				cached to write_buf */
+	bool*		crc32_pending;/*!< flag to indicate that the
+				CRC32 checksum of a batch page in
+				write_buf has not been computed yet */
+	char*		path;	/*!< with innodb_doublewrite_files,
+				the path of the doublewrite file;
+				NULL if the doublewrite buffer is
+				in the system tablespace */
+	pfs_os_file_t	file;	/*!< handle of the doublewrite file,
+				if path != NULL. block1 and block2
+				are then page numbers in the file. */
 };
 
 
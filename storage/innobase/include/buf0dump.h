@@ -65,7 +65,8 @@ buf_load_abort();
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
-again.
+again. It also makes a dump every innodb_buffer_pool_dump_interval
+seconds.
 @return this function does not return, it calls os_thread_exit() */
 extern "C"
 os_thread_ret_t
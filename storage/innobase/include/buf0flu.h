@@ -82,14 +82,19 @@ buf_flush_write_complete(
 @param[in,out]	page		page frame
 @param[in,out]	page_zip_	compressed page, or NULL if uncompressed
 @param[in]	newest_lsn	newest modification LSN to the page
-@param[in]	skip_checksum	whether to disable the page checksum */
-void
+@param[in]	skip_checksum	whether to disable the page checksum
+@param[in]	defer_crc32	whether the caller computes a CRC32
+checksum later, together with the checksums of other pages
+@return true if the CRC32 checksum was not written because of
+defer_crc32 */
+bool
 buf_flush_init_for_writing(
 	const buf_block_t*	block,
 	byte*			page,
 	void*			page_zip_,
 	lsn_t			newest_lsn,
-	bool			skip_checksum);
+	bool			skip_checksum,
+	bool			defer_crc32 = false);
 
 #ifndef UNIV_HOTBACKUP
 # if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
@@ -174,6 +179,20 @@ void
 buf_flush_wait_flushed(
 	lsn_t		new_oldest);
 
+/** Get the smallest oldest_modification of the pages from a given page
+of a flush list towards the head, not counting the pages of the system
+temporary tablespace. When innodb_flush_list_relaxed_order is set, a flush
+list is ordered only up to LOG_FLUSH_ORDER_LAG, and the pages preceding
+bpage are scanned until the order guarantees that no older page follows.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	bpage		page in the flush list that does not belong
+to the system temporary tablespace, normally the last such page
+@return smallest oldest_modification */
+lsn_t
+buf_flush_list_oldest_lsn(
+	const buf_pool_t*	buf_pool,
+	const buf_page_t*	bpage);
+
 /******************************************************************//**
 Waits until a flush batch of the given type ends. This is called by
 a thread that only wants to wait for a flush to end but doesn't do
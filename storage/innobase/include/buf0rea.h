@@ -64,6 +64,28 @@ buf_read_page_background(
 	const page_size_t&	page_size,
 	bool			sync);
 
+/** Maximum number of pages that buf_read_page_range() reads */
+#define BUF_READ_PAGE_RANGE_MAX	64
+
+/** Reads a range of adjacent pages synchronously to the buffer pool with
+one read request. The pages that already reside in the buffer pool are
+read but discarded.
+@param[in]	page_id		id of the first page, not in the system
+tablespace
+@param[in]	n_pages		number of pages, at most
+BUF_READ_PAGE_RANGE_MAX, which must be in the first data file of the
+tablespace; only the first one may be a change buffer bitmap page
+@param[in]	page_size	page size
+@param[in,out]	buf		buffer of n_pages * page_size.physical()
+bytes, aligned to UNIV_PAGE_SIZE
+@return number of pages that were read into the buffer pool */
+ulint
+buf_read_page_range(
+	const page_id_t&	page_id,
+	ulint			n_pages,
+	const page_size_t&	page_size,
+	byte*			buf);
+
 /** Applies a random read-ahead in buf_pool if there are at least a threshold
 value of accessed pages from the random read-ahead area. Does not read any
 page, not even the one at the position (space, offset), if the read-ahead
@@ -86,6 +108,23 @@ buf_read_ahead_random(
 	const page_size_t&	page_size,
 	ibool			inside_ibuf);
 
+/** Applies read-ahead to the undo log pages that precede a page that a
+consistent read is about to access. The undo logs of older transactions
+are usually allocated before the newer ones, so that the pages that a walk
+along a chain of roll pointers visits next mostly precede the current one.
+NOTE: the calling thread may own latches on pages: to avoid deadlocks
+this function must be written such that it cannot end up waiting for
+these latches!
+@param[in]	page_id		undo log page that is about to be read
+@param[in]	page_size	page size
+@param[in]	n_pages		maximum number of pages to read ahead
+@return number of page read requests issued */
+ulint
+buf_read_ahead_undo(
+	const page_id_t&	page_id,
+	const page_size_t&	page_size,
+	ulint			n_pages);
+
 /** Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
 Does not read any page if the read-ahead mechanism is not activated. Note
@@ -149,12 +149,19 @@ to open the table and allows InnoDB to quickly find the tablespace. */
 
 #define DICT_TF_WIDTH_SHARED_SPACE	1
 
+/** Width of the ZIP_CODEC flag, which is the page_zip_codec_t of the
+pages of a ROW_FORMAT=COMPRESSED table. An older engine would not be able
+to decompress pages that use another codec than zlib. This flag prevents
+older engines from attempting to open the table. */
+#define DICT_TF_WIDTH_ZIP_CODEC		1
+
 /** Width of all the currently known table flags */
 #define DICT_TF_BITS	(DICT_TF_WIDTH_COMPACT			\
 			+ DICT_TF_WIDTH_ZIP_SSIZE		\
 			+ DICT_TF_WIDTH_ATOMIC_BLOBS		\
 			+ DICT_TF_WIDTH_DATA_DIR		\
-			+ DICT_TF_WIDTH_SHARED_SPACE)
+			+ DICT_TF_WIDTH_SHARED_SPACE		\
+			+ DICT_TF_WIDTH_ZIP_CODEC)
 
 /** A mask of all the known/used bits in table flags */
 #define DICT_TF_BIT_MASK	(~(~0 << DICT_TF_BITS))
@@ -173,9 +180,12 @@ to open the table and allows InnoDB to quickly find the tablespace. */
 /** Zero relative shift position of the SHARED TABLESPACE field */
 #define DICT_TF_POS_SHARED_SPACE	(DICT_TF_POS_DATA_DIR		\
 					+ DICT_TF_WIDTH_DATA_DIR)
-/** Zero relative shift position of the start of the UNUSED bits */
-#define DICT_TF_POS_UNUSED		(DICT_TF_POS_SHARED_SPACE	\
+/** Zero relative shift position of the ZIP_CODEC field */
+#define DICT_TF_POS_ZIP_CODEC		(DICT_TF_POS_SHARED_SPACE	\
 					+ DICT_TF_WIDTH_SHARED_SPACE)
+/** Zero relative shift position of the start of the UNUSED bits */
+#define DICT_TF_POS_UNUSED		(DICT_TF_POS_ZIP_CODEC		\
+					+ DICT_TF_WIDTH_ZIP_CODEC)
 
 /** Bit mask of the COMPACT field */
 #define DICT_TF_MASK_COMPACT				\
@@ -197,6 +207,10 @@ to open the table and allows InnoDB to quickly find the tablespace. */
 #define DICT_TF_MASK_SHARED_SPACE			\
 		((~(~0U << DICT_TF_WIDTH_SHARED_SPACE))	\
 		<< DICT_TF_POS_SHARED_SPACE)
+/** Bit mask of the ZIP_CODEC field */
+#define DICT_TF_MASK_ZIP_CODEC				\
+		((~(~0U << DICT_TF_WIDTH_ZIP_CODEC))	\
+		<< DICT_TF_POS_ZIP_CODEC)
 
 /** Return the value of the COMPACT field */
 #define DICT_TF_GET_COMPACT(flags)			\
@@ -218,6 +232,10 @@ to open the table and allows InnoDB to quickly find the tablespace. */
 #define DICT_TF_HAS_SHARED_SPACE(flags)			\
 		((flags & DICT_TF_MASK_SHARED_SPACE)	\
 		>> DICT_TF_POS_SHARED_SPACE)
+/** Return the value of the ZIP_CODEC field */
+#define DICT_TF_GET_ZIP_CODEC(flags)			\
+		((flags & DICT_TF_MASK_ZIP_CODEC)	\
+		>> DICT_TF_POS_ZIP_CODEC)
 /** Return the contents of the UNUSED bits */
 #define DICT_TF_GET_UNUSED(flags)			\
 		(flags >> DICT_TF_POS_UNUSED)
@@ -984,6 +1002,12 @@ struct dict_index_t{
 	ulint		stat_n_leaf_pages;
 				/*!< approximate number of leaf pages in the
 				index tree */
+	ib_uint64_t	stat_modified_counter;
+				/*!< approximate number of records inserted
+				into, deleted from or moved in this index
+				since its statistics were last calculated;
+				not protected by any latch, see
+				dict_table_t::stat_modified_counter */
 	/* @} */
 	last_ops_cur_t*	last_ins_cur;
 				/*!< cache the last insert position.
@@ -1395,6 +1419,12 @@ struct dict_table_t {
 	Use DICT_TF2_FLAG_IS_SET() to parse this flag. */
 	unsigned				flags2:DICT_TF2_BITS;
 
+	/** Codec of the ROW_FORMAT=COMPRESSED pages, from
+	DICT_TF_GET_ZIP_CODEC(flags). This is not a bit-field, because
+	redo log apply sets it for each record on the dummy table of the
+	index that is parsed from the record. */
+	page_zip_codec_t			zip_codec;
+
 	/** TRUE if this is in a single-table tablespace and the .ibd file is
 	missing. Then we must return in ha_innodb.cc an error if the user
 	tries to query such an orphaned table. */
@@ -1691,7 +1721,8 @@ struct dict_table_t {
 
 	/** Count of the number of record locks on this table. We use this to
 	determine whether we can evict the table from the dictionary cache.
-	It is protected by lock_sys->mutex. */
+	It is updated atomically, because record locks can be created under
+	different lock_sys shards at the same time. */
 	ulint					n_rec_locks;
 
 #ifndef UNIV_DEBUG
@@ -42,6 +42,10 @@ Created Jan 06, 2010 Vasil Dimov
 #define TABLE_STATS_NAME        "mysql/innodb_table_stats"
 #define INDEX_STATS_NAME        "mysql/innodb_index_stats"
 
+/** Maximum number of threads that may analyze indexes for
+dict_stats_update() in addition to the threads that called it */
+#define DICT_STATS_MAX_ANALYZE_THREADS	64
+
 enum dict_stats_upd_option_t {
 	DICT_STATS_RECALC_PERSISTENT,/* (re) calculate the
 				statistics using a precise and slow
@@ -49,6 +53,12 @@ enum dict_stats_upd_option_t {
 				storage, if the persistent storage is
 				not present then emit a warning and
 				fall back to transient stats */
+	DICT_STATS_RECALC_PERSISTENT_MODIFIED,/* like
+				DICT_STATS_RECALC_PERSISTENT, but keep
+				the statistics of the secondary indexes
+				that were not modified much since they
+				were calculated; used by the auto
+				recalculation background thread */
 	DICT_STATS_RECALC_TRANSIENT,/* (re) calculate the statistics
 				using an imprecise quick algo
 				without saving the results
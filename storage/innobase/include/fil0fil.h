@@ -154,7 +154,9 @@ struct fil_space_t {
 	bool		stop_ios;/*!< true if we want to rename the
 				.ibd file of tablespace and want to
 				stop temporarily posting of new i/o
-				requests on the file */
+				requests on the file. Set while holding
+				the fil_shard_t mutex as well, like
+				stop_new_ops and is_being_truncated */
 	bool		stop_new_ops;
 				/*!< we set this true when we start
 				deleting a single-table tablespace.
@@ -255,7 +257,9 @@ struct fil_node_t {
 	fil_space_t*	space;
 	/** file name; protected by fil_system->mutex and log_sys->mutex. */
 	char*		name;
-	/** whether this file is open */
+	/** whether this file is open; changed while holding both
+	fil_system->mutex and the mutex of the fil_shard_t of the space,
+	so that fil_io() can check it under either */
 	bool		is_open;
 	/** file handle (valid if is_open) */
 	pfs_os_file_t	handle;
@@ -277,7 +281,10 @@ struct fil_node_t {
 	ulint		init_size;
 	/** maximum size of the file in database pages (0 if unlimited) */
 	ulint		max_size;
-	/** count of pending i/o's; is_open must be true if nonzero */
+	/** count of pending i/o's; is_open must be true if nonzero.
+	Updated atomically; it may only become nonzero while is_open
+	is true and fil_system->mutex or the mutex of the fil_shard_t
+	of the space is held */
 	ulint		n_pending;
 	/** count of pending flushes; is_open must be true if nonzero */
 	ulint		n_pending_flushes;
@@ -291,6 +298,10 @@ struct fil_node_t {
 	UT_LIST_NODE_T(fil_node_t) chain;
 	/** link to the fil_system->LRU list (keeping track of open files) */
 	UT_LIST_NODE_T(fil_node_t) LRU;
+	/** whether i/o has been started on the file since
+	fil_try_to_close_file_in_LRU() last looked at it; set without
+	holding any mutex */
+	bool		lru_accessed;
 
 	/** whether the file system of this file supports PUNCH HOLE */
 	bool		punch_hole;
@@ -301,6 +312,11 @@ struct fil_node_t {
 	/** whether atomic write is enabled for this file */
 	bool		atomic_write;
 
+	/** whether the file was registered from the tablespace directory
+	cache and its first page has not been checked yet; size is then
+	the size recorded in the cache */
+	bool		unvalidated;
+
 	/** FIL_NODE_MAGIC_N */
 	ulint		magic_n;
 };
@@ -1110,6 +1126,56 @@ fil_ibd_open(
 	const char*	path_in)
 	MY_ATTRIBUTE((warn_unused_result));
 
+#ifndef UNIV_HOTBACKUP
+/** Read the tablespace directory cache that fil_dir_cache_write() wrote
+at an earlier shutdown. fil_ibd_open_cached() looks up the entries until
+fil_dir_cache_free() is called. Unless the server is read-only, the file
+is removed, so that it is not used after a later crash or a shutdown that
+does not write it; it only describes the files at the shutdown that wrote
+it.
+@param[in]	use	whether to read the file; false if the redo log
+was applied or the cache is disabled, in which case the file is only
+removed
+@return number of tablespaces in the cache */
+ulint
+fil_dir_cache_load(
+	bool	use);
+
+/** Register a file-per-table tablespace from the tablespace directory
+cache, without looking for or opening its file. The cache entry must
+match the id, name and flags. The first page of the file is checked when
+the file is opened for the first time, or by fil_dir_cache_thread(),
+whichever comes first.
+@param[in]	id		tablespace ID
+@param[in]	flags		tablespace flags
+@param[in]	space_name	tablespace name of the datafile
+@return whether the tablespace was registered */
+bool
+fil_ibd_open_cached(
+	ulint		id,
+	ulint		flags,
+	const char*	space_name);
+
+/** Free the entries read by fil_dir_cache_load().
+@return number of tablespaces that fil_ibd_open_cached() registered, which
+fil_dir_cache_thread() has to validate */
+ulint
+fil_dir_cache_free();
+
+/** Write the tablespace directory cache: the id, name, flags, size and
+path of each file-per-table tablespace in the tablespace memory cache. */
+void
+fil_dir_cache_write();
+
+/** Validate the tablespaces that fil_ibd_open_cached() registered, in the
+background. The thread exits when it is done or at shutdown.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(fil_dir_cache_thread)(
+	void*	arg);
+#endif /* !UNIV_HOTBACKUP */
+
 enum fil_load_status {
 	/** The tablespace file(s) were found and valid. */
 	FIL_LOAD_OK,
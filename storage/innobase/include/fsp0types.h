@@ -259,6 +259,10 @@ it is for a single client and should be deleted upon startup if it exists. */
 /** Width of the encryption flag.  This flag indicates that the tablespace
 is a tablespace with encryption. */
 #define FSP_FLAGS_WIDTH_ENCRYPTION	1
+/** Width of the ZIP_CODEC flag. It is set when the compressed pages
+use another codec than zlib (see page_zip_codec_t), so that an older
+engine does not attempt to open the tablespace. */
+#define FSP_FLAGS_WIDTH_ZIP_CODEC	1
 /** Width of all the currently known tablespace flags */
 #define FSP_FLAGS_WIDTH		(FSP_FLAGS_WIDTH_POST_ANTELOPE	\
 				+ FSP_FLAGS_WIDTH_ZIP_SSIZE	\
@@ -267,7 +271,8 @@ is a tablespace with encryption. */
 				+ FSP_FLAGS_WIDTH_DATA_DIR	\
 				+ FSP_FLAGS_WIDTH_SHARED	\
 				+ FSP_FLAGS_WIDTH_TEMPORARY	\
-				+ FSP_FLAGS_WIDTH_ENCRYPTION)
+				+ FSP_FLAGS_WIDTH_ENCRYPTION	\
+				+ FSP_FLAGS_WIDTH_ZIP_CODEC)
 
 /** A mask of all the known/used bits in tablespace flags */
 #define FSP_FLAGS_MASK		(~(~0 << FSP_FLAGS_WIDTH))
@@ -295,9 +300,12 @@ is a tablespace with encryption. */
 /** Zero relative shift position of the start of the ENCRYPTION bit */
 #define FSP_FLAGS_POS_ENCRYPTION	(FSP_FLAGS_POS_TEMPORARY	\
 					+ FSP_FLAGS_WIDTH_TEMPORARY)
-/** Zero relative shift position of the start of the UNUSED bits */
-#define FSP_FLAGS_POS_UNUSED		(FSP_FLAGS_POS_ENCRYPTION	\
+/** Zero relative shift position of the ZIP_CODEC field */
+#define FSP_FLAGS_POS_ZIP_CODEC		(FSP_FLAGS_POS_ENCRYPTION	\
 					+ FSP_FLAGS_WIDTH_ENCRYPTION)
+/** Zero relative shift position of the start of the UNUSED bits */
+#define FSP_FLAGS_POS_UNUSED		(FSP_FLAGS_POS_ZIP_CODEC	\
+					+ FSP_FLAGS_WIDTH_ZIP_CODEC)
 
 /** Bit mask of the POST_ANTELOPE field */
 #define FSP_FLAGS_MASK_POST_ANTELOPE				\
@@ -331,6 +339,10 @@ is a tablespace with encryption. */
 #define FSP_FLAGS_MASK_ENCRYPTION				\
 		((~(~0U << FSP_FLAGS_WIDTH_ENCRYPTION))		\
 		<< FSP_FLAGS_POS_ENCRYPTION)
+/** Bit mask of the ZIP_CODEC field */
+#define FSP_FLAGS_MASK_ZIP_CODEC				\
+		((~(~0U << FSP_FLAGS_WIDTH_ZIP_CODEC))		\
+		<< FSP_FLAGS_POS_ZIP_CODEC)
 
 /** Return the value of the POST_ANTELOPE field */
 #define FSP_FLAGS_GET_POST_ANTELOPE(flags)			\
@@ -364,6 +376,10 @@ is a tablespace with encryption. */
 #define FSP_FLAGS_GET_ENCRYPTION(flags)				\
 		((flags & FSP_FLAGS_MASK_ENCRYPTION)		\
 		>> FSP_FLAGS_POS_ENCRYPTION)
+/** Return the value of the ZIP_CODEC field */
+#define FSP_FLAGS_GET_ZIP_CODEC(flags)				\
+		((flags & FSP_FLAGS_MASK_ZIP_CODEC)		\
+		>> FSP_FLAGS_POS_ZIP_CODEC)
 /** Return the contents of the UNUSED bits */
 #define FSP_FLAGS_GET_UNUSED(flags)				\
 		(flags >> FSP_FLAGS_POS_UNUSED)
@@ -505,6 +505,8 @@ fts_cache_find_word(
 /*================*/
 	const fts_index_cache_t*
 			index_cache,	/*!< in: cache to search */
+	const ib_rbt_t*	words,		/*!< in: index_cache->words or
+					index_cache->frozen_words */
 	const fts_string_t*
 			text)		/*!< in: word to search for */
 	MY_ATTRIBUTE((warn_unused_result));
@@ -75,6 +75,11 @@ struct fts_index_cache_t {
 	ib_rbt_t*	words;		/*!< Nodes; indexed by fts_string_t*,
 					cells are fts_tokenizer_word_t*.*/
 
+	ib_rbt_t*	frozen_words;	/*!< The words that SYNC is writing
+					to the INDEX table; documents added
+					meanwhile go to the words above.
+					NULL if there are none */
+
 	ib_vector_t*	doc_stats;	/*!< Array of the fts_doc_stats_t
 					contained in the memory buffer.
 					Must be in sorted order (ascending).
@@ -126,11 +131,13 @@ struct fts_sync_t {
 					add to the FTS cache */
 	ibool		interrupted;	/*!< TRUE if SYNC was interrupted */
 	doc_id_t	min_doc_id;	/*!< The smallest doc id added to the
-					cache. It should equal to
-					doc_ids[lower_index] */
+					cache since the words were frozen */
 	doc_id_t	max_doc_id;	/*!< The doc id at which the cache was
 					noted as being full, we use this to
 					set the upper_limit field */
+	doc_id_t	frozen_max_doc_id;
+					/*!< max_doc_id when the words were
+					frozen */
 	ib_time_monotonic_t	start_time;
 	/*!< SYNC start time */
 	bool		in_progress;	/*!< flag whether sync is in progress.*/
@@ -174,6 +181,10 @@ struct fts_cache_t {
 					whenever this gets too big */
 	uint64_t	total_size_before_sync;
 	/*!< total size of fts cache, when last SYNC request was sent */
+	ulint		frozen_size;	/*!< total_size of the frozen words,
+					when they were frozen */
+	mem_heap_t*	frozen_heap;	/*!< The sync_heap memory of the
+					frozen words, or NULL */
 
 	fts_sync_t*	sync;		/*!< sync structure to sync data to
 					disk */
@@ -352,6 +363,17 @@ fts_decode_vlc(
 	byte**	ptr);	/*!< in: ptr to decode from, this ptr is
 			incremented by the number of bytes decoded */
 
+/** Skip the word positions of one document in an ilist.
+@param[in,out]	ptr	the first position; on return, the byte after the
+end of word position marker
+@param[in]	end	end of the ilist
+@return number of positions */
+UNIV_INLINE
+ulint
+fts_skip_vlc_positions(
+	byte**		ptr,
+	const byte*	end);
+
 /******************************************************************//**
 Duplicate a string. */
 UNIV_INLINE
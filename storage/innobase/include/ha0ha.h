@@ -51,6 +51,24 @@ ha_search_and_get_data(
 /*===================*/
 	hash_table_t*	table,	/*!< in: hash table */
 	ulint		fold);	/*!< in: folded value of the searched data */
+
+/** Looks for an element in a hash table without holding the latch that
+protects it. Nodes may be concurrently moved or freed, so the result must
+be validated by the caller, and the walk gives up after visiting n_max
+nodes in case it has been led into a cycle.
+@param[in]	table	hash table
+@param[in]	fold	folded value of the searched data
+@param[in]	n_max	maximum number of chain nodes to visit
+@param[out]	data	pointer to the data of the first hash table node
+			in chain having the fold number, NULL if not found
+@return false if the walk was abandoned after n_max nodes */
+UNIV_INLINE
+bool
+ha_search_and_get_data_nowait(
+	hash_table_t*		table,
+	ulint			fold,
+	ulint			n_max,
+	const rec_t**		data);
 /*********************************************************//**
 Looks for an element when we know the pointer to the data and updates
 the pointer to data if found.
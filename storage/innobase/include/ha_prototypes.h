@@ -301,6 +301,22 @@ thd_lock_wait_timeout(
 /*==================*/
 	THD*	thd);	/*!< in: thread handle, or NULL to query
 			the global innodb_lock_wait_timeout */
+/** Get the value of innodb_ddl_threads.
+@param[in]	thd	thread handle, or NULL to query
+			the global innodb_ddl_threads
+@return maximum number of threads that build the indexes of a table */
+ulint
+thd_ddl_threads(
+	THD*	thd);
+
+/** Get the value of innodb_parallel_read_threads.
+@param[in]	thd	thread handle, or NULL to query
+			the global innodb_parallel_read_threads
+@return maximum number of threads that read a clustered index */
+ulint
+thd_parallel_read_threads(
+	THD*	thd);
+
 /******************************************************************//**
 Add up the time waited for the lock for the current query. */
 void
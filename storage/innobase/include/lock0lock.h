@@ -53,6 +53,26 @@ class ReadView;
 
 extern my_bool	innobase_deadlock_detect;
 
+/* If set, deadlocks are detected by lock_deadlock_detect_thread instead
+of the thread that enqueues the lock wait. */
+extern my_bool	innobase_deadlock_detect_async;
+
+/** Alternatives for innobase_lock_schedule_algorithm, which can be changed
+by setting innodb_lock_schedule_algorithm */
+enum lock_schedule_algorithm_t {
+	LOCK_SCHEDULE_FCFS,		/*!< Grant waiting record locks in
+					the order of the lock queue */
+	LOCK_SCHEDULE_CATS		/*!< Grant waiting record locks first
+					to the transactions that block the
+					most other transactions
+					(Contention-Aware Transaction
+					Scheduling) */
+};
+
+/** The "innodb_lock_schedule_algorithm" setting, one of
+lock_schedule_algorithm_t */
+extern ulong	innobase_lock_schedule_algorithm;
+
 /*********************************************************************//**
 Gets the size of a lock struct.
 @return size in bytes */
@@ -843,6 +863,25 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	void*	arg);	/*!< in: a dummy parameter required by
 			os_thread_create */
 
+/*********************************************************************//**
+A thread which resolves the deadlocks among the transactions suspended
+in lock waits, when innodb_deadlock_detect_async is set.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_detect_thread)(
+/*========================================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
+/*********************************************************************//**
+Searches the wait-for graph of the suspended transactions for cycles
+and rolls back a victim of each cycle. The graph is copied under
+lock_sys->latch, but the search for cycles runs without it. */
+void
+lock_detect_deadlocks();
+/*===================*/
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -1005,14 +1044,42 @@ struct lock_op_t{
 
 typedef ib_mutex_t LockMutex;
 
+/** Number of shards of the record lock hash table */
+#define LOCK_SYS_N_SHARDS	64
+
+/** A shard of the record lock hash table. The record locks on a page are
+in the hash cell lock_rec_hash(space, page_no), and the cells are assigned
+to the shards round-robin. */
+struct lock_sys_shard_t {
+	LockMutex	mutex;			/*!< Mutex protecting the
+						record lock queues of the
+						pages in the shard, together
+						with lock_sys->latch in
+						shared mode */
+
+	char		pad[CACHE_LINE_SIZE];	/*!< To avoid false sharing */
+};
+
 /** The lock system struct */
 struct lock_sys_t{
 	char		pad1[CACHE_LINE_SIZE];	/*!< padding to prevent other
 						memory update hotspots from
 						residing on the same memory
 						cache line */
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. In exclusive mode it
+						protects everything. In shared
+						mode, the record lock queues of
+						a page are protected by the
+						mutex of its shard; this is
+						used for the record lock
+						requests that can be granted
+						or released without waking up
+						or suspending a transaction */
+	char		pad2[CACHE_LINE_SIZE];	/*!< Padding */
+	lock_sys_shard_t
+			shards[LOCK_SYS_N_SHARDS];
+						/*!< Shards of rec_hash */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	hash_table_t*	prdt_hash;		/*!< hash table of the predicate
@@ -1020,7 +1087,7 @@ struct lock_sys_t{
 	hash_table_t*	prdt_page_hash;		/*!< hash table of the page
 						lock */
 
-	char		pad2[CACHE_LINE_SIZE];	/*!< Padding */
+	char		pad3[CACHE_LINE_SIZE];	/*!< Padding */
 	LockMutex	wait_mutex;		/*!< Mutex protecting the
 						next two fields */
 	srv_slot_t*	waiting_threads;	/*!< Array  of user threads
@@ -1046,6 +1113,14 @@ struct lock_sys_t{
 
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
+
+	os_event_t	deadlock_event;		/*!< Set when a thread is
+						suspended in a lock wait, to
+						wake up the deadlock detector
+						thread */
+
+	bool		deadlock_thread_active;	/*!< True if the deadlock
+						detector thread is running */
 };
 
 /*********************************************************************//**
@@ -1106,21 +1181,26 @@ lock_rec_trx_wait(
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
+/** Try to acquire lock_sys->latch in exclusive mode without waiting.
+@return 0 if the latch was acquired */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys->mutex.trylock(__FILE__, __LINE__))
+	(!rw_lock_x_lock_nowait(&lock_sys->latch))
+
+/** Test if lock_sys->latch is owned in exclusive mode. */
+#define lock_mutex_own() (rw_lock_own(&lock_sys->latch, RW_LOCK_X))
 
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() (lock_sys->mutex.is_owned())
+/** Test if lock_sys->latch is owned in shared or exclusive mode. */
+#define lock_mutex_own_any()					\
+	(rw_lock_own(&lock_sys->latch, RW_LOCK_S) || lock_mutex_own())
 
-/** Acquire the lock_sys->mutex. */
+/** Acquire lock_sys->latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release lock_sys->latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	lock_sys->mutex.exit();			\
+	rw_lock_x_unlock(&lock_sys->latch);	\
 } while (0)
 
 /** Test if lock_sys->wait_mutex is owned. */
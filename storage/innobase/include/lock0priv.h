@@ -114,7 +114,9 @@ operator<<(std::ostream& out, const lock_rec_t& lock)
 	return(lock.print(out));
 }
 
-/** Lock struct; protected by lock_sys->mutex */
+/** Lock struct; protected by lock_sys->latch in exclusive mode, or for
+record locks by lock_sys->latch in shared mode together with the shard
+of the page */
 struct lock_t {
 	trx_t*		trx;		/*!< transaction owning the
 					lock */
@@ -288,6 +290,17 @@ operator<<(std::ostream& out, const lock_t& lock)
 
 #ifdef UNIV_DEBUG
 extern ibool	lock_print_waits;
+
+/** Check if the caller may inspect and modify the record lock queue of a
+page: it holds lock_sys->latch in exclusive mode, or in shared mode
+together with the mutex of the shard of the page.
+@param[in]	space	tablespace identifier
+@param[in]	page_no	page number
+@return true if the record lock queue of the page is latched */
+bool
+lock_rec_queue_own(
+	ulint	space,
+	ulint	page_no);
 #endif /* UNIV_DEBUG */
 
 /** Restricts the length of search we will do in the waits-for
@@ -889,7 +902,8 @@ private:
 	Setup the context from the requirements */
 	void init(const page_t* page)
 	{
-		ut_ad(lock_mutex_own());
+		ut_ad(lock_rec_queue_own(m_rec_id.m_space_id,
+					 m_rec_id.m_page_no));
 		ut_ad(!srv_read_only_mode);
 		ut_ad(dict_index_is_clust(m_index)
 		      || !dict_index_is_online_ddl(m_index));
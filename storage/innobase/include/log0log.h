@@ -144,6 +144,61 @@ log_write_low(
 /*==========*/
 	const byte*	str,		/*!< in: string */
 	ulint		str_len);	/*!< in: string length */
+/** Reserve space in the log buffer for a string that will be copied by
+log_buffer_write() after log_sys->mutex has been released. This must be
+invoked between log_reserve_and_open() and log_close(), instead of
+log_write_low().
+@param[in]	len	string length
+@param[out]	ticket	copy ticket to pass to log_buffer_copy_complete()
+@return offset in log_sys->buf where the string must be copied to */
+ulint
+log_buffer_reserve(
+	ulint		len,
+	ib_uint64_t*	ticket);
+/** Copy a string to a part of the log buffer that was reserved with
+log_buffer_reserve(). The caller need not hold log_sys->mutex.
+@param[in,out]	buf	log_sys->buf at the time of the reservation
+@param[in]	offset	offset in buf to copy the string to
+@param[in]	str	string
+@param[in]	len	string length
+@return offset in buf after the string */
+ulint
+log_buffer_write(
+	byte*		buf,
+	ulint		offset,
+	const byte*	str,
+	ulint		len);
+/** Note that a copy reserved with log_buffer_reserve() has been completed.
+The caller need not hold log_sys->mutex.
+@param[in]	ticket	copy ticket returned by log_buffer_reserve()
+@param[in]	end_lsn	end lsn of the copied string */
+void
+log_buffer_copy_complete(
+	ib_uint64_t	ticket,
+	lsn_t		end_lsn);
+/** Register a mini-transaction that will add dirty pages to the flush
+lists after releasing log_sys->mutex, without holding
+log_flush_order_mutex while adding them.
+@param[in]	start_lsn	start lsn of the mini-transaction
+@return order ticket to pass to log_flush_order_complete() */
+ib_uint64_t
+log_flush_order_reserve(
+	lsn_t	start_lsn);
+/** Wait until the pages of a mini-transaction registered with
+log_flush_order_reserve() may be added to the flush lists, that is,
+until start_lsn is less than LOG_FLUSH_ORDER_LAG ahead of the start lsn of
+the oldest mini-transaction that has not yet added its pages.
+This does not acquire log_sys->mutex.
+@param[in]	start_lsn	start lsn of the mini-transaction */
+void
+log_flush_order_wait(
+	lsn_t	start_lsn);
+/** Note that a mini-transaction registered with log_flush_order_reserve()
+has added its dirty pages to the flush lists.
+@param[in]	ticket	order ticket returned by log_flush_order_reserve() */
+void
+log_flush_order_complete(
+	ib_uint64_t	ticket);
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -225,6 +280,14 @@ void
 log_buffer_sync_in_background(
 /*==========================*/
 	bool	flush);	/*<! in: flush the logs to disk */
+/** Start the dedicated log writer, flusher and notifier threads, after
+which log_write_up_to() only waits for them (innodb_log_writer_threads). */
+void
+log_writer_threads_start();
+/** Stop the dedicated log threads, if they are running. The threads
+waiting in log_write_up_to() will write the log themselves. */
+void
+log_writer_threads_stop();
 /** Make a checkpoint. Note that this function does not flush dirty
 blocks from the buffer pool: it only checks what is lsn of the oldest
 modification in the pool, and writes information about the lsn in
@@ -497,6 +560,26 @@ extern my_bool	innodb_log_checksums;
 
 #define LOG_BUFFER_SIZE		(srv_log_buffer_size * UNIV_PAGE_SIZE)
 
+/** Number of log buffer copies that may be in progress outside
+log_sys->mutex at the same time */
+#define LOG_COPY_SLOTS		1024
+
+/** Number of events that the threads waiting for the dedicated log
+threads are distributed over */
+#define LOG_WAIT_EVENTS		2048
+
+/** Number of mini-transactions that may be adding their dirty pages to
+the flush lists at the same time when innodb_flush_list_relaxed_order
+is set */
+#define LOG_ORDER_SLOTS		1024
+
+/** When innodb_flush_list_relaxed_order is set, a page is added to a
+flush list only while its oldest_modification is less than this many
+bytes ahead of the start lsn of the oldest mini-transaction that has
+not yet added its pages. Any page added to a flush list later has a
+bigger oldest_modification than that of the page minus this lag. */
+#define LOG_FLUSH_ORDER_LAG	(512 * 1024)
+
 /* Offsets of a log block header */
 #define	LOG_BLOCK_HDR_NO	0	/* block number which must be > 0 and
 					is allowed to wrap around at 2G; the
@@ -651,7 +734,10 @@ struct log_t{
 					to release log_sys->mutex during
 					mtr_commit and still ensure that
 					insertions in the flush_list happen
-					in the LSN order. */
+					in the LSN order. With
+					innodb_flush_list_relaxed_order, it
+					only protects the order tickets; see
+					log_flush_order_reserve() */
 #endif /* !UNIV_HOTBACKUP */
 	byte*		buf_ptr;	/*!< unaligned log buffer, which should
 					be of double of buf_size */
@@ -681,6 +767,54 @@ struct log_t{
 	UT_LIST_BASE_NODE_T(log_group_t)
 			log_groups;	/*!< log groups */
 
+#ifndef UNIV_HOTBACKUP
+	/** Tracking of the log buffer copies which are done after the
+	mini-transaction released log_sys->mutex; see log_buffer_reserve()
+	@{ */
+
+	lsn_t*		copy_slots;	/*!< end lsn of each completed copy,
+					indexed by ticket modulo
+					LOG_COPY_SLOTS; 0 if the copy is
+					still in progress or the slot is
+					free */
+	ib_uint64_t	copy_next;	/*!< ticket of the next reservation;
+					protected by mutex */
+	ib_uint64_t	copy_tail;	/*!< oldest ticket whose copy is not
+					known to be complete; protected by
+					mutex */
+	lsn_t		copy_ready_lsn;	/*!< the log buffer contents are
+					complete up to this lsn: all copies
+					ending at or before it have been
+					done; protected by mutex */
+	/* @} */
+
+	/** Tracking of the mini-transactions that add their dirty pages to
+	the flush lists without log_flush_order_mutex; see
+	log_flush_order_reserve() @{ */
+
+	lsn_t*		order_slots;	/*!< start lsn of each mini-transaction
+					that is adding its pages, indexed by
+					ticket modulo LOG_ORDER_SLOTS; 0 if
+					it has completed or the slot is free */
+	ib_uint64_t	order_next;	/*!< ticket of the next registration;
+					protected by log_flush_order_mutex */
+	ib_uint64_t	order_tail;	/*!< oldest ticket that is not known
+					to be complete; protected by
+					log_flush_order_mutex */
+	volatile lsn_t	order_closed_lsn;/*!< all the pages of the
+					mini-transactions starting before this
+					lsn have been added to the flush
+					lists; written under
+					log_flush_order_mutex, may be read
+					without it */
+	ulint		order_n_waiters;/*!< number of threads waiting for
+					order_closed_lsn to advance or for a
+					free slot; updated atomically */
+	os_event_t	order_event;	/*!< set by log_flush_order_complete()
+					when order_n_waiters > 0 */
+	/* @} */
+#endif /* !UNIV_HOTBACKUP */
+
 #ifndef UNIV_HOTBACKUP
 	/** The fields involved in the log buffer flush @{ */
 
@@ -718,6 +852,32 @@ struct log_t{
 					called */
 	/* @} */
 
+	/** Dedicated log writer, flusher and notifier threads
+	(innodb_log_writer_threads) @{ */
+
+	volatile bool	writer_threads_active;
+					/*!< true if the log threads are
+					running, and log_write_up_to() waits
+					for them instead of writing */
+	ulint		n_writer_threads;/*!< number of log threads that have
+					not exited; updated atomically */
+	ulint		n_write_waiters;/*!< number of threads waiting for
+					a log write; updated atomically */
+	ulint		n_flush_waiters;/*!< number of threads waiting for
+					a log flush; updated atomically */
+	os_event_t	writer_event;	/*!< set to wake up the log writer */
+	os_event_t	flusher_event;	/*!< set to wake up the log flusher */
+	os_event_t	notifier_event;	/*!< set to wake up the log notifier
+					after write_lsn or flushed_to_disk_lsn
+					advanced */
+	os_event_t*	write_events;	/*!< LOG_WAIT_EVENTS events of the
+					threads waiting for write_lsn,
+					see log_wait_event() */
+	os_event_t*	flush_events;	/*!< LOG_WAIT_EVENTS events of the
+					threads waiting for
+					flushed_to_disk_lsn */
+	/* @} */
+
 	/** Fields involved in checkpoints @{ */
 	lsn_t		log_group_capacity; /*!< capacity of the log group; if
 					the checkpoint age exceeds this, it is
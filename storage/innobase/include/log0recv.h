@@ -311,6 +311,19 @@ struct recv_sys_t{
 	buf_flush_t		flush_type;/*!< type of the flush request.
 				BUF_FLUSH_LRU: flush end of LRU, keeping free blocks.
 				BUF_FLUSH_LIST: flush all of blocks. */
+	ulint		n_apply_threads;/*!< number of partitions of
+				addr_hash in the running apply batch; cell i
+				belongs to partition i % n_apply_threads */
+	ulint		n_apply_running;/*!< number of recv_apply threads
+				that have not yet finished their partition;
+				protected by mutex */
+	os_event_t	apply_done;/*!< set when n_apply_running
+				drops to zero */
+	bool		apply_printed;/*!< whether the running apply
+				batch has printed its start message;
+				protected by mutex */
+	lsn_t		apply_start_lsn;/*!< the log records up to this
+				lsn have been applied by earlier batches */
 #endif /* !UNIV_HOTBACKUP */
 	ibool		apply_log_recs;
 				/*!< this is TRUE when log rec application to
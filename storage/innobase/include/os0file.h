@@ -1954,6 +1954,24 @@ Frees the asynchronous io system. */
 void
 os_aio_free();
 
+/** Register memory areas, such as the buffer pool chunks, with the
+asynchronous i/o system so that the data page reads and writes into them
+do not need to map the pages on each request. This replaces the areas
+that were registered before. It does nothing unless io_uring is used.
+@param[in]	areas		start of each area
+@param[in]	sizes		size of each area in bytes
+@param[in]	n_areas		number of areas */
+void
+os_aio_register_buffers(
+	byte* const*	areas,
+	const ulint*	sizes,
+	ulint		n_areas);
+
+/** Unregister the memory areas registered by os_aio_register_buffers().
+Requests that are already submitted are not affected. */
+void
+os_aio_unregister_buffers();
+
 /**
 NOTE! Use the corresponding macro os_aio(), not directly this function!
 Requests an asynchronous i/o operation.
@@ -105,6 +105,17 @@ struct redo_page_compress_t {
 	ulint		trx_id_pos;	/*!< position of trx-id column. */
 };
 
+/** Codecs of the compressed stream of a ROW_FORMAT=COMPRESSED page.
+The records are always encoded as a deflate stream. With other codecs
+than zlib, the stream is stored without compression and the codec is
+applied to it as a whole. */
+enum page_zip_codec_t {
+	/** zlib deflate, the original format */
+	PAGE_ZIP_CODEC_ZLIB = 0,
+	/** LZ4 */
+	PAGE_ZIP_CODEC_LZ4 = 1
+};
+
 /** Compressed page descriptor */
 struct page_zip_des_t
 {
@@ -87,6 +87,22 @@ extern uint	page_zip_level;
 compression algorithm changes in zlib. */
 extern my_bool	page_zip_log_pages;
 
+/** Low 4 bits of the first byte of the compressed stream when the codec
+is not zlib; the high 4 bits are the page_zip_codec_t. The first byte of
+a zlib stream is the CMF byte of the zlib header, whose low 4 bits are
+always Z_DEFLATED (8). */
+#define PAGE_ZIP_CODEC_MARK		0x0F
+/** Size of the header of a compressed stream that is not zlib: the
+codec byte and the length of the codec output (2 bytes) */
+#define PAGE_ZIP_CODEC_HEADER		3
+/** Size of the buffer for the uncompressed deflate stream that a codec
+other than zlib compresses */
+#define PAGE_ZIP_STAGE_SIZE		(2 * UNIV_PAGE_SIZE)
+/** Shift of the page_zip_codec_t in the compression level byte of
+the MLOG_ZIP_PAGE_COMPRESS_NO_DATA and MLOG_ZIP_PAGE_REORGANIZE
+redo log records */
+#define PAGE_ZIP_LEVEL_CODEC_SHIFT	4
+
 /**********************************************************************//**
 Determine the size of a compressed page in bytes.
 @return size in bytes */
@@ -180,6 +196,37 @@ page_zip_compress(
 	mtr_t*			mtr);		/*!< in/out: mini-transaction,
 						or NULL */
 
+/** Compress the deflate stream of a page with a codec other than zlib.
+@param[in]	codec	codec
+@param[in]	in	uncompressed deflate stream
+@param[in]	in_len	length of the deflate stream
+@param[out]	out	the codec header and the compressed stream
+@param[in]	out_len	size of out
+@return number of bytes written to out, or 0 if they did not fit */
+ulint
+page_zip_codec_pack(
+	page_zip_codec_t	codec,
+	const byte*		in,
+	ulint			in_len,
+	byte*			out,
+	ulint			out_len);
+
+/** Decompress the deflate stream of a page that page_zip_codec_pack()
+compressed.
+@param[in]	in	the codec header and the compressed stream
+@param[in]	in_len	maximum length of the compressed stream
+@param[out]	out	uncompressed deflate stream
+@param[in]	out_len	size of out
+@param[out]	used	number of bytes of in that were used
+@return length of the deflate stream, or 0 if the stream is corrupted */
+ulint
+page_zip_codec_unpack(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len,
+	ulint*		used);
+
 /**********************************************************************//**
 Write the index information for the compressed page.
 @return used size of buf */
@@ -537,6 +584,37 @@ page_zip_verify_checksum(
 );
 
 #ifndef UNIV_INNOCHECKSUM
+/** Determine the codec of a compressed stream.
+@param[in]	stream	start of the compressed stream, at PAGE_DATA
+@return codec, or PAGE_ZIP_CODEC_ZLIB for a zlib stream */
+UNIV_INLINE
+page_zip_codec_t
+page_zip_codec_get(
+	const byte*	stream);
+
+/** Encode a compression level and the codec of the table of an index
+for a redo log record.
+@param[in]	level	compression level
+@param[in]	index	index of the page
+@return the level byte of the redo log record */
+UNIV_INLINE
+ulint
+page_zip_level_encode(
+	ulint			level,
+	const dict_index_t*	index);
+
+/** Decode the level byte of a redo log record that was written with
+page_zip_level_encode(), and make page_zip_compress() use the codec
+with the index.
+@param[in]	val	the level byte of the redo log record
+@param[in,out]	index	index that was parsed from the redo log record
+@return compression level */
+UNIV_INLINE
+ulint
+page_zip_level_decode(
+	ulint		val,
+	dict_index_t*	index);
+
 /**********************************************************************//**
 Write a log record of compressing an index page without the data on the page. */
 UNIV_INLINE
@@ -61,19 +61,19 @@ public:
 	/**
 	Close a view created by the above function.
 	@para view		view allocated by trx_open.
-	@param own_mutex	true if caller owns trx_sys_t::mutex */
-	void view_close(ReadView*& view, bool own_mutex);
+	@param free_view	true to return the view to the free list,
+				false to only mark it closed (AC-NL-RO) */
+	void view_close(ReadView*& view, bool free_view);
 
 	/**
-	Release a view that is inactive but not closed. Caller must own
-	the trx_sys_t::mutex.
+	Release a view that is inactive but not closed.
 	@param view		View to release */
 	void view_release(ReadView*& view);
 
-	/** Clones the oldest view and stores it in view. No need to
-	call view_close(). The caller owns the view that is passed in.
-	It will also move the closed views from the m_views list to the
-	m_free list. This function is called by Purge to create it view.
+	/** Creates a view that sees no more than any of the open views
+	and stores it in view. No need to call view_close(). The caller
+	owns the view that is passed in. This function is called by Purge
+	to create its view.
 	@param view		Preallocated view, owned by the caller */
 	void clone_oldest_view(ReadView* view);
 
@@ -109,10 +109,10 @@ private:
 	inline ReadView* get_view();
 
 	/**
-	Get the oldest view in the system. It will also move the delete
-	marked read views from the views list to the freed list.
-	@return oldest view if found or NULL */
-	inline ReadView* get_oldest_view() const;
+	Register a view in m_views as being prepared. Caller must own
+	m_mutex.
+	@param view		view to register */
+	inline void view_register(ReadView* view);
 
 private:
 	// Prevent copying
@@ -122,12 +122,19 @@ private:
 private:
 	typedef UT_LIST_BASE_NODE_T(ReadView) view_list_t;
 
+	/** Protects m_free, m_views and m_n_registered. The views are
+	prepared without holding it. */
+	mutable ib_mutex_t	m_mutex;
+
 	/** Free views ready for reuse. */
 	view_list_t		m_free;
 
 	/** Active and closed views, the closed views will have the
 	creator trx id set to TRX_ID_MAX */
 	view_list_t		m_views;
+
+	/** Number of times a view was registered in m_views */
+	ulint			m_n_registered;
 };
 
 #endif /* read0read_h */
@@ -42,6 +42,9 @@ Created 2/16/1997 Heikki Tuuri
 // Friend declaration
 class MVCC;
 
+// Forward declaration
+class VersionCache;
+
 /** Read view lists the trx ids of those transactions for which a consistent
 read should not see the modifications to the database. */
 
@@ -249,15 +252,16 @@ public:
 		return(m_ids.empty());
 	}
 
-#ifdef UNIV_DEBUG
 	/**
-	@param rhs		view to compare with
-	@return truen if this view is less than or equal rhs */
-	bool le(const ReadView* rhs) const
+	@return the cache of the old record versions that were built in
+	this view, or NULL if innodb_version_cache_size was 0 when the view
+	was opened */
+	VersionCache* version_cache() const
 	{
-		return(m_low_limit_no <= rhs->m_low_limit_no);
+		return(m_vers_cache);
 	}
 
+#ifdef UNIV_DEBUG
 	trx_id_t up_limit_id() const
 	{
 		return(m_up_limit_id);
@@ -270,23 +274,41 @@ private:
 
 	/**
 	Opens a read view where exactly the transactions serialized before this
-	point in time are seen in the view.
+	point in time are seen in the view. Does not acquire trx_sys->mutex
+	unless the active transaction ids cannot be read without it.
 	@param id		Creator transaction id */
 	inline void prepare(trx_id_t id);
 
+	/**
+	Take the snapshot from trx_sys_t::rw_trx_active without acquiring
+	trx_sys->mutex.
+	@return false if the snapshot was not consistent and must be retried */
+	inline bool prepare_lock_free();
+
+	/**
+	Take the snapshot from trx_sys_t::rw_trx_ids. Caller must own
+	trx_sys->mutex. */
+	inline void prepare_low();
+
+	/**
+	Empty the version cache for a new snapshot, creating or resizing it
+	according to innodb_version_cache_size. */
+	inline void reset_version_cache();
+
 	/**
 	Complete the read view creation */
 	inline void complete();
 
 	/**
-	Copy state from another view. Must call copy_complete() to finish.
-	@param other		view to copy from */
-	inline void copy_prepare(const ReadView& other);
+	Widen this view so that it does not see any changes that are not
+	visible to the other view. Must call merge_complete() to finish.
+	@param other		view to merge */
+	inline void merge(const ReadView& other);
 
 	/**
-	Complete the copy, insert the creator transaction id into the
-	m_trx_ids too and adjust the m_up_limit_id *, if required */
-	inline void copy_complete();
+	Complete the merge, sort the m_ids, insert the creator transaction id
+	into the m_ids too and adjust the m_up_limit_id, if required */
+	inline void merge_complete();
 
 	/**
 	Set the creator transaction id, existing id must be 0 */
@@ -329,6 +351,17 @@ private:
 	/** AC-NL-RO transaction view that has been "closed". */
 	bool		m_closed;
 
+	/** true while the view is in MVCC::m_views but prepare() has not
+	completed yet */
+	volatile bool	m_preparing;
+
+	/** Value of MVCC::m_n_registered when the view was last opened */
+	ulint		m_ticket;
+
+	/** Old record versions that were built for this snapshot, or
+	NULL */
+	VersionCache*	m_vers_cache;
+
 	typedef UT_LIST_NODE_T(ReadView) node_t;
 
 	/** List of read views in trx_sys */
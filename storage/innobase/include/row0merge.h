@@ -374,6 +374,9 @@ row_merge_file_create(
 @param[in,out]	stage	performance schema accounting object, used by
 ALTER TABLE. If not NULL, stage->begin_phase_sort() will be called initially
 and then stage->inc() will be called for each record processed.
+@param[in]	n_threads	maximum number of threads that merge the runs
+of a pass; 1 for a unique index, whose duplicates are reported in
+dup->table
 @return DB_SUCCESS or error code */
 dberr_t
 row_merge_sort(
@@ -382,7 +385,8 @@ row_merge_sort(
 	merge_file_t*		file,
 	row_merge_block_t*	block,
 	int*			tmpfd,
-	ut_stage_alter_t*	stage = NULL);
+	ut_stage_alter_t*	stage = NULL,
+	ulint			n_threads = 1);
 
 /*********************************************************************//**
 Allocate a sort buffer.
@@ -585,14 +585,33 @@ row_scan_index_for_mysql(
 	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
 						in MySQL handle */
 	const dict_index_t*	index,		/*!< in: index */
-#ifdef WL6742
 	bool			check_keys,	/*!< in: true=check for mis-
 						ordered or duplicate records,
 						false=count the rows only */
-#endif
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 	MY_ATTRIBUTE((warn_unused_result));
+
+/** Scan a clustered index with several threads for either COUNT(*) or
+CHECK TABLE, counting the records in the read view of the transaction.
+For CHECK TABLE, the records are also checked to be in ascending order
+and unique, also across the boundaries of the ranges that the threads
+read.
+@param[in,out]	trx		transaction; it must have been started
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads
+@param[in]	check_keys	true=check for misordered or duplicate
+records, false=count the rows only
+@param[out]	n_rows		number of records seen in the read view
+@return DB_SUCCESS or other error */
+dberr_t
+row_scan_clust_index_parallel(
+	trx_t*			trx,
+	dict_index_t*		index,
+	ulint			n_threads,
+	bool			check_keys,
+	ulint*			n_rows)
+	MY_ATTRIBUTE((warn_unused_result));
 /*********************************************************************//**
 Initialize this module */
 void
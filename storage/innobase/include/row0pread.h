@@ -0,0 +1,188 @@
+/*****************************************************************************
+
+Copyright (c) 2023, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel read of the records of a clustered index
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "buf0types.h"
+#include "dict0types.h"
+#include "data0data.h"
+#include "os0event.h"
+#include "trx0types.h"
+#include "ut0new.h"
+
+#include <vector>
+
+class ReadView;
+
+/*
+The proper function call sequence of ParallelReader is as below:
+-- ParallelReader::ParallelReader
+-- ParallelReader::run, which invokes Callback::operator() for every
+   visible record from up to n_threads threads
+-- ParallelReader::~ParallelReader
+
+The clustered index is split into key ranges at the highest level of the
+B-tree that has enough node pointers, and the threads scan the ranges in
+the read view of the transaction, building the old versions of records
+as needed. */
+
+class ParallelReader
+{
+public:
+	/** A visible record that is passed to the callback */
+	struct Ctx {
+		/** Thread that read the record: 0 for the thread that
+		invoked run(), and 1..n_threads()-1 for the others */
+		ulint		m_thread_id;
+
+		/** Position of the key range of the record */
+		ulint		m_range_id;
+
+		/** true if this is the first record of the range that
+		is passed to the callback */
+		bool		m_first;
+
+		/** The record, in the version that is visible to the
+		read view */
+		const rec_t*	m_rec;
+
+		/** rec_get_offsets(m_rec, index) */
+		const ulint*	m_offsets;
+
+		/** The leaf page where the record was read */
+		const buf_block_t*	m_block;
+	};
+
+	/** Processes the records that are read. It is invoked from
+	several threads at the same time, with a different
+	Ctx::m_thread_id each. */
+	class Callback
+	{
+	public:
+		virtual ~Callback() {}
+
+		/** Process a record.
+		@param[in]	ctx	the record and where it was read
+		@return DB_SUCCESS, or an error code to stop the scan */
+		virtual dberr_t operator()(const Ctx& ctx) = 0;
+	};
+
+	/** Constructor
+	@param[in]	trx		transaction whose read view is used;
+	it must have been started
+	@param[in]	index		clustered index
+	@param[in]	n_threads	maximum number of threads */
+	ParallelReader(
+		trx_t*		trx,
+		dict_index_t*	index,
+		ulint		n_threads);
+
+	/** Destructor */
+	~ParallelReader();
+
+	/** Read all the records of the index that are visible in the
+	read view of the transaction. In READ UNCOMMITTED, the latest
+	versions of the records are read.
+	@param[in,out]	callback	invoked for each visible record
+	that is not delete-marked
+	@return DB_SUCCESS, or the first error */
+	dberr_t run(Callback& callback);
+
+	/** @return maximum number of threads, which bounds
+	Ctx::m_thread_id */
+	ulint n_threads() const
+	{
+		return(m_n_threads);
+	}
+
+	/** Read key ranges until none is left. This is the body of the
+	threads that run() starts.
+	@param[in]	thread_id	Ctx::m_thread_id of the thread */
+	void worker(ulint thread_id);
+
+private:
+	/** Split the index into key ranges, filling m_ranges. */
+	void split();
+
+	/** Read the records of a key range.
+	@param[in]	range_id	position of the range in m_ranges
+	@param[in]	thread_id	Ctx::m_thread_id of this thread
+	@param[in,out]	heap		memory heap for old versions
+	@return DB_SUCCESS or error code */
+	dberr_t read_range(
+		ulint		range_id,
+		ulint		thread_id,
+		mem_heap_t*	heap);
+
+private:
+	typedef std::vector<const dtuple_t*, ut_allocator<const dtuple_t*> >
+		ranges_t;
+
+	/** Transaction */
+	trx_t*			m_trx;
+
+	/** Clustered index */
+	dict_index_t*		m_index;
+
+	/** Maximum number of threads */
+	const ulint		m_n_threads;
+
+	/** Read view, or NULL in READ UNCOMMITTED */
+	ReadView*		m_view;
+
+	/** Memory heap for the keys in m_ranges */
+	mem_heap_t*		m_heap;
+
+	/** The smallest key of each range; the first one is NULL. A
+	range ends where the next one starts. */
+	ranges_t		m_ranges;
+
+	/** Next range to read, updated atomically */
+	ulint			m_next;
+
+	/** First error as a dberr_t, updated atomically; once set, the
+	threads stop reading */
+	volatile ulint		m_err;
+
+	/** Callback of the ongoing run() */
+	Callback*		m_callback;
+
+	/** Number of threads that have not finished, updated
+	atomically */
+	ulint			m_n_running;
+
+	/** Set when the last started thread has finished */
+	os_event_t		m_done_event;
+};
+
+#endif /* row0pread_h */
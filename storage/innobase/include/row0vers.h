@@ -42,10 +42,113 @@ Created 2/6/1997 Heikki Tuuri
 #include "rem0types.h"
 #include "mtr0mtr.h"
 #include "dict0mem.h"
+#include "sync0types.h"
+#include "ut0new.h"
+
+#include <map>
 
 // Forward declaration
 class ReadView;
 
+/** Cache of the old record versions that have been built for the
+consistent reads of one read view. A version is identified by the index
+and the roll pointer of the clustered index record that it was built
+from, because the roll pointer of a record that is not visible to the
+view points to an update undo log record that purge cannot remove while
+the view is open. The cache is shared by the threads that read in the
+same view, and it is emptied when it is full. */
+class VersionCache
+{
+public:
+	/** Constructor
+	@param[in]	max_size	maximum size of the cache in bytes */
+	explicit VersionCache(ulint max_size);
+
+	/** Destructor */
+	~VersionCache();
+
+	/** @return maximum size of the cache in bytes */
+	ulint max_size() const
+	{
+		return(m_max_size);
+	}
+
+	/** Look up the version that was built from a record.
+	@param[in]	index_id	clustered index id
+	@param[in]	roll_ptr	DB_ROLL_PTR of the record
+	@param[in]	trx_id		DB_TRX_ID of the record
+	@param[in,out]	heap		memory heap where the version is copied
+	@param[out]	rec		copy of the version, or NULL if the
+	record does not exist in the view
+	@return true if the version was found */
+	bool lookup(
+		index_id_t	index_id,
+		roll_ptr_t	roll_ptr,
+		trx_id_t	trx_id,
+		mem_heap_t*	heap,
+		rec_t**		rec);
+
+	/** Add the version that was built from a record.
+	@param[in]	index_id	clustered index id
+	@param[in]	roll_ptr	DB_ROLL_PTR of the record
+	@param[in]	trx_id		DB_TRX_ID of the record
+	@param[in]	rec		version that the view sees, or NULL
+	if the record does not exist in the view
+	@param[in]	offsets		rec_get_offsets(rec), or NULL */
+	void insert(
+		index_id_t	index_id,
+		roll_ptr_t	roll_ptr,
+		trx_id_t	trx_id,
+		const rec_t*	rec,
+		const ulint*	offsets);
+
+	/** Remove all the versions. */
+	void clear();
+
+private:
+	/** A cached version */
+	struct Version {
+		/** DB_TRX_ID of the record that the version was built
+		from */
+		trx_id_t	m_trx_id;
+
+		/** Copy of the version, starting at its extra bytes, or
+		NULL if the record does not exist in the view */
+		byte*		m_data;
+
+		/** rec_offs_extra_size() of the version */
+		ulint		m_extra;
+
+		/** rec_offs_size() of the version */
+		ulint		m_size;
+	};
+
+	typedef std::pair<index_id_t, roll_ptr_t> key_t;
+
+	typedef std::map<
+		key_t, Version, std::less<key_t>,
+		ut_allocator<std::pair<const key_t, Version> > > versions_t;
+
+	// Disable copying
+	VersionCache(const VersionCache&);
+	VersionCache& operator=(const VersionCache&);
+
+	/** Protects the other members */
+	OSMutex		m_mutex;
+
+	/** The cached versions */
+	versions_t	m_versions;
+
+	/** Memory heap for the copies of the versions */
+	mem_heap_t*	m_heap;
+
+	/** Approximate memory used by the cache, in bytes */
+	ulint		m_size;
+
+	/** Maximum size of the cache in bytes */
+	const ulint	m_max_size;
+};
+
 /*****************************************************************//**
 Finds out if an active transaction has inserted or modified a secondary
 index record.
@@ -150,6 +150,8 @@ enum monitor_id_t {
 	MONITOR_RECLOCK_CREATED,
 	MONITOR_RECLOCK_REMOVED,
 	MONITOR_NUM_RECLOCK,
+	MONITOR_LOCK_SHARD_WAIT,
+	MONITOR_LOCK_REC_X_RETRY,
 	MONITOR_TABLELOCK_CREATED,
 	MONITOR_TABLELOCK_REMOVED,
 	MONITOR_NUM_TABLELOCK,
@@ -243,6 +245,15 @@ enum monitor_id_t {
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_NUM_CALL,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL,
 
+	/* Page cleaner counters */
+	MONITOR_MODULE_PAGE_CLEANER,
+	MONITOR_PC_INSTANCE_LAG_MAX,
+	MONITOR_PC_INSTANCE_LAG_AVG,
+	MONITOR_PC_LAGGING_INSTANCE,
+	MONITOR_PC_SINGLE_PAGE_FLUSHES,
+	MONITOR_PC_STARVED_INSTANCE,
+	MONITOR_PC_INSTANCE_REQUESTS,
+
 	/* Buffer Page I/O specific counters. */
 	MONITOR_MODULE_BUF_PAGE,
 	MONITOR_INDEX_LEAF_PAGE_READ,
@@ -304,6 +315,10 @@ enum monitor_id_t {
 	MONITOR_NUM_UNDO_SLOT_USED,
 	MONITOR_NUM_UNDO_SLOT_CACHED,
 	MONITOR_RSEG_CUR_SIZE,
+	MONITOR_TRX_VERSION_BUILDS,
+	MONITOR_TRX_VERSION_UNDO_HOPS,
+	MONITOR_TRX_VERSION_CACHE_HITS,
+	MONITOR_TRX_UNDO_READ_AHEAD,
 
 	/* Purge related counters */
 	MONITOR_MODULE_PURGE,
@@ -314,6 +329,9 @@ enum monitor_id_t {
 	MONITOR_DML_PURGE_DELAY,
 	MONITOR_PURGE_STOP_COUNT,
 	MONITOR_PURGE_RESUME_COUNT,
+	MONITOR_PURGE_BATCH_SIZE,
+	MONITOR_PURGE_LAG_RECORDS,
+	MONITOR_PURGE_LAG_SECONDS,
 
 	/* Recovery related counters */
 	MONITOR_MODULE_RECOVERY,
@@ -332,6 +350,19 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
 	MONITOR_OVLD_LOG_PADDED,
+	MONITOR_LOG_CONCURRENT_COPIES,
+	MONITOR_LOG_COPY_SLOT_WAITS,
+	MONITOR_LOG_COPY_WRITE_WAITS,
+	MONITOR_LOG_WRITER_LAG,
+	MONITOR_LOG_FLUSHER_LAG,
+	MONITOR_LOG_LSN_WAITS,
+	MONITOR_LOG_LSN_WAIT_UNDER_100US,
+	MONITOR_LOG_LSN_WAIT_UNDER_1MS,
+	MONITOR_LOG_LSN_WAIT_UNDER_10MS,
+	MONITOR_LOG_LSN_WAIT_UNDER_100MS,
+	MONITOR_LOG_LSN_WAIT_OVER_100MS,
+	MONITOR_LOG_FLUSH_ORDER_WAITS,
+	MONITOR_LOG_FLUSH_ORDER_SLOT_WAITS,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
@@ -359,6 +390,8 @@ enum monitor_id_t {
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
 	MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+	MONITOR_ADAPTIVE_HASH_SEARCH_LOCK_FREE,
+	MONITOR_ADAPTIVE_HASH_LOCK_FREE_RETRY,
 
 	/* Tablespace related counters */
 	MONITOR_MODULE_FIL_SYSTEM,
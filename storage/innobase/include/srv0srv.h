@@ -236,6 +236,11 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/* If this flag is TRUE, Linux native aio uses io_uring instead of libaio */
+extern my_bool	srv_use_io_uring;
+/* If this flag is TRUE, file-per-table tablespaces are registered at
+startup from the tablespace directory cache written at shutdown */
+extern my_bool	srv_tablespace_cache;
 extern my_bool	srv_numa_interleave;
 #endif /* !UNIV_HOTBACKUP */
 
@@ -297,6 +302,15 @@ extern ulint	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
 extern ulong	srv_log_write_ahead_size;
+/** Whether mini-transactions copy their redo log records to the log
+buffer after releasing log_sys->mutex (innodb_log_concurrent_copy) */
+extern my_bool	srv_log_concurrent_copy;
+/** Whether to start dedicated log writer, flusher and notifier threads
+(innodb_log_writer_threads) */
+extern my_bool	srv_log_writer_threads;
+/** Whether mini-transactions add their dirty pages to the flush lists
+without log_flush_order_mutex (innodb_flush_list_relaxed_order) */
+extern my_bool	srv_flush_list_relaxed_order;
 extern char	srv_adaptive_flushing;
 extern my_bool	srv_flush_sync;
 
@@ -332,12 +346,18 @@ extern ulint	srv_buf_pool_base_size;
 extern ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 extern ulong	srv_buf_pool_dump_pct;
+/** Number of threads that read the pages of a buffer pool load */
+extern ulong	srv_buf_load_threads;
+/** Seconds between periodic buffer pool dumps, or 0 */
+extern ulong	srv_buf_dump_interval;
 /** Lock table size in bytes */
 extern ulint	srv_lock_table_size;
 
 extern ulint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+extern ulong	srv_undo_read_ahead;
+extern ulong	srv_version_cache_size;
 extern ulint	srv_n_read_io_threads;
 extern ulint	srv_n_write_io_threads;
 
@@ -367,6 +387,10 @@ extern ulint	srv_max_n_open_files;
 
 extern ulong	srv_n_page_cleaners;
 
+/** Whether each buffer pool instance is flushed by its own independently
+scheduled page cleaner */
+extern my_bool	srv_page_cleaner_per_instance;
+
 extern double	srv_max_dirty_pages_pct;
 extern double	srv_max_dirty_pages_pct_lwm;
 
@@ -377,6 +401,9 @@ extern ulong	srv_force_recovery;
 #ifndef NDEBUG
 extern ulong	srv_force_recovery_crash;
 #endif /* !NDEBUG */
+/** Number of threads that apply a batch of redo log records during crash
+recovery (innodb_recovery_apply_threads) */
+extern ulong	srv_recovery_apply_threads;
 
 extern ulint	srv_fast_shutdown;	/*!< If this is 1, do not do a
 					purge and index buffer merge.
@@ -391,10 +418,17 @@ extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
+extern my_bool			srv_stats_auto_recalc_incremental;
+extern ulong			srv_stats_analyze_threads;
 extern my_bool			srv_stats_include_delete_marked;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+/** Number of doublewrite files outside the system tablespace,
+0 to use the doublewrite buffer in the system tablespace */
+extern ulong	srv_doublewrite_files;
+/** Directory of the doublewrite files */
+extern char*	srv_doublewrite_dir;
 extern ulong	srv_checksum_algorithm;
 
 extern double	srv_max_buf_pool_modified_pct;
@@ -417,6 +451,9 @@ extern ibool	srv_buf_dump_thread_active;
 /* true during the lifetime of the buffer pool resize thread */
 extern bool	srv_buf_resize_thread_active;
 
+/* true while the tablespace directory cache is being validated */
+extern bool	srv_fil_dir_cache_thread_active;
+
 /* TRUE during the lifetime of the stats thread */
 extern ibool	srv_dict_stats_thread_active;
 
@@ -458,6 +495,9 @@ extern ulong srv_n_purge_threads;
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/* whether to purge more pages per batch while the history list grows */
+extern my_bool srv_adaptive_purge_batch_size;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -475,16 +515,23 @@ extern srv_stats_t	srv_stats;
 # ifdef UNIV_PFS_THREAD
 /* Keys to register InnoDB threads with performance schema */
 extern mysql_pfs_key_t	buf_dump_thread_key;
+extern mysql_pfs_key_t	fil_dir_cache_thread_key;
 extern mysql_pfs_key_t	dict_stats_thread_key;
+extern mysql_pfs_key_t	dict_stats_analyze_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	io_ibuf_thread_key;
 extern mysql_pfs_key_t	io_log_thread_key;
 extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
+extern mysql_pfs_key_t	log_notifier_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
 extern mysql_pfs_key_t	page_cleaner_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
+extern mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
@@ -972,6 +1019,7 @@ struct srv_slot_t{
 #else /* !UNIV_HOTBACKUP */
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_native_aio			FALSE
+# define srv_use_io_uring			FALSE
 # define srv_numa_interleave			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
@@ -218,6 +218,8 @@ enum latch_level_t {
 
 	SYNC_MONITOR_MUTEX,
 
+	SYNC_FIL_SHARD,
+
 	SYNC_ANY_LATCH,
 
 	SYNC_DOUBLEWRITE,
@@ -250,7 +252,9 @@ enum latch_level_t {
 	SYNC_REC_LOCK,
 	SYNC_THREADS,
 	SYNC_TRX,
+	SYNC_TRX_SYS_SHARD,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_SYS_SHARD,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
@@ -324,6 +328,7 @@ enum latch_id_t {
 	LATCH_ID_DICT_SYS,
 	LATCH_ID_FILE_FORMAT_MAX,
 	LATCH_ID_FIL_SYSTEM,
+	LATCH_ID_FIL_SHARD,
 	LATCH_ID_FLUSH_LIST,
 	LATCH_ID_FTS_BG_THREADS,
 	LATCH_ID_FTS_DELETE,
@@ -366,6 +371,9 @@ enum latch_id_t {
 	LATCH_ID_LOCK_SYS,
 	LATCH_ID_LOCK_SYS_WAIT,
 	LATCH_ID_TRX_SYS,
+	LATCH_ID_MVCC_VIEW,
+	LATCH_ID_TRX_SYS_SHARD,
+	LATCH_ID_LOCK_SYS_SHARD,
 	LATCH_ID_SRV_SYS,
 	LATCH_ID_SRV_SYS_TASKS,
 	LATCH_ID_PAGE_ZIP_STAT_PER_INDEX,
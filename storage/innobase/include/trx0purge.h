@@ -102,6 +102,13 @@ trx_purge(
 					records to purge in one batch */
 	bool	truncate);		/*!< in: truncate history if true */
 /*******************************************************************//**
+Update the purge lag monitor counters (purge_lag_records and
+purge_lag_seconds) from the history list length and the progress of
+purge. Invoked by the master thread once a second. */
+void
+trx_purge_update_lag(void);
+/*======================*/
+/*******************************************************************//**
 Stop purge and wait for it to stop, move to PURGE_STATE_STOP. */
 void
 trx_purge_stop(void);
@@ -131,6 +138,18 @@ trx_purge_state(void);
 // Forward declaration
 struct TrxUndoRsegsIterator;
 
+/** Number of samples of the transaction number counter that are kept for
+estimating the purge lag in seconds. When all are in use, the samples are
+thinned out, so that they can cover a lag of any length. */
+#define PURGE_LAG_N_SAMPLES	64
+
+/** A sample of the transaction number counter */
+struct purge_lag_sample_t {
+	trx_id_t	trx_no;		/*!< Transactions that committed
+					before time have a smaller number */
+	ib_time_t	time;		/*!< Time of the sample */
+};
+
 /** This is the purge pointer/iterator. We need both the undo no and the
 transaction no up to which purge has parsed and applied the records. */
 struct purge_iter_t {
@@ -470,6 +489,23 @@ struct trx_purge_t{
 
 	undo::Truncate	undo_trunc;	/*!< Track UNDO tablespace marked
 					for truncate. */
+
+	mem_heap_t*	heap;		/*!< Memory heap for the UNDO records
+					of the current batch; it is emptied
+					when the next batch is fetched */
+	ib_uint64_t	n_recs_fetched;	/*!< Number of UNDO records fetched,
+					for estimating the purge lag */
+	ib_uint64_t	n_logs_fetched;	/*!< Number of UNDO logs whose
+					records were fetched */
+	purge_lag_sample_t
+			lag_samples[PURGE_LAG_N_SAMPLES];
+					/*!< Samples of trx_sys->max_trx_id,
+					taken at most once a second, oldest
+					first; the first one is the latest
+					that purge has passed, if any.
+					Only accessed by the master thread */
+	ulint		n_lag_samples;	/*!< Number of samples in
+					lag_samples */
 };
 
 /** Info required to purge a record */
@@ -165,6 +165,12 @@ UNIV_INLINE
 trx_id_t
 trx_sys_get_new_trx_id();
 /*===================*/
+/** Allocates a new read-write transaction id and registers it as active
+in trx_sys_t::rw_trx_ids and trx_sys_t::rw_trx_active.
+@return new, allocated trx id */
+UNIV_INLINE
+trx_id_t
+trx_sys_get_new_rw_trx_id();
 /*****************************************************************//**
 Determines the maximum transaction id.
 @return maximum currently allocated trx id; will be stale after the
@@ -424,6 +430,27 @@ UNIV_INLINE
 void
 trx_sys_rw_trx_add(trx_t* trx);
 
+/** Get the shard of the read-write transaction set for a transaction id.
+@param[in]	trx_id	transaction id
+@return shard */
+UNIV_INLINE
+trx_sys_shard_t*
+trx_sys_get_shard(trx_id_t trx_id);
+
+/** Insert a transaction into its shard of the read-write transaction set.
+The caller need not own trx_sys->mutex.
+@param[in]	trx	transaction with trx->id > 0 */
+UNIV_INLINE
+void
+trx_sys_rw_trx_set_insert(trx_t* trx);
+
+/** Remove a transaction from its shard of the read-write transaction set.
+The caller need not own trx_sys->mutex.
+@param[in]	trx	transaction with trx->id > 0 */
+UNIV_INLINE
+void
+trx_sys_rw_trx_set_erase(trx_t* trx);
+
 #ifdef UNIV_DEBUG
 /*************************************************************//**
 Validate the trx_sys_t::rw_trx_list.
@@ -563,6 +590,19 @@ identifier is added to this 64-bit constant. */
 /* @} */
 
 #ifndef UNIV_HOTBACKUP
+/** Number of shards of the read-write transaction set */
+#define TRX_SYS_N_SHARDS	64
+
+/** A shard of the read-write transactions, selected by transaction id */
+struct trx_sys_shard_t {
+	TrxSysMutex	mutex;		/*!< mutex protecting rw_trx_set */
+
+	TrxIdSet	rw_trx_set;	/*!< Mapping from transaction id
+					to transaction instance */
+
+	char		pad[64];	/*!< To avoid false sharing */
+};
+
 /** The transaction system central memory data structure. */
 struct trx_sys_t {
 
@@ -582,6 +622,12 @@ struct trx_sys_t {
 	trx_ut_list_t	serialisation_list;
 					/*!< Ordered on trx_t::no of all the
 					currenrtly active RW transactions */
+	volatile trx_id_t
+			serialisation_min_no;
+					/*!< trx_t::no of the first transaction
+					in serialisation_list, or TRX_ID_MAX
+					if the list is empty. Read without
+					the mutex by ReadView::prepare() */
 #ifdef UNIV_DEBUG
 	trx_id_t	rw_max_trx_id;	/*!< Max trx id of read-write
 					transactions which exist or existed */
@@ -613,6 +659,15 @@ struct trx_sys_t {
 					to ensure right order of removal and
 					consistent snapshot. */
 
+	TrxIdRegistry	rw_trx_active;	/*!< The ids in rw_trx_ids, readable
+					without the mutex when creating a
+					ReadView */
+
+	volatile trx_id_t
+			rw_trx_min_id;	/*!< The first element of rw_trx_ids,
+					or 0 if it is empty. Read without
+					the mutex by trx_rw_min_trx_id() */
+
 	char		pad3[64];	/*!< To avoid false sharing */
 	trx_rseg_t*	rseg_array[TRX_SYS_N_RSEGS];
 					/*!< Pointer array to rollback
@@ -635,8 +690,10 @@ struct trx_sys_t {
 					scheduling purge if any of the rollback
 					segment has pending records to purge. */
 
-	TrxIdSet	rw_trx_set;	/*!< Mapping from transaction id
-					to transaction instance */
+	trx_sys_shard_t	rw_trx_shards[TRX_SYS_N_SHARDS];
+					/*!< Mapping from transaction id
+					to transaction instance, sharded on
+					the transaction id */
 
 	ulint		n_prepared_trx;	/*!< Number of transactions currently
 					in the XA PREPARED state */
@@ -699,6 +699,20 @@ The tranasction must be in the mysql_trx_list. */
 
 typedef std::vector<ib_lock_t*, ut_allocator<ib_lock_t*> >	lock_pool_t;
 
+/** Maximum number of transactions whose schedule weight a waiting
+transaction can increase */
+#define TRX_SCHEDULE_MAX_DEBTS	16
+
+/** Schedule weight that a waiting transaction added to another one, to be
+taken back when the wait ends */
+struct trx_schedule_debt_t {
+	trx_t*		trx;		/*!< transaction whose weight was
+					increased */
+	ulint		epoch;		/*!< trx->lock.schedule_epoch when
+					the weight was added */
+	ulint		weight;		/*!< the weight that was added */
+};
+
 /*******************************************************************//**
 Latching protocol for trx_lock_t::que_state.  trx_lock_t::que_state
 captures the state of the query thread during the execution of a query.
@@ -791,6 +805,36 @@ struct trx_lock_t {
 					and the trx_t::mutex. */
 	ulint		n_rec_locks;	/*!< number of rec locks in this trx */
 
+	ulint		schedule_weight;/*!< approximate number of
+					transactions that are waiting,
+					directly or through other waits, for
+					the locks of this transaction; used
+					when innodb_lock_schedule_algorithm
+					is CATS. Increased and reset under
+					lock_sys->latch in exclusive mode,
+					decreased atomically under the
+					shared latch when a wait ends */
+
+	ulint		schedule_epoch;	/*!< incremented when
+					schedule_weight is reset at the end
+					of the transaction, so that waits
+					ending later do not decrease it;
+					protected by lock_sys->latch in
+					exclusive mode */
+
+	trx_schedule_debt_t
+			schedule_debts[TRX_SCHEDULE_MAX_DEBTS];
+					/*!< the weight added to other
+					transactions by the current record
+					lock wait; protected by
+					lock_sys->latch in exclusive mode, or
+					in shared mode by the shard of the
+					waiting lock */
+
+	ulint		n_schedule_debts;
+					/*!< number of elements in
+					schedule_debts */
+
 	/** The transaction called ha_innobase::start_stmt() to
 	lock a table. Most likely a temporary table. */
 	bool		start_stmt;
@@ -124,6 +124,8 @@ struct trx_t;
 struct trx_lock_t;
 /** Transaction system */
 struct trx_sys_t;
+/** Shard of the read-write transactions in trx_sys_t */
+struct trx_sys_shard_t;
 /** Signal */
 struct trx_sig_t;
 /** Rollback segment */
@@ -327,4 +329,101 @@ struct TrxTrackCmp {
 typedef std::set<TrxTrack, TrxTrackCmp, ut_allocator<TrxTrack> >
 	TrxIdSet;
 
+/** Registry of the ids of the active read-write transactions that can be
+read without holding trx_sys_t::mutex. The ids are spread over cache line
+aligned shards of fixed size slots. Modifications are serialised by the
+caller (trx_sys_t::mutex). Erasing an id is bracketed by a version
+counter, so that a reader can detect that a transaction committed while
+it was copying the ids and retry. Ids that do not fit into the slots are
+only counted, and readers must then fall back to trx_sys_t::rw_trx_ids. */
+class TrxIdRegistry {
+public:
+	/** Number of shards */
+	static const ulint	N_SHARDS = 64;
+
+	/** Number of slots in a shard */
+	static const ulint	N_SLOTS = 256;
+
+	TrxIdRegistry();
+
+	~TrxIdRegistry();
+
+	/** Add an active transaction id. The caller must make the id visible
+	to readers (advance trx_sys_t::max_trx_id past it) only after this.
+	@param[in]	id	transaction id, must be > 0 */
+	void insert(trx_id_t id);
+
+	/** Remove a transaction id that was added by insert().
+	@param[in]	id	transaction id */
+	void erase(trx_id_t id);
+
+	/** Start a lock-free read.
+	@return the version to pass to read_validate(), or ULINT_UNDEFINED if
+	an erase() is in progress */
+	ulint read_begin() const;
+
+	/** Check that no erase() was started since read_begin().
+	@param[in]	version	value returned by read_begin()
+	@return true if the ids copied since read_begin() are consistent */
+	bool read_validate(ulint version) const;
+
+	/** @return true if some active ids are not stored in the slots */
+	bool overflowed() const
+	{
+		return(m_n_overflow > 0);
+	}
+
+	/** @return approximate number of active ids */
+	ulint size() const
+	{
+		return(m_n_active);
+	}
+
+	/** Copy the active transaction ids less than limit, in no particular
+	order. Must be called between read_begin() and read_validate().
+	@param[out]	ids	array of n_max elements
+	@param[in]	n_max	size of ids
+	@param[in]	limit	copy only the ids < limit
+	@param[in]	skip	id not to copy, 0 if none
+	@return number of ids copied, or ULINT_UNDEFINED if ids is too small */
+	ulint copy(
+		trx_id_t*	ids,
+		ulint		n_max,
+		trx_id_t	limit,
+		trx_id_t	skip) const;
+
+private:
+	/** Slots of the ids that map to the same shard */
+	struct shard_t {
+		/** Number of slots in use, the free slots below it are 0 */
+		volatile ulint		n_used;
+
+		/** N_SLOTS slots, 0 when free */
+		volatile trx_id_t*	slots;
+
+		byte			pad[64 - sizeof(ulint)
+					    - sizeof(trx_id_t*)];
+	};
+
+	/** Shards of the registry */
+	shard_t			m_shards[N_SHARDS];
+
+	/** Memory of all the slots */
+	trx_id_t*		m_slots;
+
+	/** Incremented before and after an erase(), odd while one is
+	in progress */
+	volatile ulint		m_version;
+
+	/** Number of the active ids that did not fit into the slots */
+	volatile ulint		m_n_overflow;
+
+	/** Number of the active ids */
+	volatile ulint		m_n_active;
+
+	// Disable copying
+	TrxIdRegistry(const TrxIdRegistry&);
+	TrxIdRegistry& operator=(const TrxIdRegistry&);
+};
+
 #endif /* trx0types_h */
@@ -62,7 +62,33 @@ extern ut_crc32_func_t	ut_crc32_legacy_big_endian;
 but very slow). */
 extern ut_crc32_func_t	ut_crc32_byte_by_byte;
 
+/** Pointer to CRC32 calculation function that processes the input as one
+sequential stream. ut_crc32 interleaves three streams when the CPU
+supports carry-less multiplication; this is kept for comparison. */
+extern ut_crc32_func_t	ut_crc32_serial;
+
+/********************************************************************//**
+Calculates CRC32 of several buffers of the same length, such as the pages
+of a doublewrite batch. This is faster than calling ut_crc32() for each
+buffer because the buffers are processed in parallel.
+@param bufs - buffers over which to calculate CRC32.
+@param n - number of buffers.
+@param len - length of each buffer in bytes.
+@param crcs - out: CRC32 of each buffer, the same as ut_crc32() returns */
+typedef void	(*ut_crc32_batch_func_t)(
+	const byte* const*	bufs,
+	ulint			n,
+	ulint			len,
+	uint32_t*		crcs);
+
+/** Pointer to the function that calculates CRC32 of several buffers. */
+extern ut_crc32_batch_func_t	ut_crc32_batch;
+
 /** Flag that tells whether the CPU supports CRC32 or not */
 extern bool		ut_crc32_sse2_enabled;
 
+/** Flag that tells whether the CPU supports carry-less multiplication,
+which ut_crc32() uses for combining interleaved streams */
+extern bool		ut_crc32_pclmul_enabled;
+
 #endif /* ut0crc32_h */
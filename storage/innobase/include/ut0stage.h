@@ -45,8 +45,10 @@ Created Nov 12, 2014 Vasil Dimov
 #include "univ.i"
 
 #include "dict0mem.h" /* dict_index_t */
+#include "os0thread.h" /* os_thread_get_curr_id() */
 #include "row0log.h" /* row_log_estimate_work() */
 #include "srv0srv.h" /* ut_stage_alter_t */
+#include "sync0types.h" /* OSMutex */
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
 
@@ -79,7 +81,13 @@ begin_phase_end()
 destructor
 
 This class knows the specifics of each phase and tries to increment the
-progress in an even manner across the entire ALTER TABLE lifetime. */
+progress in an even manner across the entire ALTER TABLE lifetime.
+
+The counting methods may be called from the threads that read, sort and
+insert on behalf of ALTER TABLE at the same time. The phases are only
+changed by the thread that called begin_phase_read_pk(), because
+mysql_set_stage() affects the calling thread; when another thread begins
+a phase, its work is counted in the current phase. */
 class ut_stage_alter_t {
 public:
 	/** Constructor.
@@ -88,6 +96,7 @@ public:
 	ut_stage_alter_t(
 		const dict_index_t*	pk)
 		:
+		m_thread_id(os_thread_get_curr_id()),
 		m_progress(NULL),
 		m_pk(pk),
 		m_n_pk_recs(0),
@@ -96,6 +105,7 @@ public:
 		m_n_flush_pages(0),
 		m_cur_phase(NOT_STARTED)
 	{
+		m_mutex.init();
 	}
 
 	/** Destructor. */
@@ -108,13 +118,15 @@ public:
 	begin_phase_read_pk(
 		ulint	n_sort_indexes);
 
-	/** Increment the number of records in PK (table) with 1.
+	/** Increment the number of records in PK (table).
 	This is used to get more accurate estimate about the number of
 	records per page which is needed because some phases work on
 	per-page basis while some work on per-record basis and we want
-	to get the progress as even as possible. */
+	to get the progress as even as possible.
+	@param[in]	n	number of records read */
 	void
-	n_pk_recs_inc();
+	n_pk_recs_inc(
+		ulint	n = 1);
 
 	/** Flag either one record or one page processed, depending on the
 	current phase.
@@ -166,12 +178,19 @@ private:
 	void
 	reestimate();
 
-	/** Change the current phase.
+	/** Change the current phase, if called from the thread that
+	began ALTER TABLE. The caller must hold m_mutex.
 	@param[in]	new_stage	pointer to the new stage to change to */
 	void
 	change_phase(
 		const PSI_stage_info*	new_stage);
 
+	/** Protects the counters and the current phase */
+	OSMutex			m_mutex;
+
+	/** The thread that called begin_phase_read_pk() */
+	os_thread_id_t		m_thread_id;
+
 	/** Performance schema accounting object. */
 	PSI_stage_progress*	m_progress;
 
@@ -221,6 +240,8 @@ private:
 inline
 ut_stage_alter_t::~ut_stage_alter_t()
 {
+	m_mutex.destroy();
+
 	if (m_progress == NULL) {
 		return;
 	}
@@ -241,6 +262,10 @@ void
 ut_stage_alter_t::begin_phase_read_pk(
 	ulint	n_sort_indexes)
 {
+	m_mutex.enter();
+
+	m_thread_id = os_thread_get_curr_id();
+
 	m_n_sort_indexes = n_sort_indexes;
 
 	m_cur_phase = READ_PK;
@@ -251,18 +276,24 @@ ut_stage_alter_t::begin_phase_read_pk(
 	mysql_stage_set_work_completed(m_progress, 0);
 
 	reestimate();
+
+	m_mutex.exit();
 }
 
-/** Increment the number of records in PK (table) with 1.
+/** Increment the number of records in PK (table).
 This is used to get more accurate estimate about the number of
 records per page which is needed because some phases work on
 per-page basis while some work on per-record basis and we want
-to get the progress as even as possible. */
+to get the progress as even as possible.
+@param[in]	n	number of records read */
 inline
 void
-ut_stage_alter_t::n_pk_recs_inc()
+ut_stage_alter_t::n_pk_recs_inc(
+	ulint	n /* = 1 */)
 {
-	m_n_pk_recs++;
+	m_mutex.enter();
+	m_n_pk_recs += n;
+	m_mutex.exit();
 }
 
 /** Flag either one record or one page processed, depending on the
@@ -273,7 +304,10 @@ void
 ut_stage_alter_t::inc(
 	ulint	inc_val /* = 1 */)
 {
+	m_mutex.enter();
+
 	if (m_progress == NULL) {
+		m_mutex.exit();
 		return;
 	}
 
@@ -332,6 +366,8 @@ ut_stage_alter_t::inc(
 		mysql_stage_inc_work_completed(m_progress, inc_val);
 		reestimate();
 	}
+
+	m_mutex.exit();
 }
 
 /** Flag the end of reading of the primary key.
@@ -341,6 +377,8 @@ inline
 void
 ut_stage_alter_t::end_phase_read_pk()
 {
+	m_mutex.enter();
+
 	reestimate();
 
 	if (m_n_pk_pages == 0) {
@@ -353,6 +391,8 @@ ut_stage_alter_t::end_phase_read_pk()
 			static_cast<double>(m_n_pk_recs) / m_n_pk_pages,
 			1.0);
 	}
+
+	m_mutex.exit();
 }
 
 /** Flag the beginning of the sort phase.
@@ -364,7 +404,12 @@ void
 ut_stage_alter_t::begin_phase_sort(
 	double	sort_multi_factor)
 {
-	if (sort_multi_factor <= 1.0) {
+	m_mutex.enter();
+
+	if (!os_thread_eq(os_thread_get_curr_id(), m_thread_id)) {
+		/* Keep the phase and its factor of the thread that
+		began ALTER TABLE. */
+	} else if (sort_multi_factor <= 1.0) {
 		m_sort_multi_factor = 1;
 	} else {
 		m_sort_multi_factor = static_cast<ulint>(
@@ -372,6 +417,8 @@ ut_stage_alter_t::begin_phase_sort(
 	}
 
 	change_phase(&srv_stage_alter_table_merge_sort);
+
+	m_mutex.exit();
 }
 
 /** Flag the beginning of the insert phase. */
@@ -379,7 +426,9 @@ inline
 void
 ut_stage_alter_t::begin_phase_insert()
 {
+	m_mutex.enter();
 	change_phase(&srv_stage_alter_table_insert);
+	m_mutex.exit();
 }
 
 /** Flag the beginning of the flush phase.
@@ -390,11 +439,15 @@ void
 ut_stage_alter_t::begin_phase_flush(
 	ulint	n_flush_pages)
 {
+	m_mutex.enter();
+
 	m_n_flush_pages = n_flush_pages;
 
 	reestimate();
 
 	change_phase(&srv_stage_alter_table_flush);
+
+	m_mutex.exit();
 }
 
 /** Flag the beginning of the log index phase. */
@@ -402,7 +455,9 @@ inline
 void
 ut_stage_alter_t::begin_phase_log_index()
 {
+	m_mutex.enter();
 	change_phase(&srv_stage_alter_table_log_index);
+	m_mutex.exit();
 }
 
 /** Flag the beginning of the log table phase. */
@@ -410,7 +465,9 @@ inline
 void
 ut_stage_alter_t::begin_phase_log_table()
 {
+	m_mutex.enter();
 	change_phase(&srv_stage_alter_table_log_table);
+	m_mutex.exit();
 }
 
 /** Flag the beginning of the end phase. */
@@ -418,7 +475,9 @@ inline
 void
 ut_stage_alter_t::begin_phase_end()
 {
+	m_mutex.enter();
 	change_phase(&srv_stage_alter_table_end);
+	m_mutex.exit();
 }
 
 /** Update the estimate of total work to be done. */
@@ -474,14 +533,16 @@ ut_stage_alter_t::reestimate()
 	mysql_stage_set_work_estimated(m_progress, estimate);
 }
 
-/** Change the current phase.
+/** Change the current phase, if called from the thread that began
+ALTER TABLE. The caller must hold m_mutex.
 @param[in]	new_stage	pointer to the new stage to change to */
 inline
 void
 ut_stage_alter_t::change_phase(
 	const PSI_stage_info*	new_stage)
 {
-	if (m_progress == NULL) {
+	if (m_progress == NULL
+	    || !os_thread_eq(os_thread_get_curr_id(), m_thread_id)) {
 		return;
 	}
 
@@ -528,7 +589,8 @@ public:
 	}
 
 	void
-	n_pk_recs_inc()
+	n_pk_recs_inc(
+		ulint	n = 1)
 	{
 	}
 
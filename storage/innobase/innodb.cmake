@@ -42,6 +42,23 @@ IF(UNIX)
     IF(HAVE_LIBAIO_H AND HAVE_LIBAIO)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
+
+      # The io_uring backend invokes the system calls directly and falls
+      # back to libaio at startup if the kernel does not support it.
+      CHECK_C_SOURCE_COMPILES("
+      #include <linux/io_uring.h>
+      #include <sys/syscall.h>
+      int main() {
+        struct io_uring_getevents_arg arg;
+        arg.ts = 0;
+        return(__NR_io_uring_setup + IORING_FEAT_EXT_ARG
+               + IORING_OP_READ_FIXED + (int) arg.ts);
+      }"
+      HAVE_LINUX_IO_URING)
+
+      IF(HAVE_LINUX_IO_URING)
+        ADD_DEFINITIONS(-DLINUX_IO_URING=1)
+      ENDIF()
     ENDIF()
 
   ELSEIF(CMAKE_SYSTEM_NAME STREQUAL "SunOS")
@@ -49,6 +49,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "trx0purge.h"
 #include "trx0sys.h"
 #include "srv0mon.h"
+#include "sync0sync.h"
 #include "ut0vec.h"
 #include "btr0btr.h"
 #include "dict0boot.h"
@@ -57,11 +58,60 @@ Created 5/7/1996 Heikki Tuuri
 #include "row0mysql.h"
 #include "pars0pars.h"
 
+#include <algorithm>
 #include <set>
 
 /* Flag to enable/disable deadlock detector. */
 my_bool	innobase_deadlock_detect = TRUE;
 
+/* Flag to detect deadlocks in a background thread. */
+my_bool	innobase_deadlock_detect_async = FALSE;
+
+/* The algorithm for granting waiting record locks. */
+ulong	innobase_lock_schedule_algorithm = LOCK_SCHEDULE_FCFS;
+
+/** Maximum length of the chain of waiting transactions along which
+the schedule weight of a new waiter is propagated */
+static const ulint	LOCK_SCHEDULE_MAX_DEPTH = 8;
+
+/** Number of waiting transactions whose edges in the wait-for graph are
+copied in one batch under lock_sys->latch by lock_detect_deadlocks() */
+static const ulint	LOCK_DEADLOCK_COPY_BATCH = 32;
+
+/** A transaction suspended in a lock wait, in the copy of the wait-for
+graph that DeadlockChecker::check_waits() searches for cycles */
+struct lock_wait_node_t {
+	trx_t*		trx;		/*!< waiting transaction */
+	ulint		first_edge;	/*!< position of the first
+					transaction that trx waits for,
+					in the array of edges */
+	ulint		n_edges;	/*!< number of transactions that
+					trx waits for */
+	ulint		next_edge;	/*!< next edge to follow in the
+					search */
+	ulint		state;		/*!< search state */
+};
+
+/** Orders the nodes of the wait-for graph by the transaction */
+struct lock_wait_node_less {
+	bool operator()(
+		const lock_wait_node_t&	a,
+		const lock_wait_node_t&	b) const
+	{
+		return(std::less<const trx_t*>()(a.trx, b.trx));
+	}
+};
+
+typedef std::vector<lock_wait_node_t, ut_allocator<lock_wait_node_t> >
+	lock_wait_nodes_t;
+
+/** Positions of nodes in lock_wait_nodes_t */
+typedef std::vector<ulint, ut_allocator<ulint> >	lock_wait_edges_t;
+
+/** Transactions that a lock request waits for */
+typedef std::vector<const trx_t*, ut_allocator<const trx_t*> >
+	lock_blockers_t;
+
 /** Total number of cached record locks */
 static const ulint	REC_LOCK_CACHE = 8;
 
@@ -93,6 +143,13 @@ public:
 		const lock_t*	lock,
 		trx_t*		trx);
 
+	/** Checks the transactions that are suspended in lock waits
+	for deadlocks. The wait-for graph is copied in batches under
+	lock_sys->latch, and searched for cycles without it. A cycle is
+	checked again under the latch before a victim is rolled back,
+	because the copy is not a consistent snapshot. */
+	static void check_waits();
+
 private:
 	/** Do a shallow copy. Default destructor OK.
 	@param trx the start transaction (start node)
@@ -234,6 +291,35 @@ private:
 	@param lock lock trx wants */
 	static void rollback_print(const trx_t* trx, const lock_t* lock);
 
+	/** Collects the transactions that a waiting lock request has to
+	wait for, that is, the owners of the conflicting lock requests
+	ahead of it in the queue.
+	@param[in]	wait_lock	waiting lock request
+	@param[out]	blockers	blocking transactions */
+	static void get_blockers(
+		const lock_t*		wait_lock,
+		lock_blockers_t&	blockers);
+
+	/** Searches the copy of the wait-for graph for a cycle.
+	@param[in,out]	nodes	waiting transactions
+	@param[in]	edges	transactions that they wait for
+	@param[out]	cycle	nodes of the cycle that was found
+	@return true if a cycle was found */
+	static bool find_cycle(
+		lock_wait_nodes_t&		nodes,
+		const lock_wait_edges_t&	edges,
+		lock_wait_edges_t&		cycle);
+
+	/** Checks that a cycle found in the copy of the wait-for graph
+	still exists, and rolls back the lightest transaction of it.
+	@param[in]	nodes	waiting transactions
+	@param[in]	cycle	nodes of the cycle
+	@return position of the node to remove from the graph: the victim,
+	or a transaction whose wait has changed since the copy */
+	static ulint resolve_cycle(
+		const lock_wait_nodes_t&	nodes,
+		const lock_wait_edges_t&	cycle);
+
 private:
 	/** DFS state information, used during deadlock checking. */
 	struct state_t {
@@ -242,6 +328,14 @@ private:
 		ulint		m_heap_no;	/*!< heap number if rec lock */
 	};
 
+	/** Search states of lock_wait_node_t */
+	enum {
+		NODE_NEW,		/*!< Not visited yet */
+		NODE_ON_STACK,		/*!< On the path being searched */
+		NODE_DONE,		/*!< Not part of any cycle */
+		NODE_REMOVED		/*!< Not waiting, or a victim */
+	};
+
 	/** Used in deadlock tracking. Protected by lock_sys->mutex. */
 	static ib_uint64_t	s_lock_mark_counter;
 
@@ -451,12 +545,19 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create(LATCH_ID_LOCK_SYS, &lock_sys->mutex);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_SYS_N_SHARDS; ++i) {
+		mutex_create(LATCH_ID_LOCK_SYS_SHARD,
+			     &lock_sys->shards[i].mutex);
+	}
 
 	mutex_create(LATCH_ID_LOCK_SYS_WAIT, &lock_sys->wait_mutex);
 
 	lock_sys->timeout_event = os_event_create(0);
 
+	lock_sys->deadlock_event = os_event_create(0);
+
 	lock_sys->rec_hash = hash_create(n_cells);
 	lock_sys->prdt_hash = hash_create(n_cells);
 	lock_sys->prdt_page_hash = hash_create(n_cells);
@@ -467,6 +568,84 @@ lock_sys_create(
 	}
 }
 
+/** Get the shard of the record lock hash table that contains the locks on
+a page. The caller must hold lock_sys->latch, so that rec_hash cannot be
+resized.
+@param[in]	space	tablespace identifier
+@param[in]	page_no	page number
+@return shard */
+static
+lock_sys_shard_t*
+lock_sys_get_shard(
+	ulint	space,
+	ulint	page_no)
+{
+	ulint	cell = lock_rec_hash(space, page_no);
+
+	return(&lock_sys->shards[cell % LOCK_SYS_N_SHARDS]);
+}
+
+/** Acquire lock_sys->latch in shared mode and the mutex of the shard that
+contains the record locks on a page. This allows to inspect and modify the
+record lock queue of the page, except for suspending or waking up a
+waiting transaction, which requires the exclusive lock_sys->latch.
+@param[in]	block	buffer block
+@return shard, to be passed to lock_shard_exit() */
+static
+lock_sys_shard_t*
+lock_shard_enter(
+	const buf_block_t*	block)
+{
+	ut_ad(!lock_mutex_own());
+
+	rw_lock_s_lock(&lock_sys->latch);
+
+	lock_sys_shard_t*	shard = lock_sys_get_shard(
+		block->page.id.space(), block->page.id.page_no());
+
+	if (shard->mutex.trylock(__FILE__, __LINE__) != 0) {
+
+		MONITOR_ATOMIC_INC(MONITOR_LOCK_SHARD_WAIT);
+
+		mutex_enter(&shard->mutex);
+	}
+
+	return(shard);
+}
+
+/** Release the latches acquired by lock_shard_enter().
+@param[in,out]	shard	shard returned by lock_shard_enter() */
+static
+void
+lock_shard_exit(
+	lock_sys_shard_t*	shard)
+{
+	mutex_exit(&shard->mutex);
+
+	rw_lock_s_unlock(&lock_sys->latch);
+}
+
+#ifdef UNIV_DEBUG
+/** Check if the caller may inspect and modify the record lock queue of a
+page: it holds lock_sys->latch in exclusive mode, or in shared mode
+together with the mutex of the shard of the page.
+@param[in]	space	tablespace identifier
+@param[in]	page_no	page number
+@return true if the record lock queue of the page is latched */
+bool
+lock_rec_queue_own(
+	ulint	space,
+	ulint	page_no)
+{
+	if (lock_mutex_own()) {
+		return(true);
+	}
+
+	return(rw_lock_own(&lock_sys->latch, RW_LOCK_S)
+	       && lock_sys_get_shard(space, page_no)->mutex.is_owned());
+}
+#endif /* UNIV_DEBUG */
+
 /** Calculates the fold value of a lock: used in migrating the hash table.
 @param[in]	lock	record lock object
 @return	folded value */
@@ -552,7 +731,14 @@ lock_sys_close(void)
 
 	os_event_destroy(lock_sys->timeout_event);
 
-	mutex_destroy(&lock_sys->mutex);
+	os_event_destroy(lock_sys->deadlock_event);
+
+	rw_lock_free(&lock_sys->latch);
+
+	for (ulint i = 0; i < LOCK_SYS_N_SHARDS; ++i) {
+		mutex_destroy(&lock_sys->shards[i].mutex);
+	}
+
 	mutex_destroy(&lock_sys->wait_mutex);
 
 	srv_slot_t*	slot = lock_sys->waiting_threads;
@@ -747,7 +933,9 @@ lock_reset_lock_and_trx_wait(
 {
 	ut_ad(lock->trx->lock.wait_lock == lock);
 	ut_ad(lock_get_wait(lock));
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_type_low(lock) == LOCK_REC
+	      ? lock_rec_queue_own(lock->space(), lock->page_number())
+	      : lock_mutex_own());
 
 	lock->trx->lock.wait_lock = NULL;
 	lock->type_mode &= ~LOCK_WAIT;
@@ -967,7 +1155,7 @@ lock_rec_reset_nth_bit(
 
 	if (bit != 0) {
 		ut_ad(lock->trx->lock.n_rec_locks > 0);
-		--lock->trx->lock.n_rec_locks;
+		os_atomic_decrement_ulint(&lock->trx->lock.n_rec_locks, 1);
 	}
 
 	return(bit);
@@ -1116,7 +1304,8 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1165,7 +1354,8 @@ lock_rec_other_has_expl_req(
 					are taken into account */
 {
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	/* Only GAP lock can be on SUPREMUM, and we are not looking for
@@ -1211,7 +1401,8 @@ lock_rec_other_has_conflicting(
 {
 	const lock_t*		lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(block->page.id.space(),
+				 block->page.id.page_no()));
 
 	bool	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1439,7 +1630,8 @@ RecLock::lock_alloc(
 	const RecID&	rec_id,
 	ulint		size)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(rec_id.m_space_id, rec_id.m_page_no));
+	ut_ad(trx_mutex_own(trx));
 
 	lock_t*	lock;
 
@@ -1489,9 +1681,9 @@ RecLock::lock_alloc(
 
 	lock_rec_set_nth_bit(lock, rec_id.m_heap_no);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
 
 	return(lock);
 }
@@ -1503,13 +1695,15 @@ Add the lock to the record lock hash and the transaction's lock list
 void
 RecLock::lock_add(lock_t* lock, bool add_to_hash)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 	ut_ad(trx_mutex_own(lock->trx));
 
 	if (add_to_hash) {
 		ulint	key = m_rec_id.fold();
 
-		++lock->index->table->n_rec_locks;
+		/* Record locks on the same table may be added to pages
+		of different shards concurrently. */
+		os_atomic_increment_ulint(&lock->index->table->n_rec_locks, 1);
 
 		HASH_INSERT(lock_t, hash, lock_hash_get(m_mode), key, lock);
 	}
@@ -1535,9 +1729,19 @@ RecLock::create(
 	bool	add_to_hash,
 	const	lock_prdt_t* prdt)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 	ut_ad(owns_trx_mutex == trx_mutex_own(trx));
 
+	/* Ensure that another transaction doesn't access the trx
+	lock state and lock data structures while we are allocating and
+	adding the lock and changing the transaction state to LOCK_WAIT.
+	Under the shared lock_sys->latch, locks can be created for the
+	same transaction on pages of other shards at the same time. */
+
+	if (!owns_trx_mutex) {
+		trx_mutex_enter(trx);
+	}
+
 	/* Create the explicit lock instance and initialise it. */
 
 	lock_t*	lock = lock_alloc(trx, m_index, m_mode, m_rec_id, m_size);
@@ -1547,14 +1751,6 @@ RecLock::create(
 		lock_prdt_set_prdt(lock, prdt);
 	}
 
-	/* Ensure that another transaction doesn't access the trx
-	lock state and lock data structures while we are adding the
-	lock and changing the transaction state to LOCK_WAIT */
-
-	if (!owns_trx_mutex) {
-		trx_mutex_enter(trx);
-	}
-
 	lock_add(lock, add_to_hash);
 
 	if (!owns_trx_mutex) {
@@ -1696,6 +1892,122 @@ RecLock::set_wait_state(lock_t* lock)
 	ut_a(stopped);
 }
 
+/** Add the schedule weight of a transaction that starts to wait to the
+transactions that hold the conflicting granted locks, and along the chain
+of the waits of those transactions. The additions are recorded in
+trx->lock.schedule_debts, so that lock_rec_sub_schedule_weight() can take
+them back when the wait ends.
+@param[in]	wait_lock	waiting record lock */
+static
+void
+lock_rec_add_schedule_weight(
+	const lock_t*	wait_lock)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	trx_t*		trx = wait_lock->trx;
+	const ulint	weight = 1 + trx->lock.schedule_weight;
+
+	ut_ad(trx->lock.n_schedule_debts == 0);
+
+	for (ulint depth = 0;
+	     depth < LOCK_SCHEDULE_MAX_DEPTH && wait_lock != NULL;
+	     ++depth) {
+
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
+
+		if (wait_lock->type_mode & (LOCK_PREDICATE | LOCK_PRDT_PAGE)) {
+			break;
+		}
+
+		const ulint	heap_no = lock_rec_find_set_bit(wait_lock);
+		const lock_t*	blocking = NULL;
+
+		for (const lock_t* lock = lock_rec_get_first_on_page_addr(
+			     lock_sys->rec_hash, wait_lock->space(),
+			     wait_lock->page_number());
+		     lock != NULL;
+		     lock = lock_rec_get_next_on_page_const(lock)) {
+
+			if (lock_get_wait(lock)
+			    || lock->trx == trx
+			    || !lock_rec_get_nth_bit(lock, heap_no)
+			    || !lock_has_to_wait(wait_lock, lock)) {
+
+				continue;
+			}
+
+			if (trx->lock.n_schedule_debts
+			    == TRX_SCHEDULE_MAX_DEBTS) {
+
+				return;
+			}
+
+			trx_schedule_debt_t&	debt = trx->lock.schedule_debts[
+				trx->lock.n_schedule_debts++];
+
+			debt.trx = lock->trx;
+			debt.epoch = lock->trx->lock.schedule_epoch;
+			debt.weight = weight;
+
+			lock->trx->lock.schedule_weight += weight;
+
+			if (blocking == NULL) {
+				blocking = lock;
+			}
+		}
+
+		/* Continue with the wait of the first blocking transaction,
+		if it is waiting for a record lock itself. */
+
+		wait_lock = NULL;
+
+		if (blocking != NULL) {
+			const lock_t*	next = blocking->trx->lock.wait_lock;
+
+			if (next != NULL
+			    && lock_get_type_low(next) == LOCK_REC) {
+
+				wait_lock = next;
+			}
+		}
+	}
+}
+
+/** Take back the schedule weight that a transaction added to other
+transactions when its record lock wait started, because the wait has ended.
+The caller must hold lock_sys->latch in exclusive mode, or in shared mode
+together with the shard of the lock that was waited for.
+@param[in,out]	trx	transaction whose lock wait ended */
+static
+void
+lock_rec_sub_schedule_weight(
+	trx_t*	trx)
+{
+	ut_ad(lock_mutex_own_any());
+
+	for (ulint i = 0; i < trx->lock.n_schedule_debts; ++i) {
+
+		const trx_schedule_debt_t&	debt = trx->lock.schedule_debts[i];
+
+		/* If the transaction released its locks meanwhile, its
+		weight was reset and the trx object may have been reused.
+		The epoch only changes under the exclusive latch. Waits
+		on pages of other shards may end at the same time. */
+
+		if (debt.trx->lock.schedule_epoch == debt.epoch) {
+
+			ut_ad(debt.trx->lock.schedule_weight >= debt.weight);
+
+			os_atomic_decrement_ulint(
+				&debt.trx->lock.schedule_weight, debt.weight);
+		}
+	}
+
+	trx->lock.n_schedule_debts = 0;
+}
+
 /**
 Enqueue a lock wait for normal transaction. If it is a high priority transaction
 then jump the record lock wait queue and if the transaction at the head of the
@@ -1744,6 +2056,12 @@ RecLock::add_to_waitq(const lock_t* wait_for, const lock_prdt_t* prdt)
 	/* m_trx->mysql_thd is NULL if it's an internal trx. So current_thd is used */
 	if (err == DB_LOCK_WAIT) {
 		thd_report_row_lock_wait(current_thd, wait_for->trx->mysql_thd);
+
+		if (innobase_lock_schedule_algorithm == LOCK_SCHEDULE_CATS
+		    && prdt == NULL) {
+
+			lock_rec_add_schedule_weight(lock);
+		}
 	}
 	return(err);
 }
@@ -1773,7 +2091,8 @@ lock_rec_add_to_queue(
 					transaction mutex */
 {
 #ifdef UNIV_DEBUG
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index)
 	      || dict_index_get_online_status(index) != ONLINE_INDEX_CREATION);
@@ -1876,7 +2195,8 @@ lock_rec_lock_fast(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -1955,9 +2275,19 @@ lock_rec_lock_slow(
 					the record */
 	ulint			heap_no,/*!< in: heap number of record */
 	dict_index_t*		index,	/*!< in: index of record */
-	que_thr_t*		thr)	/*!< in: query thread */
-{
-	ut_ad(lock_mutex_own());
+	que_thr_t*		thr,	/*!< in: query thread */
+	bool			can_wait)
+					/*!< in: true if the caller holds
+					lock_sys->latch in exclusive mode;
+					false if it holds it in shared mode
+					and the shard of the page, in which
+					case DB_LOCK_WAIT is returned
+					without enqueuing a waiting
+					request */
+{
+	ut_ad(lock_rec_queue_own(block->page.id.space(),
+				 block->page.id.page_no()));
+	ut_ad(can_wait == lock_mutex_own());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -1989,7 +2319,14 @@ lock_rec_lock_slow(
 		const lock_t* wait_for = lock_rec_other_has_conflicting(
 			mode, block, heap_no, trx);
 
-		if (wait_for != NULL) {
+		if (wait_for != NULL && !can_wait) {
+
+			/* The caller must retry under the exclusive
+			lock_sys->latch. */
+
+			err = DB_LOCK_WAIT;
+
+		} else if (wait_for != NULL) {
 
 			/* If another transaction has a non-gap conflicting
 			request in the queue, as this transaction does not
@@ -2026,6 +2363,11 @@ possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
 of a page supremum record, a gap type lock.
+
+The request is first tried under the shard of the page with lock_sys->latch
+held in shared mode. Only if it has to wait is it retried under the
+exclusive latch, which is needed for enqueuing a waiting request and for
+deadlock detection.
 @return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -2045,7 +2387,7 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(!lock_mutex_own());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -2058,20 +2400,45 @@ lock_rec_lock(
 	      || mode - (LOCK_MODE_MASK & mode) == 0);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
+	dberr_t			err;
+	lock_sys_shard_t*	shard = lock_shard_enter(block);
+
 	/* We try a simplified and faster subroutine for the most
 	common cases */
 	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
 	case LOCK_REC_SUCCESS:
-		return(DB_SUCCESS);
+		err = DB_SUCCESS;
+		break;
 	case LOCK_REC_SUCCESS_CREATED:
-		return(DB_SUCCESS_LOCKED_REC);
+		err = DB_SUCCESS_LOCKED_REC;
+		break;
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+		err = lock_rec_lock_slow(impl, mode, block,
+					 heap_no, index, thr, false);
+		break;
+	default:
+		ut_error;
+		err = DB_ERROR;
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	lock_shard_exit(shard);
+
+	if (err != DB_LOCK_WAIT) {
+		return(err);
+	}
+
+	/* The request conflicts with a lock of another transaction.
+	The queue may have changed meanwhile, so start over. */
+
+	MONITOR_ATOMIC_INC(MONITOR_LOCK_REC_X_RETRY);
+
+	lock_mutex_enter();
+
+	err = lock_rec_lock_slow(impl, mode, block, heap_no, index, thr, true);
+
+	lock_mutex_exit();
+
+	return(err);
 }
 
 /*********************************************************************//**
@@ -2091,7 +2458,8 @@ lock_rec_has_to_wait_in_queue(
 	ulint		bit_offset;
 	hash_table_t*	hash;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(wait_lock->space(),
+				 wait_lock->page_number()));
 	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
 
@@ -2123,14 +2491,21 @@ lock_rec_has_to_wait_in_queue(
 
 /*************************************************************//**
 Grants a lock to a waiting lock request and releases the waiting transaction.
-The caller must hold lock_sys->mutex but not lock->trx->mutex. */
+The caller must hold lock_sys->latch in exclusive mode, or for a record lock
+in rec_hash in shared mode together with the shard of the page, but not
+lock->trx->mutex. */
 static
 void
 lock_grant(
 /*=======*/
 	lock_t*	lock)	/*!< in/out: waiting lock request */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_type_low(lock) == LOCK_REC
+	      ? lock_rec_queue_own(lock->space(), lock->page_number())
+	      : lock_mutex_own());
+	ut_ad(lock_get_type_low(lock) != LOCK_REC
+	      || lock->hash_table() == lock_sys->rec_hash
+	      || lock_mutex_own());
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -2168,6 +2543,11 @@ lock_grant(
 	}
 
 	trx_mutex_exit(lock->trx);
+
+	/* The transaction cannot start another wait before we release
+	lock_sys->latch. */
+
+	lock_rec_sub_schedule_weight(lock->trx);
 }
 
 /**
@@ -2317,7 +2697,7 @@ RecLock::lock_add_priority(
 	/* Add the lock to lock hash table. */
 	lock->hash = add_position->hash;
 	add_position->hash = lock;
-	++lock->index->table->n_rec_locks;
+	os_atomic_increment_ulint(&lock->index->table->n_rec_locks, 1);
 
 	return(grant_lock);
 }
@@ -2432,6 +2812,126 @@ lock_rec_cancel(
 	}
 
 	trx_mutex_exit(lock->trx);
+
+	lock_rec_sub_schedule_weight(lock->trx);
+}
+
+/** Checks if a waiting record lock request still has to wait in a queue,
+when it may overtake the waiting requests ahead of it of transactions with
+a smaller schedule weight.
+@param[in]	wait_lock	waiting record lock
+@return lock that is causing the wait */
+static
+const lock_t*
+lock_rec_has_to_wait_by_weight(
+	const lock_t*	wait_lock)
+{
+	ut_ad(lock_rec_queue_own(wait_lock->space(),
+				 wait_lock->page_number()));
+	ut_ad(lock_get_wait(wait_lock));
+	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
+
+	const ulint	heap_no = lock_rec_find_set_bit(wait_lock);
+	const ulint	weight = wait_lock->trx->lock.schedule_weight;
+
+	for (const lock_t* lock = lock_rec_get_first_on_page_addr(
+		     lock_sys->rec_hash, wait_lock->space(),
+		     wait_lock->page_number());
+	     lock != wait_lock;
+	     lock = lock_rec_get_next_on_page_const(lock)) {
+
+		if (lock_get_wait(lock)
+		    && lock->trx->lock.schedule_weight < weight) {
+
+			continue;
+		}
+
+		if (lock_rec_get_nth_bit(lock, heap_no)
+		    && lock_has_to_wait(wait_lock, lock)) {
+
+			return(lock);
+		}
+	}
+
+	return(NULL);
+}
+
+/** Moves a record lock to the front of its hash cell, ahead of all the
+other locks on the page.
+@param[in,out]	lock	record lock */
+static
+void
+lock_rec_move_to_front(
+	lock_t*	lock)
+{
+	ut_ad(lock_rec_queue_own(lock->space(), lock->page_number()));
+
+	hash_table_t*	lock_hash = lock->hash_table();
+	ulint		fold = lock_rec_fold(lock->space(),
+					     lock->page_number());
+
+	HASH_DELETE(lock_t, hash, lock_hash, fold, lock);
+
+	hash_cell_t*	cell = hash_get_nth_cell(
+		lock_hash, hash_calc_hash(fold, lock_hash));
+
+	lock->hash = static_cast<lock_t*>(cell->node);
+	cell->node = lock;
+}
+
+/** Orders waiting locks by decreasing schedule weight of their
+transactions */
+struct lock_schedule_weight_greater {
+	bool operator()(const lock_t* lhs, const lock_t* rhs) const
+	{
+		return(lhs->trx->lock.schedule_weight
+		       > rhs->trx->lock.schedule_weight);
+	}
+};
+
+/** Grant lock to waiting requests on a page that no longer conflict, in
+the order of decreasing schedule weight of the transactions. A granted
+request is moved ahead of the requests it overtook, so that they wait
+for it in lock_rec_has_to_wait_in_queue() and in deadlock detection.
+@param[in]	space		tablespace id
+@param[in]	page_no		page number */
+static
+void
+lock_rec_grant_by_weight(
+	ulint	space,
+	ulint	page_no)
+{
+	ut_ad(lock_rec_queue_own(space, page_no));
+
+	lock_pool_t	waiting;
+
+	for (lock_t* lock = lock_rec_get_first_on_page_addr(
+		     lock_sys->rec_hash, space, page_no);
+	     lock != NULL;
+	     lock = lock_rec_get_next_on_page(lock)) {
+
+		if (lock_get_wait(lock)) {
+			waiting.push_back(lock);
+		}
+	}
+
+	/* Waiting requests of equal weight keep their queue order. */
+	std::stable_sort(waiting.begin(), waiting.end(),
+			 lock_schedule_weight_greater());
+
+	for (lock_pool_t::iterator it = waiting.begin();
+	     it != waiting.end();
+	     ++it) {
+
+		lock_t*	lock = *it;
+
+		if (!lock_rec_has_to_wait_by_weight(lock)) {
+
+			lock_rec_move_to_front(lock);
+
+			lock_grant(lock);
+		}
+	}
 }
 
 /** Grant lock to waiting requests that no longer conflicts
@@ -2447,6 +2947,14 @@ lock_rec_grant(lock_t* in_lock)
 	ulint		page_no = in_lock->page_number();
 	hash_table_t*	lock_hash = in_lock->hash_table();
 
+	if (innobase_lock_schedule_algorithm == LOCK_SCHEDULE_CATS
+	    && lock_hash == lock_sys->rec_hash) {
+
+		lock_rec_grant_by_weight(space, page_no);
+
+		return;
+	}
+
 	/* Check if waiting locks in the queue can now be granted: grant
 	locks if there are no conflicting locks ahead. Stop at the first
 	X lock that is waiting or has been granted. */
@@ -2484,8 +2992,10 @@ lock_rec_dequeue_from_page(
 	trx_lock_t*	trx_lock;
 	hash_table_t*	lock_hash;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(in_lock->space(), in_lock->page_number()));
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
+	ut_ad(lock_hash_get(in_lock->type_mode) == lock_sys->rec_hash
+	      || lock_mutex_own());
 	/* We may or may not be holding in_lock->trx->mutex here. */
 
 	trx_lock = &in_lock->trx->lock;
@@ -2494,7 +3004,7 @@ lock_rec_dequeue_from_page(
 	page_no = in_lock->un_member.rec_lock.page_no;
 
 	ut_ad(in_lock->index->table->n_rec_locks > 0);
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	lock_hash = lock_hash_get(in_lock->type_mode);
 
@@ -2503,8 +3013,8 @@ lock_rec_dequeue_from_page(
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 
 	lock_rec_grant(in_lock);
 }
@@ -2531,7 +3041,7 @@ lock_rec_discard(
 	page_no = in_lock->un_member.rec_lock.page_no;
 
 	ut_ad(in_lock->index->table->n_rec_locks > 0);
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_hash_get(in_lock->type_mode),
 			    lock_rec_fold(space, page_no), in_lock);
@@ -2539,7 +3049,7 @@ lock_rec_discard(
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
 	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 }
 
 /*************************************************************//**
@@ -4274,7 +4784,7 @@ lock_rec_unlock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter();
+	lock_sys_shard_t*	shard = lock_shard_enter(block);
 	trx_mutex_enter(trx);
 
 	first_lock = lock_rec_get_first(lock_sys->rec_hash, block, heap_no);
@@ -4289,7 +4799,7 @@ lock_rec_unlock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_shard_exit(shard);
 	trx_mutex_exit(trx);
 
 	stmt = innobase_get_stmt_unsafe(trx->mysql_thd, &stmt_len);
@@ -4307,9 +4817,41 @@ released:
 	ut_a(!lock_get_wait(lock));
 	lock_rec_reset_nth_bit(lock, heap_no);
 
-	/* Check if we can now grant waiting lock requests */
+	bool	has_waiters = false;
 
 	for (lock = first_lock; lock != NULL;
+	     lock = lock_rec_get_next(heap_no, lock)) {
+		if (lock_get_wait(lock)) {
+			has_waiters = true;
+			break;
+		}
+	}
+
+	lock_shard_exit(shard);
+	trx_mutex_exit(trx);
+
+	if (!has_waiters) {
+		return;
+	}
+
+	/* Check if we can now grant waiting lock requests. Waiting
+	requests are only enqueued and granted under the exclusive
+	lock_sys->latch, so look up the queue again. */
+
+	lock_mutex_enter();
+
+	if (innobase_lock_schedule_algorithm == LOCK_SCHEDULE_CATS) {
+
+		lock_rec_grant_by_weight(block->page.id.space(),
+					 block->page.id.page_no());
+
+		lock_mutex_exit();
+
+		return;
+	}
+
+	for (lock = lock_rec_get_first(lock_sys->rec_hash, block, heap_no);
+	     lock != NULL;
 	     lock = lock_rec_get_next(heap_no, lock)) {
 		if (lock_get_wait(lock)
 		    && !lock_rec_has_to_wait_in_queue(lock)) {
@@ -4321,7 +4863,6 @@ released:
 	}
 
 	lock_mutex_exit();
-	trx_mutex_exit(trx);
 }
 
 #ifdef UNIV_DEBUG
@@ -4462,6 +5003,71 @@ lock_trx_release_read_locks(
 	lock_mutex_exit();
 }
 
+/** Release the record locks in rec_hash of a committing transaction, page by
+page under the shard of the page, and grant the waiting requests that no
+longer conflict. The caller must hold lock_sys->latch in shared mode. The
+table locks and the predicate locks are left to lock_release(), which needs
+the exclusive latch.
+@param[in,out]	trx	transaction that is committed in memory */
+static
+void
+lock_release_rec_locks(
+	trx_t*	trx)
+{
+	ulint	count = 0;
+
+	ut_ad(rw_lock_own(&lock_sys->latch, RW_LOCK_S));
+	ut_ad(!trx_mutex_own(trx));
+	ut_ad(!trx_is_referenced(trx));
+	ut_ad(trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY));
+
+	/* Implicit locks of trx are no longer converted to explicit
+	ones, so only this thread modifies trx->lock.trx_locks while we
+	hold lock_sys->latch. Page reorganisation can move the locks of
+	trx, but it needs the exclusive latch. */
+
+	lock_t*	lock = UT_LIST_GET_LAST(trx->lock.trx_locks);
+
+	while (lock != NULL) {
+
+		lock_t*	prev = UT_LIST_GET_PREV(trx_locks, lock);
+
+		if (lock_get_type_low(lock) != LOCK_REC
+		    || lock->hash_table() != lock_sys->rec_hash) {
+
+			lock = prev;
+			continue;
+		}
+
+		ut_d(lock_check_dict_lock(lock));
+
+		lock_sys_shard_t*	shard = lock_sys_get_shard(
+			lock->space(), lock->page_number());
+
+		mutex_enter(&shard->mutex);
+
+		lock_rec_dequeue_from_page(lock);
+
+		mutex_exit(&shard->mutex);
+
+		if (++count == LOCK_RELEASE_INTERVAL) {
+			/* Release the latch for a while, so that we
+			do not block the exclusive requests */
+
+			rw_lock_s_unlock(&lock_sys->latch);
+
+			rw_lock_s_lock(&lock_sys->latch);
+
+			count = 0;
+
+			/* The locks may have been moved meanwhile */
+			prev = UT_LIST_GET_LAST(trx->lock.trx_locks);
+		}
+
+		lock = prev;
+	}
+}
+
 /*********************************************************************//**
 Releases transaction locks, and releases possible other transactions waiting
 because of these locks. */
@@ -5925,7 +6531,7 @@ lock_rec_insert_check_and_lock(
 	const rec_t*	next_rec = page_rec_get_next_const(rec);
 	ulint		heap_no = page_rec_get_heap_no(next_rec);
 
-	lock_mutex_enter();
+	lock_sys_shard_t*	shard = lock_shard_enter(block);
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -5940,7 +6546,7 @@ lock_rec_insert_check_and_lock(
 	if (lock == NULL) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
+		lock_shard_exit(shard);
 
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -5957,6 +6563,8 @@ lock_rec_insert_check_and_lock(
 	/* Spatial index does not use GAP lock protection. It uses
 	"predicate lock" to protect the "range" */
 	if (dict_index_is_spatial(index)) {
+		lock_shard_exit(shard);
+
 		return(DB_SUCCESS);
 	}
 
@@ -5977,21 +6585,41 @@ lock_rec_insert_check_and_lock(
 	const lock_t*	wait_for = lock_rec_other_has_conflicting(
 				type_mode, block, heap_no, trx);
 
-	if (wait_for != NULL) {
+	lock_shard_exit(shard);
 
-		RecLock	rec_lock(thr, index, block, heap_no, type_mode);
+	if (wait_for == NULL) {
 
-		trx_mutex_enter(trx);
+		err = DB_SUCCESS;
 
-		err = rec_lock.add_to_waitq(wait_for);
+	} else {
+		/* Enqueuing a waiting request requires the exclusive
+		lock_sys->latch. The conflicting lock may have been
+		released meanwhile, so check again. */
 
-		trx_mutex_exit(trx);
+		MONITOR_ATOMIC_INC(MONITOR_LOCK_REC_X_RETRY);
 
-	} else {
-		err = DB_SUCCESS;
-	}
+		lock_mutex_enter();
 
-	lock_mutex_exit();
+		wait_for = lock_rec_other_has_conflicting(
+			type_mode, block, heap_no, trx);
+
+		if (wait_for != NULL) {
+
+			RecLock	rec_lock(thr, index, block, heap_no,
+					 type_mode);
+
+			trx_mutex_enter(trx);
+
+			err = rec_lock.add_to_waitq(wait_for);
+
+			trx_mutex_exit(trx);
+
+		} else {
+			err = DB_SUCCESS;
+		}
+
+		lock_mutex_exit();
+	}
 
 	switch (err) {
 	case DB_SUCCESS_LOCKED_REC:
@@ -6052,7 +6680,11 @@ lock_rec_convert_impl_to_expl_for_trx(
 
 	DEBUG_SYNC_C("before_lock_rec_convert_impl_to_expl_for_trx");
 
-	lock_mutex_enter();
+	/* A granted lock is added, so the shard of the page suffices:
+	trx cannot commit and release its locks while we hold a reference
+	to it. */
+
+	lock_sys_shard_t*	shard = lock_shard_enter(block);
 
 	ut_ad(!trx_state_eq(trx, TRX_STATE_NOT_STARTED));
 
@@ -6068,7 +6700,7 @@ lock_rec_convert_impl_to_expl_for_trx(
 			type_mode, block, heap_no, index, trx, FALSE);
 	}
 
-	lock_mutex_exit();
+	lock_shard_exit(shard);
 
 	trx_release_reference(trx);
 
@@ -6178,16 +6810,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6239,16 +6867,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -6339,8 +6963,6 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6349,9 +6971,7 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6412,8 +7032,6 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6421,9 +7039,7 @@ lock_clust_rec_read_check_and_lock(
 
 	err = lock_rec_lock(FALSE, mode | gap_mode, block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6789,6 +7405,8 @@ lock_cancel_waiting_and_release(
 		lock_wait_release_thread_if_suspended(thr);
 	}
 
+	lock_rec_sub_schedule_weight(lock->trx);
+
 	lock->trx->lock.cancel = false;
 }
 
@@ -6857,12 +7475,15 @@ lock_trx_release_locks(
 
 	release_lock = (UT_LIST_GET_LEN(trx->lock.trx_locks) > 0);
 
-	/* Don't take lock_sys mutex if trx didn't acquire any lock. */
+	/* Don't take lock_sys->latch if trx didn't acquire any lock. */
 	if (release_lock) {
 
 		/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-		is protected by both the lock_sys->mutex and the trx->mutex. */
-		lock_mutex_enter();
+		is protected by both the lock_sys->latch and the trx->mutex.
+		The shared latch suffices, because the threads that inspect
+		the locks of other transactions under the shared latch also
+		hold trx->mutex. */
+		rw_lock_s_lock(&lock_sys->latch);
 	}
 
 	trx_mutex_enter(trx);
@@ -6889,7 +7510,7 @@ lock_trx_release_locks(
 
 		ut_a(release_lock);
 
-		lock_mutex_exit();
+		rw_lock_s_unlock(&lock_sys->latch);
 
 		while (trx_is_referenced(trx)) {
 
@@ -6906,7 +7527,7 @@ lock_trx_release_locks(
 
 		trx_mutex_exit(trx);
 
-		lock_mutex_enter();
+		rw_lock_s_lock(&lock_sys->latch);
 
 		trx_mutex_enter(trx);
 	}
@@ -6930,13 +7551,40 @@ lock_trx_release_locks(
 
 	if (release_lock) {
 
-		lock_release(trx);
+		/* Release the record locks and wake up their waiters under
+		the shards of the pages; only the table locks and the
+		predicate locks need the exclusive latch. */
 
-		lock_mutex_exit();
+		lock_release_rec_locks(trx);
+
+		rw_lock_s_unlock(&lock_sys->latch);
+
+		/* The schedule weight is the sum of the weights that the
+		current waits for our locks added. With no locks left, it
+		cannot grow any more, and if it is nonzero, those waits will
+		end later and must not decrease the weight of the next
+		transaction that uses this trx object. */
+
+		if (UT_LIST_GET_LEN(trx->lock.trx_locks) > 0
+		    || trx->lock.schedule_weight > 0) {
+
+			lock_mutex_enter();
+
+			lock_release(trx);
+
+			trx->lock.schedule_weight = 0;
+
+			++trx->lock.schedule_epoch;
+
+			lock_mutex_exit();
+		}
 	}
 
 	trx->lock.n_rec_locks = 0;
 
+	ut_ad(trx->lock.n_schedule_debts == 0);
+	ut_ad(trx->lock.schedule_weight == 0);
+
 	/* We don't remove the locks one by one from the vector for
 	efficiency reasons. We simply reset it because we would have
 	released all the locks anyway. */
@@ -7618,6 +8266,10 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 		return(trx);
 	} else if (!innobase_deadlock_detect) {
 		return(NULL);
+	} else if (innobase_deadlock_detect_async) {
+		/* The wait is checked by lock_deadlock_detect_thread
+		after this thread has been suspended. */
+		return(NULL);
 	}
 
 	/*  Release the mutex to obey the latching order.
@@ -7679,6 +8331,340 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 	return(victim_trx);
 }
 
+/** Collects the transactions that a waiting lock request has to wait for,
+that is, the owners of the conflicting lock requests ahead of it in the
+queue.
+@param[in]	wait_lock	waiting lock request
+@param[out]	blockers	blocking transactions */
+void
+DeadlockChecker::get_blockers(
+	const lock_t*		wait_lock,
+	lock_blockers_t&	blockers)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	blockers.clear();
+
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		ulint	heap_no = lock_rec_find_set_bit(wait_lock);
+
+		ut_ad(heap_no != ULINT_UNDEFINED);
+
+		for (const lock_t* lock = lock_rec_get_first_on_page_addr(
+			     wait_lock->hash_table(),
+			     wait_lock->un_member.rec_lock.space,
+			     wait_lock->un_member.rec_lock.page_no);
+		     lock != wait_lock;
+		     lock = lock_rec_get_next_on_page_const(lock)) {
+
+			ut_ad(lock != NULL);
+
+			if (lock_rec_get_nth_bit(lock, heap_no)
+			    && lock_has_to_wait(wait_lock, lock)) {
+
+				blockers.push_back(lock->trx);
+			}
+		}
+	} else {
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_TABLE);
+
+		for (const lock_t* lock = UT_LIST_GET_PREV(
+			     un_member.tab_lock.locks, wait_lock);
+		     lock != NULL;
+		     lock = UT_LIST_GET_PREV(un_member.tab_lock.locks, lock)) {
+
+			if (lock_has_to_wait(wait_lock, lock)) {
+				blockers.push_back(lock->trx);
+			}
+		}
+	}
+}
+
+/** Searches the copy of the wait-for graph for a cycle.
+@param[in,out]	nodes	waiting transactions
+@param[in]	edges	transactions that they wait for
+@param[out]	cycle	nodes of the cycle that was found
+@return true if a cycle was found */
+bool
+DeadlockChecker::find_cycle(
+	lock_wait_nodes_t&		nodes,
+	const lock_wait_edges_t&	edges,
+	lock_wait_edges_t&		cycle)
+{
+	lock_wait_edges_t	path;
+
+	for (ulint i = 0; i < nodes.size(); ++i) {
+
+		if (nodes[i].state != NODE_REMOVED) {
+			nodes[i].state = NODE_NEW;
+		}
+	}
+
+	for (ulint i = 0; i < nodes.size(); ++i) {
+
+		if (nodes[i].state != NODE_NEW) {
+			continue;
+		}
+
+		nodes[i].state = NODE_ON_STACK;
+		nodes[i].next_edge = 0;
+		path.push_back(i);
+
+		while (!path.empty()) {
+			lock_wait_node_t&	node = nodes[path.back()];
+
+			if (node.next_edge == node.n_edges) {
+				node.state = NODE_DONE;
+				path.pop_back();
+				continue;
+			}
+
+			ulint	next = edges[node.first_edge
+					     + node.next_edge++];
+
+			switch (nodes[next].state) {
+			case NODE_NEW:
+				nodes[next].state = NODE_ON_STACK;
+				nodes[next].next_edge = 0;
+				path.push_back(next);
+				break;
+
+			case NODE_ON_STACK:
+				cycle.assign(
+					std::find(path.begin(), path.end(),
+						  next),
+					path.end());
+
+				return(true);
+			}
+		}
+	}
+
+	return(false);
+}
+
+/** Checks that a cycle found in the copy of the wait-for graph still
+exists, and rolls back the lightest transaction of it.
+@param[in]	nodes	waiting transactions
+@param[in]	cycle	nodes of the cycle
+@return position of the node to remove from the graph: the victim, or a
+transaction whose wait has changed since the copy */
+ulint
+DeadlockChecker::resolve_cycle(
+	const lock_wait_nodes_t&	nodes,
+	const lock_wait_edges_t&	cycle)
+{
+	lock_blockers_t	blockers;
+	ulint		victim = ULINT_UNDEFINED;
+
+	lock_mutex_enter();
+
+	for (ulint i = 0; i < cycle.size(); ++i) {
+		trx_t*		trx = nodes[cycle[i]].trx;
+		const trx_t*	next = nodes[cycle[(i + 1) % cycle.size()]].trx;
+
+		if (trx->lock.wait_lock == NULL) {
+			lock_mutex_exit();
+			return(cycle[i]);
+		}
+
+		get_blockers(trx->lock.wait_lock, blockers);
+
+		if (std::find(blockers.begin(), blockers.end(), next)
+		    == blockers.end()) {
+
+			/* The wait has changed since the copy. A new
+			cycle through this transaction will be found by
+			the next check. */
+			lock_mutex_exit();
+			return(cycle[i]);
+		}
+
+		/* Prefer the lightest transaction that is not of high
+		priority. */
+		if (victim == ULINT_UNDEFINED) {
+			victim = i;
+		} else {
+			const trx_t*	victim_trx = nodes[cycle[victim]].trx;
+
+			if (trx_is_high_priority(trx)
+			    != trx_is_high_priority(victim_trx)
+			    ? !trx_is_high_priority(trx)
+			    : trx_weight_ge(victim_trx, trx)) {
+
+				victim = i;
+			}
+		}
+	}
+
+	start_print();
+
+	for (ulint i = 0; i < cycle.size(); ++i) {
+		const trx_t*	trx = nodes[cycle[i]].trx;
+		char		buf[128];
+
+		ut_snprintf(buf, sizeof buf, "%s*** (" ULINTPF ") TRANSACTION:\n",
+			    i == 0 ? "\n" : "", i + 1);
+		print(buf);
+
+		print(trx, 3000);
+
+		ut_snprintf(buf, sizeof buf,
+			    "*** (" ULINTPF ") WAITING FOR THIS LOCK"
+			    " TO BE GRANTED:\n", i + 1);
+		print(buf);
+
+		print(trx->lock.wait_lock);
+	}
+
+	char	buf[128];
+
+	ut_snprintf(buf, sizeof buf,
+		    "*** WE ROLL BACK TRANSACTION (" ULINTPF ")\n",
+		    victim + 1);
+	print(buf);
+
+	DBUG_PRINT("ib_lock", ("deadlock detected"));
+
+	trx_t*	trx = nodes[cycle[victim]].trx;
+
+	trx_mutex_enter(trx);
+
+	trx->lock.was_chosen_as_deadlock_victim = true;
+
+	lock_cancel_waiting_and_release(trx->lock.wait_lock);
+
+	trx_mutex_exit(trx);
+
+	lock_deadlock_found = true;
+
+	MONITOR_INC(MONITOR_DEADLOCK);
+
+	lock_mutex_exit();
+
+	return(cycle[victim]);
+}
+
+/** Checks the transactions that are suspended in lock waits for deadlocks.
+The wait-for graph is copied in batches under lock_sys->latch, and searched
+for cycles without it. A cycle is checked again under the latch before a
+victim is rolled back, because the copy is not a consistent snapshot. */
+void
+DeadlockChecker::check_waits()
+{
+	ut_ad(!lock_mutex_own());
+	ut_ad(!srv_read_only_mode);
+
+	lock_wait_nodes_t	nodes;
+
+	/* A slot can't be freed or reserved without the lock wait
+	mutex. After the mutex is released, the waits may end and the
+	transaction objects may be returned to trx_pools and reused by
+	other transactions. Their memory stays valid, because the pools
+	are only freed at shutdown, but a node may describe a different
+	transaction by the time it is examined. This is harmless: the
+	edges are read under lock_sys->latch from the current
+	trx->lock.wait_lock, and resolve_cycle() checks every edge of a
+	cycle again under the exclusive latch before it rolls back a
+	victim, so only a cycle that exists at that time is resolved. */
+
+	lock_wait_mutex_enter();
+
+	for (const srv_slot_t* slot = lock_sys->waiting_threads;
+	     slot < lock_sys->last_slot;
+	     ++slot) {
+
+		if (slot->in_use) {
+			lock_wait_node_t	node;
+
+			node.trx = thr_get_trx(slot->thr);
+			node.first_edge = 0;
+			node.n_edges = 0;
+			node.next_edge = 0;
+			node.state = NODE_NEW;
+
+			nodes.push_back(node);
+		}
+	}
+
+	lock_wait_mutex_exit();
+
+	if (nodes.size() < 2) {
+		return;
+	}
+
+	std::sort(nodes.begin(), nodes.end(), lock_wait_node_less());
+
+	lock_wait_edges_t	edges;
+	lock_blockers_t		blockers;
+
+	for (ulint i = 0; i < nodes.size(); ++i) {
+
+		if (i % LOCK_DEADLOCK_COPY_BATCH == 0) {
+			if (i > 0) {
+				lock_mutex_exit();
+			}
+
+			lock_mutex_enter();
+		}
+
+		lock_wait_node_t&	node = nodes[i];
+		const lock_t*		wait_lock = node.trx->lock.wait_lock;
+
+		node.first_edge = edges.size();
+
+		if (wait_lock == NULL) {
+			node.state = NODE_REMOVED;
+			continue;
+		}
+
+		get_blockers(wait_lock, blockers);
+
+		/* Only the waiting transactions can be part of a cycle. */
+		for (lock_blockers_t::const_iterator it = blockers.begin();
+		     it != blockers.end();
+		     ++it) {
+
+			lock_wait_node_t	key;
+
+			key.trx = const_cast<trx_t*>(*it);
+
+			lock_wait_nodes_t::const_iterator	found;
+
+			found = std::lower_bound(
+				nodes.begin(), nodes.end(), key,
+				lock_wait_node_less());
+
+			if (found != nodes.end() && found->trx == key.trx) {
+				edges.push_back(found - nodes.begin());
+			}
+		}
+
+		node.n_edges = edges.size() - node.first_edge;
+	}
+
+	lock_mutex_exit();
+
+	lock_wait_edges_t	cycle;
+
+	/* Every round removes one node from the graph. */
+	while (find_cycle(nodes, edges, cycle)) {
+		nodes[resolve_cycle(nodes, cycle)].state = NODE_REMOVED;
+	}
+}
+
+/*********************************************************************//**
+Searches the wait-for graph of the suspended transactions for cycles
+and rolls back a victim of each cycle. The graph is copied under
+lock_sys->latch, but the search for cycles runs without it. */
+void
+lock_detect_deadlocks()
+/*===================*/
+{
+	DeadlockChecker::check_waits();
+}
+
 /**
 Allocate cached locks for the transaction.
 @param trx		allocate cached record locks for this transaction */
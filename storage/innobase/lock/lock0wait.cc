@@ -256,6 +256,12 @@ lock_wait_suspend_thread(
 
 	os_event_set(lock_sys->timeout_event);
 
+	/* Let the deadlock detector check the new lock wait */
+
+	if (innobase_deadlock_detect_async) {
+		os_event_set(lock_sys->deadlock_event);
+	}
+
 	lock_wait_mutex_exit();
 	trx_mutex_exit(trx);
 
@@ -391,13 +397,14 @@ lock_wait_release_thread_if_suspended(
 	que_thr_t*	thr)	/*!< in: query thread associated with the
 				user OS thread	 */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_mutex_own_any());
 	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 
-	/* We own both the lock mutex and the trx_t::mutex but not the
-	lock wait mutex. This is OK because other threads will see the state
-	of this slot as being in use and no other thread can change the state
-	of the slot to free unless that thread also owns the lock mutex. */
+	/* We own lock_sys->latch, in shared or exclusive mode, and the
+	trx_t::mutex but not the lock wait mutex. This is OK because other
+	threads will see the state of this slot as being in use and no other
+	thread can change the state of the slot to free unless that thread
+	owns lock_sys->latch in exclusive mode. */
 
 	if (thr->slot != NULL && thr->slot->in_use && thr->slot->thr == thr) {
 		trx_t*	trx = thr_get_trx(thr);
@@ -536,3 +543,60 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	OS_THREAD_DUMMY_RETURN;
 }
 
+/*********************************************************************//**
+A thread which resolves the deadlocks among the transactions suspended
+in lock waits, when innodb_deadlock_detect_async is set.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_detect_thread)(
+/*========================================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/* in: a dummy parameter required by
+			os_thread_create */
+{
+	int64_t		sig_count = 0;
+	os_event_t	event = lock_sys->deadlock_event;
+
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(srv_lock_deadlock_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	lock_sys->deadlock_thread_active = true;
+
+	do {
+		/* We are woken up when a thread is suspended in a lock
+		wait, and check the waits once a second in any case. */
+
+		ulint	ret = os_event_wait_time_low(event, 1000000, sig_count);
+
+		sig_count = os_event_reset(event);
+
+		if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
+			break;
+		}
+
+		/* A wake-up is also handled after the variable has been
+		switched off, because the waits enqueued before that were
+		not checked by the waiting threads. */
+
+		if (innobase_deadlock_detect
+		    && (innobase_deadlock_detect_async
+			|| ret != OS_SYNC_TIME_EXCEEDED)) {
+
+			lock_detect_deadlocks();
+		}
+
+	} while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP);
+
+	lock_sys->deadlock_thread_active = false;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
@@ -94,6 +94,12 @@ reduce the size of the log.
 /** Redo log system */
 log_t*	log_sys	= NULL;
 
+#if !defined(UNIV_HOTBACKUP) && defined(UNIV_PFS_THREAD)
+mysql_pfs_key_t	log_flusher_thread_key;
+mysql_pfs_key_t	log_notifier_thread_key;
+mysql_pfs_key_t	log_writer_thread_key;
+#endif /* !UNIV_HOTBACKUP && UNIV_PFS_THREAD */
+
 /** Whether to generate and require checksums on the redo log pages */
 my_bool	innodb_log_checksums;
 
@@ -138,6 +144,19 @@ void
 log_io_complete_checkpoint(void);
 /*============================*/
 
+/** Wait until the copies to the log buffer that were reserved by
+log_buffer_reserve() have been completed. */
+static
+void
+log_buffer_wait_for_copies();
+
+/** Advance log_sys->order_tail over the mini-transactions that have added
+their dirty pages to the flush lists. */
+static
+bool
+log_flush_order_advance(
+	bool	to_lsn);
+
 #ifndef UNIV_HOTBACKUP
 /****************************************************************//**
 Returns the oldest modified block lsn in the pool, or log_sys->lsn if none
@@ -152,11 +171,26 @@ log_buf_pool_get_oldest_modification(void)
 
 	ut_ad(log_mutex_own());
 
+	if (srv_flush_list_relaxed_order) {
+		/* The pages of the mini-transactions that have not
+		yet been added to the flush lists are not older than
+		order_closed_lsn. It must be determined before the flush
+		lists are scanned, so that a mini-transaction completing
+		in between is either seen in the flush lists or still
+		bounds order_closed_lsn. */
+		log_flush_order_mutex_enter();
+		log_flush_order_advance(true);
+		log_flush_order_mutex_exit();
+	}
+
+	const lsn_t	closed_lsn = srv_flush_list_relaxed_order
+		? log_sys->order_closed_lsn : log_sys->lsn;
+
 	lsn = buf_pool_get_oldest_modification();
 
-	if (!lsn) {
+	if (!lsn || lsn > closed_lsn) {
 
-		lsn = log_sys->lsn;
+		lsn = closed_lsn;
 	}
 
 	return(lsn);
@@ -215,6 +249,8 @@ log_buffer_extend(
 		log_mutex_enter_all();
 	}
 
+	log_buffer_wait_for_copies();
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -403,14 +439,16 @@ loop:
 	return(log_sys->lsn);
 }
 
-/************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
+/** Append a string to the log buffer, or only reserve space for it,
+updating the log block headers and trailers that the string spans.
+@param[in]	str	string, or NULL if the string will be copied
+later by log_buffer_write()
+@param[in]	str_len	string length */
+static
 void
-log_write_low(
-/*==========*/
-	const byte*	str,		/*!< in: string */
-	ulint		str_len)	/*!< in: string length */
+log_buffer_append_low(
+	const byte*	str,
+	ulint		str_len)
 {
 	log_t*	log	= log_sys;
 	ulint	len;
@@ -437,10 +475,12 @@ part_loop:
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
-
 	str_len -= len;
-	str = str + len;
+
+	if (str != NULL) {
+		ut_memcpy(log->buf + log->buf_free, str, len);
+		str = str + len;
+	}
 
 	log_block = static_cast<byte*>(
 		ut_align_down(
@@ -474,6 +514,357 @@ part_loop:
 	srv_stats.log_write_requests.inc();
 }
 
+/************************************************************//**
+Writes to the log the string given. It is assumed that the caller holds the
+log mutex. */
+void
+log_write_low(
+/*==========*/
+	const byte*	str,		/*!< in: string */
+	ulint		str_len)	/*!< in: string length */
+{
+	ut_ad(str != NULL);
+
+	log_buffer_append_low(str, str_len);
+}
+
+/** Advance log_sys->copy_tail over the copies that have been completed.
+@return whether all the copies reserved so far have been completed */
+static
+bool
+log_buffer_copy_advance()
+{
+	ut_ad(log_mutex_own());
+
+	while (log_sys->copy_tail < log_sys->copy_next) {
+		lsn_t*	slot = &log_sys->copy_slots[
+			log_sys->copy_tail % LOG_COPY_SLOTS];
+
+		os_rmb;
+
+		if (*slot == 0) {
+			return(false);
+		}
+
+		log_sys->copy_ready_lsn = *slot;
+		*slot = 0;
+		log_sys->copy_tail++;
+	}
+
+	log_sys->copy_ready_lsn = log_sys->lsn;
+
+	return(true);
+}
+
+/** Wait until the copies to the log buffer that were reserved by
+log_buffer_reserve() have been completed, so that the whole log buffer
+up to log_sys->lsn can be written or moved. */
+static
+void
+log_buffer_wait_for_copies()
+{
+	ut_ad(log_mutex_own());
+
+	if (log_buffer_copy_advance()) {
+		return;
+	}
+
+	MONITOR_INC(MONITOR_LOG_COPY_WRITE_WAITS);
+
+	for (ulint i = 0; !log_buffer_copy_advance(); i++) {
+		if (i < srv_n_spin_wait_rounds) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		} else {
+			os_thread_yield();
+		}
+	}
+
+	ut_ad(log_sys->copy_ready_lsn == log_sys->lsn);
+}
+
+/** Reserve space in the log buffer for a string that will be copied by
+log_buffer_write() after log_sys->mutex has been released. This must be
+invoked between log_reserve_and_open() and log_close(), instead of
+log_write_low().
+@param[in]	len	string length
+@param[out]	ticket	copy ticket to pass to log_buffer_copy_complete()
+@return offset in log_sys->buf where the string must be copied to */
+ulint
+log_buffer_reserve(
+	ulint		len,
+	ib_uint64_t*	ticket)
+{
+	ut_ad(log_mutex_own());
+	ut_ad(len > 0);
+
+	/* The slot of the new ticket is only free when all the copies
+	that were reserved LOG_COPY_SLOTS tickets earlier are done. */
+	if (log_sys->copy_next - log_sys->copy_tail >= LOG_COPY_SLOTS) {
+
+		MONITOR_INC(MONITOR_LOG_COPY_SLOT_WAITS);
+
+		for (ulint i = 0;; i++) {
+			log_buffer_copy_advance();
+
+			if (log_sys->copy_next - log_sys->copy_tail
+			    < LOG_COPY_SLOTS) {
+				break;
+			}
+
+			if (i < srv_n_spin_wait_rounds) {
+				ut_delay(ut_rnd_interval(
+						 0, srv_spin_wait_delay));
+			} else {
+				os_thread_yield();
+			}
+		}
+	} else if (log_sys->copy_tail == log_sys->copy_next) {
+		log_sys->copy_ready_lsn = log_sys->lsn;
+	}
+
+	ut_ad(log_sys->copy_slots[log_sys->copy_next % LOG_COPY_SLOTS] == 0);
+
+	*ticket = log_sys->copy_next++;
+
+	const ulint	offset = log_sys->buf_free;
+
+	log_buffer_append_low(NULL, len);
+
+	MONITOR_INC(MONITOR_LOG_CONCURRENT_COPIES);
+
+	return(offset);
+}
+
+/** Copy a string to a part of the log buffer that was reserved with
+log_buffer_reserve(). The caller need not hold log_sys->mutex.
+@param[in,out]	buf	log_sys->buf at the time of the reservation
+@param[in]	offset	offset in buf to copy the string to
+@param[in]	str	string
+@param[in]	len	string length
+@return offset in buf after the string */
+ulint
+log_buffer_write(
+	byte*		buf,
+	ulint		offset,
+	const byte*	str,
+	ulint		len)
+{
+	while (len > 0) {
+		ulint	in_block = offset % OS_FILE_LOG_BLOCK_SIZE;
+		ulint	part = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- in_block;
+
+		ut_ad(in_block >= LOG_BLOCK_HDR_SIZE);
+
+		if (part > len) {
+			part = len;
+		}
+
+		ut_memcpy(buf + offset, str, part);
+
+		offset += part;
+		str += part;
+		len -= part;
+
+		if (offset % OS_FILE_LOG_BLOCK_SIZE
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the header
+			of the next one, which log_buffer_reserve()
+			already initialized. */
+			offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+
+	return(offset);
+}
+
+/** Note that a copy reserved with log_buffer_reserve() has been completed.
+The caller need not hold log_sys->mutex.
+@param[in]	ticket	copy ticket returned by log_buffer_reserve()
+@param[in]	end_lsn	end lsn of the copied string */
+void
+log_buffer_copy_complete(
+	ib_uint64_t	ticket,
+	lsn_t		end_lsn)
+{
+	ut_ad(end_lsn > 0);
+
+	/* Make the copied bytes visible before the slot. */
+	os_wmb;
+
+	log_sys->copy_slots[ticket % LOG_COPY_SLOTS] = end_lsn;
+}
+
+/** Advance log_sys->order_tail over the mini-transactions that have added
+their dirty pages to the flush lists, and update log_sys->order_closed_lsn.
+The caller must hold log_flush_order_mutex.
+@param[in]	to_lsn	whether to advance order_closed_lsn to
+log_sys->lsn if all the registered mini-transactions have completed; this
+requires log_sys->mutex, because a mini-transaction that has been assigned
+an lsn may not have registered yet
+@return whether all the registered mini-transactions have completed */
+static
+bool
+log_flush_order_advance(
+	bool	to_lsn)
+{
+	ut_ad(log_flush_order_mutex_own());
+	ut_ad(!to_lsn || log_mutex_own());
+
+	while (log_sys->order_tail < log_sys->order_next) {
+		const lsn_t*	slot = &log_sys->order_slots[
+			log_sys->order_tail % LOG_ORDER_SLOTS];
+
+		os_rmb;
+
+		if (*slot != 0) {
+			log_sys->order_closed_lsn = *slot;
+			return(false);
+		}
+
+		log_sys->order_tail++;
+	}
+
+	if (to_lsn) {
+		log_sys->order_closed_lsn = log_sys->lsn;
+	}
+
+	return(true);
+}
+
+/** Register a mini-transaction that will add dirty pages to the flush
+lists after releasing log_sys->mutex, without log_flush_order_mutex.
+@param[in]	start_lsn	start lsn of the mini-transaction
+@return order ticket to pass to log_flush_order_complete() */
+ib_uint64_t
+log_flush_order_reserve(
+	lsn_t	start_lsn)
+{
+	ut_ad(log_mutex_own());
+	ut_ad(start_lsn > 0);
+
+	/* The tickets are registered under log_sys->mutex in the order of
+	start_lsn, and under log_flush_order_mutex, which is only held
+	briefly and never while waiting. */
+	log_flush_order_mutex_enter();
+
+	/* The slot of the new ticket is only free when all the
+	mini-transactions that were registered LOG_ORDER_SLOTS tickets
+	earlier have completed. Neither log_flush_order_wait() nor
+	log_flush_order_complete() acquires log_sys->mutex, so it may be
+	held while waiting. The oldest registered mini-transaction passes
+	log_flush_order_wait(), because order_closed_lsn is at least its
+	start lsn once log_flush_order_advance() has run. */
+	if (log_sys->order_next - log_sys->order_tail >= LOG_ORDER_SLOTS) {
+
+		MONITOR_INC(MONITOR_LOG_FLUSH_ORDER_SLOT_WAITS);
+
+		os_atomic_increment_ulint(&log_sys->order_n_waiters, 1);
+
+		for (;;) {
+			const int64_t	sig_count = os_event_reset(
+				log_sys->order_event);
+
+			log_flush_order_advance(true);
+
+			if (log_sys->order_next - log_sys->order_tail
+			    < LOG_ORDER_SLOTS) {
+				break;
+			}
+
+			log_flush_order_mutex_exit();
+
+			os_event_wait_low(log_sys->order_event, sig_count);
+
+			log_flush_order_mutex_enter();
+		}
+
+		os_atomic_decrement_ulint(&log_sys->order_n_waiters, 1);
+	} else if (log_sys->order_tail == log_sys->order_next) {
+		log_sys->order_closed_lsn = start_lsn;
+	}
+
+	ut_ad(log_sys->order_slots[log_sys->order_next % LOG_ORDER_SLOTS]
+	      == 0);
+
+	log_sys->order_slots[log_sys->order_next % LOG_ORDER_SLOTS]
+		= start_lsn;
+
+	const ib_uint64_t	ticket = log_sys->order_next++;
+
+	log_flush_order_mutex_exit();
+
+	return(ticket);
+}
+
+/** Wait until the pages of a mini-transaction registered with
+log_flush_order_reserve() may be added to the flush lists, that is,
+until start_lsn is less than LOG_FLUSH_ORDER_LAG ahead of the start lsn of
+the oldest mini-transaction that has not yet added its pages.
+This does not acquire log_sys->mutex, which log_flush_order_reserve() may
+hold while waiting for this mini-transaction to complete.
+@param[in]	start_lsn	start lsn of the mini-transaction */
+void
+log_flush_order_wait(
+	lsn_t	start_lsn)
+{
+	ut_ad(!log_mutex_own());
+
+	if (start_lsn < log_sys->order_closed_lsn + LOG_FLUSH_ORDER_LAG) {
+		return;
+	}
+
+	MONITOR_INC(MONITOR_LOG_FLUSH_ORDER_WAITS);
+
+	/* order_closed_lsn only advances when the oldest registered
+	mini-transaction completes. Instead of polling, sleep until
+	log_flush_order_complete() signals a completion. The event is
+	reset before the slots are examined, so that a completion in
+	between is not missed. This mini-transaction has not completed,
+	so log_flush_order_advance() stops at or before its slot. */
+	os_atomic_increment_ulint(&log_sys->order_n_waiters, 1);
+
+	for (;;) {
+		const int64_t	sig_count = os_event_reset(
+			log_sys->order_event);
+
+		log_flush_order_mutex_enter();
+		log_flush_order_advance(false);
+		log_flush_order_mutex_exit();
+
+		if (start_lsn
+		    < log_sys->order_closed_lsn + LOG_FLUSH_ORDER_LAG) {
+			break;
+		}
+
+		os_event_wait_low(log_sys->order_event, sig_count);
+	}
+
+	os_atomic_decrement_ulint(&log_sys->order_n_waiters, 1);
+}
+
+/** Note that a mini-transaction registered with log_flush_order_reserve()
+has added its dirty pages to the flush lists.
+@param[in]	ticket	order ticket returned by log_flush_order_reserve() */
+void
+log_flush_order_complete(
+	ib_uint64_t	ticket)
+{
+	lsn_t*	slot = &log_sys->order_slots[ticket % LOG_ORDER_SLOTS];
+
+	ut_ad(*slot != 0);
+
+	/* Clear the slot with a full memory barrier: the flush list
+	insertions become visible before it, and order_n_waiters is read
+	after it. A waiter increments order_n_waiters before examining
+	the slots, so either it sees the slot cleared or it is woken up. */
+	os_atomic_decrement_uint64(slot, *slot);
+
+	if (log_sys->order_n_waiters > 0) {
+		os_event_set(log_sys->order_event);
+	}
+}
+
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -822,6 +1213,13 @@ log_init(void)
 
 	log_sys->first_in_use = true;
 
+	log_sys->copy_slots = static_cast<lsn_t*>(
+		ut_zalloc_nokey(LOG_COPY_SLOTS * sizeof(lsn_t)));
+
+	log_sys->order_slots = static_cast<lsn_t*>(
+		ut_zalloc_nokey(LOG_ORDER_SLOTS * sizeof(lsn_t)));
+	log_sys->order_event = os_event_create(0);
+
 	log_sys->max_buf_free = log_sys->buf_size / LOG_BUF_FLUSH_RATIO
 		- LOG_BUF_FLUSH_MARGIN;
 	log_sys->check_flush_or_checkpoint = true;
@@ -837,6 +1235,20 @@ log_init(void)
 
 	os_event_set(log_sys->flush_event);
 
+	log_sys->writer_event = os_event_create(0);
+	log_sys->flusher_event = os_event_create(0);
+	log_sys->notifier_event = os_event_create(0);
+
+	log_sys->write_events = static_cast<os_event_t*>(
+		ut_malloc_nokey(LOG_WAIT_EVENTS * sizeof(os_event_t)));
+	log_sys->flush_events = static_cast<os_event_t*>(
+		ut_malloc_nokey(LOG_WAIT_EVENTS * sizeof(os_event_t)));
+
+	for (ulint i = 0; i < LOG_WAIT_EVENTS; i++) {
+		log_sys->write_events[i] = os_event_create(0);
+		log_sys->flush_events[i] = os_event_create(0);
+	}
+
 	/*----------------------------*/
 
 	log_sys->last_checkpoint_lsn = log_sys->lsn;
@@ -858,6 +1270,8 @@ log_init(void)
 
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn = LOG_START_LSN + LOG_BLOCK_HDR_SIZE;
+	log_sys->copy_ready_lsn = log_sys->lsn;
+	log_sys->order_closed_lsn = log_sys->lsn;
 
 	MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE,
 		    log_sys->lsn - log_sys->last_checkpoint_lsn);
@@ -1147,6 +1561,17 @@ loop:
 	}
 }
 
+/** Wake up the log notifier thread after the log was written or flushed,
+if the dedicated log threads are running. */
+static inline
+void
+log_wake_notifier()
+{
+	if (log_sys->writer_threads_active) {
+		os_event_set(log_sys->notifier_event);
+	}
+}
+
 /** Flush the log has been written to the log file. */
 static
 void
@@ -1169,6 +1594,8 @@ log_write_flush_to_disk_low()
 	MONITOR_DEC(MONITOR_PENDING_LOG_FLUSH);
 
 	os_event_set(log_sys->flush_event);
+
+	log_wake_notifier();
 }
 
 /** Switch the log buffer in use, and copy the content of last block
@@ -1207,14 +1634,16 @@ log_buffer_switch()
 }
 
 /** Ensure that the log has been written to the log file up to a given
-log entry (such as that of a transaction commit). Start a new write, or
-wait and check if an already running write is covering the request.
+log entry (such as that of a transaction commit) in the calling thread.
+Start a new write, or wait and check if an already running write is
+covering the request.
 @param[in]	lsn		log sequence number that should be
 included in the redo log file write
 @param[in]	flush_to_disk	whether the written log should also
 be flushed to the file system */
+static
 void
-log_write_up_to(
+log_write_up_to_low(
 	lsn_t	lsn,
 	bool	flush_to_disk)
 {
@@ -1308,6 +1737,10 @@ loop:
 		return;
 	}
 
+	/* Only write fully filled log buffer contents: wait for the
+	mini-transactions that are still copying their log records. */
+	log_buffer_wait_for_copies();
+
 	log_group_t*	group;
 	ulint		start_offset;
 	ulint		end_offset;
@@ -1410,11 +1843,373 @@ loop:
 
 	log_write_mutex_exit();
 
+	log_wake_notifier();
+
 	if (flush_to_disk) {
 		log_write_flush_to_disk_low();
 	}
 }
 
+/** Get the event to wait on until the log has been written or flushed
+up to an lsn. The waiters are distributed over the events by the log
+block of the lsn, so that log_notifier_thread() only wakes up the
+threads whose request may have been satisfied.
+@param[in]	lsn		log sequence number to wait for
+@param[in]	flush_to_disk	whether to wait for the log flush
+@return event to wait on */
+static inline
+os_event_t
+log_wait_event(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	const ulint	slot = static_cast<ulint>(
+		(lsn - 1) / OS_FILE_LOG_BLOCK_SIZE) % LOG_WAIT_EVENTS;
+
+	return(flush_to_disk
+	       ? log_sys->flush_events[slot]
+	       : log_sys->write_events[slot]);
+}
+
+/** Account the time that a thread waited for the log threads.
+@param[in]	us	wait time in microseconds */
+static
+void
+log_wait_time_account(
+	ib_time_monotonic_us_t	us)
+{
+	MONITOR_INC(MONITOR_LOG_LSN_WAITS);
+
+	if (us < 100) {
+		MONITOR_INC(MONITOR_LOG_LSN_WAIT_UNDER_100US);
+	} else if (us < 1000) {
+		MONITOR_INC(MONITOR_LOG_LSN_WAIT_UNDER_1MS);
+	} else if (us < 10000) {
+		MONITOR_INC(MONITOR_LOG_LSN_WAIT_UNDER_10MS);
+	} else if (us < 100000) {
+		MONITOR_INC(MONITOR_LOG_LSN_WAIT_UNDER_100MS);
+	} else {
+		MONITOR_INC(MONITOR_LOG_LSN_WAIT_OVER_100MS);
+	}
+}
+
+/** Wait until the dedicated log threads have written, and if requested
+flushed, the log up to an lsn. If the log threads are stopped while
+waiting, the log is written by the calling thread.
+@param[in]	lsn		log sequence number to wait for
+@param[in]	flush_to_disk	whether to wait for the log flush */
+static
+void
+log_wait_for_lsn(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	ulint*			n_waiters = flush_to_disk
+		? &log_sys->n_flush_waiters
+		: &log_sys->n_write_waiters;
+	os_event_t		event = log_wait_event(lsn, flush_to_disk);
+	ib_time_monotonic_us_t	start = ut_time_monotonic_us();
+	bool			done = false;
+
+	os_atomic_increment_ulint(n_waiters, 1);
+
+	os_event_set(log_sys->writer_event);
+
+	while (log_sys->writer_threads_active) {
+		int64_t	sig_count = os_event_reset(event);
+
+		os_rmb;
+
+		if ((flush_to_disk
+		     ? log_sys->flushed_to_disk_lsn
+		     : log_sys->write_lsn) >= lsn) {
+
+			done = true;
+			break;
+		}
+
+		os_event_wait_time_low(event, 100000, sig_count);
+	}
+
+	os_atomic_decrement_ulint(n_waiters, 1);
+
+	if (!done) {
+		/* The log threads were stopped. */
+		log_write_up_to_low(lsn, flush_to_disk);
+		return;
+	}
+
+	log_wait_time_account(ut_time_monotonic_us() - start);
+}
+
+/** Ensure that the log has been written to the log file up to a given
+log entry (such as that of a transaction commit). Start a new write, or
+wait and check if an already running write is covering the request.
+If the dedicated log threads are running, only wait for them.
+@param[in]	lsn		log sequence number that should be
+included in the redo log file write
+@param[in]	flush_to_disk	whether the written log should also
+be flushed to the file system */
+void
+log_write_up_to(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	ut_ad(!srv_read_only_mode);
+
+	if (!log_sys->writer_threads_active || recv_no_ibuf_operations) {
+		log_write_up_to_low(lsn, flush_to_disk);
+		return;
+	}
+
+	os_rmb;
+
+	if ((flush_to_disk
+	     ? log_sys->flushed_to_disk_lsn
+	     : log_sys->write_lsn) >= lsn) {
+		return;
+	}
+
+	if (lsn == LSN_MAX) {
+		lsn = log_get_lsn();
+	}
+
+	log_wait_for_lsn(lsn, flush_to_disk);
+}
+
+/** Wake up the threads that wait for the log to be written or flushed
+up to an lsn within a range.
+@param[in]	events		LOG_WAIT_EVENTS events of the waiters
+@param[in]	old_lsn		lsn up to which the waiters were woken up
+@param[in]	new_lsn		lsn up to which the log is now written
+or flushed */
+static
+void
+log_notify_range(
+	os_event_t*	events,
+	lsn_t		old_lsn,
+	lsn_t		new_lsn)
+{
+	ut_ad(old_lsn < new_lsn);
+
+	lsn_t	first = old_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	lsn_t	last = (new_lsn - 1) / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (last - first >= LOG_WAIT_EVENTS) {
+		last = first + LOG_WAIT_EVENTS - 1;
+	}
+
+	for (lsn_t i = first; i <= last; i++) {
+		os_event_set(events[i % LOG_WAIT_EVENTS]);
+	}
+}
+
+/** Log writer thread: writes the log buffer to the log files whenever
+there are threads waiting for the log to be written or flushed.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(
+	void*	arg MY_ATTRIBUTE((unused)))
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_writer_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (log_sys->writer_threads_active
+	       && srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+
+		int64_t	sig_count = os_event_reset(log_sys->writer_event);
+
+		os_rmb;
+
+		const lsn_t	lsn = log_sys->lsn;
+		const lsn_t	write_lsn = log_sys->write_lsn;
+
+		if (lsn > write_lsn) {
+			MONITOR_SET(MONITOR_LOG_WRITER_LAG, lsn - write_lsn);
+
+			log_write_up_to_low(lsn, false);
+		}
+
+		if (log_sys->n_flush_waiters > 0
+		    && log_sys->flushed_to_disk_lsn < log_sys->write_lsn) {
+			os_event_set(log_sys->flusher_event);
+		}
+
+		if (lsn <= write_lsn) {
+			os_event_wait_time_low(
+				log_sys->writer_event, 1000000, sig_count);
+		}
+	}
+
+	os_atomic_decrement_ulint(&log_sys->n_writer_threads, 1);
+
+	my_thread_end();
+
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Log flusher thread: flushes the written log to disk whenever there
+are threads waiting for the log to be flushed.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(
+	void*	arg MY_ATTRIBUTE((unused)))
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flusher_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (log_sys->writer_threads_active
+	       && srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+
+		int64_t	sig_count = os_event_reset(log_sys->flusher_event);
+
+		os_rmb;
+
+		if (log_sys->n_flush_waiters == 0
+		    || log_sys->flushed_to_disk_lsn >= log_sys->write_lsn) {
+
+			os_event_wait_time_low(
+				log_sys->flusher_event, 1000000, sig_count);
+			continue;
+		}
+
+		log_mutex_enter_all();
+
+		if (log_sys->n_pending_flushes > 0) {
+			/* Another thread is flushing the log. */
+			log_mutex_exit_all();
+			os_event_wait(log_sys->flush_event);
+			continue;
+		}
+
+		MONITOR_SET(MONITOR_LOG_FLUSHER_LAG,
+			    log_sys->write_lsn - log_sys->flushed_to_disk_lsn);
+
+		log_sys->n_pending_flushes++;
+		log_sys->current_flush_lsn = log_sys->write_lsn;
+		MONITOR_INC(MONITOR_PENDING_LOG_FLUSH);
+		os_event_reset(log_sys->flush_event);
+
+		log_mutex_exit_all();
+
+		log_write_flush_to_disk_low();
+	}
+
+	os_atomic_decrement_ulint(&log_sys->n_writer_threads, 1);
+
+	my_thread_end();
+
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Log notifier thread: wakes up the threads waiting in
+log_write_up_to() whenever the log has been written or flushed further.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_notifier_thread)(
+	void*	arg MY_ATTRIBUTE((unused)))
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_notifier_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	os_rmb;
+
+	lsn_t	notified_write_lsn = log_sys->write_lsn;
+	lsn_t	notified_flush_lsn = log_sys->flushed_to_disk_lsn;
+
+	while (log_sys->writer_threads_active
+	       && srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+
+		int64_t	sig_count = os_event_reset(log_sys->notifier_event);
+
+		os_rmb;
+
+		const lsn_t	write_lsn = log_sys->write_lsn;
+		const lsn_t	flush_lsn = log_sys->flushed_to_disk_lsn;
+
+		if (write_lsn > notified_write_lsn) {
+			log_notify_range(log_sys->write_events,
+					 notified_write_lsn, write_lsn);
+			notified_write_lsn = write_lsn;
+		}
+
+		if (flush_lsn > notified_flush_lsn) {
+			log_notify_range(log_sys->flush_events,
+					 notified_flush_lsn, flush_lsn);
+			notified_flush_lsn = flush_lsn;
+		}
+
+		os_event_wait_time_low(
+			log_sys->notifier_event, 1000000, sig_count);
+	}
+
+	os_atomic_decrement_ulint(&log_sys->n_writer_threads, 1);
+
+	my_thread_end();
+
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start the dedicated log writer, flusher and notifier threads, after
+which log_write_up_to() only waits for them (innodb_log_writer_threads). */
+void
+log_writer_threads_start()
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(!log_sys->writer_threads_active);
+
+	log_sys->n_writer_threads = 3;
+	log_sys->writer_threads_active = true;
+	os_wmb;
+
+	os_thread_create(log_writer_thread, NULL, NULL);
+	os_thread_create(log_flusher_thread, NULL, NULL);
+	os_thread_create(log_notifier_thread, NULL, NULL);
+}
+
+/** Stop the dedicated log threads, if they are running. The threads
+waiting in log_write_up_to() will write the log themselves. */
+void
+log_writer_threads_stop()
+{
+	if (!log_sys->writer_threads_active) {
+		return;
+	}
+
+	log_sys->writer_threads_active = false;
+	os_wmb;
+
+	while (log_sys->n_writer_threads > 0) {
+		os_event_set(log_sys->writer_event);
+		os_event_set(log_sys->flusher_event);
+		os_event_set(log_sys->notifier_event);
+		os_thread_sleep(10000);
+	}
+
+	for (ulint i = 0; i < LOG_WAIT_EVENTS; i++) {
+		os_event_set(log_sys->write_events[i]);
+		os_event_set(log_sys->flush_events[i]);
+	}
+}
+
 /** write to the log file up to the last log entry.
 @param[in]	sync	whether we want the written log
 also to be flushed to disk. */
@@ -2209,6 +3004,10 @@ loop:
 		}
 	}
 
+	/* The remaining log writes and the final checkpoint are done
+	by this thread. */
+	log_writer_threads_stop();
+
 	log_mutex_enter();
 	const ulint	n_write	= log_sys->n_pending_checkpoint_writes;
 	const ulint	n_flush	= log_sys->n_pending_flushes;
@@ -2351,6 +3150,10 @@ loop:
 
 	if (!srv_read_only_mode) {
 		fil_write_flushed_lsn(lsn);
+
+		if (srv_tablespace_cache) {
+			fil_dir_cache_write();
+		}
 	}
 
 	fil_close_all_files();
@@ -2494,11 +3297,32 @@ log_shutdown(void)
 	ut_free(log_sys->buf_ptr);
 	log_sys->buf_ptr = NULL;
 	log_sys->buf = NULL;
+	ut_free(log_sys->copy_slots);
+	log_sys->copy_slots = NULL;
+	ut_free(log_sys->order_slots);
+	log_sys->order_slots = NULL;
 	ut_free(log_sys->checkpoint_buf_ptr);
 	log_sys->checkpoint_buf_ptr = NULL;
 	log_sys->checkpoint_buf = NULL;
 
 	os_event_destroy(log_sys->flush_event);
+	os_event_destroy(log_sys->order_event);
+
+	ut_ad(!log_sys->writer_threads_active);
+
+	os_event_destroy(log_sys->writer_event);
+	os_event_destroy(log_sys->flusher_event);
+	os_event_destroy(log_sys->notifier_event);
+
+	for (ulint i = 0; i < LOG_WAIT_EVENTS; i++) {
+		os_event_destroy(log_sys->write_events[i]);
+		os_event_destroy(log_sys->flush_events[i]);
+	}
+
+	ut_free(log_sys->write_events);
+	log_sys->write_events = NULL;
+	ut_free(log_sys->flush_events);
+	log_sys->flush_events = NULL;
 
 	rw_lock_free(&log_sys->checkpoint_lock);
 
@@ -165,6 +165,7 @@ mysql_pfs_key_t	trx_rollback_clean_thread_key;
 
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	recv_apply_thread_key;
 mysql_pfs_key_t	recv_writer_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
@@ -825,6 +826,10 @@ recv_sys_close(void)
 		if (recv_sys->flush_end != NULL) {
 			os_event_destroy(recv_sys->flush_end);
 		}
+
+		if (recv_sys->apply_done != NULL) {
+			os_event_destroy(recv_sys->apply_done);
+		}
 #endif /* !UNIV_HOTBACKUP */
 		ut_free(recv_sys->buf);
 		ut_free(recv_sys->last_block_buf_start);
@@ -865,6 +870,10 @@ recv_sys_mem_free(void)
 		if (recv_sys->flush_end != NULL) {
 			os_event_destroy(recv_sys->flush_end);
 		}
+
+		if (recv_sys->apply_done != NULL) {
+			os_event_destroy(recv_sys->apply_done);
+		}
 #endif /* !UNIV_HOTBACKUP */
 		ut_free(recv_sys->buf);
 		ut_free(recv_sys->last_block_buf_start);
@@ -970,6 +979,9 @@ recv_sys_init(
 		recv_sys->flush_start = os_event_create(0);
 		recv_sys->flush_end = os_event_create(0);
 	}
+
+	recv_sys->apply_done = os_event_create(0);
+	recv_sys->apply_start_lsn = 0;
 #else /* !UNIV_HOTBACKUP */
 	recv_sys->heap = mem_heap_create(256);
 	recv_is_from_backup = true;
@@ -2618,48 +2630,29 @@ recv_read_in_area(
 	return(n);
 }
 
-/*******************************************************************//**
-Empties the hash table of stored log records, applying them to appropriate
-pages. */
+/** Applies the hashed log records of one partition of recv_sys->addr_hash.
+The records of the pages that are in the buffer pool are applied by the
+calling thread; the other pages are read in, and the i/o handler threads
+apply the records to them once the read completes.
+The caller must own recv_sys->mutex, and it is owned again on return.
+@param[in]	part	partition number; cells whose number modulo
+			recv_sys->n_apply_threads equals this are processed
+@param[in]	progress	whether to print the progress in percent */
+static
 void
-recv_apply_hashed_log_recs(
-/*=======================*/
-	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
-				allowed during the application; if FALSE,
-				no ibuf operations are allowed, and after
-				the application all file pages are flushed to
-				disk and invalidated in buffer pool: this
-				alternative means that no new log records
-				can be generated during the application;
-				the caller must in this case own the log
-				mutex */
+recv_apply_hashed_partition(
+	ulint	part,
+	bool	progress)
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
-loop:
-	mutex_enter(&(recv_sys->mutex));
-
-	if (recv_sys->apply_batch_on) {
-
-		mutex_exit(&(recv_sys->mutex));
-
-		os_thread_sleep(500000);
-
-		goto loop;
-	}
-
-	ut_ad(!allow_ibuf == log_mutex_own());
-
-	if (!allow_ibuf) {
-		recv_no_ibuf_operations = true;
-	}
+	recv_addr_t*	recv_addr;
+	mtr_t		mtr;
+	const ulint	n_cells = hash_get_n_cells(recv_sys->addr_hash);
+	const ulint	n_parts = recv_sys->n_apply_threads;
 
-	recv_sys->apply_log_recs = TRUE;
-	recv_sys->apply_batch_on = TRUE;
+	ut_ad(mutex_own(&recv_sys->mutex));
+	ut_ad(part < n_parts);
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	for (ulint i = part; i < n_cells; i += n_parts) {
 
 		for (recv_addr = static_cast<recv_addr_t*>(
 				HASH_GET_FIRST(recv_sys->addr_hash, i));
@@ -2692,13 +2685,13 @@ loop:
 			ut_ad(found);
 
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
+				if (!recv_sys->apply_printed) {
 					ib::info() << "Starting an apply batch"
 						" of log records"
 						" to the database...";
 					fputs("InnoDB: Progress in percent: ",
 					      stderr);
-					has_printed = TRUE;
+					recv_sys->apply_printed = true;
 				}
 
 				mutex_exit(&(recv_sys->mutex));
@@ -2725,17 +2718,128 @@ loop:
 			}
 		}
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
+		if (progress
+		    && recv_sys->apply_printed
+		    && (i * 100) / n_cells != ((i + n_parts) * 100) / n_cells) {
+
+			fprintf(stderr, "%lu ", (ulong) ((i * 100) / n_cells));
+		}
+	}
+}
+
+/******************************************************************//**
+recv_apply thread that applies the hashed log records of one partition
+of recv_sys->addr_hash in a parallel apply batch.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: partition number, cast to a pointer */
+{
+	ulint	part = reinterpret_cast<ulint>(arg);
+
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	mutex_enter(&recv_sys->mutex);
+
+	recv_apply_hashed_partition(part, false);
 
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
+	ut_a(recv_sys->n_apply_running > 0);
+
+	if (--recv_sys->n_apply_running == 0) {
+		os_event_set(recv_sys->apply_done);
+	}
+
+	mutex_exit(&recv_sys->mutex);
+
+	my_thread_end();
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Empties the hash table of stored log records, applying them to appropriate
+pages. The cells of the hash table are partitioned among
+srv_recovery_apply_threads threads, the calling thread included. */
+void
+recv_apply_hashed_log_recs(
+/*=======================*/
+	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
+				allowed during the application; if FALSE,
+				no ibuf operations are allowed, and after
+				the application all file pages are flushed to
+				disk and invalidated in buffer pool: this
+				alternative means that no new log records
+				can be generated during the application;
+				the caller must in this case own the log
+				mutex */
+{
+loop:
+	mutex_enter(&(recv_sys->mutex));
+
+	if (recv_sys->apply_batch_on) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_thread_sleep(500000);
+
+		goto loop;
+	}
+
+	ut_ad(!allow_ibuf == log_mutex_own());
+
+	if (!allow_ibuf) {
+		recv_no_ibuf_operations = true;
+	}
+
+	recv_sys->apply_log_recs = TRUE;
+	recv_sys->apply_batch_on = TRUE;
+	recv_sys->apply_printed = false;
+
+	const ulint	n_batch_addrs = recv_sys->n_addrs;
+	const lsn_t	batch_start_lsn = recv_sys->apply_start_lsn
+		? recv_sys->apply_start_lsn : recv_sys->parse_start_lsn;
+	const ib_time_monotonic_us_t	batch_start_time
+		= ut_time_monotonic_us();
+
+	/* Do not start more threads than there are pages to apply. */
+	recv_sys->n_apply_threads = ut_min(
+		static_cast<ulint>(srv_recovery_apply_threads),
+		ut_max(n_batch_addrs, static_cast<ulint>(1)));
+	recv_sys->n_apply_running = recv_sys->n_apply_threads - 1;
+
+	if (recv_sys->n_apply_running > 0) {
+		os_event_reset(recv_sys->apply_done);
+
+		for (ulint i = 1; i < recv_sys->n_apply_threads; i++) {
+			os_thread_create(
+				recv_apply_thread,
+				reinterpret_cast<void*>(i), NULL);
 		}
 	}
 
+	recv_apply_hashed_partition(0, true);
+
+	/* Wait until the other partitions have been scanned */
+
+	while (recv_sys->n_apply_running != 0) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_event_wait(recv_sys->apply_done);
+
+		mutex_enter(&(recv_sys->mutex));
+	}
+
 	/* Wait until all the pages have been processed */
 
 	while (recv_sys->n_addrs != 0) {
@@ -2747,7 +2851,7 @@ loop:
 		mutex_enter(&(recv_sys->mutex));
 	}
 
-	if (has_printed) {
+	if (recv_sys->apply_printed) {
 
 		fprintf(stderr, "\n");
 	}
@@ -2790,10 +2894,22 @@ loop:
 
 	recv_sys_empty_hash();
 
-	if (has_printed) {
-		ib::info() << "Apply batch completed";
+	if (recv_sys->apply_printed) {
+		double	secs = static_cast<double>(
+			ut_time_monotonic_us() - batch_start_time) / 1000000;
+		double	mb = static_cast<double>(
+			recv_sys->recovered_lsn - batch_start_lsn)
+			/ (1024 * 1024);
+
+		ib::info() << "Apply batch completed: " << n_batch_addrs
+			<< " pages, " << mb << " MB of redo log applied by "
+			<< recv_sys->n_apply_threads << " threads in "
+			<< secs << " s ("
+			<< (secs > 0 ? mb / secs : 0) << " MB/s)";
 	}
 
+	recv_sys->apply_start_lsn = recv_sys->recovered_lsn;
+
 	mutex_exit(&(recv_sys->mutex));
 }
 #else /* !UNIV_HOTBACKUP */
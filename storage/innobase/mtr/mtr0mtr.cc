@@ -324,6 +324,7 @@ public:
 	{
 		m_impl = &mtr->m_impl;
 		m_sync = mtr->m_sync;
+		m_copy_buf = NULL;
 	}
 
 	/** Destructor */
@@ -349,6 +350,16 @@ public:
 	@param[in]	len	number of bytes to write */
 	void finish_write(ulint len);
 
+	/** Reserve space for the redo log records in the redo log buffer.
+	The records must be copied by copy_reserved() after releasing
+	log_sys->mutex.
+	@param[in]	len	number of bytes to write */
+	void reserve_write(ulint len);
+
+	/** Copy the redo log records to the space that was reserved by
+	reserve_write(). */
+	void copy_reserved();
+
 private:
 	/** Prepare to write the mini-transaction log to the redo log buffer.
 	@return number of bytes to write in finish_write() */
@@ -369,6 +380,21 @@ private:
 
 	/** End lsn of the possible log entry for this mtr */
 	lsn_t			m_end_lsn;
+
+	/** Log buffer to copy the reserved log records to, or NULL if
+	the records were copied while holding log_sys->mutex */
+	byte*			m_copy_buf;
+
+	/** Offset of the reserved space in m_copy_buf */
+	ulint			m_copy_offset;
+
+	/** Copy ticket of the reservation in m_copy_buf */
+	ib_uint64_t		m_copy_ticket;
+
+	/** Flush order ticket from log_flush_order_reserve(), when the
+	dirty pages are added to the flush lists without
+	log_flush_order_mutex */
+	ib_uint64_t		m_order_ticket;
 };
 
 /** Check if a mini-transaction is dirtying a clean page.
@@ -396,6 +422,35 @@ struct mtr_write_log_t {
 	}
 };
 
+/** Copy the block contents to space reserved in the redo log buffer */
+struct mtr_copy_log_t {
+	/** Constructor
+	@param[in,out]	buf	log buffer of the reservation
+	@param[in]	offset	offset of the reserved space in buf */
+	mtr_copy_log_t(byte* buf, ulint offset)
+		:
+		m_buf(buf),
+		m_offset(offset)
+	{
+		/* Do nothing */
+	}
+
+	/** Copy a block to the reserved space.
+	@return whether the copying should continue */
+	bool operator()(const mtr_buf_t::block_t* block)
+	{
+		m_offset = log_buffer_write(
+			m_buf, m_offset, block->begin(), block->used());
+		return(true);
+	}
+
+	/** Log buffer of the reservation */
+	byte*	m_buf;
+
+	/** Offset to copy the next block to */
+	ulint	m_offset;
+};
+
 /** Append records to the system-wide redo log buffer.
 @param[in]	log	redo log records */
 void
@@ -836,6 +891,43 @@ mtr_t::Command::finish_write(
 	m_end_lsn = log_close();
 }
 
+/** Reserve space for the redo log records in the redo log buffer.
+The records must be copied by copy_reserved() after releasing
+log_sys->mutex.
+@param[in]	len	number of bytes to write */
+void
+mtr_t::Command::reserve_write(
+	ulint	len)
+{
+	ut_ad(m_impl->m_log_mode == MTR_LOG_ALL);
+	ut_ad(log_mutex_own());
+	ut_ad(m_impl->m_log.size() == len);
+	ut_ad(len > 0);
+
+	m_start_lsn = log_reserve_and_open(len);
+
+	m_copy_buf = log_sys->buf;
+	m_copy_offset = log_buffer_reserve(len, &m_copy_ticket);
+
+	m_end_lsn = log_close();
+}
+
+/** Copy the redo log records to the space that was reserved by
+reserve_write(). */
+void
+mtr_t::Command::copy_reserved()
+{
+	ut_ad(m_copy_buf != NULL);
+
+	mtr_copy_log_t	copy_log(m_copy_buf, m_copy_offset);
+
+	m_impl->m_log.for_each_block(copy_log);
+
+	log_buffer_copy_complete(m_copy_ticket, m_end_lsn);
+
+	m_copy_buf = NULL;
+}
+
 /** Release the latches and blocks acquired by this mini-transaction */
 void
 mtr_t::Command::release_all()
@@ -867,26 +959,59 @@ mtr_t::Command::execute()
 	ut_ad(m_impl->m_log_mode != MTR_LOG_NONE);
 
 	if (const ulint len = prepare_write()) {
-		finish_write(len);
+		if (srv_log_concurrent_copy) {
+			reserve_write(len);
+		} else {
+			finish_write(len);
+		}
 	}
 
-	if (m_impl->m_made_dirty) {
+	const bool	relaxed = m_impl->m_made_dirty
+		&& srv_flush_list_relaxed_order;
+	const bool	ordered = m_impl->m_made_dirty && !relaxed;
+
+	if (relaxed) {
+		m_order_ticket = log_flush_order_reserve(m_start_lsn);
+	} else if (ordered) {
 		log_flush_order_mutex_enter();
 	}
 
 	/* It is now safe to release the log mutex because the
 	flush_order mutex will ensure that we are the first one
-	to insert into the flush list. */
+	to insert into the flush list. In the relaxed order, the
+	insertions are only bounded by log_flush_order_wait(). */
 	log_mutex_exit();
 
 	m_impl->m_mtr->m_commit_lsn = m_end_lsn;
 
+	/* Copy the records while the page latches are still held, so
+	that the pages cannot be flushed before the copy has completed.
+	The copy must precede anything that may block, such as
+	log_flush_order_wait(), because the holders of log_sys->mutex
+	wait for the copy in log_buffer_wait_for_copies() and
+	log_buffer_reserve(). Under log_flush_order_mutex, copy after
+	releasing it, so that the copies are not serialized; nothing in
+	between acquires log_sys->mutex. */
+	if (m_copy_buf != NULL && !ordered) {
+		copy_reserved();
+	}
+
+	if (relaxed) {
+		log_flush_order_wait(m_start_lsn);
+	}
+
 	release_blocks();
 
-	if (m_impl->m_made_dirty) {
+	if (relaxed) {
+		log_flush_order_complete(m_order_ticket);
+	} else if (ordered) {
 		log_flush_order_mutex_exit();
 	}
 
+	if (m_copy_buf != NULL) {
+		copy_reserved();
+	}
+
 	release_all();
 
 	release_resources();
@@ -73,6 +73,13 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+# include <linux/io_uring.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <sys/uio.h>
+#endif /* LINUX_IO_URING */
+
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
 # include <fcntl.h>
 # include <linux/falloc.h>
@@ -205,6 +212,19 @@ If an AIO request is made the calling thread not only queues it in the
 array but also submits the requests. The helper thread then collects
 the completed IO request and calls completion routine on it.
 
+Linux io_uring:
+===============
+
+If the kernel supports io_uring and innodb_use_io_uring is set together
+with innodb_use_native_aio, each segment of the four arrays gets an
+io_uring instance in place of the libaio context. Requests that are
+posted with IORequest::DO_NOT_WAKE are queued in the submission ring and
+submitted as one batch by os_aio_simulated_wake_handler_threads(). The
+buffer pool memory is registered with the rings so that page reads and
+writes skip the per request mapping of the buffer. The helper thread
+reaps the completion ring in user space and only enters the kernel when
+it is empty. If io_uring is not available we fall back to libaio.
+
 **********************************************************************/
 
 
@@ -305,6 +325,161 @@ struct Slot {
 	bool			skip_punch_hole;
 };
 
+#ifdef LINUX_IO_URING
+/** Memory areas registered with io_uring: start and length, sorted by
+start */
+typedef std::vector<std::pair<byte*, ulint>,
+		    ut_allocator<std::pair<byte*, ulint> > >	IoUringBuffers;
+
+/** Maximum number of requests that are queued in a submission ring
+before they are submitted to the kernel */
+static const ulint	OS_AIO_URING_BATCH = 64;
+
+/** Maximum number of completions that are reaped at a time */
+static const ulint	OS_AIO_URING_REAP_BATCH = 64;
+
+/** The kernel limit on the size of a registered buffer */
+static const ulint	OS_AIO_URING_MAX_BUFFER = 1024 * 1024 * 1024UL;
+
+/** A submission and completion ring pair of io_uring, used through the
+raw system calls. There is one per segment of an AIO array. Requests are
+queued by any thread; completions are reaped only by the i/o handler
+thread of the segment. */
+class IoUring {
+public:
+	/** Constructor */
+	IoUring();
+
+	/** Destructor */
+	~IoUring();
+
+	/** Set up the rings.
+	@param[in]	entries		minimum number of submission entries;
+					it must not be less than the number of
+					requests that can be pending at a time
+	@return 0 or a negated errno value */
+	int create(ulint entries)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Queue a request in the submission ring.
+	@param[in]	slot	reserved slot of the request
+	@param[in]	submit	true to submit the queued requests now;
+				false to leave them for flush() unless
+				OS_AIO_URING_BATCH requests are queued */
+	void queue(const Slot* slot, bool submit);
+
+	/** Submit the queued requests */
+	void flush();
+
+	/** Reap completed requests. The completion ring is checked in user
+	space first; if it is empty we wait in the kernel.
+	@param[out]	slots		slots of the completed requests
+	@param[out]	res		results of the completed requests: the
+					number of bytes or a negated errno value
+	@param[in]	n		size of slots[] and res[]
+	@param[in]	timeout_ns	maximum time to wait, in nanoseconds
+	@return number of completed requests, or a negated errno value */
+	int reap(Slot** slots, int* res, ulint n, ulint timeout_ns)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Register memory areas for fixed buffer reads and writes,
+	replacing any registered areas.
+	@param[in]	buffers		areas to register, sorted by start
+	@return 0 or a negated errno value */
+	int register_buffers(const IoUringBuffers& buffers)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Unregister the memory areas */
+	void unregister_buffers();
+
+private:
+	/** Submit the queued requests; the caller must own m_mutex. */
+	void submit_low();
+
+	/** Unregister the memory areas; the caller must own m_mutex. */
+	void unregister_buffers_low();
+
+	/** Move completions out of the completion ring.
+	@param[out]	slots	slots of the completed requests
+	@param[out]	res	results of the completed requests
+	@param[in]	n	size of slots[] and res[]
+	@return number of completed requests */
+	int peek(Slot** slots, int* res, ulint n);
+
+	/** Look for a registered area that holds a buffer.
+	@param[in]	ptr	start of the buffer
+	@param[in]	len	length of the buffer
+	@param[out]	index	index of the area
+	@return true if the buffer is in a registered area */
+	bool find_buffer(const byte* ptr, ulint len, ulint* index) const;
+
+	/** Invoke io_uring_enter(2).
+	@return the return value, or a negated errno value */
+	int enter(
+		unsigned	to_submit,
+		unsigned	min_complete,
+		unsigned	flags,
+		const void*	arg,
+		size_t		arg_size);
+
+	/** Release the rings */
+	void destroy();
+
+private:
+	/** Protects the submission ring and m_buffers */
+	OSMutex			m_mutex;
+
+	/** The ring file descriptor, or -1 */
+	int			m_fd;
+
+	/** Mapping of the submission and completion rings */
+	void*			m_ring;
+
+	/** Size of m_ring */
+	size_t			m_ring_size;
+
+	/** Mapping of the submission queue entries */
+	struct io_uring_sqe*	m_sqes;
+
+	/** Size of m_sqes */
+	size_t			m_sqes_size;
+
+	/** Submission ring head, advanced by the kernel */
+	unsigned*		m_sq_head;
+
+	/** Submission ring tail */
+	unsigned*		m_sq_tail;
+
+	/** Submission ring index array */
+	unsigned*		m_sq_array;
+
+	/** Mask for submission ring positions */
+	unsigned		m_sq_mask;
+
+	/** Number of submission queue entries */
+	unsigned		m_sq_entries;
+
+	/** Completion ring head */
+	unsigned*		m_cq_head;
+
+	/** Completion ring tail, advanced by the kernel */
+	unsigned*		m_cq_tail;
+
+	/** Mask for completion ring positions */
+	unsigned		m_cq_mask;
+
+	/** Completion ring entries */
+	struct io_uring_cqe*	m_cqes;
+
+	/** Number of queued requests that are not submitted; only
+	modified while holding m_mutex */
+	volatile ulint		m_n_unsubmitted;
+
+	/** Registered memory areas */
+	IoUringBuffers		m_buffers;
+};
+#endif /* LINUX_IO_URING */
+
 /** The asynchronous i/o array structure */
 class AIO {
 public:
@@ -464,6 +639,37 @@ public:
 	@return true if supported, false otherwise. */
 	static bool is_linux_native_aio_supported()
 		MY_ATTRIBUTE((warn_unused_result));
+
+# ifdef LINUX_IO_URING
+	/** Accessor for the io_uring instance of a segment
+	@param[in]	segment	Segment for which to get the instance
+	@return the io_uring instance, or NULL if libaio is used */
+	IoUring* io_uring(ulint segment)
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		ut_ad(segment < get_n_segments());
+
+		return(m_uring == NULL ? NULL : &m_uring[segment]);
+	}
+
+	/** Checks if the kernel supports the io_uring features that
+	we use.
+	@return true if supported, false otherwise. */
+	static bool is_io_uring_supported()
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Submit the requests that are queued in all the io_uring
+	instances. */
+	static void io_uring_flush_all();
+
+	/** Register memory areas with the io_uring instances of the
+	arrays that read and write data pages.
+	@param[in]	buffers		areas to register, sorted by start */
+	static void io_uring_register_buffers(const IoUringBuffers& buffers);
+
+	/** Unregister the memory areas from all the io_uring instances */
+	static void io_uring_unregister_buffers();
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 #ifdef WIN_ASYNC_IO
@@ -657,6 +863,13 @@ private:
 	@return DB_SUCCESS or error code */
 	dberr_t init_linux_native_aio()
 		MY_ATTRIBUTE((warn_unused_result));
+
+# ifdef LINUX_IO_URING
+	/** Initialise an io_uring instance for each segment
+	@return DB_SUCCESS or error code */
+	dberr_t init_io_uring()
+		MY_ATTRIBUTE((warn_unused_result));
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 private:
@@ -705,6 +918,12 @@ private:
 	event for each possible pending IO. The size of the array
 	is equal to m_slots.size(). */
 	IOEvents		m_events;
+
+# ifdef LINUX_IO_URING
+	/** io_uring instances, one per segment, used in place of
+	m_aio_ctx when innodb_use_io_uring is set; NULL otherwise */
+	IoUring*		m_uring;
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIV_AIO */
 
 	/** The aio arrays for non-ibuf i/o and ibuf i/o, as well as
@@ -2321,6 +2540,22 @@ private:
 	each wakeup and that is why we use timed wait in io_getevents(). */
 	void collect();
 
+#ifdef LINUX_IO_URING
+	/** Collect completed requests from the io_uring instance of the
+	segment. This is the io_uring counterpart of collect(): the thread
+	submits any queued requests, reaps the completion ring and waits in
+	the kernel with a timeout only when the ring is empty.
+	@param[in,out]	ring		io_uring instance of the segment */
+	void collect_io_uring(IoUring* ring);
+#endif /* LINUX_IO_URING */
+
+	/** Mark a request as completed. The error handling is done in
+	check_state().
+	@param[in,out]	slot		the completed request
+	@param[in]	res		number of bytes read or written, or a
+					negated errno value */
+	void complete(Slot* slot, long res);
+
 private:
 	/** Slot array */
 	AIO*			m_array;
@@ -2364,6 +2599,15 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	/* make sure that slot->offset fits in off_t */
 	ut_ad(sizeof(off_t) >= sizeof(os_offset_t));
 
+#ifdef LINUX_IO_URING
+	if (IoUring* ring = m_array->io_uring(m_segment)) {
+
+		ring->queue(slot, true);
+
+		return(DB_SUCCESS);
+	}
+#endif /* LINUX_IO_URING */
+
 	struct iocb*	iocb = &slot->control;
 	if (slot->type.is_read()) {
 		io_prep_pread(
@@ -2491,14 +2735,17 @@ LinuxAIOHandler::collect()
 	ut_ad(m_array != NULL);
 	ut_ad(m_segment < m_array->get_n_segments());
 
-	/* Which io_context we are going to use. */
-	io_context*	io_ctx = m_array->io_ctx(m_segment);
+#ifdef LINUX_IO_URING
+	if (IoUring* ring = m_array->io_uring(m_segment)) {
 
-	/* Starting point of the m_segment we will be working on. */
-	ulint	start_pos = m_segment * m_n_slots;
+		collect_io_uring(ring);
 
-	/* End point. */
-	ulint	end_pos = start_pos + m_n_slots;
+		return;
+	}
+#endif /* LINUX_IO_URING */
+
+	/* Which io_context we are going to use. */
+	io_context*	io_ctx = m_array->io_ctx(m_segment);
 
 	for (;;) {
 		struct io_event*	events;
@@ -2529,54 +2776,15 @@ LinuxAIOHandler::collect()
 
 			Slot*	slot = reinterpret_cast<Slot*>(iocb->data);
 
-			/* Some sanity checks. */
-			ut_a(slot != NULL);
-			ut_a(slot->is_reserved);
-
-			/* We are not scribbling previous segment. */
-			ut_a(slot->pos >= start_pos);
-
-			/* We have not overstepped to next segment. */
-			ut_a(slot->pos < end_pos);
-
-			/* We never compress/decompress the first page */
-
-			if (slot->offset > 0
-			    && !slot->skip_punch_hole
-			    && slot->type.is_compression_enabled()
-			    && !slot->type.is_log()
-			    && slot->type.is_write()
-			    && slot->type.is_compressed()
-			    && slot->type.punch_hole()) {
-
-				slot->err = AIOHandler::io_complete(slot);
-			} else {
-				slot->err = DB_SUCCESS;
-			}
-
-			/* Mark this request as completed. The error handling
-			will be done in the calling function. */
-			m_array->acquire();
-
 			/* events[i].res2 should always be ZERO */
 			ut_ad(events[i].res2 == 0);
-			slot->io_already_done = true;
 
-			/*Even though events[i].res is an unsigned number
+			/* Even though events[i].res is an unsigned number
 			in libaio, it is used to return a negative value
 			(negated errno value) to indicate error and a positive
 			value to indicate number of bytes read or written. */
 
-			if (events[i].res > slot->len) {
-				/* failure */
-				slot->n_bytes = 0;
-				slot->ret = events[i].res;
-			} else {
-				/* success */
-				slot->n_bytes = events[i].res;
-				slot->ret = 0;
-			}
-			m_array->release();
+			complete(slot, static_cast<long>(events[i].res));
 		}
 
 		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
@@ -2616,6 +2824,111 @@ LinuxAIOHandler::collect()
 	}
 }
 
+#ifdef LINUX_IO_URING
+/** Collect completed requests from the io_uring instance of the segment.
+@param[in,out]	ring		io_uring instance of the segment */
+void
+LinuxAIOHandler::collect_io_uring(IoUring* ring)
+{
+	Slot*	slots[OS_AIO_URING_REAP_BATCH];
+	int	res[OS_AIO_URING_REAP_BATCH];
+
+	for (;;) {
+		/* Submit the requests that were queued with
+		IORequest::DO_NOT_WAKE and not flushed yet. */
+		ring->flush();
+
+		int	ret = ring->reap(
+			slots, res, UT_ARR_SIZE(slots), OS_AIO_REAP_TIMEOUT);
+
+		for (int i = 0; i < ret; ++i) {
+			complete(slots[i], res[i]);
+		}
+
+		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
+		    || !buf_page_cleaner_is_active
+		    || ret > 0) {
+
+			break;
+		}
+
+		switch (ret) {
+		case -EAGAIN:
+		case -EBUSY:
+		case -EINTR:
+		case 0:
+			/* Nothing completed in time, or the kernel is
+			short of resources. Go back and check again. */
+			continue;
+		}
+
+		ib::fatal()
+			<< "Unexpected ret_code[" << ret
+			<< "] from io_uring_enter()!";
+
+		break;
+	}
+}
+#endif /* LINUX_IO_URING */
+
+/** Mark a request as completed. The error handling is done in
+check_state().
+@param[in,out]	slot		the completed request
+@param[in]	res		number of bytes read or written, or a
+				negated errno value */
+void
+LinuxAIOHandler::complete(Slot* slot, long res)
+{
+	/* Starting point of the m_segment we are working on. */
+	ulint	start_pos = m_segment * m_n_slots;
+
+	/* End point. */
+	ulint	end_pos = start_pos + m_n_slots;
+
+	/* Some sanity checks. */
+	ut_a(slot != NULL);
+	ut_a(slot->is_reserved);
+
+	/* We are not scribbling previous segment. */
+	ut_a(slot->pos >= start_pos);
+
+	/* We have not overstepped to next segment. */
+	ut_a(slot->pos < end_pos);
+
+	/* We never compress/decompress the first page */
+
+	if (slot->offset > 0
+	    && !slot->skip_punch_hole
+	    && slot->type.is_compression_enabled()
+	    && !slot->type.is_log()
+	    && slot->type.is_write()
+	    && slot->type.is_compressed()
+	    && slot->type.punch_hole()) {
+
+		slot->err = AIOHandler::io_complete(slot);
+	} else {
+		slot->err = DB_SUCCESS;
+	}
+
+	/* Mark this request as completed. The error handling
+	will be done in the calling function. */
+	m_array->acquire();
+
+	slot->io_already_done = true;
+
+	if (res < 0 || static_cast<ulint>(res) > slot->len) {
+		/* failure */
+		slot->n_bytes = 0;
+		slot->ret = static_cast<int>(res);
+	} else {
+		/* success */
+		slot->n_bytes = res;
+		slot->ret = 0;
+	}
+
+	m_array->release();
+}
+
 /** Process a Linux AIO request
 @param[out]	m1		the messages passed with the
 @param[out]	m2		AIO request; note that in case the
@@ -2762,6 +3075,17 @@ AIO::linux_dispatch(Slot* slot)
 
 	io_ctx_index = (slot->pos * m_n_segments) / m_slots.size();
 
+#ifdef LINUX_IO_URING
+	if (m_uring != NULL) {
+
+		/* A request that is not to wake the handler is part of a
+		batch that os_aio_simulated_wake_handler_threads() submits. */
+		m_uring[io_ctx_index].queue(slot, slot->type.is_wake());
+
+		return(true);
+	}
+#endif /* LINUX_IO_URING */
+
 	int	ret = io_submit(m_aio_ctx[io_ctx_index], 1, &iocb);
 
 	/* io_submit() returns number of successfully queued requests
@@ -2774,6 +3098,549 @@ AIO::linux_dispatch(Slot* slot)
 	return(ret == 1);
 }
 
+#ifdef LINUX_IO_URING
+/** Compares a memory address with the start of a registered area */
+struct IoUringBufferLess {
+	bool operator()(
+		const byte*				ptr,
+		const std::pair<byte*, ulint>&		area) const
+	{
+		return(ptr < area.first);
+	}
+};
+
+/** Constructor */
+IoUring::IoUring()
+	:
+	m_fd(-1),
+	m_ring(NULL),
+	m_ring_size(),
+	m_sqes(NULL),
+	m_sqes_size(),
+	m_sq_head(),
+	m_sq_tail(),
+	m_sq_array(),
+	m_sq_mask(),
+	m_sq_entries(),
+	m_cq_head(),
+	m_cq_tail(),
+	m_cq_mask(),
+	m_cqes(),
+	m_n_unsubmitted()
+{
+	m_mutex.init();
+}
+
+/** Destructor */
+IoUring::~IoUring()
+{
+	destroy();
+
+	m_mutex.destroy();
+}
+
+/** Release the rings */
+void
+IoUring::destroy()
+{
+	if (m_sqes != NULL) {
+		munmap(m_sqes, m_sqes_size);
+		m_sqes = NULL;
+	}
+
+	if (m_ring != NULL) {
+		munmap(m_ring, m_ring_size);
+		m_ring = NULL;
+	}
+
+	if (m_fd >= 0) {
+		/* This also releases the registered buffers. */
+		::close(m_fd);
+		m_fd = -1;
+	}
+
+	m_buffers.clear();
+}
+
+/** Set up the rings.
+@param[in]	entries		minimum number of submission entries
+@return 0 or a negated errno value */
+int
+IoUring::create(ulint entries)
+{
+	struct io_uring_params	params;
+
+	ut_a(m_fd < 0);
+
+	memset(&params, 0x0, sizeof(params));
+
+	m_fd = static_cast<int>(syscall(
+		__NR_io_uring_setup, static_cast<unsigned>(entries), &params));
+
+	if (m_fd < 0) {
+		return(-errno);
+	}
+
+	/* We need a single mapping for both rings, completions that are
+	not dropped when the completion ring overflows, and timed waits
+	for completions. */
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)
+	    || !(params.features & IORING_FEAT_NODROP)
+	    || !(params.features & IORING_FEAT_EXT_ARG)) {
+
+		destroy();
+
+		return(-ENOSYS);
+	}
+
+	m_ring_size = std::max(
+		params.sq_off.array + params.sq_entries * sizeof(unsigned),
+		params.cq_off.cqes
+		+ params.cq_entries * sizeof(struct io_uring_cqe));
+
+	m_ring = mmap(NULL, m_ring_size, PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+	if (m_ring == MAP_FAILED) {
+		int	err = errno;
+
+		m_ring = NULL;
+		destroy();
+
+		return(-err);
+	}
+
+	m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	void*	sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+	if (sqes == MAP_FAILED) {
+		int	err = errno;
+
+		destroy();
+
+		return(-err);
+	}
+
+	m_sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+	byte*	ring = static_cast<byte*>(m_ring);
+
+	m_sq_head = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+	m_sq_array = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+	m_sq_mask = *reinterpret_cast<unsigned*>(
+		ring + params.sq_off.ring_mask);
+	m_sq_entries = params.sq_entries;
+
+	m_cq_head = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+	m_cq_mask = *reinterpret_cast<unsigned*>(
+		ring + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<struct io_uring_cqe*>(
+		ring + params.cq_off.cqes);
+
+	return(0);
+}
+
+/** Invoke io_uring_enter(2).
+@return the return value, or a negated errno value */
+int
+IoUring::enter(
+	unsigned	to_submit,
+	unsigned	min_complete,
+	unsigned	flags,
+	const void*	arg,
+	size_t		arg_size)
+{
+	long	ret = syscall(
+		__NR_io_uring_enter, m_fd, to_submit, min_complete, flags,
+		arg, arg_size);
+
+	return(ret < 0 ? -errno : static_cast<int>(ret));
+}
+
+/** Look for a registered area that holds a buffer.
+@param[in]	ptr	start of the buffer
+@param[in]	len	length of the buffer
+@param[out]	index	index of the area
+@return true if the buffer is in a registered area */
+bool
+IoUring::find_buffer(const byte* ptr, ulint len, ulint* index) const
+{
+	IoUringBuffers::const_iterator	it = std::upper_bound(
+		m_buffers.begin(), m_buffers.end(), ptr, IoUringBufferLess());
+
+	if (it == m_buffers.begin()) {
+		return(false);
+	}
+
+	--it;
+
+	if (ptr + len > it->first + it->second) {
+		return(false);
+	}
+
+	*index = it - m_buffers.begin();
+
+	return(true);
+}
+
+/** Queue a request in the submission ring.
+@param[in]	slot	reserved slot of the request
+@param[in]	submit	true to submit the queued requests now */
+void
+IoUring::queue(const Slot* slot, bool submit)
+{
+	ut_ad(slot->is_reserved);
+
+	m_mutex.enter();
+
+	unsigned	tail = *m_sq_tail;
+
+	/* Each slot of the segment has at most one request in the ring
+	and the ring has an entry for each slot. */
+	ut_a(tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE)
+	     < m_sq_entries);
+
+	unsigned		index = tail & m_sq_mask;
+	struct io_uring_sqe*	sqe = &m_sqes[index];
+	ulint			buf_index;
+	bool			fixed = find_buffer(
+		slot->ptr, slot->len, &buf_index);
+
+	memset(sqe, 0x0, sizeof(*sqe));
+
+	if (slot->type.is_read()) {
+		sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	} else {
+		ut_a(slot->type.is_write());
+		sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+	}
+
+	if (fixed) {
+		sqe->buf_index = static_cast<__u16>(buf_index);
+	}
+
+	sqe->fd = slot->file.m_file;
+	sqe->off = slot->offset;
+	sqe->addr = reinterpret_cast<uintptr_t>(slot->ptr);
+	sqe->len = static_cast<__u32>(slot->len);
+	sqe->user_data = reinterpret_cast<uintptr_t>(slot);
+
+	m_sq_array[index] = index;
+
+	/* Make the entry visible to the kernel. */
+	__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	++m_n_unsubmitted;
+
+	if (submit || m_n_unsubmitted >= OS_AIO_URING_BATCH) {
+		submit_low();
+	}
+
+	m_mutex.exit();
+}
+
+/** Submit the queued requests; the caller must own m_mutex. */
+void
+IoUring::submit_low()
+{
+	while (m_n_unsubmitted > 0) {
+
+		int	ret = enter(
+			static_cast<unsigned>(m_n_unsubmitted), 0, 0, NULL, 0);
+
+		if (ret > 0) {
+			m_n_unsubmitted -= ret;
+			continue;
+		}
+
+		switch (ret) {
+		case -EINTR:
+			continue;
+
+		case 0:
+		case -EAGAIN:
+		case -EBUSY:
+			/* The kernel is short of resources or completions
+			must be reaped first. The requests stay queued and
+			the i/o handler thread submits them. */
+			return;
+		}
+
+		ib::fatal()
+			<< "Unexpected ret_code[" << ret
+			<< "] from io_uring_enter()!";
+	}
+}
+
+/** Submit the queued requests */
+void
+IoUring::flush()
+{
+	/* A dirty read: requests queued after it are submitted by the
+	thread that queued them or by the next flush(). */
+	if (m_n_unsubmitted == 0) {
+		return;
+	}
+
+	m_mutex.enter();
+
+	submit_low();
+
+	m_mutex.exit();
+}
+
+/** Move completions out of the completion ring.
+@param[out]	slots	slots of the completed requests
+@param[out]	res	results of the completed requests
+@param[in]	n	size of slots[] and res[]
+@return number of completed requests */
+int
+IoUring::peek(Slot** slots, int* res, ulint n)
+{
+	/* Only the i/o handler thread of the segment moves the head. */
+	unsigned	head = *m_cq_head;
+	unsigned	tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+	int		count = 0;
+
+	for (; head != tail && static_cast<ulint>(count) < n; ++head) {
+
+		const struct io_uring_cqe*	cqe = &m_cqes[head & m_cq_mask];
+
+		slots[count] = reinterpret_cast<Slot*>(cqe->user_data);
+		res[count] = cqe->res;
+		++count;
+	}
+
+	/* Let the kernel reuse the entries. */
+	__atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+
+	return(count);
+}
+
+/** Reap completed requests.
+@param[out]	slots		slots of the completed requests
+@param[out]	res		results of the completed requests
+@param[in]	n		size of slots[] and res[]
+@param[in]	timeout_ns	maximum time to wait, in nanoseconds
+@return number of completed requests, or a negated errno value */
+int
+IoUring::reap(Slot** slots, int* res, ulint n, ulint timeout_ns)
+{
+	int	count = peek(slots, res, n);
+
+	if (count > 0) {
+		return(count);
+	}
+
+	struct __kernel_timespec	ts;
+	struct io_uring_getevents_arg	arg;
+
+	ts.tv_sec = timeout_ns / 1000000000UL;
+	ts.tv_nsec = timeout_ns % 1000000000UL;
+
+	memset(&arg, 0x0, sizeof(arg));
+	arg.ts = reinterpret_cast<uintptr_t>(&ts);
+
+	int	ret = enter(
+		0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+		&arg, sizeof(arg));
+
+	if (ret < 0 && ret != -ETIME) {
+		return(ret);
+	}
+
+	return(peek(slots, res, n));
+}
+
+/** Register memory areas for fixed buffer reads and writes.
+@param[in]	buffers		areas to register, sorted by start
+@return 0 or a negated errno value */
+int
+IoUring::register_buffers(const IoUringBuffers& buffers)
+{
+	ut_ad(!buffers.empty());
+
+	std::vector<struct iovec, ut_allocator<struct iovec> >	iov(
+		buffers.size());
+
+	for (ulint i = 0; i < buffers.size(); ++i) {
+		iov[i].iov_base = buffers[i].first;
+		iov[i].iov_len = buffers[i].second;
+	}
+
+	m_mutex.enter();
+
+	unregister_buffers_low();
+
+	long	ret = syscall(
+		__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS,
+		&iov[0], static_cast<unsigned>(iov.size()));
+
+	if (ret == 0) {
+		m_buffers = buffers;
+	} else {
+		ret = -errno;
+	}
+
+	m_mutex.exit();
+
+	return(static_cast<int>(ret));
+}
+
+/** Unregister the memory areas */
+void
+IoUring::unregister_buffers()
+{
+	m_mutex.enter();
+
+	unregister_buffers_low();
+
+	m_mutex.exit();
+}
+
+/** Unregister the memory areas; the caller must own m_mutex. */
+void
+IoUring::unregister_buffers_low()
+{
+	if (m_buffers.empty()) {
+		return;
+	}
+
+	/* The kernel looks up buf_index when it submits a request, so
+	the queued requests must not refer to the areas any more. */
+	submit_low();
+
+	/* The kernel may have left some requests queued. Turn them into
+	plain reads and writes of the same buffers. */
+	unsigned	tail = *m_sq_tail;
+
+	for (unsigned head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+	     head != tail;
+	     ++head) {
+
+		struct io_uring_sqe*	sqe
+			= &m_sqes[m_sq_array[head & m_sq_mask]];
+
+		switch (sqe->opcode) {
+		case IORING_OP_READ_FIXED:
+			sqe->opcode = IORING_OP_READ;
+			sqe->buf_index = 0;
+			break;
+		case IORING_OP_WRITE_FIXED:
+			sqe->opcode = IORING_OP_WRITE;
+			sqe->buf_index = 0;
+			break;
+		}
+	}
+
+	syscall(__NR_io_uring_register, m_fd,
+		IORING_UNREGISTER_BUFFERS, NULL, 0);
+
+	m_buffers.clear();
+}
+
+/** Checks if the kernel supports the io_uring features that we use.
+@return true if supported, false otherwise. */
+bool
+AIO::is_io_uring_supported()
+{
+	IoUring	ring;
+	int	ret = ring.create(1);
+
+	if (ret != 0) {
+		ib::warn()
+			<< "io_uring_setup() returned error[" << -ret << "]";
+	}
+
+	return(ret == 0);
+}
+
+/** Submit the requests that are queued in all the io_uring instances. */
+void
+AIO::io_uring_flush_all()
+{
+	AIO*	arrays[] = { s_reads, s_writes, s_ibuf, s_log };
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+
+		AIO*	array = arrays[i];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		for (ulint j = 0; j < array->m_n_segments; ++j) {
+			array->m_uring[j].flush();
+		}
+	}
+}
+
+/** Register memory areas with the io_uring instances of the arrays that
+read and write data pages.
+@param[in]	buffers		areas to register, sorted by start */
+void
+AIO::io_uring_register_buffers(const IoUringBuffers& buffers)
+{
+	AIO*	arrays[] = { s_reads, s_writes, s_ibuf };
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+
+		AIO*	array = arrays[i];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		for (ulint j = 0; j < array->m_n_segments; ++j) {
+
+			int	ret = array->m_uring[j].register_buffers(
+				buffers);
+
+			if (ret == 0) {
+				continue;
+			}
+
+			/* Typically ENOMEM when the pages would exceed
+			RLIMIT_MEMLOCK. The I/O still works, only without
+			fixed buffers. */
+			ib::warn()
+				<< "Could not register the buffer pool"
+				" with io_uring: error[" << -ret << "]."
+				" Pages will be read and written without"
+				" registered buffers.";
+
+			io_uring_unregister_buffers();
+
+			return;
+		}
+	}
+}
+
+/** Unregister the memory areas from all the io_uring instances */
+void
+AIO::io_uring_unregister_buffers()
+{
+	AIO*	arrays[] = { s_reads, s_writes, s_ibuf };
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+
+		AIO*	array = arrays[i];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		for (ulint j = 0; j < array->m_n_segments; ++j) {
+			array->m_uring[j].unregister_buffers();
+		}
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /** Creates an io_context for native linux AIO.
 @param[in]	max_events	number of events
 @param[out]	io_ctx		io_ctx to initialize.
@@ -6313,6 +7180,9 @@ AIO::AIO(
 # ifdef LINUX_NATIVE_AIO
 	,m_aio_ctx(),
 	m_events(m_slots.size())
+#  ifdef LINUX_IO_URING
+	,m_uring()
+#  endif /* LINUX_IO_URING */
 # elif defined(_WIN32)
 	,m_handles()
 # endif /* LINUX_NATIVE_AIO */
@@ -6403,6 +7273,38 @@ AIO::init_linux_native_aio()
 
 	return(DB_SUCCESS);
 }
+
+# ifdef LINUX_IO_URING
+/** Initialise an io_uring instance for each segment */
+dberr_t
+AIO::init_io_uring()
+{
+	ut_a(m_uring == NULL);
+
+	m_uring = UT_NEW_ARRAY_NOKEY(IoUring, m_n_segments);
+
+	if (m_uring == NULL) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+
+		/* The kernel rounds the number of entries up to a power
+		of two, so every slot of the segment fits in the ring. */
+		int	ret = m_uring[i].create(slots_per_segment());
+
+		if (ret != 0) {
+			ib::error()
+				<< "io_uring_setup() returned error["
+				<< -ret << "]";
+
+			return(DB_IO_ERROR);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 /** Initialise the array */
@@ -6419,7 +7321,12 @@ AIO::init()
 
 	if (srv_use_native_aio) {
 #ifdef LINUX_NATIVE_AIO
+# ifdef LINUX_IO_URING
+		dberr_t	err = srv_use_io_uring
+			? init_io_uring() : init_linux_native_aio();
+# else
 		dberr_t	err = init_linux_native_aio();
+# endif /* LINUX_IO_URING */
 
 		if (err != DB_SUCCESS) {
 			return(err);
@@ -6489,6 +7396,10 @@ AIO::~AIO()
 		m_events.clear();
 		ut_free(m_aio_ctx);
 	}
+
+# ifdef LINUX_IO_URING
+	UT_DELETE_ARRAY(m_uring);
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 	m_slots.clear();
@@ -6513,9 +7424,37 @@ AIO::start(
 	ulint		n_writers,
 	ulint		n_slots_sync)
 {
+#ifdef LINUX_IO_URING
+	if (!srv_use_native_aio) {
+
+		srv_use_io_uring = FALSE;
+
+	} else if (srv_use_io_uring && !is_io_uring_supported()) {
+
+		ib::warn() << "io_uring disabled, using Linux Native AIO.";
+
+		srv_use_io_uring = FALSE;
+
+	} else if (srv_use_io_uring) {
+
+		ib::info() << "Using io_uring";
+	}
+#else
+	if (srv_use_io_uring) {
+
+		ib::warn()
+			<< "innodb_use_io_uring is not supported on this"
+			" platform and is ignored.";
+
+		srv_use_io_uring = FALSE;
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
-	/* Check if native aio is supported on this system and tmpfs */
-	if (srv_use_native_aio && !is_linux_native_aio_supported()) {
+	/* Check if native aio is supported on this system and tmpfs.
+	io_uring does not depend on libaio. */
+	if (srv_use_native_aio && !srv_use_io_uring
+	    && !is_linux_native_aio_supported()) {
 
 		ib::warn() << "Linux Native AIO disabled.";
 
@@ -6806,6 +7745,56 @@ os_aio_free()
 	block_cache = NULL;
 }
 
+/** Register memory areas, such as the buffer pool chunks, with the
+asynchronous i/o system so that the data page reads and writes into them
+do not need to map the pages on each request. This replaces the areas
+that were registered before. It does nothing unless io_uring is used.
+@param[in]	areas		start of each area
+@param[in]	sizes		size of each area in bytes
+@param[in]	n_areas		number of areas */
+void
+os_aio_register_buffers(
+	byte* const*	areas,
+	const ulint*	sizes,
+	ulint		n_areas)
+{
+#ifdef LINUX_IO_URING
+	if (!srv_use_native_aio || !srv_use_io_uring) {
+		return;
+	}
+
+	IoUringBuffers	buffers;
+
+	for (ulint i = 0; i < n_areas; ++i) {
+
+		/* Larger areas are accessed without registration. */
+		if (sizes[i] <= OS_AIO_URING_MAX_BUFFER) {
+			buffers.push_back(std::make_pair(areas[i], sizes[i]));
+		}
+	}
+
+	if (buffers.empty()) {
+		return;
+	}
+
+	std::sort(buffers.begin(), buffers.end());
+
+	AIO::io_uring_register_buffers(buffers);
+#endif /* LINUX_IO_URING */
+}
+
+/** Unregister the memory areas registered by os_aio_register_buffers().
+Requests that are already submitted are not affected. */
+void
+os_aio_unregister_buffers()
+{
+#ifdef LINUX_IO_URING
+	if (srv_use_native_aio && srv_use_io_uring) {
+		AIO::io_uring_unregister_buffers();
+	}
+#endif /* LINUX_IO_URING */
+}
+
 /** Wakes up all async i/o threads so that they know to exit themselves in
 shutdown. */
 void
@@ -7173,6 +8162,12 @@ void
 os_aio_simulated_wake_handler_threads()
 {
 	if (srv_use_native_aio) {
+#ifdef LINUX_IO_URING
+		/* Submit the batch of requests that were posted with
+		IORequest::DO_NOT_WAKE. */
+		AIO::io_uring_flush_all();
+#endif /* LINUX_IO_URING */
+
 		/* We do not use simulated aio: do nothing */
 
 		return;
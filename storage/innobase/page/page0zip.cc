@@ -57,6 +57,7 @@ const byte field_ref_zero[FIELD_REF_SIZE] = {
 #include "log0recv.h"
 #include "row0trunc.h"
 #include "zlib.h"
+#include <lz4.h>
 #ifndef UNIV_HOTBACKUP
 # include "buf0buf.h"
 # include "buf0lru.h"
@@ -821,6 +822,102 @@ page_zip_set_alloc(
 	strm->opaque = heap;
 }
 
+/** Compress the deflate stream of a page with a codec other than zlib.
+@param[in]	codec	codec
+@param[in]	in	uncompressed deflate stream
+@param[in]	in_len	length of the deflate stream
+@param[out]	out	the codec header and the compressed stream
+@param[in]	out_len	size of out
+@return number of bytes written to out, or 0 if they did not fit */
+ulint
+page_zip_codec_pack(
+	page_zip_codec_t	codec,
+	const byte*		in,
+	ulint			in_len,
+	byte*			out,
+	ulint			out_len)
+{
+	int	len = 0;
+
+	ut_ad(out_len < UNIV_PAGE_SIZE_MAX);
+
+	if (out_len <= PAGE_ZIP_CODEC_HEADER) {
+		return(0);
+	}
+
+	switch (codec) {
+	case PAGE_ZIP_CODEC_LZ4:
+		len = LZ4_compress_default(
+			reinterpret_cast<const char*>(in),
+			reinterpret_cast<char*>(out + PAGE_ZIP_CODEC_HEADER),
+			static_cast<int>(in_len),
+			static_cast<int>(out_len - PAGE_ZIP_CODEC_HEADER));
+		break;
+	case PAGE_ZIP_CODEC_ZLIB:
+		ut_ad(0);
+		break;
+	}
+
+	if (len <= 0) {
+		return(0);
+	}
+
+	mach_write_to_1(out, (codec << 4) | PAGE_ZIP_CODEC_MARK);
+	mach_write_to_2(out + 1, len);
+
+	return(PAGE_ZIP_CODEC_HEADER + len);
+}
+
+/** Decompress the deflate stream of a page that page_zip_codec_pack()
+compressed.
+@param[in]	in	the codec header and the compressed stream
+@param[in]	in_len	maximum length of the compressed stream
+@param[out]	out	uncompressed deflate stream
+@param[in]	out_len	size of out
+@param[out]	used	number of bytes of in that were used
+@return length of the deflate stream, or 0 if the stream is corrupted */
+ulint
+page_zip_codec_unpack(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len,
+	ulint*		used)
+{
+	int	len = 0;
+
+	if (in_len <= PAGE_ZIP_CODEC_HEADER) {
+		return(0);
+	}
+
+	const ulint	c_len = mach_read_from_2(in + 1);
+
+	if (c_len > in_len - PAGE_ZIP_CODEC_HEADER) {
+		return(0);
+	}
+
+	switch (page_zip_codec_get(in)) {
+	case PAGE_ZIP_CODEC_LZ4:
+		len = LZ4_decompress_safe(
+			reinterpret_cast<const char*>(
+				in + PAGE_ZIP_CODEC_HEADER),
+			reinterpret_cast<char*>(out),
+			static_cast<int>(c_len),
+			static_cast<int>(out_len));
+		break;
+	case PAGE_ZIP_CODEC_ZLIB:
+		break;
+	}
+
+	if (len <= 0) {
+		return(0);
+	}
+
+	*used = PAGE_ZIP_CODEC_HEADER + c_len;
+
+	return(len);
+}
+
 #if 0 || defined UNIV_DEBUG || defined UNIV_ZIP_DEBUG
 /** Symbol for enabling compression and decompression diagnostics */
 # define PAGE_ZIP_COMPRESS_DBG
@@ -1296,6 +1393,9 @@ page_zip_compress(
 	byte*			storage;	/* storage of uncompressed
 						columns */
 	index_id_t		ind_id;
+	page_zip_codec_t	codec;
+	byte*			stage = NULL;	/* deflate stream that
+						the codec compresses */
 #ifndef UNIV_HOTBACKUP
 	ib_time_monotonic_us_t usec = ut_time_monotonic_us();
 #endif /* !UNIV_HOTBACKUP */
@@ -1339,6 +1439,7 @@ page_zip_compress(
 		ut_ad(page_comp_info != NULL);
 		n_fields = page_comp_info->n_fields;
 		ind_id = page_comp_info->index_id;
+		codec = PAGE_ZIP_CODEC_ZLIB;
 	} else {
 		if (page_is_leaf(page)) {
 			n_fields = dict_index_get_n_fields(index);
@@ -1346,6 +1447,7 @@ page_zip_compress(
 			n_fields = dict_index_get_n_unique_in_tree_nonleaf(index);
 		}
 		ind_id = index->id;
+		codec = index->table->zip_codec;
 	}
 
 	/* The dense directory excludes the infimum and supremum records. */
@@ -1404,24 +1506,49 @@ page_zip_compress(
 			       + n_dense * ((sizeof *recs)
 					    - PAGE_ZIP_DIR_SLOT_SIZE)
 			       + UNIV_PAGE_SIZE * 4
-			       + (512 << MAX_MEM_LEVEL));
+			       + (512 << MAX_MEM_LEVEL)
+			       + (codec == PAGE_ZIP_CODEC_ZLIB
+				  ? 0 : PAGE_ZIP_STAGE_SIZE));
 
 	recs = static_cast<const rec_t**>(
 		mem_heap_zalloc(heap, n_dense * sizeof *recs));
 
 	fields = static_cast<byte*>(mem_heap_alloc(heap, (n_fields + 1) * 2));
 
-	buf = static_cast<byte*>(
-		mem_heap_alloc(heap, page_zip_get_size(page_zip) - PAGE_DATA));
+	if (codec == PAGE_ZIP_CODEC_ZLIB) {
+		buf = static_cast<byte*>(
+			mem_heap_alloc(heap,
+				       page_zip_get_size(page_zip) - PAGE_DATA));
+	} else {
+		/* The deflate stream is written to stage, which is
+		immediately followed by buf. Because the stream is
+		shorter than PAGE_ZIP_STAGE_SIZE, the space that is
+		reserved at the end of buf for BLOB pointers can be
+		accounted for in c_stream.avail_out as usual. */
+		stage = static_cast<byte*>(
+			mem_heap_alloc(heap, PAGE_ZIP_STAGE_SIZE
+				       + page_zip_get_size(page_zip)
+				       - PAGE_DATA));
+		buf = stage + PAGE_ZIP_STAGE_SIZE;
+	}
 
 	buf_end = buf + page_zip_get_size(page_zip) - PAGE_DATA;
 
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, static_cast<int>(level),
-			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
-			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+	if (stage == NULL) {
+		err = deflateInit2(&c_stream, static_cast<int>(level),
+				   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
+				   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+	} else {
+		/* Emit a raw deflate stream of stored blocks,
+		for the codec to compress. */
+		err = deflateInit2(&c_stream, Z_NO_COMPRESSION,
+				   Z_DEFLATED,
+				   -static_cast<int>(UNIV_PAGE_SIZE_SHIFT),
+				   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+	}
 	ut_a(err == Z_OK);
 
 	c_stream.next_out = buf;
@@ -1471,6 +1598,12 @@ page_zip_compress(
 	}
 
 	c_stream.avail_out -= static_cast<uInt>(n_dense * slot_size);
+
+	if (stage != NULL) {
+		c_stream.next_out = stage;
+		c_stream.avail_out += PAGE_ZIP_STAGE_SIZE;
+	}
+
 	if (truncate_t::s_fix_up_active) {
 		ut_ad(page_comp_info != NULL);
 		c_stream.avail_in = static_cast<uInt>(
@@ -1546,6 +1679,29 @@ page_zip_compress(
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
 	err = deflate(&c_stream, Z_FINISH);
 
+	if (stage != NULL && err == Z_STREAM_END) {
+		/* Compress the deflate stream into buf, leaving
+		alone the BLOB pointers at the end of buf. */
+		ulint	len = 0;
+
+		if (c_stream.total_out < PAGE_ZIP_STAGE_SIZE) {
+			const ulint	avail = static_cast<ulint>(
+				c_stream.next_out + c_stream.avail_out - buf);
+
+			len = page_zip_codec_pack(codec, stage,
+						  c_stream.total_out,
+						  buf, avail);
+
+			c_stream.next_out = buf + len;
+			c_stream.avail_out = static_cast<uInt>(avail - len);
+			c_stream.total_out = len;
+		}
+
+		if (len == 0) {
+			err = Z_BUF_ERROR;
+		}
+	}
+
 	if (UNIV_UNLIKELY(err != Z_STREAM_END)) {
 zlib_error:
 		deflateEnd(&c_stream);
@@ -2294,6 +2450,35 @@ page_zip_decompress_heap_no(
 	return(TRUE);
 }
 
+/** Finish the decompression of the records of a page and make d_stream
+point to the modification log, which follows the compressed stream.
+@param[in]	page_zip	compressed page
+@param[in,out]	d_stream	stream that has reached Z_STREAM_END */
+static
+void
+page_zip_inflate_end(
+	page_zip_des_t*	page_zip,
+	z_stream*	d_stream)
+{
+	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+		ut_error;
+	}
+
+	byte*	stream = page_zip->data + PAGE_DATA;
+
+	if (page_zip_codec_get(stream) != PAGE_ZIP_CODEC_ZLIB) {
+		/* The records were inflated from the output of
+		page_zip_codec_unpack(). Its length was added to
+		avail_in, which thus is right for the modification
+		log already. */
+		const ulint	used = PAGE_ZIP_CODEC_HEADER
+			+ mach_read_from_2(stream + 1);
+
+		d_stream->next_in = stream + used;
+		d_stream->total_in = used;
+	}
+}
+
 /**********************************************************************//**
 Decompress the records of a node pointer page.
 @return TRUE on success, FALSE on failure */
@@ -2415,9 +2600,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
-		ut_error;
-	}
+	page_zip_inflate_end(page_zip, d_stream);
 
 	{
 		page_t*	page = page_align(d_stream->next_out);
@@ -2569,9 +2752,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
-		ut_error;
-	}
+	page_zip_inflate_end(page_zip, d_stream);
 
 	{
 		page_t*	page = page_align(d_stream->next_out);
@@ -2900,9 +3081,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
-		ut_error;
-	}
+	page_zip_inflate_end(page_zip, d_stream);
 
 	{
 		page_t*	page = page_align(d_stream->next_out);
@@ -3066,7 +3245,12 @@ page_zip_decompress_low(
 		return(FALSE);
 	}
 
-	heap = mem_heap_create(n_dense * (3 * sizeof *recs) + UNIV_PAGE_SIZE);
+	heap = mem_heap_create(n_dense * (3 * sizeof *recs) + UNIV_PAGE_SIZE
+			       + (page_zip_codec_get(page_zip->data + PAGE_DATA)
+				  == PAGE_ZIP_CODEC_ZLIB
+				  ? 0
+				  : PAGE_ZIP_STAGE_SIZE
+				  + page_zip_get_size(page_zip)));
 
 	recs = static_cast<rec_t**>(
 		mem_heap_alloc(heap, n_dense * sizeof *recs));
@@ -3135,9 +3319,43 @@ zlib_error:
 	d_stream.next_out = page + PAGE_ZIP_START;
 	d_stream.avail_out = UNIV_PAGE_SIZE - PAGE_ZIP_START;
 
-	if (UNIV_UNLIKELY(inflateInit2(&d_stream, UNIV_PAGE_SIZE_SHIFT)
-			  != Z_OK)) {
-		ut_error;
+	if (page_zip_codec_get(d_stream.next_in) == PAGE_ZIP_CODEC_ZLIB) {
+		if (UNIV_UNLIKELY(inflateInit2(&d_stream,
+					       UNIV_PAGE_SIZE_SHIFT)
+				  != Z_OK)) {
+			ut_error;
+		}
+	} else {
+		/* Unpack the raw deflate stream that
+		page_zip_compress() wrote. The space after the
+		stream is only accounted for in avail_in, so that
+		the page_zip_decompress_*() functions can subtract
+		the uncompressed data from it as usual. */
+		ulint	used;
+		byte*	stage = static_cast<byte*>(
+			mem_heap_alloc(heap, PAGE_ZIP_STAGE_SIZE
+				       + page_zip_get_size(page_zip)));
+		ulint	len = page_zip_codec_unpack(
+			d_stream.next_in, d_stream.avail_in,
+			stage, PAGE_ZIP_STAGE_SIZE, &used);
+
+		if (UNIV_UNLIKELY(!len)) {
+			page_zip_fail(("page_zip_decompress:"
+				       " codec %u\n",
+				       unsigned(*d_stream.next_in)));
+			goto zlib_error;
+		}
+
+		d_stream.next_in = stage;
+		d_stream.avail_in = static_cast<uInt>(
+			len + d_stream.avail_in - used);
+
+		if (UNIV_UNLIKELY(inflateInit2(
+				  &d_stream,
+				  -static_cast<int>(UNIV_PAGE_SIZE_SHIFT))
+				  != Z_OK)) {
+			ut_error;
+		}
 	}
 
 	/* Decode the zlib header and the index information. */
@@ -34,6 +34,7 @@ Created 2/16/1997 Heikki Tuuri
 #include "read0read.h"
 
 #include "srv0srv.h"
+#include "row0vers.h"
 #include "trx0sys.h"
 
 /*
@@ -138,15 +139,17 @@ FACT C: Purge does not remove any delete-marked row that is visible
 in any cursor read view.
 
 PROOF: We know that:
- 1: Currently active read views in trx_sys_t::view_list are ordered by
-    ReadView::low_limit_no in descending order, that is,
-    newest read view first.
+ 1: A read view that is prepared after another read view has been
+    completed sees everything that the older view sees, because the
+    snapshots are consistent and transactions only ever commit.
 
- 2: Purge clones the oldest read view and uses that to determine whether there
-    are any active transactions that can see the to be purged records.
+ 2: Purge takes a fresh snapshot and then merges into it every view in
+    MVCC::m_views that is open, waiting for the views that were registered
+    before the fresh snapshot was completed and are still being prepared.
+    The merged view sees a change only if all of those views see it.
 
 Therefore any joining or active transaction will not have a view older
-than the purge view, according to 1.
+than the purge view, according to 1 and 2.
 
 When purge needs to remove a delete-marked row from a secondary index,
 it will first check that the DB_TRX_ID value of the corresponding
@@ -171,46 +174,44 @@ For details see: row_vers_old_has_index_entry() and row_purge_poss_sec()
 Some additional issues:
 
 What if trx_sys->view_list == NULL and some transaction T1 and Purge both
-try to open read_view at same time. Only one can acquire trx_sys->mutex.
+try to open read_view at same time. Neither holds trx_sys->mutex.
 In which order will the views be opened? Should it matter? If no, why?
 
-The order does not matter. No new transactions can be created and no running
-RW transaction can commit or rollback (or free views). AC-NL-RO transactions
-will mark their views as closed but not actually free their views.
+The order does not matter. If T1 registered its view before Purge read
+MVCC::m_n_registered, Purge waits for T1 to complete its view and merges it.
+Otherwise T1 starts preparing after the fresh snapshot of Purge has been
+completed, and sees at least as much as Purge, according to 1.
+
+A snapshot is taken without trx_sys->mutex by reading max_trx_id and then
+the ids below it in trx_sys_t::rw_trx_active. An id is registered before
+max_trx_id is advanced past it, and erasing an id bumps the version of the
+registry, so a snapshot that overlapped a commit is discarded and retried.
 */
 
 /** Minimum number of elements to reserve in ReadView::ids_t */
 static const ulint MIN_TRX_IDS = 32;
 
-#ifdef UNIV_DEBUG
-/** Functor to validate the view list. */
-struct	ViewCheck {
-
-	ViewCheck() : m_prev_view() { }
-
-	void	operator()(const ReadView* view)
-	{
-		ut_a(m_prev_view == NULL
-		     || view->is_closed()
-		     || view->le(m_prev_view));
-
-		m_prev_view = view;
-	}
-
-	const ReadView*	m_prev_view;
-};
+/** Number of attempts to take a snapshot without trx_sys->mutex */
+static const ulint READ_VIEW_LOCK_FREE_RETRIES = 8;
 
+#ifdef UNIV_DEBUG
 /**
-Validates a read view list. */
+Validates a read view list. The views are not ordered, they are prepared
+concurrently. */
 
 bool
 MVCC::validate() const
 {
-	ViewCheck	check;
+	ut_ad(mutex_own(&m_mutex));
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	for (const ReadView* view = UT_LIST_GET_FIRST(m_views);
+	     view != NULL;
+	     view = UT_LIST_GET_NEXT(m_view_list, view)) {
 
-	ut_list_map(m_views, check);
+		ut_a(view->m_preparing
+		     || view->is_closed()
+		     || view->m_up_limit_id <= view->m_low_limit_id);
+	}
 
 	return(true);
 }
@@ -333,7 +334,11 @@ ReadView::ReadView()
 	m_up_limit_id(),
 	m_creator_trx_id(),
 	m_ids(),
-	m_low_limit_no()
+	m_low_limit_no(),
+	m_closed(),
+	m_preparing(),
+	m_ticket(),
+	m_vers_cache()
 {
 	ut_d(::memset(&m_view_list, 0x0, sizeof(m_view_list)));
 }
@@ -342,13 +347,17 @@ ReadView::ReadView()
 ReadView destructor */
 ReadView::~ReadView()
 {
-	// Do nothing
+	UT_DELETE(m_vers_cache);
 }
 
 /** Constructor
 @param size		Number of views to pre-allocate */
 MVCC::MVCC(ulint size)
+	:
+	m_n_registered()
 {
+	mutex_create(LATCH_ID_MVCC_VIEW, &m_mutex);
+
 	UT_LIST_INIT(m_free, &ReadView::m_view_list);
 	UT_LIST_INIT(m_views, &ReadView::m_view_list);
 
@@ -371,6 +380,8 @@ MVCC::~MVCC()
 	}
 
 	ut_a(UT_LIST_GET_LEN(m_views) == 0);
+
+	mutex_free(&m_mutex);
 }
 
 /**
@@ -432,30 +443,29 @@ ReadView::copy_trx_ids(const trx_ids_t& trx_ids)
 	}
 
 #ifdef UNIV_DEBUG
-	/* Assert that all transaction ids in list are active. */
+	/* Assert that all transaction ids in list are active. A transaction
+	is added to its shard of the rw_trx_set only after it has been
+	assigned an id under trx_sys->mutex, so it may not be found yet. */
 	for (trx_ids_t::const_iterator it = trx_ids.begin();
 	     it != trx_ids.end(); ++it) {
 
 		trx_t*	trx = trx_get_rw_trx_by_id(*it);
-		ut_ad(trx != NULL);
-		ut_ad(trx->state == TRX_STATE_ACTIVE
+		ut_ad(trx == NULL
+		      || trx->state == TRX_STATE_ACTIVE
 		      || trx->state == TRX_STATE_PREPARED);
 	}
 #endif /* UNIV_DEBUG */
 }
 
 /**
-Opens a read view where exactly the transactions serialized before this
-point in time are seen in the view.
-@param id		Creator transaction id */
+Take the snapshot from trx_sys_t::rw_trx_ids. Caller must own
+trx_sys->mutex. */
 
 void
-ReadView::prepare(trx_id_t id)
+ReadView::prepare_low()
 {
 	ut_ad(mutex_own(&trx_sys->mutex));
 
-	m_creator_trx_id = id;
-
 	m_low_limit_no = m_low_limit_id = trx_sys->max_trx_id;
 
 	if (!trx_sys->rw_trx_ids.empty()) {
@@ -475,6 +485,115 @@ ReadView::prepare(trx_id_t id)
 	}
 }
 
+/**
+Take the snapshot from trx_sys_t::rw_trx_active without acquiring
+trx_sys->mutex.
+@return false if the snapshot was not consistent and must be retried */
+
+bool
+ReadView::prepare_lock_free()
+{
+	const TrxIdRegistry&	active = trx_sys->rw_trx_active;
+
+	ulint	version = active.read_begin();
+
+	if (version == ULINT_UNDEFINED) {
+		return(false);
+	}
+
+	/* Every id below this limit was registered before the limit was
+	published, see trx_sys_get_new_rw_trx_id(). */
+	trx_id_t	limit = trx_sys->max_trx_id;
+
+	os_rmb;
+
+	if (active.overflowed()) {
+		return(false);
+	}
+
+	trx_id_t	min_no = trx_sys->serialisation_min_no;
+
+	m_ids.clear();
+	m_ids.reserve(active.size() + 1);
+
+	ulint	n = active.copy(
+		m_ids.data(), m_ids.capacity(), limit, m_creator_trx_id);
+
+	if (n == ULINT_UNDEFINED) {
+		m_ids.reserve(m_ids.capacity() * 2);
+		return(false);
+	}
+
+	if (!active.read_validate(version)) {
+		return(false);
+	}
+
+	m_ids.resize(n);
+
+	std::sort(m_ids.data(), m_ids.data() + n);
+
+	m_low_limit_id = limit;
+
+	m_low_limit_no = std::min(limit, min_no);
+
+	return(true);
+}
+
+/**
+Opens a read view where exactly the transactions serialized before this
+point in time are seen in the view. Does not acquire trx_sys->mutex
+unless the active transaction ids cannot be read without it.
+@param id		Creator transaction id */
+
+void
+ReadView::prepare(trx_id_t id)
+{
+	ut_ad(!trx_sys_mutex_own());
+
+	m_creator_trx_id = id;
+
+#if defined(HAVE_MEMORY_BARRIER) && UNIV_WORD_SIZE >= DATA_TRX_ID_LEN
+	for (ulint i = 0; i < READ_VIEW_LOCK_FREE_RETRIES; ++i) {
+
+		if (prepare_lock_free()) {
+			return;
+
+		} else if (trx_sys->rw_trx_active.overflowed()) {
+			/* Some of the ids are only in rw_trx_ids. */
+			break;
+		}
+	}
+#endif /* HAVE_MEMORY_BARRIER && UNIV_WORD_SIZE >= DATA_TRX_ID_LEN */
+
+	trx_sys_mutex_enter();
+
+	prepare_low();
+
+	trx_sys_mutex_exit();
+}
+
+/**
+Empty the version cache for a new snapshot, creating or resizing it
+according to innodb_version_cache_size. */
+
+void
+ReadView::reset_version_cache()
+{
+	if (m_vers_cache != NULL
+	    && m_vers_cache->max_size() != srv_version_cache_size) {
+
+		UT_DELETE(m_vers_cache);
+		m_vers_cache = NULL;
+	}
+
+	if (m_vers_cache != NULL) {
+		m_vers_cache->clear();
+	} else if (srv_version_cache_size > 0) {
+		m_vers_cache = UT_NEW_NOKEY(
+			VersionCache(srv_version_cache_size));
+	}
+}
+
 /**
 Complete the read view creation */
 
@@ -487,6 +606,12 @@ ReadView::complete()
 	ut_ad(m_up_limit_id <= m_low_limit_id);
 
 	m_closed = false;
+
+	/* Purge may read the view as soon as it is no longer marked as
+	being prepared. */
+	os_wmb;
+
+	m_preparing = false;
 }
 
 /**
@@ -497,7 +622,7 @@ a new view.
 ReadView*
 MVCC::get_view()
 {
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&m_mutex));
 
 	ReadView*	view;
 
@@ -516,14 +641,26 @@ MVCC::get_view()
 }
 
 /**
-Release a view that is inactive but not closed. Caller must own
-the trx_sys_t::mutex.
+Register a view in m_views as being prepared. Caller must own m_mutex.
+@param view		view to register */
+
+void
+MVCC::view_register(ReadView* view)
+{
+	ut_ad(mutex_own(&m_mutex));
+
+	view->m_preparing = true;
+
+	view->m_ticket = ++m_n_registered;
+}
+
+/**
+Release a view that is inactive but not closed.
 @param view		View to release */
 void
 MVCC::view_release(ReadView*& view)
 {
 	ut_ad(!srv_read_only_mode);
-	ut_ad(trx_sys_mutex_own());
 
 	uintptr_t	p = reinterpret_cast<uintptr_t>(view);
 
@@ -538,10 +675,14 @@ MVCC::view_release(ReadView*& view)
 
 	ut_ad(view->m_creator_trx_id == 0);
 
+	mutex_enter(&m_mutex);
+
 	UT_LIST_REMOVE(m_views, view);
 
 	UT_LIST_ADD_LAST(m_free, view);
 
+	mutex_exit(&m_mutex);
+
 	view = NULL;
 }
 
@@ -584,98 +725,100 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 			}
 		}
 
-		mutex_enter(&trx_sys->mutex);
+		/* The view stays in m_views, there is no order to keep. */
+		mutex_enter(&m_mutex);
 
-		UT_LIST_REMOVE(m_views, view);
+		view_register(view);
+
+		mutex_exit(&m_mutex);
 
 	} else {
-		mutex_enter(&trx_sys->mutex);
+		mutex_enter(&m_mutex);
 
 		view = get_view();
-	}
-
-	if (view != NULL) {
 
-		view->prepare(trx->id);
-
-		view->complete();
+		if (view != NULL) {
 
-		UT_LIST_ADD_FIRST(m_views, view);
+			view_register(view);
 
-		ut_ad(!view->is_closed());
+			UT_LIST_ADD_FIRST(m_views, view);
+		}
 
-		ut_ad(validate());
+		mutex_exit(&m_mutex);
 	}
 
-	trx_sys_mutex_exit();
-}
-
-/**
-Get the oldest (active) view in the system.
-@return oldest view if found or NULL */
+	if (view != NULL) {
 
-ReadView*
-MVCC::get_oldest_view() const
-{
-	ReadView*	view;
+		/* The versions that were built for the previous snapshot
+		are not valid for the new one. */
+		view->reset_version_cache();
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+		view->prepare(trx->id);
 
-	for (view = UT_LIST_GET_LAST(m_views);
-	     view != NULL;
-	     view = UT_LIST_GET_PREV(m_view_list, view)) {
+		view->complete();
 
-		if (!view->is_closed()) {
-			break;
-		}
+		ut_ad(!view->is_closed());
 	}
-
-	return(view);
 }
 
 /**
-Copy state from another view. Must call copy_complete() to finish.
-@param other		view to copy from */
+Widen this view so that it does not see any changes that are not
+visible to the other view. Must call merge_complete() to finish.
+@param other		view to merge */
 
 void
-ReadView::copy_prepare(const ReadView& other)
+ReadView::merge(const ReadView& other)
 {
 	ut_ad(&other != this);
 
-	if (!other.m_ids.empty()) {
-		const ids_t::value_type* 	p = other.m_ids.data();
-
-		m_ids.assign(p, p + other.m_ids.size());
-	} else {
-		m_ids.clear();
+	if (other.m_low_limit_no < m_low_limit_no) {
+		m_low_limit_no = other.m_low_limit_no;
 	}
 
-	m_up_limit_id = other.m_up_limit_id;
+	if (other.m_low_limit_id < m_low_limit_id) {
+		m_low_limit_id = other.m_low_limit_id;
+	}
 
-	m_low_limit_no = other.m_low_limit_no;
+	for (ulint i = 0; i < other.m_ids.size(); ++i) {
+		m_ids.push_back(other.m_ids.data()[i]);
+	}
 
-	m_low_limit_id = other.m_low_limit_id;
+	/* The creator may be assigned an id concurrently, see
+	MVCC::set_view_creator_trx_id(). Either value is fine: the new
+	id is not below any m_low_limit_id. */
+	trx_id_t	creator_trx_id = other.m_creator_trx_id;
 
-	m_creator_trx_id = other.m_creator_trx_id;
+	if (creator_trx_id > 0 && creator_trx_id != TRX_ID_MAX) {
+		m_ids.push_back(creator_trx_id);
+	}
 }
 
 /**
-Complete the copy, insert the creator transaction id into the
-m_ids too and adjust the m_up_limit_id, if required */
+Complete the merge, sort the m_ids, insert the creator transaction id
+into the m_ids too and adjust the m_up_limit_id, if required */
 
 void
-ReadView::copy_complete()
+ReadView::merge_complete()
 {
 	ut_ad(!trx_sys_mutex_own());
 
 	if (m_creator_trx_id > 0) {
-		m_ids.insert(m_creator_trx_id);
+		m_ids.push_back(m_creator_trx_id);
 	}
 
-	if (!m_ids.empty()) {
-		/* The last active transaction has the smallest id. */
-		m_up_limit_id = std::min(m_ids.front(), m_up_limit_id);
-	}
+	ids_t::value_type*	begin = m_ids.data();
+	ids_t::value_type*	end = begin + m_ids.size();
+
+	std::sort(begin, end);
+
+	end = std::unique(begin, end);
+
+	/* The ids at or above the low limit are not seen anyway. */
+	end = std::lower_bound(begin, end, m_low_limit_id);
+
+	m_ids.resize(end - begin);
+
+	m_up_limit_id = !m_ids.empty() ? m_ids.front() : m_low_limit_id;
 
 	ut_ad(m_up_limit_id <= m_low_limit_id);
 
@@ -683,34 +826,69 @@ ReadView::copy_complete()
 	m_creator_trx_id = 0;
 }
 
-/** Clones the oldest view and stores it in view. No need to
-call view_close(). The caller owns the view that is passed in.
-This function is called by Purge to determine whether it should
-purge the delete marked record or not.
+/** Creates a view that sees no more than any of the open views and
+stores it in view. No need to call view_close(). The caller owns the
+view that is passed in. This function is called by Purge to determine
+whether it should purge the delete marked record or not.
 @param view		Preallocated view, owned by the caller */
 
 void
 MVCC::clone_oldest_view(ReadView* view)
 {
-	mutex_enter(&trx_sys->mutex);
+	/* Views that are registered after this snapshot has been
+	completed can only see more than it. */
+	view->prepare(0);
 
-	ReadView*	oldest_view = get_oldest_view();
+	view->complete();
 
-	if (oldest_view == NULL) {
+	ulint	n_registered = ULINT_UNDEFINED;
 
-		view->prepare(0);
+	for (;;) {
+		mutex_enter(&m_mutex);
 
-		trx_sys_mutex_exit();
+		if (n_registered == ULINT_UNDEFINED) {
+			n_registered = m_n_registered;
+		}
 
-		view->complete();
+		const ReadView*	oldest_view;
 
-	} else {
-		view->copy_prepare(*oldest_view);
+		for (oldest_view = UT_LIST_GET_FIRST(m_views);
+		     oldest_view != NULL;
+		     oldest_view = UT_LIST_GET_NEXT(m_view_list, oldest_view)) {
 
-		trx_sys_mutex_exit();
+			if (oldest_view->m_preparing
+			    && oldest_view->m_ticket <= n_registered) {
 
-		view->copy_complete();
+				break;
+			}
+		}
+
+		if (oldest_view == NULL) {
+			break;
+		}
+
+		/* Wait for the older view to be completed. */
+		mutex_exit(&m_mutex);
+
+		os_thread_yield();
 	}
+
+	for (const ReadView* oldest_view = UT_LIST_GET_FIRST(m_views);
+	     oldest_view != NULL;
+	     oldest_view = UT_LIST_GET_NEXT(m_view_list, oldest_view)) {
+
+		if (oldest_view->m_preparing || oldest_view->is_closed()) {
+			continue;
+		}
+
+		os_rmb;
+
+		view->merge(*oldest_view);
+	}
+
+	mutex_exit(&m_mutex);
+
+	view->merge_complete();
 }
 
 /**
@@ -719,7 +897,7 @@ MVCC::clone_oldest_view(ReadView* view)
 ulint
 MVCC::size() const
 {
-	trx_sys_mutex_enter();
+	mutex_enter(&m_mutex);
 
 	ulint	size = 0;
 
@@ -732,7 +910,7 @@ MVCC::size() const
 		}
 	}
 
-	trx_sys_mutex_exit();
+	mutex_exit(&m_mutex);
 
 	return(size);
 }
@@ -740,16 +918,17 @@ MVCC::size() const
 /**
 Close a view created by the above function.
 @para view		view allocated by trx_open.
-@param own_mutex	true if caller owns trx_sys_t::mutex */
+@param free_view	true to return the view to the free list,
+			false to only mark it closed (AC-NL-RO) */
 
 void
-MVCC::view_close(ReadView*& view, bool own_mutex)
+MVCC::view_close(ReadView*& view, bool free_view)
 {
 	uintptr_t	p = reinterpret_cast<uintptr_t>(view);
 
 	/* Note: The assumption here is that AC-NL-RO transactions will
-	call this function with own_mutex == false. */
-	if (!own_mutex) {
+	call this function with free_view == false. */
+	if (!free_view) {
 		/* Sanitise the pointer first. */
 		ReadView*	ptr = reinterpret_cast<ReadView*>(p & ~1);
 
@@ -762,6 +941,8 @@ MVCC::view_close(ReadView*& view, bool own_mutex)
 	} else {
 		view = reinterpret_cast<ReadView*>(p & ~1);
 
+		mutex_enter(&m_mutex);
+
 		view->close();
 
 		UT_LIST_REMOVE(m_views, view);
@@ -769,6 +950,8 @@ MVCC::view_close(ReadView*& view, bool own_mutex)
 
 		ut_ad(validate());
 
+		mutex_exit(&m_mutex);
+
 		view = NULL;
 	}
 }
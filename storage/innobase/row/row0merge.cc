@@ -40,6 +40,7 @@ Completed by Sunny Bains and Marko Makela
 #include "row0ext.h"
 #include "row0log.h"
 #include "row0ins.h"
+#include "row0pread.h"
 #include "row0sel.h"
 #include "dict0crea.h"
 #include "trx0purge.h"
@@ -2659,6 +2660,474 @@ wait_again:
 	DBUG_RETURN(err);
 }
 
+/** Check if row_merge_read_clustered_index_parallel() can write the
+entries of the indexes that are being created.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	online		true if creating indexes online
+@param[in]	indexes		indexes to be created
+@param[in]	n_indexes	size of indexes[]
+@param[in]	add_v		new virtual columns added along with indexes
+@return whether the table is not rebuilt and all the indexes are
+non-unique B-tree indexes on stored columns */
+static
+bool
+row_merge_scan_parallel_possible(
+	const trx_t*		trx,
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	bool			online,
+	dict_index_t**		indexes,
+	ulint			n_indexes,
+	const dict_add_v_col_t*	add_v)
+{
+	/* An online scan must use the read view of the transaction,
+	which ParallelReader does not do in READ UNCOMMITTED. */
+	if (old_table != new_table
+	    || add_v != NULL
+	    || (online
+		&& trx->isolation_level == TRX_ISO_READ_UNCOMMITTED)) {
+		return(false);
+	}
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		/* Duplicates would be reported in the MySQL row buffer,
+		and virtual columns computed in the MySQL table, which
+		must not be written by two threads at the same time. */
+		if (dict_index_is_unique(indexes[i])
+		    || dict_index_is_spatial(indexes[i])
+		    || (indexes[i]->type & DICT_FTS)
+		    || dict_index_has_virtual(indexes[i])) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Writes the entries of the indexes that are being created to merge
+files, for row_merge_read_clustered_index_parallel(). Each thread fills its
+own sort buffers, and writes each full buffer as a sorted block at the end
+of the merge file of the index. Thus every block of a merge file is a run
+for row_merge_sort(), like the blocks that row_merge_read_clustered_index()
+writes. */
+class MergeScanCallback : public ParallelReader::Callback {
+public:
+	/** Constructor
+	@param[in]	trx		transaction
+	@param[in]	table		table where the indexes are created
+	@param[in]	indexes		indexes to be created
+	@param[in]	n_indexes	size of indexes[]
+	@param[in,out]	files		merge files of the indexes
+	@param[in]	n_threads	maximum number of threads
+	@param[in,out]	stage		performance schema accounting object */
+	MergeScanCallback(
+		trx_t*			trx,
+		const dict_table_t*	table,
+		dict_index_t**		indexes,
+		ulint			n_indexes,
+		merge_file_t*		files,
+		ulint			n_threads,
+		ut_stage_alter_t*	stage)
+		:
+		m_trx(trx),
+		m_table(table),
+		m_indexes(indexes),
+		m_n_indexes(n_indexes),
+		m_files(files),
+		m_n_threads(n_threads),
+		m_stage(stage),
+		m_error_index(ULINT_UNDEFINED),
+		m_alloc(mem_key_row_merge_sort)
+	{
+		m_threads = static_cast<thread_t*>(
+			ut_zalloc_nokey(n_threads * sizeof *m_threads));
+	}
+
+	~MergeScanCallback()
+	{
+		for (ulint t = 0; t < m_n_threads; t++) {
+			thread_t&	thread = m_threads[t];
+
+			if (thread.bufs != NULL) {
+				for (ulint i = 0; i < m_n_indexes; i++) {
+					row_merge_buf_free(thread.bufs[i]);
+				}
+
+				ut_free(thread.bufs);
+			}
+
+			ut_free(thread.n_rec);
+
+			if (thread.block != NULL) {
+				m_alloc.deallocate_large(
+					thread.block, &thread.block_pfx);
+			}
+
+			if (thread.row_heap != NULL) {
+				mem_heap_free(thread.row_heap);
+			}
+
+			if (thread.v_heap != NULL) {
+				mem_heap_free(thread.v_heap);
+			}
+		}
+
+		ut_free(m_threads);
+	}
+
+	/** Allocate the sort buffers of the threads.
+	@return DB_SUCCESS or DB_OUT_OF_MEMORY */
+	dberr_t init()
+	{
+		for (ulint t = 0; t < m_n_threads; t++) {
+			thread_t&	thread = m_threads[t];
+
+			thread.block = m_alloc.allocate_large(
+				srv_sort_buf_size, &thread.block_pfx);
+
+			if (thread.block == NULL) {
+				return(DB_OUT_OF_MEMORY);
+			}
+
+			thread.bufs = static_cast<row_merge_buf_t**>(
+				ut_malloc_nokey(
+					m_n_indexes * sizeof *thread.bufs));
+			thread.n_rec = static_cast<ulint*>(
+				ut_zalloc_nokey(
+					m_n_indexes * sizeof *thread.n_rec));
+
+			for (ulint i = 0; i < m_n_indexes; i++) {
+				thread.bufs[i] = row_merge_buf_create(
+					m_indexes[i]);
+			}
+
+			thread.row_heap = mem_heap_create(sizeof(mrec_buf_t));
+			thread.page_no = FIL_NULL;
+		}
+
+		return(DB_SUCCESS);
+	}
+
+	/** Add the entries of a record to the sort buffers.
+	@param[in]	ctx	the record and where it was read
+	@return DB_SUCCESS or error code */
+	dberr_t operator()(const ParallelReader::Ctx& ctx)
+	{
+		thread_t&	thread = m_threads[ctx.m_thread_id];
+		const ulint	page_no = ctx.m_block->page.id.page_no();
+
+		if (page_no != thread.page_no) {
+			thread.page_no = page_no;
+
+			m_stage->n_pk_recs_inc(thread.n_pk_recs);
+			m_stage->inc();
+
+			thread.n_pk_recs = 0;
+		}
+
+		thread.n_pk_recs++;
+
+		mem_heap_empty(thread.row_heap);
+
+		row_ext_t*	ext;
+		const dtuple_t*	row = row_build(
+			ROW_COPY_POINTERS, dict_table_get_first_index(m_table),
+			ctx.m_rec, ctx.m_offsets, m_table, NULL, NULL, &ext,
+			thread.row_heap);
+
+		for (ulint i = 0; i < m_n_indexes; i++) {
+			dberr_t	err = add(thread, i, row, ext);
+
+			if (err != DB_SUCCESS) {
+				os_compare_and_swap_ulint(
+					&m_error_index, ULINT_UNDEFINED, i);
+				return(err);
+			}
+		}
+
+		return(DB_SUCCESS);
+	}
+
+	/** Write the entries that are left in the sort buffers, and count
+	the records of the merge files. This must be called after
+	ParallelReader::run() has returned.
+	@return DB_SUCCESS or error code */
+	dberr_t finish()
+	{
+		for (ulint t = 0; t < m_n_threads; t++) {
+			thread_t&	thread = m_threads[t];
+
+			m_stage->n_pk_recs_inc(thread.n_pk_recs);
+			thread.n_pk_recs = 0;
+
+			for (ulint i = 0; i < m_n_indexes; i++) {
+				if (thread.bufs[i]->n_tuples > 0) {
+					dberr_t	err = write(thread, i);
+
+					if (err != DB_SUCCESS) {
+						m_error_index = i;
+						return(err);
+					}
+				}
+
+				m_files[i].n_rec += thread.n_rec[i];
+			}
+		}
+
+		return(DB_SUCCESS);
+	}
+
+	/** @return position in indexes[] of the index whose entry
+	could not be written, or 0 */
+	ulint error_index() const
+	{
+		return(m_error_index == ULINT_UNDEFINED ? 0 : m_error_index);
+	}
+
+private:
+	/** State of a thread */
+	struct thread_t {
+		/** sort buffer of each index */
+		row_merge_buf_t**	bufs;
+		/** number of entries of each index */
+		ulint*			n_rec;
+		/** buffer of srv_sort_buf_size bytes for writing */
+		row_merge_block_t*	block;
+		/** allocation of block */
+		ut_new_pfx_t		block_pfx;
+		/** memory heap for the row of the record */
+		mem_heap_t*		row_heap;
+		/** memory heap for virtual columns, not used */
+		mem_heap_t*		v_heap;
+		/** page number of the last record read */
+		ulint			page_no;
+		/** number of records read from that page */
+		ulint			n_pk_recs;
+		/** keeps the states of the threads in separate cache
+		lines */
+		byte			pad[CACHE_LINE_SIZE];
+	};
+
+	/** Add the entry of a row to the sort buffer of an index, after
+	writing the buffer if it is full.
+	@param[in,out]	thread	state of this thread
+	@param[in]	i	position of the index in m_indexes[]
+	@param[in]	row	row of the record
+	@param[in]	ext	cache of externally stored column prefixes,
+	or NULL
+	@return DB_SUCCESS or error code */
+	dberr_t add(
+		thread_t&		thread,
+		ulint			i,
+		const dtuple_t*		row,
+		const row_ext_t*	ext)
+	{
+		dberr_t		err = DB_SUCCESS;
+		doc_id_t	doc_id = 0;
+		ulint		n_added = row_merge_buf_add(
+			thread.bufs[i], NULL, m_table, m_table, NULL, row, ext,
+			&doc_id, NULL, &err, &thread.v_heap, NULL, m_trx);
+
+		if (n_added == 0) {
+			err = write(thread, i);
+
+			if (err != DB_SUCCESS) {
+				return(err);
+			}
+
+			n_added = row_merge_buf_add(
+				thread.bufs[i], NULL, m_table, m_table, NULL,
+				row, ext, &doc_id, NULL, &err, &thread.v_heap,
+				NULL, m_trx);
+
+			/* An empty buffer should have enough room for at
+			least one record. */
+			ut_a(n_added > 0);
+		}
+
+		thread.n_rec[i] += n_added;
+
+		return(err);
+	}
+
+	/** Sort the buffer of an index, write it at the end of the merge
+	file of the index, and empty it.
+	@param[in,out]	thread	state of this thread
+	@param[in]	i	position of the index in m_indexes[]
+	@return DB_SUCCESS or DB_TEMP_FILE_WRITE_FAIL */
+	dberr_t write(
+		thread_t&	thread,
+		ulint		i)
+	{
+		row_merge_buf_t*	buf = thread.bufs[i];
+		merge_file_t*		file = &m_files[i];
+
+		row_merge_buf_sort(buf, NULL);
+		row_merge_buf_write(buf, file, thread.block);
+
+		const ulint	offset = os_atomic_increment_ulint(
+			&file->offset, 1) - 1;
+		const bool	success = row_merge_write(
+			file->fd, offset, thread.block);
+
+		UNIV_MEM_INVALID(thread.block, srv_sort_buf_size);
+
+		thread.bufs[i] = row_merge_buf_empty(buf);
+
+		return(success ? DB_SUCCESS : DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	/** Transaction */
+	trx_t*			m_trx;
+
+	/** Table where the indexes are created */
+	const dict_table_t*	m_table;
+
+	/** Indexes to be created */
+	dict_index_t**		m_indexes;
+
+	/** Size of m_indexes[] */
+	const ulint		m_n_indexes;
+
+	/** Merge files of the indexes */
+	merge_file_t*		m_files;
+
+	/** Size of m_threads */
+	const ulint		m_n_threads;
+
+	/** Performance schema accounting object */
+	ut_stage_alter_t*	m_stage;
+
+	/** Position in m_indexes[] of the index whose entry could not
+	be written first, updated atomically */
+	ulint			m_error_index;
+
+	/** Allocator of the write buffers */
+	ut_allocator<row_merge_block_t>	m_alloc;
+
+	/** State of each thread */
+	thread_t*		m_threads;
+};
+
+/** Read the clustered index with several threads, and write the entries
+of the indexes that are being created to merge files, like
+row_merge_read_clustered_index() does when the table is not rebuilt.
+Each block of a merge file is a sorted run, but the order of the blocks
+depends on the threads. See row_merge_scan_parallel_possible() for the
+indexes that can be created this way.
+@param[in]	trx		transaction
+@param[in]	table		table where the indexes are created
+@param[in]	online		true if creating indexes online
+@param[in]	indexes		indexes to be created
+@param[in]	n_indexes	size of indexes[]
+@param[out]	files		merge files of the indexes; the file of an
+index that has no entries is not created
+@param[in,out]	tmpfd		temporary file handle
+@param[in]	n_threads	maximum number of threads
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. stage->n_pk_recs_inc() will be called for the records read and
+stage->inc() will be called for each page read.
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+	trx_t*			trx,
+	const dict_table_t*	table,
+	bool			online,
+	dict_index_t**		indexes,
+	ulint			n_indexes,
+	merge_file_t*		files,
+	int*			tmpfd,
+	ulint			n_threads,
+	ut_stage_alter_t*	stage)
+{
+	const char*	path = thd_innodb_tmpdir(trx->mysql_thd);
+	dberr_t		err = DB_SUCCESS;
+	DBUG_ENTER("row_merge_read_clustered_index_parallel");
+
+	ut_ad(!online || MVCC::is_view_active(trx->read_view));
+
+	trx->op_info = "reading clustered index";
+	trx->error_key_num = 0;
+
+	/* The threads append blocks to the same files. */
+	for (ulint i = 0; i < n_indexes; i++) {
+		if (row_merge_file_create(&files[i], path) < 0) {
+			err = DB_OUT_OF_MEMORY;
+			trx->error_key_num = i;
+			goto func_exit;
+		}
+
+		MONITOR_ATOMIC_INC(MONITOR_ALTER_TABLE_SORT_FILES);
+	}
+
+	if (row_merge_tmpfile_if_needed(tmpfd, path) < 0) {
+		err = DB_OUT_OF_MEMORY;
+		goto func_exit;
+	}
+
+	{
+		ParallelReader		reader(
+			trx, dict_table_get_first_index(table), n_threads);
+		MergeScanCallback	callback(
+			trx, table, indexes, n_indexes, files,
+			reader.n_threads(), stage);
+
+		err = callback.init();
+
+		if (err == DB_SUCCESS) {
+			err = reader.run(callback);
+		}
+
+		if (err == DB_SUCCESS) {
+			err = callback.finish();
+		}
+
+		if (err != DB_SUCCESS && err != DB_INTERRUPTED) {
+			trx->error_key_num = callback.error_index();
+		}
+	}
+
+	if (err != DB_SUCCESS) {
+		goto func_exit;
+	}
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		if (files[i].offset == 0) {
+			/* The index stays empty. */
+			row_merge_file_destroy(&files[i]);
+		}
+
+		if (online) {
+			/* Note the newest transaction that modified this
+			index when the scan was completed. We prevent
+			older readers from accessing this index, to ensure
+			read consistency. */
+			dict_index_t*	index = indexes[i];
+			trx_id_t	max_trx_id;
+
+			rw_lock_x_lock(dict_index_get_lock(index));
+			ut_a(dict_index_get_online_status(index)
+			     == ONLINE_INDEX_CREATION);
+
+			max_trx_id = row_log_get_max_trx(index);
+
+			if (max_trx_id > index->trx_id) {
+				index->trx_id = max_trx_id;
+			}
+
+			rw_lock_x_unlock(dict_index_get_lock(index));
+		}
+	}
+
+func_exit:
+	trx->op_info = "";
+
+	DBUG_RETURN(err);
+}
+
 /** Write a record via buffer 2 and read the next record to buffer N.
 @param N number of the buffer (0 or 1)
 @param INDEX record descriptor
@@ -3014,6 +3483,240 @@ row_merge(
 	return(DB_SUCCESS);
 }
 
+/** Shared state of the threads that merge the runs of a merge file in
+one pass of row_merge_sort() */
+struct row_merge_pass_ctx_t {
+	trx_t*			trx;		/*!< transaction */
+	const row_merge_dup_t*	dup;		/*!< descriptor of index being
+						created */
+	const merge_file_t*	file;		/*!< input file */
+	int			out_fd;		/*!< output file handle */
+	const ulint*		run_offset;	/*!< first offset number of
+						each input run */
+	ulint			num_run;	/*!< number of input runs */
+	const ulint*		out_offset;	/*!< first offset number of
+						each output run */
+	ulint			n_out;		/*!< number of output runs */
+	ulint			next;		/*!< next output run to write,
+						updated atomically */
+	ulint			n_rec;		/*!< number of records
+						written, updated atomically */
+	volatile ulint		error;		/*!< first error as a
+						dberr_t, updated atomically */
+	ut_stage_alter_t*	stage;		/*!< performance schema
+						accounting object, or NULL */
+	ulint			n_running;	/*!< number of running threads,
+						updated atomically */
+	os_event_t		done_event;	/*!< set when the last thread
+						has finished */
+};
+
+/** Buffers of a thread that merges runs for row_merge_sort() */
+struct row_merge_pass_arg_t {
+	row_merge_pass_ctx_t*	ctx;		/*!< shared state of the
+						current pass */
+	row_merge_block_t*	block;		/*!< 3 buffers of
+						srv_sort_buf_size bytes */
+	ut_new_pfx_t		block_pfx;	/*!< allocation of block */
+};
+
+/** Write the output runs of a merge pass until none is left. Output run
+j merges the input runs j and j + num_run / 2, or copies the last input
+run if num_run is odd, like row_merge() does.
+@param[in,out]	ctx	shared state of the merging threads
+@param[in,out]	block	3 buffers of this thread */
+static
+void
+row_merge_pass_runs(
+	row_merge_pass_ctx_t*	ctx,
+	row_merge_block_t*	block)
+{
+	const ulint	half = ctx->num_run / 2;
+
+	while (ctx->error == DB_SUCCESS) {
+		ulint	j = os_atomic_increment_ulint(&ctx->next, 1) - 1;
+
+		if (j >= ctx->n_out) {
+			break;
+		}
+
+		merge_file_t	of;
+		ulint		foffs0 = ctx->run_offset[j];
+		ulint		foffs1 = ctx->run_offset[j + half];
+		dberr_t		error = DB_SUCCESS;
+
+		of.fd = ctx->out_fd;
+		of.offset = ctx->out_offset[j];
+		of.n_rec = 0;
+
+		if (trx_is_interrupted(ctx->trx)) {
+			error = DB_INTERRUPTED;
+		} else if (j < half) {
+			error = row_merge_blocks(ctx->dup, ctx->file, block,
+						 &foffs0, &foffs1, &of,
+						 ctx->stage);
+		} else if (!row_merge_blocks_copy(ctx->dup->index, ctx->file,
+						  block, &foffs1, &of,
+						  ctx->stage)) {
+			error = DB_CORRUPTION;
+		}
+
+		if (error != DB_SUCCESS) {
+			/* Keep the first error. */
+			os_compare_and_swap_ulint(
+				&ctx->error, static_cast<ulint>(DB_SUCCESS),
+				static_cast<ulint>(error));
+			break;
+		}
+
+		/* A merged run never takes more blocks than its input
+		runs. */
+		ut_ad(of.offset <= (j + 1 < ctx->n_out
+				    ? ctx->out_offset[j + 1]
+				    : ctx->file->offset));
+
+		os_atomic_increment_ulint(&ctx->n_rec, of.n_rec);
+	}
+}
+
+/*********************************************************************//**
+Thread that merges runs for row_merge_parallel().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_merge_pass_thread)(
+/*==================================*/
+	void*	arg)	/*!< in: row_merge_pass_arg_t */
+{
+	row_merge_pass_arg_t*	pass_arg
+		= static_cast<row_merge_pass_arg_t*>(arg);
+	row_merge_pass_ctx_t*	ctx = pass_arg->ctx;
+
+	row_merge_pass_runs(ctx, pass_arg->block);
+
+	if (os_atomic_decrement_ulint(&ctx->n_running, 1) == 0) {
+		os_event_set(ctx->done_event);
+	}
+
+	os_thread_exit(false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Merge disk files with several threads. This does one pass of
+row_merge(), but each output run is written at a known offset: where its
+input runs would be if the first half of the runs were interleaved with the
+second half. A merged run never takes more blocks than its input runs, and
+the remaining blocks are not read. Thus the output file is as long as the
+input file, and every run is delimited by run_offset[] only.
+@param[in]	trx		transaction
+@param[in]	dup		descriptor of index being created
+@param[in,out]	file		file containing index entries
+@param[in,out]	block		3 buffers of the calling thread
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	num_run		number of runs that remain to be merged
+@param[in,out]	run_offset	array that contains the first offset
+number of each run
+@param[in,out]	args		buffers of the other threads
+@param[in]	n_args		size of args[]
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. If not NULL stage->inc() will be called for each record
+processed.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_parallel(
+	trx_t*			trx,
+	const row_merge_dup_t*	dup,
+	merge_file_t*		file,
+	row_merge_block_t*	block,
+	int*			tmpfd,
+	ulint*			num_run,
+	ulint*			run_offset,
+	row_merge_pass_arg_t*	args,
+	ulint			n_args,
+	ut_stage_alter_t*	stage)
+{
+	const ulint		half = *num_run / 2;
+	row_merge_pass_ctx_t	ctx;
+
+	ut_ad(half > 0);
+
+	ctx.n_out = *num_run - half;
+
+	ulint*	out_offset = static_cast<ulint*>(
+		ut_malloc_nokey(ctx.n_out * sizeof *out_offset));
+
+	for (ulint j = 0; j < ctx.n_out; j++) {
+		out_offset[j] = run_offset[j] + run_offset[j + half]
+			- run_offset[half];
+	}
+
+	ctx.trx = trx;
+	ctx.dup = dup;
+	ctx.file = file;
+	ctx.out_fd = *tmpfd;
+	ctx.run_offset = run_offset;
+	ctx.num_run = *num_run;
+	ctx.out_offset = out_offset;
+	ctx.next = 0;
+	ctx.n_rec = 0;
+	ctx.error = DB_SUCCESS;
+	ctx.stage = stage;
+
+	/* The calling thread merges runs as well. */
+	const ulint	n_started = ut_min(n_args, ctx.n_out - 1);
+
+	ctx.n_running = n_started;
+	ctx.done_event = os_event_create(0);
+
+	os_thread_id_t*	thread_ids = static_cast<os_thread_id_t*>(
+		ut_malloc_nokey((n_started + 1) * sizeof *thread_ids));
+
+	for (ulint i = 0; i < n_started; i++) {
+		args[i].ctx = &ctx;
+		os_thread_create(row_merge_pass_thread, &args[i],
+				 &thread_ids[i]);
+	}
+
+	row_merge_pass_runs(&ctx, block);
+
+	if (n_started > 0) {
+		os_event_wait(ctx.done_event);
+
+		for (ulint i = 0; i < n_started; i++) {
+			os_thread_join(thread_ids[i]);
+		}
+	}
+
+	os_event_destroy(ctx.done_event);
+	ut_free(thread_ids);
+
+	dberr_t	error = static_cast<dberr_t>(ctx.error);
+
+	if (error == DB_SUCCESS && ctx.n_rec != file->n_rec) {
+		error = DB_CORRUPTION;
+	}
+
+	if (error == DB_SUCCESS) {
+		memcpy(run_offset, out_offset, ctx.n_out * sizeof *run_offset);
+		*num_run = ctx.n_out;
+
+		/* Swap file descriptors for the next pass. The output
+		file keeps the offset of the input file. */
+		const int	fd = file->fd;
+
+		file->fd = *tmpfd;
+		*tmpfd = fd;
+	}
+
+	ut_free(out_offset);
+
+	UNIV_MEM_INVALID(&block[0], 3 * srv_sort_buf_size);
+
+	return(error);
+}
+
 /** Merge disk files.
 @param[in]	trx	transaction
 @param[in]	dup	descriptor of index being created
@@ -3023,6 +3726,9 @@ row_merge(
 @param[in,out]	stage	performance schema accounting object, used by
 ALTER TABLE. If not NULL, stage->begin_phase_sort() will be called initially
 and then stage->inc() will be called for each record processed.
+@param[in]	n_threads	maximum number of threads that merge the runs
+of a pass; 1 for a unique index, whose duplicates are reported in
+dup->table
 @return DB_SUCCESS or error code */
 dberr_t
 row_merge_sort(
@@ -3031,14 +3737,20 @@ row_merge_sort(
 	merge_file_t*		file,
 	row_merge_block_t*	block,
 	int*			tmpfd,
-	ut_stage_alter_t*	stage /* = NULL */)
+	ut_stage_alter_t*	stage /* = NULL */,
+	ulint			n_threads /* = 1 */)
 {
 	const ulint	half	= file->offset / 2;
 	ulint		num_runs;
 	ulint*		run_offset;
 	dberr_t		error	= DB_SUCCESS;
+	row_merge_pass_arg_t*	args	= NULL;
+	ulint		n_args	= 0;
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
 	DBUG_ENTER("row_merge_sort");
 
+	ut_ad(n_threads == 1 || !dict_index_is_unique(dup->index));
+
 	/* Record the number of merge runs we need to perform */
 	num_runs = file->offset;
 
@@ -3062,10 +3774,41 @@ row_merge_sort(
 	of file marker).  Thus, it must be at least one block. */
 	ut_ad(file->offset > 0);
 
+	if (n_threads > 1) {
+		/* The first pass writes the most runs, num_runs - half.
+		The calling thread merges runs as well. Without
+		buffers, leave the work to the other threads. */
+		n_args = ut_min(n_threads, num_runs - half) - 1;
+
+		args = static_cast<row_merge_pass_arg_t*>(
+			ut_malloc_nokey(n_args * sizeof *args));
+
+		for (ulint i = 0; i < n_args; i++) {
+			args[i].block = alloc.allocate_large(
+				3 * srv_sort_buf_size, &args[i].block_pfx);
+
+			if (args[i].block == NULL) {
+				n_args = i;
+				break;
+			}
+		}
+
+		/* Initially, each block is a run. */
+		for (ulint i = 0; i < num_runs; i++) {
+			run_offset[i] = i;
+		}
+	}
+
 	/* Merge the runs until we have one big run */
 	do {
-		error = row_merge(trx, dup, file, block, tmpfd,
-				  &num_runs, run_offset, stage);
+		if (n_args > 0) {
+			error = row_merge_parallel(
+				trx, dup, file, block, tmpfd, &num_runs,
+				run_offset, args, n_args, stage);
+		} else {
+			error = row_merge(trx, dup, file, block, tmpfd,
+					  &num_runs, run_offset, stage);
+		}
 
 		if (error != DB_SUCCESS) {
 			break;
@@ -3074,6 +3817,11 @@ row_merge_sort(
 		UNIV_MEM_ASSERT_RW(run_offset, num_runs * sizeof *run_offset);
 	} while (num_runs > 1);
 
+	for (ulint i = 0; i < n_args; i++) {
+		alloc.deallocate_large(args[i].block, &args[i].block_pfx);
+	}
+
+	ut_free(args);
 	ut_free(run_offset);
 
 	DBUG_RETURN(error);
@@ -4282,6 +5030,273 @@ row_merge_write_redo(
 	mtr.commit();
 }
 
+/** Sort the index entries in a merge file and load them into an index.
+@param[in]	trx		transaction
+@param[in,out]	index		index to be loaded
+@param[in]	old_table	table where rows are read from
+@param[in,out]	table		MySQL table, for reporting erroneous key value
+if applicable
+@param[in]	col_map		mapping of old column numbers to new ones, or
+NULL if not rebuilding the table
+@param[in,out]	file		file containing the index entries
+@param[in,out]	block		3 buffers of srv_sort_buf_size bytes
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	flush_observer	flush observer of the bulk load, or NULL
+@param[in,out]	stage		performance schema accounting object, or NULL
+@param[in]	n_threads	maximum number of threads for the merge sort
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_sort_and_load(
+	trx_t*			trx,
+	dict_index_t*		index,
+	const dict_table_t*	old_table,
+	struct TABLE*		table,
+	const ulint*		col_map,
+	merge_file_t*		file,
+	row_merge_block_t*	block,
+	int*			tmpfd,
+	FlushObserver*		flush_observer,
+	ut_stage_alter_t*	stage,
+	ulint			n_threads)
+{
+	row_merge_dup_t	dup = {index, table, col_map, 0};
+
+	dberr_t	error = row_merge_sort(
+		trx, &dup, file, block, tmpfd, stage, n_threads);
+
+	if (error == DB_SUCCESS) {
+		BtrBulk	btr_bulk(index, trx->id, flush_observer);
+		btr_bulk.init();
+
+		error = row_merge_insert_index_tuples(
+			trx->id, index, old_table, file->fd, block, NULL,
+			&btr_bulk, stage);
+
+		error = btr_bulk.finish(error);
+	}
+
+	return(error);
+}
+
+/** Shared state of the threads that sort and load the secondary indexes
+in parallel in row_merge_build_indexes() */
+struct row_merge_load_ctx_t {
+	trx_t*			trx;		/*!< transaction */
+	const dict_table_t*	old_table;	/*!< table where rows are
+						read from */
+	dict_index_t**		indexes;	/*!< indexes to be created */
+	merge_file_t*		merge_files;	/*!< files containing the
+						index entries */
+	struct TABLE*		table;		/*!< MySQL table */
+	const ulint*		col_map;	/*!< mapping of old column
+						numbers to new ones, or NULL */
+	FlushObserver*		flush_observer;	/*!< flush observer of the
+						bulk load */
+	ut_stage_alter_t*	stage;		/*!< performance schema
+						accounting object */
+	ulint			n_sort_threads;	/*!< maximum number of threads
+						for the merge sort of an
+						index */
+	const char*		path;		/*!< location for creating
+						temporary files */
+	const ulint*		todo;		/*!< positions in indexes[] of
+						the indexes to be loaded */
+	ulint			n_todo;		/*!< size of todo[] */
+	ulint			next;		/*!< next position in todo[],
+						updated atomically */
+	dberr_t*		errors;		/*!< error codes of the loaded
+						indexes */
+	ulint			n_running;	/*!< number of running threads,
+						updated atomically */
+	os_event_t		done_event;	/*!< set when the last thread
+						has finished */
+};
+
+/** Sort and load the indexes of row_merge_load_ctx_t::todo[] until none
+is left.
+@param[in,out]	ctx	shared state of the loading threads
+@param[in,out]	block	3 buffers of srv_sort_buf_size bytes
+@param[in,out]	tmpfd	temporary file handle of this thread */
+static
+void
+row_merge_load_indexes(
+	row_merge_load_ctx_t*	ctx,
+	row_merge_block_t*	block,
+	int*			tmpfd)
+{
+	for (;;) {
+		ulint	n = os_atomic_increment_ulint(&ctx->next, 1) - 1;
+
+		if (n >= ctx->n_todo) {
+			break;
+		}
+
+		ulint		i = ctx->todo[n];
+		merge_file_t*	file = &ctx->merge_files[i];
+		dberr_t		error;
+
+		if (row_merge_tmpfile_if_needed(tmpfd, ctx->path) < 0) {
+			error = DB_OUT_OF_MEMORY;
+		} else {
+			error = row_merge_sort_and_load(
+				ctx->trx, ctx->indexes[i], ctx->old_table,
+				ctx->table, ctx->col_map, file, block, tmpfd,
+				ctx->flush_observer, ctx->stage,
+				ctx->n_sort_threads);
+		}
+
+		ctx->errors[i] = error;
+
+		/* Close the temporary file to free up space. */
+		row_merge_file_destroy(file);
+	}
+}
+
+/*********************************************************************//**
+Thread that sorts and loads secondary indexes for row_merge_build_indexes().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_merge_load_thread)(
+/*==================================*/
+	void*	arg)	/*!< in: row_merge_load_ctx_t */
+{
+	row_merge_load_ctx_t*		ctx
+		= static_cast<row_merge_load_ctx_t*>(arg);
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	ut_new_pfx_t			block_pfx;
+	row_merge_block_t*		block;
+
+	block = alloc.allocate_large(3 * srv_sort_buf_size, &block_pfx);
+
+	/* Without a buffer, leave the work to the other threads. */
+	if (block != NULL) {
+		int	tmpfd = -1;
+
+		row_merge_load_indexes(ctx, block, &tmpfd);
+
+		row_merge_file_destroy_low(tmpfd);
+
+		alloc.deallocate_large(block, &block_pfx);
+	}
+
+	if (os_atomic_decrement_ulint(&ctx->n_running, 1) == 0) {
+		os_event_set(ctx->done_event);
+	}
+
+	os_thread_exit(false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Sort the index entries and load them into the non-unique secondary
+indexes using several threads. Each thread loads whole indexes with its
+own buffers and temporary file, and merges the runs of an index with more
+threads if there are fewer indexes than threads. Unique indexes are left to
+the caller, because a duplicate key is reported in the MySQL row buffer of
+the table, which must not be written by two threads at the same time.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	indexes		indexes to be created
+@param[in]	n_indexes	size of indexes[]
+@param[in,out]	table		MySQL table
+@param[in]	col_map		mapping of old column numbers to new ones, or
+NULL if not rebuilding the table
+@param[in,out]	merge_files	files containing the index entries; the files
+of the loaded indexes are destroyed
+@param[in,out]	block		3 buffers of srv_sort_buf_size bytes, for use
+by the calling thread
+@param[in,out]	tmpfd		temporary file handle of the calling thread
+@param[in,out]	flush_observer	flush observer of the bulk load
+@param[in,out]	stage		performance schema accounting object
+@param[in]	n_threads	maximum number of threads, including the
+calling thread
+@param[out]	errors		error codes of the loaded indexes, DB_SUCCESS
+for the others */
+static
+void
+row_merge_load_indexes_parallel(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	dict_index_t**		indexes,
+	ulint			n_indexes,
+	struct TABLE*		table,
+	const ulint*		col_map,
+	merge_file_t*		merge_files,
+	row_merge_block_t*	block,
+	int*			tmpfd,
+	FlushObserver*		flush_observer,
+	ut_stage_alter_t*	stage,
+	ulint			n_threads,
+	dberr_t*		errors)
+{
+	ulint*			todo = static_cast<ulint*>(
+		ut_malloc_nokey(n_indexes * sizeof *todo));
+	row_merge_load_ctx_t	ctx;
+
+	ctx.n_todo = 0;
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		errors[i] = DB_SUCCESS;
+
+		if (merge_files[i].fd >= 0
+		    && !dict_index_is_unique(indexes[i])
+		    && !dict_index_is_spatial(indexes[i])
+		    && !(indexes[i]->type & DICT_FTS)) {
+
+			todo[ctx.n_todo++] = i;
+		}
+	}
+
+	/* The calling thread loads indexes as well. */
+	ulint	n_started = ut_min(n_threads, ctx.n_todo);
+
+	if (n_started < 2) {
+		ut_free(todo);
+		return;
+	}
+
+	ctx.n_sort_threads = n_threads / n_started;
+
+	n_started--;
+
+	ctx.trx = trx;
+	ctx.old_table = old_table;
+	ctx.indexes = indexes;
+	ctx.merge_files = merge_files;
+	ctx.table = table;
+	ctx.col_map = col_map;
+	ctx.flush_observer = flush_observer;
+	ctx.stage = stage;
+	ctx.path = thd_innodb_tmpdir(trx->mysql_thd);
+	ctx.todo = todo;
+	ctx.next = 0;
+	ctx.errors = errors;
+	ctx.n_running = n_started;
+	ctx.done_event = os_event_create(0);
+
+	os_thread_id_t*	thread_ids = static_cast<os_thread_id_t*>(
+		ut_malloc_nokey(n_started * sizeof *thread_ids));
+
+	for (ulint i = 0; i < n_started; i++) {
+		os_thread_create(row_merge_load_thread, &ctx, &thread_ids[i]);
+	}
+
+	row_merge_load_indexes(&ctx, block, tmpfd);
+
+	os_event_wait(ctx.done_event);
+
+	for (ulint i = 0; i < n_started; i++) {
+		os_thread_join(thread_ids[i]);
+	}
+
+	os_event_destroy(ctx.done_event);
+
+	ut_free(thread_ids);
+	ut_free(todo);
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4341,6 +5356,8 @@ row_merge_build_indexes(
 	fts_psort_t*		merge_info = NULL;
 	int64_t			sig_count = 0;
 	bool			fts_psort_initiated = false;
+	dberr_t*		load_errors = NULL;
+	const ulint		n_threads = thd_ddl_threads(trx->mysql_thd);
 	DBUG_ENTER("row_merge_build_indexes");
 
 	ut_ad(!srv_read_only_mode);
@@ -4438,11 +5455,21 @@ row_merge_build_indexes(
 
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
-	error = row_merge_read_clustered_index(
-		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, add_cols, add_v, col_map, add_autoinc,
-		sequence, block, skip_pk_sort, &tmpfd, stage, eval_table);
+	if (n_threads > 1
+	    && row_merge_scan_parallel_possible(
+		    trx, old_table, new_table, online, indexes, n_indexes,
+		    add_v)) {
+		error = row_merge_read_clustered_index_parallel(
+			trx, new_table, online, indexes, n_indexes,
+			merge_files, &tmpfd, n_threads, stage);
+	} else {
+		error = row_merge_read_clustered_index(
+			trx, table, old_table, new_table, online, indexes,
+			fts_sort_idx, psort_info, merge_files, key_numbers,
+			n_indexes, add_cols, add_v, col_map, add_autoinc,
+			sequence, block, skip_pk_sort, &tmpfd, stage,
+			eval_table);
+	}
 
 	stage->end_phase_read_pk();
 
@@ -4456,6 +5483,16 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	if (n_threads > 1) {
+		load_errors = static_cast<dberr_t*>(
+			ut_malloc_nokey(n_indexes * sizeof *load_errors));
+
+		row_merge_load_indexes_parallel(
+			trx, old_table, indexes, n_indexes, table, col_map,
+			merge_files, block, &tmpfd, flush_observer, stage,
+			n_threads, load_errors);
+	}
+
 	for (i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -4536,25 +5573,15 @@ wait_again:
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
 		} else if (merge_files[i].fd >= 0) {
-			row_merge_dup_t	dup = {
-				sort_idx, table, col_map, 0};
-
-			error = row_merge_sort(
-				trx, &dup, &merge_files[i],
-				block, &tmpfd, stage);
-
-			if (error == DB_SUCCESS) {
-				BtrBulk	btr_bulk(sort_idx, trx->id,
-						 flush_observer);
-				btr_bulk.init();
-
-				error = row_merge_insert_index_tuples(
-					trx->id, sort_idx, old_table,
-					merge_files[i].fd, block, NULL,
-					&btr_bulk, stage);
-
-				error = btr_bulk.finish(error);
-			}
+			error = row_merge_sort_and_load(
+				trx, sort_idx, old_table, table, col_map,
+				&merge_files[i], block, &tmpfd,
+				flush_observer, stage,
+				dict_index_is_unique(sort_idx)
+				? 1 : n_threads);
+		} else if (load_errors != NULL) {
+			/* Loaded by row_merge_load_indexes_parallel() */
+			error = load_errors[i];
 		}
 
 		/* Close the temporary file to free up space. */
@@ -4615,6 +5642,10 @@ func_exit:
 
 	ut_free(merge_files);
 
+	if (load_errors != NULL) {
+		ut_free(load_errors);
+	}
+
 	alloc.deallocate_large(block, &block_pfx);
 
 	DICT_TF2_FLAG_UNSET(new_table, DICT_TF2_FTS_ADD_DOC_ID);
@@ -69,6 +69,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "row0import.h"
 #include "row0ins.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "row0row.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -5893,13 +5894,9 @@ row_scan_index_for_mysql(
 	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
 						in MySQL handle */
 	const dict_index_t*	index,		/*!< in: index */
-#ifdef WL6742
-	/* Removing WL6742 as part of Bug 23046302 */
-
 	bool			check_keys,	/*!< in: true=check for mis-
 						ordered or duplicate records,
 						false=count the rows only */
-#endif
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 {
@@ -5982,12 +5979,9 @@ func_exit:
 
 	*n_rows = *n_rows + 1;
 
-#ifdef WL6742
-	/*Removing WL6742 as part of Bug 23046302 */
 	if (!check_keys) {
 		goto next_rec;
 	}
-#endif
 	/* else this code is doing handler::check() for CHECK TABLE */
 
 	/* row_search... returns the index record in buf, record origin offset
@@ -6068,16 +6062,343 @@ not_ok:
 			mem_heap_free(tmp_heap);
 		}
 	}
-#ifdef WL6742
-/* Removed WL6742 as part of Bug 23046302 */
 next_rec:
-#endif
 	ret = row_search_for_mysql(
 		buf, PAGE_CUR_G, prebuilt, 0, ROW_SEL_NEXT);
 
 	goto loop;
 }
 
+/** Counts and optionally checks the records of a clustered index for
+row_scan_clust_index_parallel(). Each thread has its own counter and
+previous entry, so that the threads do not need to synchronize. For CHECK
+TABLE, each thread also keeps the first and the last record of the ranges
+that it reads, so that the records at the range boundaries can be compared
+after ParallelReader::run(). */
+class ScanIndexCallback : public ParallelReader::Callback {
+public:
+	/** Constructor
+	@param[in]	index		clustered index
+	@param[in]	n_threads	maximum number of threads
+	@param[in]	check_keys	true=check for misordered or
+	duplicate records */
+	ScanIndexCallback(
+		const dict_index_t*	index,
+		ulint			n_threads,
+		bool			check_keys)
+		:
+		m_index(index),
+		m_check_keys(check_keys),
+		m_n_threads(n_threads),
+		m_err(DB_SUCCESS)
+	{
+		m_threads = static_cast<thread_t*>(
+			ut_zalloc_nokey(n_threads * sizeof *m_threads));
+
+		for (ulint i = 0; i < n_threads; i++) {
+			m_threads[i].heap = mem_heap_create(100);
+			m_threads[i].bounds_heap = mem_heap_create(100);
+		}
+	}
+
+	~ScanIndexCallback()
+	{
+		for (ulint i = 0; i < m_n_threads; i++) {
+			mem_heap_free(m_threads[i].heap);
+			mem_heap_free(m_threads[i].bounds_heap);
+		}
+
+		ut_free(m_threads);
+	}
+
+	/** Count a record, and compare it to the previous record of the
+	same range for CHECK TABLE.
+	@param[in]	ctx	the record and where it was read
+	@return DB_SUCCESS */
+	dberr_t operator()(const ParallelReader::Ctx& ctx)
+	{
+		thread_t&	thread = m_threads[ctx.m_thread_id];
+
+		thread.n_rows++;
+
+		if (!m_check_keys) {
+			return(DB_SUCCESS);
+		}
+
+		if (ctx.m_first) {
+			/* The ranges are read in any order; the records at
+			the boundaries are compared by check_ranges(). */
+			end_range(thread);
+			begin_range(thread, ctx);
+			thread.prev_entry = NULL;
+		}
+
+		if (thread.prev_entry != NULL) {
+			check(thread.prev_entry, ctx.m_rec, ctx.m_offsets);
+		}
+
+		ulint	n_ext;
+
+		mem_heap_empty(thread.heap);
+
+		thread.prev_entry = row_rec_to_index_entry(
+			ctx.m_rec, m_index, ctx.m_offsets, &n_ext,
+			thread.heap);
+
+		return(DB_SUCCESS);
+	}
+
+	/** Check that the last record of each range is smaller than the
+	first record of the next range that has records, like the records
+	within a range. This must be called after ParallelReader::run(). */
+	void check_ranges()
+	{
+		typedef std::vector<const bound_t*, ut_allocator<const bound_t*> >
+			bounds_t;
+
+		bounds_t	bounds;
+
+		for (ulint i = 0; i < m_n_threads; i++) {
+			end_range(m_threads[i]);
+
+			for (const bound_t* bound = m_threads[i].bounds;
+			     bound != NULL;
+			     bound = bound->prev) {
+
+				bounds.push_back(bound);
+			}
+		}
+
+		std::sort(bounds.begin(), bounds.end(), bound_less);
+
+		for (ulint i = 1; i < bounds.size(); i++) {
+			check(bounds[i - 1]->last_entry,
+			      bounds[i]->first_rec, bounds[i]->first_offsets);
+		}
+	}
+
+	/** @return number of records counted by all the threads */
+	ulint n_rows() const
+	{
+		ulint	n_rows = 0;
+
+		for (ulint i = 0; i < m_n_threads; i++) {
+			n_rows += m_threads[i].n_rows;
+		}
+
+		return(n_rows);
+	}
+
+	/** @return DB_INDEX_CORRUPT or DB_DUPLICATE_KEY if such a record
+	was found, else DB_SUCCESS */
+	dberr_t error() const
+	{
+		return(static_cast<dberr_t>(m_err));
+	}
+
+private:
+	/** The first and the last record of a range */
+	struct bound_t {
+		/** position of the range */
+		ulint		range_id;
+		/** copy of the first record of the range */
+		const rec_t*	first_rec;
+		/** rec_get_offsets(first_rec, m_index) */
+		const ulint*	first_offsets;
+		/** the last record of the range, or NULL while the
+		range is being read */
+		const dtuple_t*	last_entry;
+		/** the range that the thread read before, or NULL */
+		const bound_t*	prev;
+	};
+
+	/** Order the ranges by their position in the index.
+	@param[in]	a	a range
+	@param[in]	b	another range
+	@return whether a precedes b */
+	static bool bound_less(const bound_t* a, const bound_t* b)
+	{
+		return(a->range_id < b->range_id);
+	}
+
+	/** State of a thread */
+	struct thread_t {
+		/** number of records counted */
+		ulint		n_rows;
+		/** the previous record of the range, or NULL */
+		dtuple_t*	prev_entry;
+		/** memory heap for prev_entry */
+		mem_heap_t*	heap;
+		/** the range being read, linked to the ranges that were
+		read before by the thread, or NULL */
+		bound_t*	bounds;
+		/** memory heap for bounds */
+		mem_heap_t*	bounds_heap;
+		/** keeps the counters of the threads in separate cache
+		lines */
+		byte		pad[CACHE_LINE_SIZE];
+	};
+
+	/** Note the first record of a range.
+	@param[in,out]	thread	state of the thread that reads the range
+	@param[in]	ctx	the first record of the range */
+	void begin_range(
+		thread_t&			thread,
+		const ParallelReader::Ctx&	ctx)
+	{
+		bound_t*	bound = static_cast<bound_t*>(
+			mem_heap_alloc(thread.bounds_heap, sizeof *bound));
+		byte*		buf = static_cast<byte*>(
+			mem_heap_alloc(thread.bounds_heap,
+				       rec_offs_size(ctx.m_offsets)));
+		ulint*		offsets = static_cast<ulint*>(
+			mem_heap_dup(thread.bounds_heap, ctx.m_offsets,
+				     rec_offs_get_n_alloc(ctx.m_offsets)
+				     * sizeof *ctx.m_offsets));
+
+		bound->range_id = ctx.m_range_id;
+		bound->first_rec = rec_copy(buf, ctx.m_rec, offsets);
+		rec_offs_make_valid(bound->first_rec, m_index, offsets);
+		bound->first_offsets = offsets;
+		bound->last_entry = NULL;
+		bound->prev = thread.bounds;
+
+		thread.bounds = bound;
+	}
+
+	/** Note the last record of the range that a thread is reading,
+	which is the previous entry of the thread.
+	@param[in,out]	thread	state of the thread */
+	void end_range(thread_t& thread)
+	{
+		bound_t*	bound = thread.bounds;
+
+		if (bound == NULL || bound->last_entry != NULL) {
+			return;
+		}
+
+		ut_ad(thread.prev_entry != NULL);
+
+		dtuple_t*	entry = dtuple_copy(
+			thread.prev_entry, thread.bounds_heap);
+
+		for (ulint i = 0; i < dtuple_get_n_fields(entry); i++) {
+			dfield_dup(dtuple_get_nth_field(entry, i),
+				   thread.bounds_heap);
+		}
+
+		bound->last_entry = entry;
+	}
+
+	/** Check that a record is greater than the previous one, and
+	that they do not have the same key.
+	@param[in]	prev_entry	the previous record
+	@param[in]	rec		the record
+	@param[in]	offsets		rec_get_offsets(rec, m_index) */
+	void check(
+		const dtuple_t*	prev_entry,
+		const rec_t*	rec,
+		const ulint*	offsets)
+	{
+		const ulint	n_user = dict_index_get_n_ordering_defined_by_user(
+			m_index);
+		ulint		matched_fields = 0;
+		bool		contains_null = false;
+		int		cmp = cmp_dtuple_rec_with_match(
+			prev_entry, rec, offsets, &matched_fields);
+
+		for (ulint i = 0; i < n_user; i++) {
+			if (UNIV_SQL_NULL == dfield_get_len(
+				    dtuple_get_nth_field(prev_entry, i))) {
+
+				contains_null = true;
+				break;
+			}
+		}
+
+		dberr_t		err;
+		const char*	msg;
+
+		if (cmp > 0) {
+			err = DB_INDEX_CORRUPT;
+			msg = "index records in a wrong order in ";
+		} else if (dict_index_is_unique(m_index)
+			   && !contains_null
+			   && matched_fields >= n_user) {
+			err = DB_DUPLICATE_KEY;
+			msg = "duplicate key in ";
+		} else {
+			return;
+		}
+
+		ib::error()
+			<< msg << m_index->name
+			<< " of table " << m_index->table->name
+			<< ": " << *prev_entry << ", "
+			<< rec_offsets_print(rec, offsets);
+
+		/* Keep the first error, and continue reading. */
+		os_compare_and_swap_ulint(
+			&m_err, static_cast<ulint>(DB_SUCCESS),
+			static_cast<ulint>(err));
+	}
+
+	/** Clustered index */
+	const dict_index_t*	m_index;
+
+	/** true=check for misordered or duplicate records */
+	const bool		m_check_keys;
+
+	/** Size of m_threads */
+	const ulint		m_n_threads;
+
+	/** State of each thread */
+	thread_t*		m_threads;
+
+	/** First error as a dberr_t, updated atomically */
+	volatile ulint		m_err;
+};
+
+/** Scan a clustered index with several threads for either COUNT(*) or
+CHECK TABLE, counting the records in the read view of the transaction.
+For CHECK TABLE, the records are also checked to be in ascending order
+and unique, also across the boundaries of the ranges that the threads
+read.
+@param[in,out]	trx		transaction; it must have been started
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads
+@param[in]	check_keys	true=check for misordered or duplicate
+records, false=count the rows only
+@param[out]	n_rows		number of records seen in the read view
+@return DB_SUCCESS or other error */
+dberr_t
+row_scan_clust_index_parallel(
+	trx_t*			trx,
+	dict_index_t*		index,
+	ulint			n_threads,
+	bool			check_keys,
+	ulint*			n_rows)
+{
+	ut_ad(dict_index_is_clust(index));
+
+	ParallelReader		reader(trx, index, n_threads);
+	ScanIndexCallback	callback(index, reader.n_threads(), check_keys);
+
+	dberr_t	err = reader.run(callback);
+
+	if (err == DB_SUCCESS && check_keys) {
+		callback.check_ranges();
+	}
+
+	*n_rows = callback.n_rows();
+
+	if (err == DB_SUCCESS) {
+		err = callback.error();
+	}
+
+	return(err);
+}
+
 /*********************************************************************//**
 Initialize this module */
 void
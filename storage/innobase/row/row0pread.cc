@@ -0,0 +1,432 @@
+/*****************************************************************************
+
+Copyright (c) 2023, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel read of the records of a clustered index
+*******************************************************/
+
+#include "row0pread.h"
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "os0thread.h"
+#include "read0read.h"
+#include "rem0cmp.h"
+#include "row0row.h"
+#include "row0vers.h"
+#include "trx0trx.h"
+
+/** Number of key ranges to aim for per thread, so that the threads that
+get the smaller ranges can take more of them */
+static const ulint	PARALLEL_READ_RANGES_PER_THREAD = 4;
+
+/** Argument of parallel_read_thread() */
+struct parallel_read_arg_t {
+	ParallelReader*	reader;		/*!< the reader */
+	ulint		thread_id;	/*!< Ctx::m_thread_id of the thread */
+};
+
+/*********************************************************************//**
+Thread that reads key ranges for ParallelReader::run().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(parallel_read_thread)(
+/*=================================*/
+	void*	arg)	/*!< in: parallel_read_arg_t */
+{
+	parallel_read_arg_t*	read_arg
+		= static_cast<parallel_read_arg_t*>(arg);
+
+	read_arg->reader->worker(read_arg->thread_id);
+
+	os_thread_exit(false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Constructor
+@param[in]	trx		transaction whose read view is used;
+it must have been started
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads */
+ParallelReader::ParallelReader(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads)
+	:
+	m_trx(trx),
+	m_index(index),
+	m_n_threads(ut_max(n_threads, static_cast<ulint>(1))),
+	m_view(NULL),
+	m_heap(NULL),
+	m_next(0),
+	m_err(DB_SUCCESS),
+	m_callback(NULL),
+	m_n_running(0)
+{
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(trx_is_started(trx));
+
+	if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED) {
+		m_view = trx_assign_read_view(trx);
+	}
+
+	m_heap = mem_heap_create(1024);
+	m_done_event = os_event_create(0);
+}
+
+/** Destructor */
+ParallelReader::~ParallelReader()
+{
+	os_event_destroy(m_done_event);
+	mem_heap_free(m_heap);
+}
+
+/** Split the index into key ranges, filling m_ranges. The ranges start at
+the node pointers of the highest non-leaf level that has at least
+PARALLEL_READ_RANGES_PER_THREAD node pointers per thread, or of level 1.
+The index tree is s-latched meanwhile, so that the node pointers of a
+level stay consistent. */
+void
+ParallelReader::split()
+{
+	typedef std::vector<ulint, ut_allocator<ulint> >	page_nos_t;
+
+	mtr_t		mtr;
+	page_nos_t	page_nos;
+	mem_heap_t*	heap = mem_heap_create(1024);
+	const ulint	n_fields = dict_index_get_n_unique_in_tree(m_index);
+	const ulint	n_wanted = m_n_threads
+		* PARALLEL_READ_RANGES_PER_THREAD;
+
+	m_ranges.clear();
+	mem_heap_empty(m_heap);
+
+	/* The first range starts at the low end of the index. */
+	m_ranges.push_back(NULL);
+
+	if (m_n_threads == 1) {
+		mem_heap_free(heap);
+		return;
+	}
+
+	mtr_start(&mtr);
+
+	mtr_s_lock(dict_index_get_lock(m_index), &mtr);
+
+	const buf_block_t*	root = btr_root_block_get(
+		m_index, RW_S_LATCH, &mtr);
+	const page_size_t	page_size(dict_table_page_size(m_index->table));
+	ulint			level = btr_page_get_level(
+		buf_block_get_frame(root), &mtr);
+
+	page_nos.push_back(root->page.id.page_no());
+
+	/* Descend one level at a time, until there are enough node
+	pointers to split the index into the wanted number of ranges.
+	Every node pointer of a level, except the first one, which has
+	REC_INFO_MIN_REC_FLAG, starts a range. Each page is latched only
+	once, because an s-latch must not be requested again while an
+	x-latch request may be waiting for it. */
+	while (level > 0) {
+		page_nos_t	child_page_nos;
+
+		m_ranges.resize(1);
+		mem_heap_empty(m_heap);
+
+		for (page_nos_t::const_iterator it = page_nos.begin();
+		     it != page_nos.end();
+		     ++it) {
+
+			const buf_block_t*	block = btr_block_get(
+				page_id_t(m_index->space, *it), page_size,
+				RW_S_LATCH, m_index, &mtr);
+			const page_t*		page = buf_block_get_frame(
+				block);
+			const rec_t*		rec = page_rec_get_next_const(
+				page_get_infimum_rec(page));
+
+			for (; !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+
+				ulint*	offsets = rec_get_offsets(
+					rec, m_index, NULL,
+					ULINT_UNDEFINED, &heap);
+
+				child_page_nos.push_back(
+					btr_node_ptr_get_child_page_no(
+						rec, offsets));
+
+				mem_heap_empty(heap);
+
+				if (rec_get_info_bits(
+					    rec, page_is_comp(page))
+				    & REC_INFO_MIN_REC_FLAG) {
+					continue;
+				}
+
+				dtuple_t*	tuple
+					= dict_index_build_data_tuple(
+						m_index,
+						const_cast<rec_t*>(rec),
+						n_fields, m_heap);
+
+				dtuple_set_info_bits(tuple, 0);
+
+				m_ranges.push_back(tuple);
+			}
+		}
+
+		if (level == 1 || child_page_nos.size() >= n_wanted) {
+			break;
+		}
+
+		page_nos.swap(child_page_nos);
+		level--;
+	}
+
+	mtr_commit(&mtr);
+
+	mem_heap_free(heap);
+}
+
+/** Read the records of a key range.
+@param[in]	range_id	position of the range in m_ranges
+@param[in]	thread_id	Ctx::m_thread_id of this thread
+@param[in,out]	heap		memory heap for old versions
+@return DB_SUCCESS or error code */
+dberr_t
+ParallelReader::read_range(
+	ulint		range_id,
+	ulint		thread_id,
+	mem_heap_t*	heap)
+{
+	const dtuple_t*	start = m_ranges[range_id];
+	const dtuple_t*	end = range_id + 1 < m_ranges.size()
+		? m_ranges[range_id + 1] : NULL;
+	const bool	comp = dict_table_is_comp(m_index->table);
+	dberr_t		err = DB_SUCCESS;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	Ctx		ctx;
+
+	ctx.m_thread_id = thread_id;
+	ctx.m_range_id = range_id;
+	ctx.m_first = true;
+
+	mtr_start(&mtr);
+
+	if (start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, m_index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		btr_pcur_open(m_index, start, PAGE_CUR_GE, BTR_SEARCH_LEAF,
+			      &pcur, &mtr);
+	}
+
+	for (;;) {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+		if (page_rec_is_supremum(rec)) {
+
+			if (m_err != DB_SUCCESS) {
+				break;
+			}
+
+			if (trx_is_interrupted(m_trx)) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+
+			if (btr_page_get_next(btr_pcur_get_page(&pcur), &mtr)
+			    == FIL_NULL) {
+				break;
+			}
+
+			if (rw_lock_get_waiters(
+				    dict_index_get_lock(m_index))) {
+				/* There are waiters on the index tree
+				lock, likely the purge thread. Store and
+				restore the cursor position on the last
+				user record of the page, and yield, like
+				row_merge_read_clustered_index() does. */
+				btr_pcur_move_to_prev_on_page(&pcur);
+
+				ut_ad(btr_pcur_is_on_user_rec(&pcur));
+
+				btr_pcur_store_position(&pcur, &mtr);
+				mtr_commit(&mtr);
+
+				os_thread_yield();
+
+				mtr_start(&mtr);
+				btr_pcur_restore_position(
+					BTR_SEARCH_LEAF, &pcur, &mtr);
+			}
+
+		} else if (!page_rec_is_infimum(rec)) {
+			ulint*	offsets;
+
+			mem_heap_empty(heap);
+
+			offsets = rec_get_offsets(
+				rec, m_index, NULL, ULINT_UNDEFINED, &heap);
+
+			if (end != NULL
+			    && cmp_dtuple_rec(end, rec, offsets) <= 0) {
+				break;
+			}
+
+			if (m_view != NULL
+			    && !m_view->changes_visible(
+				    row_get_rec_trx_id(rec, m_index, offsets),
+				    m_index->table->name)) {
+				rec_t*	old_vers;
+
+				row_vers_build_for_consistent_read(
+					rec, &mtr, m_index, &offsets, m_view,
+					&heap, heap, &old_vers, NULL);
+
+				rec = old_vers;
+			}
+
+			if (rec != NULL && !rec_get_deleted_flag(rec, comp)) {
+				ctx.m_rec = rec;
+				ctx.m_offsets = offsets;
+				ctx.m_block = btr_pcur_get_block(&pcur);
+
+				err = (*m_callback)(ctx);
+
+				if (err != DB_SUCCESS) {
+					break;
+				}
+
+				ctx.m_first = false;
+			}
+		}
+
+		if (!btr_pcur_move_to_next(&pcur, &mtr)) {
+			break;
+		}
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	return(err);
+}
+
+/** Read key ranges until none is left. This is the body of the threads
+that run() starts.
+@param[in]	thread_id	Ctx::m_thread_id of the thread */
+void
+ParallelReader::worker(ulint thread_id)
+{
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	while (m_err == DB_SUCCESS) {
+		ulint	range_id = os_atomic_increment_ulint(&m_next, 1) - 1;
+
+		if (range_id >= m_ranges.size()) {
+			break;
+		}
+
+		dberr_t	err = read_range(range_id, thread_id, heap);
+
+		if (err != DB_SUCCESS) {
+			/* Keep the first error. */
+			os_compare_and_swap_ulint(
+				&m_err, static_cast<ulint>(DB_SUCCESS),
+				static_cast<ulint>(err));
+		}
+	}
+
+	mem_heap_free(heap);
+
+	if (thread_id > 0
+	    && os_atomic_decrement_ulint(&m_n_running, 1) == 0) {
+		os_event_set(m_done_event);
+	}
+}
+
+/** Read all the records of the index that are visible in the read view
+of the transaction. In READ UNCOMMITTED, the latest versions of the records
+are read.
+@param[in,out]	callback	invoked for each visible record that is not
+delete-marked
+@return DB_SUCCESS, or the first error */
+dberr_t
+ParallelReader::run(Callback& callback)
+{
+	split();
+
+	m_callback = &callback;
+	m_next = 0;
+	m_err = DB_SUCCESS;
+
+	/* The calling thread reads ranges as well. */
+	ulint	n_started = ut_min(m_n_threads, m_ranges.size()) - 1;
+
+	parallel_read_arg_t*	args = NULL;
+	os_thread_id_t*		thread_ids = NULL;
+
+	if (n_started > 0) {
+		args = static_cast<parallel_read_arg_t*>(
+			ut_malloc_nokey(n_started * sizeof *args));
+		thread_ids = static_cast<os_thread_id_t*>(
+			ut_malloc_nokey(n_started * sizeof *thread_ids));
+
+		m_n_running = n_started;
+		os_event_reset(m_done_event);
+
+		for (ulint i = 0; i < n_started; i++) {
+			args[i].reader = this;
+			args[i].thread_id = i + 1;
+
+			os_thread_create(parallel_read_thread, &args[i],
+					 &thread_ids[i]);
+		}
+	}
+
+	worker(0);
+
+	if (n_started > 0) {
+		os_event_wait(m_done_event);
+
+		for (ulint i = 0; i < n_started; i++) {
+			os_thread_join(thread_ids[i]);
+		}
+
+		ut_free(thread_ids);
+		ut_free(args);
+	}
+
+	m_callback = NULL;
+
+	return(static_cast<dberr_t>(m_err));
+}
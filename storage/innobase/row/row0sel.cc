@@ -4949,8 +4949,14 @@ row_search_mvcc(
 			hash index semaphore! */
 
 			ut_a(!trx->has_search_latch);
-			rw_lock_s_lock(btr_get_search_latch(index));
-			trx->has_search_latch = true;
+
+			/* With innodb_adaptive_hash_index_lock_free, the
+			hash index is looked up without its latch and the
+			record is protected by the page latch alone. */
+			if (!btr_search_lock_free) {
+				rw_lock_s_lock(btr_get_search_latch(index));
+				trx->has_search_latch = true;
+			}
 
 			switch (row_sel_try_search_shortcut_for_mysql(
 					&rec, prebuilt, &offsets, &heap,
@@ -5002,8 +5008,11 @@ row_search_mvcc(
 
 				err = DB_SUCCESS;
 
-				rw_lock_s_unlock(btr_get_search_latch(index));
-				trx->has_search_latch = false;
+				if (trx->has_search_latch) {
+					rw_lock_s_unlock(
+						btr_get_search_latch(index));
+					trx->has_search_latch = false;
+				}
 
 				goto func_exit;
 
@@ -5013,8 +5022,11 @@ row_search_mvcc(
 
 				err = DB_RECORD_NOT_FOUND;
 
-				rw_lock_s_unlock(btr_get_search_latch(index));
-				trx->has_search_latch = false;
+				if (trx->has_search_latch) {
+					rw_lock_s_unlock(
+						btr_get_search_latch(index));
+					trx->has_search_latch = false;
+				}
 
 				/* NOTE that we do NOT store the cursor
 				position */
@@ -5031,8 +5043,10 @@ row_search_mvcc(
 			mtr_commit(&mtr);
 			mtr_start(&mtr);
 
-                        rw_lock_s_unlock(btr_get_search_latch(index));
-                        trx->has_search_latch = false;
+			if (trx->has_search_latch) {
+				rw_lock_s_unlock(btr_get_search_latch(index));
+				trx->has_search_latch = false;
+			}
 		}
 	}
 
@@ -2400,7 +2400,14 @@ row_upd_sec_step(
 	if (node->state == UPD_NODE_UPDATE_ALL_SEC
 	    || row_upd_changes_ord_field_binary(node->index, node->update,
 						thr, node->row, node->ext)) {
-		return(row_upd_sec_index_entry(node, thr));
+		dberr_t	err = row_upd_sec_index_entry(node, thr);
+
+		/* After DB_LOCK_WAIT the step is executed again. */
+		if (err == DB_SUCCESS) {
+			node->index->stat_modified_counter++;
+		}
+
+		return(err);
 	}
 
 	return(DB_SUCCESS);
@@ -2963,6 +2970,7 @@ row_upd_clust_step(
 			flags, node, index, offsets, thr, referenced, &mtr);
 
 		if (err == DB_SUCCESS) {
+			index->stat_modified_counter++;
 			node->state = UPD_NODE_UPDATE_ALL_SEC;
 			node->index = dict_table_get_next_index(index);
 		}
@@ -3013,6 +3021,7 @@ row_upd_clust_step(
 			goto exit_func;
 		}
 
+		index->stat_modified_counter++;
 		node->state = UPD_NODE_UPDATE_ALL_SEC;
 	} else {
 		err = row_upd_clust_rec(
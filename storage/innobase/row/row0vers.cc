@@ -56,6 +56,7 @@ Created 2/6/1997 Heikki Tuuri
 #include "read0read.h"
 #include "lock0lock.h"
 #include "row0mysql.h"
+#include "srv0mon.h"
 
 /** Check whether all non-virtual columns in a virtual index match that of in
 the cluster index
@@ -1104,6 +1105,215 @@ row_vers_old_has_index_entry(
 	}
 }
 
+/** Approximate memory used by a VersionCache entry, besides the copy of
+the version */
+static const ulint	VERSION_CACHE_ENTRY_SIZE = 64;
+
+/** Constructor
+@param[in]	max_size	maximum size of the cache in bytes */
+VersionCache::VersionCache(ulint max_size)
+	:
+	m_versions(),
+	m_heap(mem_heap_create(1024)),
+	m_size(),
+	m_max_size(max_size)
+{
+	m_mutex.init();
+}
+
+/** Destructor */
+VersionCache::~VersionCache()
+{
+	mem_heap_free(m_heap);
+
+	m_mutex.destroy();
+}
+
+/** Look up the version that was built from a record.
+@param[in]	index_id	clustered index id
+@param[in]	roll_ptr	DB_ROLL_PTR of the record
+@param[in]	trx_id		DB_TRX_ID of the record
+@param[in,out]	heap		memory heap where the version is copied
+@param[out]	rec		copy of the version, or NULL if the
+record does not exist in the view
+@return true if the version was found */
+bool
+VersionCache::lookup(
+	index_id_t	index_id,
+	roll_ptr_t	roll_ptr,
+	trx_id_t	trx_id,
+	mem_heap_t*	heap,
+	rec_t**		rec)
+{
+	m_mutex.enter();
+
+	versions_t::const_iterator	it = m_versions.find(
+		key_t(index_id, roll_ptr));
+
+	if (it == m_versions.end() || it->second.m_trx_id != trx_id) {
+
+		m_mutex.exit();
+
+		return(false);
+	}
+
+	const Version&	version = it->second;
+
+	if (version.m_data == NULL) {
+		*rec = NULL;
+	} else {
+		byte*	buf = static_cast<byte*>(
+			mem_heap_alloc(heap, version.m_size));
+
+		memcpy(buf, version.m_data, version.m_size);
+
+		*rec = buf + version.m_extra;
+	}
+
+	m_mutex.exit();
+
+	return(true);
+}
+
+/** Add the version that was built from a record.
+@param[in]	index_id	clustered index id
+@param[in]	roll_ptr	DB_ROLL_PTR of the record
+@param[in]	trx_id		DB_TRX_ID of the record
+@param[in]	rec		version that the view sees, or NULL
+if the record does not exist in the view
+@param[in]	offsets		rec_get_offsets(rec), or NULL */
+void
+VersionCache::insert(
+	index_id_t	index_id,
+	roll_ptr_t	roll_ptr,
+	trx_id_t	trx_id,
+	const rec_t*	rec,
+	const ulint*	offsets)
+{
+	ulint	size = VERSION_CACHE_ENTRY_SIZE;
+
+	if (rec != NULL) {
+		size += rec_offs_size(offsets);
+	}
+
+	if (size > m_max_size) {
+		return;
+	}
+
+	m_mutex.enter();
+
+	if (m_size + size > m_max_size) {
+		m_versions.clear();
+		mem_heap_empty(m_heap);
+		m_size = 0;
+	}
+
+	std::pair<versions_t::iterator, bool>	ret = m_versions.insert(
+		versions_t::value_type(key_t(index_id, roll_ptr), Version()));
+
+	if (ret.second) {
+		Version&	version = ret.first->second;
+
+		version.m_trx_id = trx_id;
+
+		if (rec == NULL) {
+			version.m_data = NULL;
+			version.m_extra = 0;
+			version.m_size = 0;
+		} else {
+			version.m_extra = rec_offs_extra_size(offsets);
+			version.m_size = rec_offs_size(offsets);
+			version.m_data = static_cast<byte*>(
+				mem_heap_dup(m_heap, rec - version.m_extra,
+					     version.m_size));
+		}
+
+		m_size += size;
+	}
+
+	m_mutex.exit();
+}
+
+/** Remove all the versions. */
+void
+VersionCache::clear()
+{
+	m_mutex.enter();
+
+	m_versions.clear();
+	mem_heap_empty(m_heap);
+	m_size = 0;
+
+	m_mutex.exit();
+}
+
+/** Look up the version of a clustered index record that a consistent
+read should see in the version cache of the read view.
+@param[in,out]	cache		version cache of the read view
+@param[in]	rec		record in the clustered index
+@param[in]	index		clustered index
+@param[in,out]	offsets		rec_get_offsets(rec, index); on success,
+rec_get_offsets(*old_vers, index)
+@param[in]	roll_ptr	DB_ROLL_PTR of rec
+@param[in]	trx_id		DB_TRX_ID of rec
+@param[in,out]	offset_heap	memory heap for the offsets
+@param[in,out]	in_heap		memory heap where *old_vers is copied
+@param[out]	old_vers	old version, or NULL if the record does
+not exist in the view
+@return true if the version was found */
+static
+bool
+row_vers_lookup_cache(
+	VersionCache*	cache,
+	const rec_t*	rec,
+	dict_index_t*	index,
+	ulint**		offsets,
+	roll_ptr_t	roll_ptr,
+	trx_id_t	trx_id,
+	mem_heap_t**	offset_heap,
+	mem_heap_t*	in_heap,
+	rec_t**		old_vers)
+{
+	rec_t*	cached;
+
+	if (!cache->lookup(index->id, roll_ptr, trx_id, in_heap, &cached)) {
+		return(false);
+	}
+
+	if (cached != NULL) {
+		ulint*	cached_offsets = rec_get_offsets(
+			cached, index, NULL, ULINT_UNDEFINED, offset_heap);
+
+		/* The primary key of a clustered index record is never
+		updated in place, so every version of rec has the same
+		primary key as rec. */
+		for (ulint i = 0; i < dict_index_get_n_unique(index); i++) {
+			ulint		len;
+			ulint		cached_len;
+			const byte*	field = rec_get_nth_field(
+				rec, *offsets, i, &len);
+			const byte*	cached_field = rec_get_nth_field(
+				cached, cached_offsets, i, &cached_len);
+
+			if (len != cached_len
+			    || (len != UNIV_SQL_NULL
+				&& memcmp(field, cached_field, len))) {
+
+				ut_ad(0);
+				return(false);
+			}
+		}
+
+		*offsets = cached_offsets;
+	}
+
+	*old_vers = cached;
+
+	MONITOR_INC(MONITOR_TRX_VERSION_CACHE_HITS);
+
+	return(true);
+}
+
 /*****************************************************************//**
 Constructs the version of a clustered index record which a consistent
 read should see. We assume that the trx id stored in rec is such that
@@ -1139,6 +1349,7 @@ row_vers_build_for_consistent_read(
 	mem_heap_t*	heap		= NULL;
 	byte*		buf;
 	dberr_t		err;
+	ulint		n_hops		= 0;
 
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(mtr_memo_contains_page(mtr, rec, MTR_MEMO_PAGE_X_FIX)
@@ -1153,6 +1364,26 @@ row_vers_build_for_consistent_read(
 
 	ut_ad(!vrow || !(*vrow));
 
+	/* The virtual columns of the old versions are not cached. */
+	VersionCache*	cache = vrow == NULL ? view->version_cache() : NULL;
+	const trx_id_t	rec_trx_id = trx_id;
+	roll_ptr_t	roll_ptr = 0;
+
+	if (cache != NULL) {
+		roll_ptr = row_get_rec_roll_ptr(rec, index, *offsets);
+
+		/* The insert undo log of a committed transaction can be
+		freed and reused at any time. */
+		if (trx_undo_roll_ptr_is_insert(roll_ptr)) {
+			cache = NULL;
+		} else if (row_vers_lookup_cache(
+				   cache, rec, index, offsets, roll_ptr,
+				   trx_id, offset_heap, in_heap, old_vers)) {
+
+			return(DB_SUCCESS);
+		}
+	}
+
 	version = rec;
 
 	for (;;) {
@@ -1173,6 +1404,8 @@ row_vers_build_for_consistent_read(
 
 		err  = (purge_sees) ? DB_SUCCESS : DB_MISSING_HISTORY;
 
+		++n_hops;
+
 		if (prev_heap != NULL) {
 			mem_heap_free(prev_heap);
 		}
@@ -1218,6 +1451,14 @@ row_vers_build_for_consistent_read(
 
 	mem_heap_free(heap);
 
+	MONITOR_INC(MONITOR_TRX_VERSION_BUILDS);
+	MONITOR_INC_VALUE(MONITOR_TRX_VERSION_UNDO_HOPS, n_hops);
+
+	if (cache != NULL && err == DB_SUCCESS) {
+		cache->insert(index->id, roll_ptr, rec_trx_id, *old_vers,
+			      *old_vers != NULL ? *offsets : NULL);
+	}
+
 	return(err);
 }
 
@@ -1273,18 +1514,11 @@ row_vers_build_for_semi_consistent_read(
 			rec_trx_id = version_trx_id;
 		}
 
-		trx_sys_mutex_enter();
-		version_trx = trx_get_rw_trx_by_id(version_trx_id);
 		/* Because version_trx is a read-write transaction,
 		its state cannot change from or to NOT_STARTED while
-		we are holding the trx_sys->mutex.  It may change from
+		it is in its shard of the rw_trx_set. It may change from
 		ACTIVE to PREPARED or COMMITTED. */
-		if (version_trx
-		    && trx_state_eq(version_trx,
-				    TRX_STATE_COMMITTED_IN_MEMORY)) {
-			version_trx = NULL;
-		}
-		trx_sys_mutex_exit();
+		version_trx = trx_rw_is_active(version_trx_id, NULL, false);
 
 		if (!version_trx) {
 committed_version_trx:
@@ -139,6 +139,17 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_NUM_RECLOCK},
 
+	{"lock_rec_shard_waits", "lock",
+	 "Number of times a lock_sys shard mutex was busy",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOCK_SHARD_WAIT},
+
+	{"lock_rec_exclusive_retries", "lock",
+	 "Number of record lock requests retried under the exclusive"
+	 " lock_sys latch",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOCK_REC_X_RETRY},
+
 	{"lock_table_lock_created", "lock", "Number of table locks created",
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_TABLELOCK_CREATED},
@@ -611,6 +622,45 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_SET_MEMBER, MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	 MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL},
 
+	/* ========== Counters for Page Cleaner ========== */
+	{"module_page_cleaner", "page_cleaner", "Page Cleaner Module",
+	 MONITOR_MODULE,
+	 MONITOR_DEFAULT_START, MONITOR_MODULE_PAGE_CLEANER},
+
+	{"page_cleaner_instance_lag_max", "page_cleaner",
+	 "Largest flush lag (current LSN minus oldest modification)"
+	 " of any buffer pool instance",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PC_INSTANCE_LAG_MAX},
+
+	{"page_cleaner_instance_lag_avg", "page_cleaner",
+	 "Average flush lag (current LSN minus oldest modification)"
+	 " of the buffer pool instances",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PC_INSTANCE_LAG_AVG},
+
+	{"page_cleaner_lagging_instance", "page_cleaner",
+	 "Buffer pool instance with the largest flush lag",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PC_LAGGING_INSTANCE},
+
+	{"page_cleaner_single_page_flushes", "page_cleaner",
+	 "Single page flushes by user threads that found no free block",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PC_SINGLE_PAGE_FLUSHES},
+
+	{"page_cleaner_starved_instance", "page_cleaner",
+	 "Buffer pool instance with the most single page flushes"
+	 " since the last page cleaner loop",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PC_STARVED_INSTANCE},
+
+	{"page_cleaner_instance_requests", "page_cleaner",
+	 "Flush requests scheduled for a single buffer pool instance"
+	 " (innodb_page_cleaner_per_instance)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PC_INSTANCE_REQUESTS},
+
 	/* ========== Counters for Buffer Page I/O ========== */
 	{"module_buffer_page", "buffer_page_io", "Buffer Page I/O Module",
 	 static_cast<monitor_type_t>(
@@ -815,6 +865,28 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT),
 	 MONITOR_DEFAULT_START, MONITOR_RSEG_CUR_SIZE},
 
+	{"trx_version_builds", "transaction",
+	 "Number of old record versions built for consistent reads",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_VERSION_BUILDS},
+
+	{"trx_version_undo_hops", "transaction",
+	 "Number of undo log records applied to build old record versions"
+	 " for consistent reads",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_VERSION_UNDO_HOPS},
+
+	{"trx_version_cache_hits", "transaction",
+	 "Number of old record versions found in the version cache"
+	 " of a read view",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_VERSION_CACHE_HITS},
+
+	{"trx_undo_read_ahead_pages", "transaction",
+	 "Number of undo log pages read ahead for consistent reads",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_UNDO_READ_AHEAD},
+
 	/* ========== Counters for Purge Module ========== */
 	{"module_purge", "purge", "Purge Module",
 	 MONITOR_MODULE,
@@ -856,6 +928,23 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DISPLAY_CURRENT,
 	 MONITOR_DEFAULT_START, MONITOR_PURGE_RESUME_COUNT},
 
+	{"purge_batch_size", "purge",
+	 "Number of undo log pages purged in a batch, as adjusted by"
+	 " innodb_adaptive_purge_batch_size",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_BATCH_SIZE},
+
+	{"purge_lag_records", "purge",
+	 "Estimated number of undo log records not yet purged",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_LAG_RECORDS},
+
+	{"purge_lag_seconds", "purge",
+	 "Estimated age in seconds of the oldest transaction that was"
+	 " committed and not yet purged",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_LAG_SECONDS},
+
 	/* ========== Counters for Recovery Module ========== */
 	{"module_log", "recovery", "Recovery Module",
 	 MONITOR_MODULE,
@@ -939,6 +1028,77 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOG_PADDED},
 
+	{"log_concurrent_copies", "recovery",
+	 "Number of mini-transaction log copies done outside the log mutex"
+	 " (innodb_log_concurrent_copy)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_CONCURRENT_COPIES},
+
+	{"log_copy_slot_waits", "recovery",
+	 "Number of log buffer reservations that waited for a free copy slot",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_COPY_SLOT_WAITS},
+
+	{"log_copy_write_waits", "recovery",
+	 "Number of log buffer writes that waited for copies in progress",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_COPY_WRITE_WAITS},
+
+	{"log_writer_lag", "recovery",
+	 "Redo log bytes not yet written when the log writer thread started"
+	 " its latest write (innodb_log_writer_threads)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_WRITER_LAG},
+
+	{"log_flusher_lag", "recovery",
+	 "Redo log bytes written but not yet flushed when the log flusher"
+	 " thread started its latest flush",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSHER_LAG},
+
+	{"log_lsn_waits", "recovery",
+	 "Number of times a thread waited for the log threads to write"
+	 " or flush the redo log",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAITS},
+
+	{"log_lsn_wait_under_100us", "recovery",
+	 "Number of waits for the log threads shorter than 100 microseconds",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAIT_UNDER_100US},
+
+	{"log_lsn_wait_under_1ms", "recovery",
+	 "Number of waits for the log threads from 100 microseconds"
+	 " to 1 millisecond",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAIT_UNDER_1MS},
+
+	{"log_lsn_wait_under_10ms", "recovery",
+	 "Number of waits for the log threads from 1 to 10 milliseconds",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAIT_UNDER_10MS},
+
+	{"log_lsn_wait_under_100ms", "recovery",
+	 "Number of waits for the log threads from 10 to 100 milliseconds",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAIT_UNDER_100MS},
+
+	{"log_lsn_wait_over_100ms", "recovery",
+	 "Number of waits for the log threads of 100 milliseconds or longer",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAIT_OVER_100MS},
+
+	{"log_flush_order_waits", "recovery",
+	 "Number of mini-transactions that waited for older ones to add their"
+	 " dirty pages to the flush lists (innodb_flush_list_relaxed_order)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_ORDER_WAITS},
+
+	{"log_flush_order_slot_waits", "recovery",
+	 "Number of mini-transactions that waited for a free flush order slot",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_ORDER_SLOT_WAITS},
+
 	/* ========== Counters for Page Compression ========== */
 	{"module_compress", "compression", "Page Compression Info",
 	 MONITOR_MODULE,
@@ -1045,6 +1205,18 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
 
+	{"adaptive_hash_searches_lock_free", "adaptive_hash_index",
+	 "Number of Adaptive Hash Index searches completed without"
+	 " acquiring the partition latch",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_SEARCH_LOCK_FREE},
+
+	{"adaptive_hash_lock_free_retries", "adaptive_hash_index",
+	 "Number of Adaptive Hash Index searches retried under the partition"
+	 " latch after a concurrent modification",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_LOCK_FREE_RETRY},
+
 	/* ========== Counters for tablespace ========== */
 	{"module_file", "file_system", "Tablespace and File System Manager",
 	 MONITOR_MODULE,
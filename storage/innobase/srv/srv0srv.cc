@@ -99,6 +99,8 @@ ibool	srv_buf_dump_thread_active = FALSE;
 
 bool	srv_buf_resize_thread_active = false;
 
+bool	srv_fil_dir_cache_thread_active = false;
+
 ibool	srv_dict_stats_thread_active = FALSE;
 
 const char*	srv_main_thread_op_info = "";
@@ -196,6 +198,15 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio = TRUE;
 
+/* If this flag is TRUE, then the Linux native aio submits and reaps the
+requests through io_uring instead of libaio, if the kernel supports it */
+my_bool	srv_use_io_uring = FALSE;
+
+/* If this flag is TRUE, then the tablespace directory cache is written at
+shutdown, and the file-per-table tablespaces found in it are registered at
+startup without opening their files */
+my_bool	srv_tablespace_cache = FALSE;
+
 #ifdef UNIV_DEBUG
 /** Force all user tables to use page compression. */
 ulong	srv_debug_compress;
@@ -230,6 +241,9 @@ uint		srv_flush_log_at_timeout = 1;
 ulong		srv_page_size = UNIV_PAGE_SIZE_DEF;
 ulong		srv_page_size_shift = UNIV_PAGE_SIZE_SHIFT_DEF;
 ulong		srv_log_write_ahead_size = 0;
+my_bool		srv_log_concurrent_copy = FALSE;
+my_bool		srv_log_writer_threads = FALSE;
+my_bool		srv_flush_list_relaxed_order = FALSE;
 
 page_size_t	univ_page_size(0, 0, false);
 
@@ -277,6 +291,10 @@ ulint	srv_buf_pool_base_size	= 0;
 ulint	srv_buf_pool_curr_size	= 0;
 /** Dump this % of each buffer pool during BP dump */
 ulong	srv_buf_pool_dump_pct;
+/** Number of threads that read the pages of a buffer pool load */
+ulong	srv_buf_load_threads;
+/** Seconds between periodic buffer pool dumps, or 0 */
+ulong	srv_buf_dump_interval;
 /** Lock table size in bytes */
 ulint	srv_lock_table_size	= ULINT_MAX;
 
@@ -291,6 +309,12 @@ my_bool	srv_random_read_ahead	= FALSE;
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong	srv_read_ahead_threshold	= 56;
+/* Number of undo log pages to read ahead when a consistent read misses
+an undo log page in the buffer pool; 0 disables undo read-ahead. */
+ulong	srv_undo_read_ahead	= 0;
+/* Maximum size in bytes of the old record versions that are cached in
+each read view; 0 disables the cache. */
+ulong	srv_version_cache_size	= 0;
 
 /** Maximum on-disk size of change buffer in terms of percentage
 of the buffer pool. */
@@ -322,6 +346,11 @@ ulong	srv_max_io_capacity     = 400;
 /* The number of page cleaner threads to use.*/
 ulong	srv_n_page_cleaners = 4;
 
+/* If this flag is TRUE, then there is one page cleaner per buffer pool
+instance, and each instance is scheduled with its own adaptive flushing
+target instead of in rounds that wait for all instances. */
+my_bool	srv_page_cleaner_per_instance = FALSE;
+
 /* The InnoDB main thread tries to keep the ratio of modified pages
 in the buffer pool to all database pages in the buffer pool smaller than
 the following number. But it is not guaranteed that the value stays below
@@ -343,6 +372,13 @@ ulong	srv_n_purge_threads = 4;
 /* the number of pages to purge in one batch */
 ulong	srv_purge_batch_size = 20;
 
+/* whether to purge more pages per batch while the history list grows */
+my_bool	srv_adaptive_purge_batch_size = FALSE;
+
+/** Maximum factor by which innodb_adaptive_purge_batch_size enlarges
+innodb_purge_batch_size */
+static const ulint	SRV_PURGE_BATCH_SIZE_MAX_FACTOR = 8;
+
 /* Internal setting for "innodb_stats_method". Decides how InnoDB treats
 NULL value when collecting statistics. By default, it is set to
 SRV_STATS_NULLS_EQUAL(0), ie. all NULL value are treated equal */
@@ -363,6 +399,10 @@ ulong	srv_force_recovery;
 This is for testing and debugging only. */
 ulong	srv_force_recovery_crash;
 #endif /* !NDEBUG */
+/** Number of threads that apply a batch of redo log records to the
+pages during crash recovery. The pages of the batch are partitioned
+among the threads by their hash value. */
+ulong	srv_recovery_apply_threads = 1;
 
 /** Print all user-level transactions deadlocks to mysqld stderr */
 
@@ -391,6 +431,12 @@ my_bool		srv_stats_persistent = TRUE;
 my_bool		srv_stats_include_delete_marked = FALSE;
 unsigned long long	srv_stats_persistent_sample_pages = 20;
 my_bool		srv_stats_auto_recalc = TRUE;
+/** Whether the automatic recalculation keeps the persistent statistics
+of the secondary indexes that were not modified much */
+my_bool		srv_stats_auto_recalc_incremental = FALSE;
+/** Number of threads that analyze the indexes of a table when
+calculating persistent statistics */
+ulong		srv_stats_analyze_threads = 1;
 
 ibool	srv_use_doublewrite_buf	= TRUE;
 
@@ -400,6 +446,14 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 ulong	srv_doublewrite_batch_size	= 120;
 
+/* If this is not 0, the doublewrite buffer is not written to the system
+tablespace but to this many files, each buffer pool instance to file
+(instance number % srv_doublewrite_files). */
+ulong	srv_doublewrite_files		= 0;
+
+/* The directory of the doublewrite files, the datadir by default. */
+char*	srv_doublewrite_dir		= NULL;
+
 ulong	srv_replication_delay		= 0;
 
 /*-------------------------------------------*/
@@ -1832,6 +1886,8 @@ srv_any_background_threads_are_active(void)
 	if (srv_read_only_mode) {
 		if (srv_buf_resize_thread_active) {
 			thread_active = "buf_resize_thread";
+		} else if (srv_fil_dir_cache_thread_active) {
+			thread_active = "fil_dir_cache_thread";
 		}
 		os_event_set(srv_buf_resize_event);
 		return(thread_active);
@@ -1839,6 +1895,8 @@ srv_any_background_threads_are_active(void)
 		thread_active = "srv_error_monitor_thread";
 	} else if (lock_sys->timeout_thread_active) {
 		thread_active = "srv_lock_timeout thread";
+	} else if (lock_sys->deadlock_thread_active) {
+		thread_active = "lock_deadlock_detect_thread";
 	} else if (srv_monitor_active) {
 		thread_active = "srv_monitor_thread";
 	} else if (srv_buf_dump_thread_active) {
@@ -1847,12 +1905,15 @@ srv_any_background_threads_are_active(void)
 		thread_active = "buf_resize_thread";
 	} else if (srv_dict_stats_thread_active) {
 		thread_active = "dict_stats_thread";
+	} else if (srv_fil_dir_cache_thread_active) {
+		thread_active = "fil_dir_cache_thread";
 	}
 
 	os_event_set(srv_error_event);
 	os_event_set(srv_monitor_event);
 	os_event_set(srv_buf_dump_event);
 	os_event_set(lock_sys->timeout_event);
+	os_event_set(lock_sys->deadlock_event);
 	os_event_set(dict_stats_event);
 	os_event_set(srv_buf_resize_event);
 
@@ -2161,6 +2222,9 @@ srv_master_do_active_tasks(void)
 		srv_wake_purge_thread_if_not_active();
 	}
 
+	srv_main_thread_op_info = "estimating purge lag";
+	trx_purge_update_lag();
+
 	if (cur_time % SRV_MASTER_DICT_LRU_INTERVAL == 0) {
 		srv_main_thread_op_info = "enforcing dict cache limit";
 		ulint	n_evicted = srv_master_evict_from_table_cache(50);
@@ -2241,6 +2305,9 @@ srv_master_do_idle_tasks(void)
 		srv_wake_purge_thread_if_not_active();
 	}
 
+	srv_main_thread_op_info = "estimating purge lag";
+	trx_purge_update_lag();
+
 	srv_main_thread_op_info = "enforcing dict cache limit";
 	ulint	n_evicted = srv_master_evict_from_table_cache(100);
 	if (n_evicted != 0) {
@@ -2584,6 +2651,7 @@ srv_do_purge(
 
 	static ulint	count = 0;
 	static ulint	n_use_threads = 0;
+	static ulint	batch_size = 0;
 	static ulint	rseg_history_len = 0;
 	ulint		old_activity_count = srv_get_activity_count();
 
@@ -2629,6 +2697,25 @@ srv_do_purge(
 		ut_a(n_use_threads > 0);
 		ut_a(n_use_threads <= n_threads);
 
+		const ulint	min_batch_size = srv_purge_batch_size;
+
+		if (!srv_adaptive_purge_batch_size) {
+			batch_size = min_batch_size;
+		} else if (trx_sys->rseg_history_len > rseg_history_len) {
+			/* History length is now longer than what it was
+			when we took the last snapshot. Purge more pages in
+			a batch, up to a multiple of the configured size. */
+			batch_size = ut_min(
+				ut_max(batch_size * 2, min_batch_size),
+				min_batch_size
+				* SRV_PURGE_BATCH_SIZE_MAX_FACTOR);
+		} else {
+			/* Shrink back towards the configured size. */
+			batch_size = ut_max(batch_size / 2, min_batch_size);
+		}
+
+		MONITOR_SET(MONITOR_PURGE_BATCH_SIZE, batch_size);
+
 		/* Take a snapshot of the history list before purge. */
 		if ((rseg_history_len = trx_sys->rseg_history_len) == 0) {
 			break;
@@ -2642,7 +2729,7 @@ srv_do_purge(
 			undo_trunc_freq);
 
 		n_pages_purged = trx_purge(
-			n_use_threads, srv_purge_batch_size,
+			n_use_threads, batch_size,
 			(++count % rseg_truncate_frequency) == 0);
 
 		*n_total_purged += n_pages_purged;
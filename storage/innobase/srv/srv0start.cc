@@ -89,6 +89,7 @@ Created 2/16/1996 Heikki Tuuri
 # include "buf0rea.h"
 # include "dict0boot.h"
 # include "dict0load.h"
+# include "dict0stats.h"
 # include "dict0stats_bg.h"
 # include "que0que.h"
 # include "usr0sess.h"
@@ -186,7 +187,9 @@ static const ulint MIN_EXPECTED_TABLESPACE_SIZE = 5 * 1024 * 1024;
 #ifdef UNIV_PFS_THREAD
 /* Keys to register InnoDB threads with performance schema */
 mysql_pfs_key_t	buf_dump_thread_key;
+mysql_pfs_key_t	fil_dir_cache_thread_key;
 mysql_pfs_key_t	dict_stats_thread_key;
+mysql_pfs_key_t	dict_stats_analyze_thread_key;
 mysql_pfs_key_t	io_handler_thread_key;
 mysql_pfs_key_t	io_ibuf_thread_key;
 mysql_pfs_key_t	io_log_thread_key;
@@ -194,6 +197,7 @@ mysql_pfs_key_t	io_read_thread_key;
 mysql_pfs_key_t	io_write_thread_key;
 mysql_pfs_key_t	srv_error_monitor_thread_key;
 mysql_pfs_key_t	srv_lock_timeout_thread_key;
+mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 mysql_pfs_key_t	srv_master_thread_key;
 mysql_pfs_key_t	srv_monitor_thread_key;
 mysql_pfs_key_t	srv_purge_thread_key;
@@ -1264,8 +1268,10 @@ srv_shutdown_all_bg_threads()
 		if (!srv_read_only_mode) {
 
 			if (srv_start_state_is_set(SRV_START_STATE_LOCK_SYS)) {
-				/* a. Let the lock timeout thread exit */
+				/* a. Let the lock timeout and the deadlock
+				detector threads exit */
 				os_event_set(lock_sys->timeout_event);
+				os_event_set(lock_sys->deadlock_event);
 			}
 
 			/* b. srv error monitor thread exits automatically,
@@ -1641,12 +1647,16 @@ innobase_start_or_create_for_mysql(void)
 	srv_max_n_threads = 1   /* io_ibuf_thread */
 			    + 1 /* io_log_thread */
 			    + 1 /* lock_wait_timeout_thread */
+			    + 1 /* lock_deadlock_detect_thread */
 			    + 1 /* srv_error_monitor_thread */
 			    + 1 /* srv_monitor_thread */
 			    + 1 /* srv_master_thread */
 			    + 1 /* srv_purge_coordinator_thread */
 			    + 1 /* buf_dump_thread */
+			    + 1 /* fil_dir_cache_thread */
 			    + 1 /* dict_stats_thread */
+			    + DICT_STATS_MAX_ANALYZE_THREADS
+				/* dict_stats_analyze_thread */
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
 			    + 1 /* trx_rollback_or_clean_all_recovered */
@@ -1714,12 +1724,19 @@ innobase_start_or_create_for_mysql(void)
 
 	srv_buf_pool_size = buf_pool_size_align(srv_buf_pool_size);
 
-	if (srv_n_page_cleaners > srv_buf_pool_instances) {
+	if (srv_n_page_cleaners > srv_buf_pool_instances
+	    || srv_page_cleaner_per_instance) {
 		/* limit of page_cleaner parallelizability
 		is number of buffer pool instances. */
 		srv_n_page_cleaners = srv_buf_pool_instances;
 	}
 
+	if (srv_doublewrite_files > srv_buf_pool_instances) {
+		/* A buffer pool instance writes to one doublewrite
+		file only. */
+		srv_doublewrite_files = srv_buf_pool_instances;
+	}
+
 	srv_boot();
 
 	ib::info() << (ut_crc32_sse2_enabled ? "Using" : "Not using")
@@ -1877,7 +1894,10 @@ innobase_start_or_create_for_mysql(void)
 	os_thread_create(buf_flush_page_cleaner_coordinator,
 			 NULL, NULL);
 
-	for (i = 1; i < srv_n_page_cleaners; ++i) {
+	/* With innodb_page_cleaner_per_instance, the coordinator only
+	schedules the requests, and each instance has a worker of its own. */
+	for (i = srv_page_cleaner_per_instance ? 0 : 1;
+	     i < srv_n_page_cleaners; ++i) {
 		os_thread_create(buf_flush_page_cleaner_worker,
 				 NULL, NULL);
 	}
@@ -2235,6 +2255,8 @@ files_checked:
 
 		recv_sys->dblwr.pages.clear();
 
+		buf_dblwr_free_loaded_pages();
+
 		if (err == DB_SUCCESS) {
 			/* Initialize the change buffer. */
 			err = dict_boot();
@@ -2334,7 +2356,22 @@ files_checked:
 			bool validate = recv_needed_recovery
 				&& srv_force_recovery == 0;
 
+			/* With the tablespace directory cache, the
+			file-per-table tablespaces that are found in it
+			are registered without looking at their files;
+			fil_dir_cache_thread validates them later. The
+			cache describes the files at a clean shutdown, so
+			it is not used if the redo log was applied. */
+			fil_dir_cache_load(srv_tablespace_cache
+					   && srv_force_recovery == 0
+					   && !recv_needed_recovery);
+
 			dict_check_tablespaces_and_store_max_id(validate);
+
+			if (fil_dir_cache_free() > 0) {
+				os_thread_create(
+					fil_dir_cache_thread, NULL, NULL);
+			}
 		}
 
 		/* Rotate the encryption key for recovery. It's because
@@ -2509,6 +2546,10 @@ files_checked:
 			lock_wait_timeout_thread,
 			NULL, thread_ids + 2 + SRV_MAX_N_IO_THREADS);
 
+		/* Create the thread which resolves deadlocks when
+		innodb_deadlock_detect_async is set */
+		os_thread_create(lock_deadlock_detect_thread, NULL, NULL);
+
 		/* Create the thread which warns of long semaphore waits */
 		os_thread_create(
 			srv_error_monitor_thread,
@@ -2520,6 +2561,12 @@ files_checked:
 			NULL, thread_ids + 4 + SRV_MAX_N_IO_THREADS);
 
 		srv_start_state_set(SRV_START_STATE_MONITOR);
+
+		if (srv_log_writer_threads) {
+			/* Create the log writer, flusher and notifier
+			threads */
+			log_writer_threads_start();
+		}
 	}
 
 	/* Create the SYS_FOREIGN and SYS_FOREIGN_COLS system tables */
@@ -58,6 +58,9 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0rseg.h"
 #include "trx0trx.h"
 
+#include <map>
+#include <vector>
+
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 ulong		srv_max_purge_lag = 0;
 
@@ -273,6 +276,8 @@ trx_purge_sys_create(
 	purge_sys->view_active = true;
 
 	purge_sys->rseg_iter = UT_NEW_NOKEY(TrxUndoRsegsIterator(purge_sys));
+
+	purge_sys->heap = mem_heap_create(UNIV_PAGE_SIZE);
 }
 
 /************************************************************************
@@ -309,6 +314,8 @@ trx_purge_sys_close(void)
 
 	UT_DELETE(purge_sys->rseg_iter);
 
+	mem_heap_free(purge_sys->heap);
+
 	ut_free(purge_sys);
 
 	purge_sys = NULL;
@@ -1665,26 +1672,45 @@ trx_purge_attach_undo_recs(
 	ut_a(i == n_purge_threads);
 
 	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
+	to a per purge node vector. All the records of a table go to the
+	same node, so that the purge threads do not contend for the same
+	index pages and tree latches. A table that is new in the batch
+	goes to the node that has the fewest records so far. */
 	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
 	ut_a(n_thrs > 0 && thr != NULL);
 
 	ut_ad(trx_purge_check_limit());
 
-	i = 0;
+	typedef std::vector<purge_node_t*, ut_allocator<purge_node_t*> >
+		purge_nodes_t;
+	typedef std::map<
+		table_id_t, ulint, std::less<table_id_t>,
+		ut_allocator<std::pair<const table_id_t, ulint> > >
+		table_nodes_t;
 
-	for (;;) {
-		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
+	purge_nodes_t	nodes;
+	table_nodes_t	table_nodes;
+	ulint*		n_recs = static_cast<ulint*>(
+		ut_zalloc_nokey(n_purge_threads * sizeof *n_recs));
 
+	for (i = 0; i < n_purge_threads; ++i) {
 		ut_a(!thr->is_active);
 
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
+		nodes.push_back(static_cast<purge_node_t*>(thr->child));
+		ut_a(que_node_get_type(nodes.back()) == QUE_NODE_PURGE);
+
+		thr = UT_LIST_GET_NEXT(thrs, thr);
+	}
+
+	/* The records of the previous batch have been purged. */
+	mem_heap_empty(purge_sys->heap);
+
+	for (;;) {
+		trx_purge_rec_t*	purge_rec;
+		trx_id_t		trx_no = purge_sys->iter.trx_no;
 
 		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+			mem_heap_zalloc(purge_sys->heap, sizeof(*purge_rec)));
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1695,38 +1721,83 @@ trx_purge_attach_undo_recs(
 
 		/* Fetch the next record, and advance the purge_sys->iter. */
 		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
+			&purge_rec->roll_ptr, &n_pages_handled,
+			purge_sys->heap);
 
-		if (purge_rec->undo_rec != NULL) {
+		if (purge_rec->undo_rec == NULL) {
+			break;
+		}
 
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
+		++purge_sys->n_recs_fetched;
+
+		if (purge_sys->iter.trx_no != trx_no) {
+			++purge_sys->n_logs_fetched;
+		}
+
+		/* Choose the node. */
+		ulint	n = 0;
+
+		if (n_purge_threads > 1) {
+			table_id_t	table_id = 0;
+			bool		has_table
+				= purge_rec->undo_rec != &trx_purge_dummy_rec;
+
+			if (has_table) {
+				ulint		type;
+				ulint		cmpl_info;
+				bool		updated_extern;
+				undo_no_t	undo_no;
+
+				trx_undo_rec_get_pars(
+					purge_rec->undo_rec, &type,
+					&cmpl_info, &updated_extern,
+					&undo_no, &table_id);
 			}
 
-			ib_vector_push(node->undo_recs, purge_rec);
+			table_nodes_t::const_iterator	it = has_table
+				? table_nodes.find(table_id)
+				: table_nodes.end();
 
-			if (n_pages_handled >= batch_size) {
+			if (it != table_nodes.end()) {
+				n = it->second;
+			} else {
+				for (i = 1; i < n_purge_threads; ++i) {
+					if (n_recs[i] < n_recs[n]) {
+						n = i;
+					}
+				}
 
-				break;
+				if (has_table) {
+					table_nodes.insert(
+						table_nodes_t::value_type(
+							table_id, n));
+				}
 			}
-		} else {
-			break;
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		purge_node_t*	node = nodes[n];
+
+		++n_recs[n];
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+		if (node->undo_recs == NULL) {
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
+		} else {
+			ut_a(!ib_vector_is_empty(node->undo_recs));
 		}
 
-		ut_a(thr != NULL);
+		ib_vector_push(node->undo_recs, purge_rec);
+
+		if (n_pages_handled >= batch_size) {
+
+			break;
+		}
 	}
 
+	ut_free(n_recs);
+
 	ut_ad(trx_purge_check_limit());
 
 	return(n_pages_handled);
@@ -1922,6 +1993,103 @@ run_synchronously:
 	return(n_pages_handled);
 }
 
+/*******************************************************************//**
+Update the purge lag monitor counters (purge_lag_records and
+purge_lag_seconds) from the history list length and the progress of
+purge. Invoked by the master thread once a second, also while purge is
+stopped or suspended. */
+void
+trx_purge_update_lag(void)
+/*======================*/
+{
+	const ulint		history_len = trx_sys->rseg_history_len;
+	const ib_time_t		now = ut_time();
+	/* Purge only moves forward, so reading this without the latch
+	can only make the estimate a little too old. */
+	const trx_id_t		purged = purge_sys->iter.trx_no;
+	purge_lag_sample_t*	samples = purge_sys->lag_samples;
+	ulint			n = purge_sys->n_lag_samples;
+
+	/* The samples are in ascending order of both trx_no and time.
+	Binary search for the first sample that purge has not passed. */
+	ulint	low = 0;
+	ulint	high = n;
+
+	while (low < high) {
+		ulint	mid = (low + high) / 2;
+
+		if (samples[mid].trx_no <= purged) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	/* Everything that committed before the latest sample that purge
+	has passed has been purged. The samples before it are no longer
+	needed. */
+	if (low > 1) {
+		n -= low - 1;
+		memmove(samples, samples + low - 1, n * sizeof *samples);
+	}
+
+	/* Take a sample of the transaction number counter, at most once
+	a second. */
+	if (n == 0 || samples[n - 1].time < now) {
+
+		if (n == PURGE_LAG_N_SAMPLES) {
+			/* Remove the sample that leaves the smallest gap
+			between its neighbours, so that the samples keep
+			covering the whole lag with a coarser resolution.
+			The first and the latest sample are always kept. */
+			ulint	victim = 1;
+
+			for (ulint i = 2; i < n - 1; i++) {
+				if (samples[i + 1].time - samples[i - 1].time
+				    < samples[victim + 1].time
+				    - samples[victim - 1].time) {
+
+					victim = i;
+				}
+			}
+
+			n--;
+			memmove(samples + victim, samples + victim + 1,
+				(n - victim) * sizeof *samples);
+		}
+
+		samples[n].trx_no = trx_sys_get_max_trx_id();
+		samples[n].time = now;
+		n++;
+	}
+
+	purge_sys->n_lag_samples = n;
+
+	ulint	lag_records = 0;
+	ulint	lag_seconds = 0;
+
+	if (history_len > 0) {
+		/* The history list counts UNDO logs. Scale it by the
+		average number of records that purge has found in a log. */
+		if (purge_sys->n_logs_fetched > 0) {
+			lag_records = static_cast<ulint>(
+				static_cast<double>(history_len)
+				* purge_sys->n_recs_fetched
+				/ purge_sys->n_logs_fetched);
+		} else {
+			lag_records = history_len;
+		}
+
+		/* The first sample is the latest one that purge has
+		passed. If purge has not passed any sample, the lag is at
+		least as old as the first sample. */
+		lag_seconds = static_cast<ulint>(now - samples[0].time);
+	}
+
+	MONITOR_SET(MONITOR_PURGE_LAG_RECORDS, lag_records);
+	MONITOR_SET(MONITOR_PURGE_LAG_SECONDS, lag_seconds);
+}
+
 /*******************************************************************//**
 Get the purge state.
 @return purge state. */
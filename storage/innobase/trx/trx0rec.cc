@@ -53,6 +53,8 @@ Created 3/26/1996 Heikki Tuuri
 #include "row0row.h"
 #include "fsp0sysspace.h"
 #include "row0mysql.h"
+#include "buf0rea.h"
+#include "srv0mon.h"
 
 /*=========== UNDO LOG RECORD CREATION AND DECODING ====================*/
 
@@ -2133,6 +2135,36 @@ trx_undo_get_undo_rec_low(
 	return(undo_rec);
 }
 
+/** Read ahead the undo log pages that precede the page of an undo log
+record, if that page is not in the buffer pool.
+@param[in]	roll_ptr	roll pointer to the record
+@param[in]	is_redo_rseg	true if redo rseg */
+static
+void
+trx_undo_read_ahead(
+	roll_ptr_t	roll_ptr,
+	bool		is_redo_rseg)
+{
+	ulint		rseg_id;
+	ulint		page_no;
+	ulint		offset;
+	ibool		is_insert;
+
+	trx_undo_decode_roll_ptr(roll_ptr, &is_insert, &rseg_id, &page_no,
+				 &offset);
+
+	const trx_rseg_t*	rseg = trx_rseg_get_on_id(
+		rseg_id, is_redo_rseg);
+	const page_id_t		page_id(rseg->space, page_no);
+
+	if (!buf_page_peek(page_id)) {
+		ulint	n_pages = buf_read_ahead_undo(
+			page_id, rseg->page_size, srv_undo_read_ahead);
+
+		MONITOR_INC_VALUE(MONITOR_TRX_UNDO_READ_AHEAD, n_pages);
+	}
+}
+
 /******************************************************************//**
 Copies an undo record to heap.
 @param[in]	roll_ptr	roll pointer to record
@@ -2164,6 +2196,10 @@ trx_undo_get_undo_rec(
 
 	missing_history = purge_sys->view.changes_visible(trx_id, name);
 	if (!missing_history) {
+		if (srv_undo_read_ahead > 0) {
+			trx_undo_read_ahead(roll_ptr, is_redo_rseg);
+		}
+
 		*undo_rec = trx_undo_get_undo_rec_low(
 			roll_ptr, heap, is_redo_rseg);
 	}
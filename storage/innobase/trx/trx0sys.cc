@@ -539,6 +539,174 @@ trx_sys_init_at_db_start(void)
 	return(purge_queue);
 }
 
+/** Constructor */
+TrxIdRegistry::TrxIdRegistry()
+	:
+	m_version(),
+	m_n_overflow(),
+	m_n_active()
+{
+	m_slots = UT_NEW_ARRAY_NOKEY(trx_id_t, N_SHARDS * N_SLOTS);
+
+	memset(m_slots, 0x0, N_SHARDS * N_SLOTS * sizeof(*m_slots));
+
+	for (ulint i = 0; i < N_SHARDS; ++i) {
+		m_shards[i].n_used = 0;
+		m_shards[i].slots = m_slots + i * N_SLOTS;
+	}
+}
+
+/** Destructor */
+TrxIdRegistry::~TrxIdRegistry()
+{
+	UT_DELETE_ARRAY(m_slots);
+}
+
+/** Add an active transaction id. The caller must make the id visible
+to readers (advance trx_sys_t::max_trx_id past it) only after this.
+@param[in]	id	transaction id, must be > 0 */
+void
+TrxIdRegistry::insert(trx_id_t id)
+{
+	ut_ad(id > 0);
+
+	++m_n_active;
+
+	/* Consecutive ids go to different shards. If the home shard
+	is full, try the following ones. */
+	for (ulint i = 0; i < N_SHARDS; ++i) {
+		shard_t*	shard = &m_shards[(id + i) % N_SHARDS];
+		ulint		n_used = shard->n_used;
+
+		for (ulint j = 0; j < n_used; ++j) {
+			if (shard->slots[j] == 0) {
+				shard->slots[j] = id;
+				return;
+			}
+		}
+
+		if (n_used < N_SLOTS) {
+			shard->slots[n_used] = id;
+
+			/* Readers must not see n_used cover the slot
+			before the id is in it. */
+			os_wmb;
+
+			shard->n_used = n_used + 1;
+			return;
+		}
+	}
+
+	++m_n_overflow;
+}
+
+/** Remove a transaction id that was added by insert().
+@param[in]	id	transaction id */
+void
+TrxIdRegistry::erase(trx_id_t id)
+{
+	ut_ad(id > 0);
+	ut_ad(m_n_active > 0);
+
+	++m_version;
+	os_wmb;
+
+	--m_n_active;
+
+	for (ulint i = 0; i < N_SHARDS; ++i) {
+		shard_t*	shard = &m_shards[(id + i) % N_SHARDS];
+		ulint		n_used = shard->n_used;
+
+		for (ulint j = 0; j < n_used; ++j) {
+
+			if (shard->slots[j] != id) {
+				continue;
+			}
+
+			shard->slots[j] = 0;
+
+			while (n_used > 0 && shard->slots[n_used - 1] == 0) {
+				--n_used;
+			}
+
+			shard->n_used = n_used;
+
+			os_wmb;
+			++m_version;
+			return;
+		}
+	}
+
+	/* The id did not fit into the slots when it was inserted. */
+	ut_ad(m_n_overflow > 0);
+	--m_n_overflow;
+
+	os_wmb;
+	++m_version;
+}
+
+/** Start a lock-free read.
+@return the version to pass to read_validate(), or ULINT_UNDEFINED if
+an erase() is in progress */
+ulint
+TrxIdRegistry::read_begin() const
+{
+	ulint	version = m_version;
+
+	os_rmb;
+
+	return((version & 1) ? ULINT_UNDEFINED : version);
+}
+
+/** Check that no erase() was started since read_begin().
+@param[in]	version	value returned by read_begin()
+@return true if the ids copied since read_begin() are consistent */
+bool
+TrxIdRegistry::read_validate(ulint version) const
+{
+	os_rmb;
+
+	return(m_version == version);
+}
+
+/** Copy the active transaction ids less than limit, in no particular
+order. Must be called between read_begin() and read_validate().
+@param[out]	ids	array of n_max elements
+@param[in]	n_max	size of ids
+@param[in]	limit	copy only the ids < limit
+@param[in]	skip	id not to copy, 0 if none
+@return number of ids copied, or ULINT_UNDEFINED if ids is too small */
+ulint
+TrxIdRegistry::copy(
+	trx_id_t*	ids,
+	ulint		n_max,
+	trx_id_t	limit,
+	trx_id_t	skip) const
+{
+	ulint	n = 0;
+
+	for (ulint i = 0; i < N_SHARDS; ++i) {
+		const shard_t*	shard = &m_shards[i];
+		ulint		n_used = shard->n_used;
+
+		os_rmb;
+
+		for (ulint j = 0; j < n_used; ++j) {
+			trx_id_t	id = shard->slots[j];
+
+			if (id == 0 || id >= limit || id == skip) {
+				continue;
+			} else if (n == n_max) {
+				return(ULINT_UNDEFINED);
+			}
+
+			ids[n++] = id;
+		}
+	}
+
+	return(n);
+}
+
 /*****************************************************************//**
 Creates the trx_sys instance and initializes purge_queue and mutex. */
 void
@@ -560,7 +728,17 @@ trx_sys_create(void)
 	new(&trx_sys->rw_trx_ids) trx_ids_t(ut_allocator<trx_id_t>(
 			mem_key_trx_sys_t_rw_trx_ids));
 
-	new(&trx_sys->rw_trx_set) TrxIdSet();
+	for (ulint i = 0; i < TRX_SYS_N_SHARDS; ++i) {
+		trx_sys_shard_t*	shard = &trx_sys->rw_trx_shards[i];
+
+		mutex_create(LATCH_ID_TRX_SYS_SHARD, &shard->mutex);
+
+		new(&shard->rw_trx_set) TrxIdSet();
+	}
+
+	new(&trx_sys->rw_trx_active) TrxIdRegistry();
+
+	trx_sys->serialisation_min_no = TRX_ID_MAX;
 }
 
 /*****************************************************************//**
@@ -1230,7 +1408,15 @@ trx_sys_close(void)
 
 	trx_sys->rw_trx_ids.~trx_ids_t();
 
-	trx_sys->rw_trx_set.~TrxIdSet();
+	for (ulint i = 0; i < TRX_SYS_N_SHARDS; ++i) {
+		trx_sys_shard_t*	shard = &trx_sys->rw_trx_shards[i];
+
+		shard->rw_trx_set.~TrxIdSet();
+
+		mutex_free(&shard->mutex);
+	}
+
+	trx_sys->rw_trx_active.~TrxIdRegistry();
 
 	ut_free(trx_sys);
 
@@ -149,6 +149,8 @@ trx_init(
 
 	trx->lock.n_rec_locks = 0;
 
+	trx->lock.schedule_weight = 0;
+
 	trx->dict_operation = TRX_DICT_OP_NONE;
 
 	trx->table_id = 0;
@@ -1049,13 +1051,9 @@ trx_lists_init_at_db_start(void)
 		     undo != NULL;
 		     undo = UT_LIST_GET_NEXT(undo_list, undo)) {
 
-			/* Check the trx_sys->rw_trx_set first. */
-			trx_sys_mutex_enter();
-
+			/* Check the trx_sys->rw_trx_shards first. */
 			trx_t*	trx = trx_get_rw_trx_by_id(undo->trx_id);
 
-			trx_sys_mutex_exit();
-
 			if (trx == NULL) {
 				trx = trx_allocate_for_background();
 
@@ -1072,9 +1070,22 @@ trx_lists_init_at_db_start(void)
 		}
 	}
 
-	TrxIdSet::iterator	end = trx_sys->rw_trx_set.end();
+	/* Merge the shards in the order of the transaction ids. */
+	typedef std::vector<TrxTrack, ut_allocator<TrxTrack> >	trx_tracks_t;
+
+	trx_tracks_t	rw_trxs;
+
+	for (ulint i = 0; i < TRX_SYS_N_SHARDS; ++i) {
+		const TrxIdSet&	set = trx_sys->rw_trx_shards[i].rw_trx_set;
+
+		rw_trxs.insert(rw_trxs.end(), set.begin(), set.end());
+	}
 
-	for (TrxIdSet::iterator it = trx_sys->rw_trx_set.begin();
+	std::sort(rw_trxs.begin(), rw_trxs.end(), TrxTrackCmp());
+
+	trx_tracks_t::const_iterator	end = rw_trxs.end();
+
+	for (trx_tracks_t::const_iterator it = rw_trxs.begin();
 	     it != end;
 	     ++it) {
 
@@ -1089,10 +1100,16 @@ trx_lists_init_at_db_start(void)
 		    || it->m_trx->state == TRX_STATE_PREPARED) {
 
 			trx_sys->rw_trx_ids.push_back(it->m_id);
+
+			trx_sys->rw_trx_active.insert(it->m_id);
 		}
 
 		UT_LIST_ADD_FIRST(trx_sys->rw_trx_list, it->m_trx);
 	}
+
+	if (!trx_sys->rw_trx_ids.empty()) {
+		trx_sys->rw_trx_min_id = trx_sys->rw_trx_ids.front();
+	}
 }
 
 /******************************************************************//**
@@ -1313,13 +1330,11 @@ trx_assign_rseg(
 	if (trx->id == 0) {
 		mutex_enter(&trx_sys->mutex);
 
-		trx->id = trx_sys_get_new_trx_id();
-
-		trx_sys->rw_trx_ids.push_back(trx->id);
-
-		trx_sys->rw_trx_set.insert(TrxTrack(trx->id, trx));
+		trx->id = trx_sys_get_new_rw_trx_id();
 
 		mutex_exit(&trx_sys->mutex);
+
+		trx_sys_rw_trx_set_insert(trx);
 	}
 }
 
@@ -1412,11 +1427,7 @@ trx_start_low(
 
 		trx_sys_mutex_enter();
 
-		trx->id = trx_sys_get_new_trx_id();
-
-		trx_sys->rw_trx_ids.push_back(trx->id);
-
-		trx_sys_rw_trx_add(trx);
+		trx->id = trx_sys_get_new_rw_trx_id();
 
 		ut_ad(trx->rsegs.m_redo.rseg != 0
 		      || srv_read_only_mode
@@ -1437,6 +1448,10 @@ trx_start_low(
 
 		trx_sys_mutex_exit();
 
+		/* Nothing can carry the id of the transaction yet, so it
+		need not be found by trx_rw_is_active() before this. */
+		trx_sys_rw_trx_set_insert(trx);
+
 	} else {
 		trx->id = 0;
 
@@ -1452,14 +1467,11 @@ trx_start_low(
 
 				ut_ad(!srv_read_only_mode);
 
-				trx->id = trx_sys_get_new_trx_id();
-
-				trx_sys->rw_trx_ids.push_back(trx->id);
-
-				trx_sys->rw_trx_set.insert(
-					TrxTrack(trx->id, trx));
+				trx->id = trx_sys_get_new_rw_trx_id();
 
 				trx_sys_mutex_exit();
+
+				trx_sys_rw_trx_set_insert(trx);
 			}
 
 			trx->state = TRX_STATE_ACTIVE;
@@ -1512,6 +1524,16 @@ trx_serialisation_number_get(
 
 	trx_sys_mutex_enter();
 
+	if (!trx->read_only
+	    && UT_LIST_GET_LEN(trx_sys->serialisation_list) == 0) {
+
+		/* Publish the minimum serialisation number before
+		max_trx_id is advanced past it, see ReadView::prepare(). */
+		trx_sys->serialisation_min_no = trx_sys->max_trx_id;
+
+		os_wmb;
+	}
+
 	trx->no = trx_sys_get_new_trx_id();
 
 	/* Track the minimum serialisation number. */
@@ -1879,10 +1901,6 @@ trx_erase_lists(
 	ut_ad(trx->id > 0);
 	trx_sys_mutex_enter();
 
-	if (serialised) {
-		UT_LIST_REMOVE(trx_sys->serialisation_list, trx);
-	}
-
 	trx_ids_t::iterator	it = std::lower_bound(
 		trx_sys->rw_trx_ids.begin(),
 		trx_sys->rw_trx_ids.end(),
@@ -1890,7 +1908,29 @@ trx_erase_lists(
 	ut_ad(*it == trx->id);
 	trx_sys->rw_trx_ids.erase(it);
 
-	if (trx->read_only || trx->rsegs.m_redo.rseg == NULL) {
+	trx_sys->rw_trx_min_id = trx_sys->rw_trx_ids.empty()
+		? 0 : trx_sys->rw_trx_ids.front();
+
+	trx_sys->rw_trx_active.erase(trx->id);
+
+	if (serialised) {
+		/* The minimum serialisation number may only grow after
+		the id is no longer active, see ReadView::prepare(). */
+		os_wmb;
+
+		UT_LIST_REMOVE(trx_sys->serialisation_list, trx);
+
+		const trx_t*	first = UT_LIST_GET_FIRST(
+			trx_sys->serialisation_list);
+
+		trx_sys->serialisation_min_no = first != NULL
+			? first->no : TRX_ID_MAX;
+	}
+
+	const bool	is_rw = !trx->read_only
+		&& trx->rsegs.m_redo.rseg != NULL;
+
+	if (!is_rw) {
 
 		ut_ad(!trx->in_rw_trx_list);
 	} else {
@@ -1898,15 +1938,17 @@ trx_erase_lists(
 		UT_LIST_REMOVE(trx_sys->rw_trx_list, trx);
 		ut_d(trx->in_rw_trx_list = false);
 		ut_ad(trx_sys_validate_trx_list());
-
-		if (trx->read_view != NULL) {
-			trx_sys->mvcc->view_close(trx->read_view, true);
-		}
 	}
 
-	trx_sys->rw_trx_set.erase(TrxTrack(trx->id));
-
 	trx_sys_mutex_exit();
+
+	/* The view and the shard of the rw_trx_set are protected by
+	their own mutexes. */
+	if (is_rw && trx->read_view != NULL) {
+		trx_sys->mvcc->view_close(trx->read_view, true);
+	}
+
+	trx_sys_rw_trx_set_erase(trx);
 }
 
 /****************************************************************//**
@@ -3244,11 +3286,7 @@ trx_set_rw_mode(
 	mutex_enter(&trx_sys->mutex);
 
 	ut_ad(trx->id == 0);
-	trx->id = trx_sys_get_new_trx_id();
-
-	trx_sys->rw_trx_ids.push_back(trx->id);
-
-	trx_sys->rw_trx_set.insert(TrxTrack(trx->id, trx));
+	trx->id = trx_sys_get_new_rw_trx_id();
 
 	/* So that we can see our own changes. */
 	if (MVCC::is_view_active(trx->read_view)) {
@@ -3266,6 +3304,8 @@ trx_set_rw_mode(
 	ut_d(trx->in_rw_trx_list = true);
 
 	mutex_exit(&trx_sys->mutex);
+
+	trx_sys_rw_trx_set_insert(trx);
 }
 
 /**
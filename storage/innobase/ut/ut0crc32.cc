@@ -104,6 +104,13 @@ ut_crc32_func_t	ut_crc32_legacy_big_endian;
 but very slow). */
 ut_crc32_func_t	ut_crc32_byte_by_byte;
 
+/** Pointer to CRC32 calculation function that processes the input as one
+sequential stream. */
+ut_crc32_func_t	ut_crc32_serial;
+
+/** Pointer to the function that calculates CRC32 of several buffers. */
+ut_crc32_batch_func_t	ut_crc32_batch;
+
 /** Swap the byte order of an 8 byte integer.
 @param[in]	i	8-byte integer
 @return 8-byte integer */
@@ -127,7 +134,62 @@ ut_crc32_swap_byteorder(
 /* Flag that tells whether the CPU supports CRC32 or not */
 bool	ut_crc32_sse2_enabled = false;
 
+/* Flag that tells whether the CPU supports carry-less multiplication
+(PCLMULQDQ) or not */
+bool	ut_crc32_pclmul_enabled = false;
+
 #if defined(__GNUC__) && defined(__x86_64__)
+/** Number of bytes in each of the three streams of a long round of
+ut_crc32_hw() */
+static const ulint	UT_CRC32_LONG_STREAM = 1024;
+
+/** Number of bytes in each of the three streams of a short round of
+ut_crc32_hw() */
+static const ulint	UT_CRC32_SHORT_STREAM = 128;
+
+/** Constants for folding the three streams of a long round:
+x^(2 * 8 * UT_CRC32_LONG_STREAM - 33) and x^(8 * UT_CRC32_LONG_STREAM - 33)
+modulo the CRC-32C polynomial, bit-reflected */
+static uint32_t		ut_crc32_long_k[2];
+
+/** Constants for folding the three streams of a short round */
+static uint32_t		ut_crc32_short_k[2];
+
+/** Calculate x^n modulo the CRC-32C polynomial.
+@param[in]	n	exponent
+@return x^n mod P, bit-reflected like the CRC32 state */
+static
+uint32_t
+ut_crc32_x_pow_n(
+	ulint	n)
+{
+	/* In the bit-reflected representation, bit 31 is x^0 and
+	multiplying by x is a right shift. */
+	uint32_t	r = 0x80000000U;
+
+	while (n-- > 0) {
+		r = (r >> 1) ^ ((r & 1) ? 0x82F63B78U : 0);
+	}
+
+	return(r);
+}
+
+/** Initialize the constants for folding interleaved CRC32 streams. */
+static
+void
+ut_crc32_fold_init()
+{
+	/* The product of carry-less multiplication of two bit-reflected
+	values is shifted by one bit, and the crc32 instruction that
+	reduces it multiplies by x^32: hence the 33. */
+	ut_crc32_long_k[0] = ut_crc32_x_pow_n(
+		2 * 8 * UT_CRC32_LONG_STREAM - 33);
+	ut_crc32_long_k[1] = ut_crc32_x_pow_n(8 * UT_CRC32_LONG_STREAM - 33);
+	ut_crc32_short_k[0] = ut_crc32_x_pow_n(
+		2 * 8 * UT_CRC32_SHORT_STREAM - 33);
+	ut_crc32_short_k[1] = ut_crc32_x_pow_n(8 * UT_CRC32_SHORT_STREAM - 33);
+}
+
 /********************************************************************//**
 Fetches CPU info */
 static
@@ -265,7 +327,83 @@ ut_crc32_64_legacy_big_endian_hw(
 	*len -= 8;
 }
 
-/** Calculates CRC32 using hardware/CPU instructions.
+/** Carry-less multiplication of two 32-bit values using a hardware/CPU
+instruction.
+@param[in]	a	first factor
+@param[in]	b	second factor
+@return 64-bit product */
+inline
+uint64_t
+ut_crc32_clmul_hw(
+	uint32_t	a,
+	uint32_t	b)
+{
+	typedef long long	v2di __attribute__((vector_size(16)));
+
+	v2di	x = { static_cast<long long>(a), 0 };
+	v2di	y = { static_cast<long long>(b), 0 };
+
+	asm("pclmulqdq $0x00, %1, %0"
+	    /* output operands */
+	    : "+x" (x)
+	    /* input operands */
+	    : "x" (y));
+
+	return(static_cast<uint64_t>(x[0]));
+}
+
+/** Calculate CRC32 over 3 * stream_len bytes as three interleaved streams
+using hardware/CPU instructions. The crc32 instruction has a latency of
+three cycles but a throughput of one per cycle, so three independent
+streams keep it busy. The checksums of the first two streams are then
+shifted over the rest of the data by carry-less multiplication and folded
+into the last word of the third stream.
+@param[in,out]	crc		crc32 checksum so far when this function is
+called, when the function ends it will contain the new checksum
+@param[in,out]	data		data to be checksummed, 8-byte aligned; the
+pointer will be advanced with 3 * stream_len bytes
+@param[in,out]	len		remaining bytes, it will be decremented with
+3 * stream_len
+@param[in]	stream_len	bytes per stream, a multiple of 8
+@param[in]	k		folding constants for stream_len */
+inline
+void
+ut_crc32_3way_hw(
+	uint32_t*	crc,
+	const byte**	data,
+	ulint*		len,
+	ulint		stream_len,
+	const uint32_t*	k)
+{
+	const uint64_t*	a = reinterpret_cast<const uint64_t*>(*data);
+	const uint64_t*	b = a + stream_len / 8;
+	const uint64_t*	c = b + stream_len / 8;
+	const ulint	n = stream_len / 8 - 1;
+	uint32_t	crc_a = *crc;
+	uint32_t	crc_b = 0;
+	uint32_t	crc_c = 0;
+
+	for (ulint i = 0; i < n; i++) {
+		crc_a = ut_crc32_64_low_hw(crc_a, a[i]);
+		crc_b = ut_crc32_64_low_hw(crc_b, b[i]);
+		crc_c = ut_crc32_64_low_hw(crc_c, c[i]);
+	}
+
+	crc_a = ut_crc32_64_low_hw(crc_a, a[n]);
+	crc_b = ut_crc32_64_low_hw(crc_b, b[n]);
+
+	*crc = ut_crc32_64_low_hw(
+		crc_c,
+		c[n]
+		^ ut_crc32_clmul_hw(crc_a, k[0])
+		^ ut_crc32_clmul_hw(crc_b, k[1]));
+
+	*data += 3 * stream_len;
+	*len -= 3 * stream_len;
+}
+
+/** Calculates CRC32 using hardware/CPU instructions, processing three
+interleaved streams at a time. Requires PCLMULQDQ.
 @param[in]	buf	data over which to calculate CRC32
 @param[in]	len	data length
 @return CRC-32C (polynomial 0x11EDC6F41) */
@@ -276,6 +414,48 @@ ut_crc32_hw(
 {
 	uint32_t	crc = 0xFFFFFFFFU;
 
+	ut_a(ut_crc32_sse2_enabled);
+	ut_ad(ut_crc32_pclmul_enabled);
+
+	/* Calculate byte-by-byte up to an 8-byte aligned address. After
+	this consume the input 8-bytes at a time. */
+	while (len > 0 && (reinterpret_cast<uintptr_t>(buf) & 7) != 0) {
+		ut_crc32_8_hw(&crc, &buf, &len);
+	}
+
+	while (len >= 3 * UT_CRC32_LONG_STREAM) {
+		ut_crc32_3way_hw(&crc, &buf, &len,
+				 UT_CRC32_LONG_STREAM, ut_crc32_long_k);
+	}
+
+	while (len >= 3 * UT_CRC32_SHORT_STREAM) {
+		ut_crc32_3way_hw(&crc, &buf, &len,
+				 UT_CRC32_SHORT_STREAM, ut_crc32_short_k);
+	}
+
+	while (len >= 8) {
+		ut_crc32_64_hw(&crc, &buf, &len);
+	}
+
+	while (len > 0) {
+		ut_crc32_8_hw(&crc, &buf, &len);
+	}
+
+	return(~crc);
+}
+
+/** Calculates CRC32 using hardware/CPU instructions, as one sequential
+stream.
+@param[in]	buf	data over which to calculate CRC32
+@param[in]	len	data length
+@return CRC-32C (polynomial 0x11EDC6F41) */
+uint32_t
+ut_crc32_serial_hw(
+	const byte*	buf,
+	ulint		len)
+{
+	uint32_t	crc = 0xFFFFFFFFU;
+
 	ut_a(ut_crc32_sse2_enabled);
 
 	/* Calculate byte-by-byte up to an 8-byte aligned address. After
@@ -427,6 +607,81 @@ ut_crc32_byte_by_byte_hw(
 
 	return(~crc);
 }
+
+/** Calculates CRC32 of several buffers of the same length using
+hardware/CPU instructions. Three buffers are processed at a time, with
+their crc32 instructions interleaved like in ut_crc32_3way_hw(), but
+without the need to fold the results.
+@param[in]	bufs	buffers over which to calculate CRC32
+@param[in]	n	number of buffers
+@param[in]	len	length of each buffer
+@param[out]	crcs	CRC-32C of each buffer */
+void
+ut_crc32_batch_hw(
+	const byte* const*	bufs,
+	ulint			n,
+	ulint			len,
+	uint32_t*		crcs)
+{
+	ulint	i = 0;
+
+	ut_a(ut_crc32_sse2_enabled);
+
+	for (; i + 3 <= n; i += 3) {
+		const byte*	a = bufs[i];
+		const byte*	b = bufs[i + 1];
+		const byte*	c = bufs[i + 2];
+		uint32_t	crc_a = 0xFFFFFFFFU;
+		uint32_t	crc_b = 0xFFFFFFFFU;
+		uint32_t	crc_c = 0xFFFFFFFFU;
+		ulint		len_a = len;
+		ulint		len_b = len;
+		ulint		len_c = len;
+
+		/* The buffers are usually equally aligned, so aligning
+		the first one is enough for the common case. */
+		while (len_a > 0 && (reinterpret_cast<uintptr_t>(a) & 7) != 0) {
+			ut_crc32_8_hw(&crc_a, &a, &len_a);
+			ut_crc32_8_hw(&crc_b, &b, &len_b);
+			ut_crc32_8_hw(&crc_c, &c, &len_c);
+		}
+
+		const ulint	n_words = len_a / 8;
+
+		for (ulint j = 0; j < n_words; j++) {
+			uint64_t	word_a;
+			uint64_t	word_b;
+			uint64_t	word_c;
+
+			memcpy(&word_a, a + 8 * j, 8);
+			memcpy(&word_b, b + 8 * j, 8);
+			memcpy(&word_c, c + 8 * j, 8);
+
+			crc_a = ut_crc32_64_low_hw(crc_a, word_a);
+			crc_b = ut_crc32_64_low_hw(crc_b, word_b);
+			crc_c = ut_crc32_64_low_hw(crc_c, word_c);
+		}
+
+		a += 8 * n_words;
+		b += 8 * n_words;
+		c += 8 * n_words;
+		len_a = len_b = len_c = len_a - 8 * n_words;
+
+		while (len_a > 0) {
+			ut_crc32_8_hw(&crc_a, &a, &len_a);
+			ut_crc32_8_hw(&crc_b, &b, &len_b);
+			ut_crc32_8_hw(&crc_c, &c, &len_c);
+		}
+
+		crcs[i] = ~crc_a;
+		crcs[i + 1] = ~crc_b;
+		crcs[i + 2] = ~crc_c;
+	}
+
+	for (; i < n; i++) {
+		crcs[i] = ut_crc32(bufs[i], len);
+	}
+}
 #endif /* defined(__GNUC__) && defined(__x86_64__) */
 
 /* CRC32 software implementation. */
@@ -689,6 +944,24 @@ ut_crc32_byte_by_byte_sw(
 	return(~crc);
 }
 
+/** Calculates CRC32 of several buffers of the same length in software,
+without using CPU instructions.
+@param[in]	bufs	buffers over which to calculate CRC32
+@param[in]	n	number of buffers
+@param[in]	len	length of each buffer
+@param[out]	crcs	CRC-32C of each buffer */
+void
+ut_crc32_batch_sw(
+	const byte* const*	bufs,
+	ulint			n,
+	ulint			len,
+	uint32_t*		crcs)
+{
+	for (ulint i = 0; i < n; i++) {
+		crcs[i] = ut_crc32_sw(bufs[i], len);
+	}
+}
+
 /********************************************************************//**
 Initializes the data structures used by ut_crc32*(). Does not do any
 allocations, would not hurt if called twice, but would be pointless. */
@@ -725,12 +998,18 @@ ut_crc32_init()
 	*/
 #ifndef UNIV_DEBUG_VALGRIND
 	ut_crc32_sse2_enabled = (features_ecx >> 20) & 1;
+	ut_crc32_pclmul_enabled = (features_ecx >> 1) & 1;
 #endif /* UNIV_DEBUG_VALGRIND */
 
 	if (ut_crc32_sse2_enabled) {
-		ut_crc32 = ut_crc32_hw;
+		ut_crc32_fold_init();
+
+		ut_crc32 = ut_crc32_pclmul_enabled
+			? ut_crc32_hw : ut_crc32_serial_hw;
 		ut_crc32_legacy_big_endian = ut_crc32_legacy_big_endian_hw;
 		ut_crc32_byte_by_byte = ut_crc32_byte_by_byte_hw;
+		ut_crc32_serial = ut_crc32_serial_hw;
+		ut_crc32_batch = ut_crc32_batch_hw;
 	}
 
 #endif /* defined(__GNUC__) && defined(__x86_64__) */
@@ -740,5 +1019,7 @@ ut_crc32_init()
 		ut_crc32 = ut_crc32_sw;
 		ut_crc32_legacy_big_endian = ut_crc32_legacy_big_endian_sw;
 		ut_crc32_byte_by_byte = ut_crc32_byte_by_byte_sw;
+		ut_crc32_serial = ut_crc32_sw;
+		ut_crc32_batch = ut_crc32_batch_sw;
 	}
 }
@@ -0,0 +1,486 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "btr0sea.h"
+#include "buf0buf.h"
+#include "ha0ha.h"
+#include "os0event.h"
+#include "srv0srv.h"
+#include "sync0sync.h"
+
+namespace innodb_btr0sea_unittest {
+
+/* Tests of the adaptive hash index lookups that do not acquire the
+partition latch, see btr_search_lookup_lock_free(). They run on a real
+buffer pool and adaptive hash index with a single partition.
+
+One test checks that heap blocks are not freed while a lookup is
+registered with btr_search_reader_enter().
+
+The stress test lets a writer insert and delete all the fold values over
+and over, so that the heap of hash nodes grows and shrinks and its blocks
+are returned to the buffer pool. A scribbler thread keeps allocating free
+blocks and overwriting them, so that a lookup that followed a node into a
+freed block would crash or return a wrong record. Readers check every
+validated lookup against the record that the writer maps the fold to.
+
+The disabled benchmark compares lookups under the S-latch of the
+partition with lookups that do not acquire it. Run it with
+--gtest_also_run_disabled_tests. */
+
+/** Number of different fold values */
+static const ulint	N_FOLDS = 16384;
+
+/** Number of hash table cells */
+static const ulint	HASH_SIZE = 8192;
+
+/** Number of buffer pool pages that the hash nodes point to */
+static const ulint	N_PAGES = 16;
+
+/** Number of fold values inserted or deleted per partition X-latch */
+static const ulint	BATCH = 256;
+
+/** Number of reading threads */
+static const ulint	N_READERS = 4;
+
+/** Number of times the writer inserts and deletes all fold values */
+static const ulint	N_ROUNDS = 50;
+
+/** Number of lookups per thread in the benchmark. Increase for actual
+benchmarking! */
+static const ulint	N_LOOKUPS = 2000000;
+
+/** Size of the buffer pool */
+static const ulint	BUF_POOL_SIZE = 32 * 1024 * 1024;
+
+class btr0sea : public ::testing::Test {
+protected:
+	static
+	void
+	SetUpTestCase()
+	{
+		/* The threads wait for the partition latch. */
+		srv_max_n_threads = srv_sync_array_size * 32;
+		os_event_global_init();
+		sync_check_init();
+
+		srv_buf_pool_instances = 1;
+		srv_buf_pool_chunk_unit = BUF_POOL_SIZE;
+		srv_buf_pool_size = BUF_POOL_SIZE;
+		srv_buf_pool_curr_size = BUF_POOL_SIZE;
+		ASSERT_EQ(DB_SUCCESS, buf_pool_init(BUF_POOL_SIZE, 1));
+
+		btr_ahi_parts = 1;
+		btr_search_sys_create(HASH_SIZE);
+
+		for (ulint i = 0; i < N_PAGES; i++) {
+			s_pages[i] = buf_block_alloc(NULL);
+		}
+	}
+
+	static
+	void
+	TearDownTestCase()
+	{
+		for (ulint i = 0; i < N_PAGES; i++) {
+			buf_block_free(s_pages[i]);
+		}
+
+		btr_search_sys_free();
+		buf_pool_free(1);
+
+		sync_check_close();
+		os_event_global_destroy();
+	}
+
+public:
+	/** @return the hash table of the only partition */
+	static
+	hash_table_t*
+	table()
+	{
+		return(btr_search_sys->hash_tables[0]);
+	}
+
+	/** Get the page that a fold value is mapped to.
+	@param[in]	fold	fold value
+	@return the page */
+	static
+	buf_block_t*
+	page(ulint fold)
+	{
+		return(s_pages[fold % N_PAGES]);
+	}
+
+	/** Get the record that a fold value is mapped to.
+	@param[in]	fold	fold value
+	@return the record, within page(fold) */
+	static
+	const rec_t*
+	rec(ulint fold)
+	{
+		return(page(fold)->frame
+		       + 8 * (fold / N_PAGES % (UNIV_PAGE_SIZE / 8)));
+	}
+
+	/** Insert fold values into the hash table, like
+	btr_search_build_page_hash_index(). At most one heap block is
+	added, so n must not exceed BATCH.
+	@param[in]	first	first fold value
+	@param[in]	n	number of fold values */
+	static
+	void
+	insert(ulint first, ulint n)
+	{
+		mem_heap_t*	heap = table()->heap;
+
+		/* See btr_search_check_free_space_in_heap() */
+		if (heap->free_block == NULL) {
+			buf_block_t*	block = buf_block_alloc(NULL);
+
+			btr_search_part_x_lock(0);
+
+			if (heap->free_block == NULL) {
+				heap->free_block = block;
+			} else {
+				buf_block_free(block);
+			}
+
+			btr_search_part_x_unlock(0);
+		}
+
+		btr_search_part_x_lock(0);
+
+		for (ulint fold = first; fold < first + n; fold++) {
+			ha_insert_for_fold(table(), fold, page(fold),
+					   rec(fold));
+		}
+
+		btr_search_part_x_unlock(0);
+	}
+
+	/** Delete fold values from the hash table, like
+	btr_search_drop_page_hash_index().
+	@param[in]	first	first fold value
+	@param[in]	n	number of fold values */
+	static
+	void
+	remove(ulint first, ulint n)
+	{
+		btr_search_part_x_lock(0);
+
+		for (ulint fold = first; fold < first + n; fold++) {
+			ha_search_and_delete_if_found(table(), fold, rec(fold));
+		}
+
+		btr_search_part_x_unlock(0);
+	}
+
+private:
+	/** The pages that the hash nodes point to */
+	static buf_block_t*	s_pages[N_PAGES];
+};
+
+buf_block_t*	btr0sea::s_pages[N_PAGES];
+
+/** Set when the threads of a test should stop */
+static volatile bool	stop;
+
+/** Thread that inserts and deletes all the fold values N_ROUNDS times */
+class WriterThread : public thread::Thread {
+protected:
+	virtual void run()
+	{
+		for (ulint i = 0; i < N_ROUNDS; i++) {
+			for (ulint fold = 0; fold < N_FOLDS; fold += BATCH) {
+				btr0sea::insert(fold, BATCH);
+			}
+
+			/* Delete in a different order than inserted, so
+			that the compaction moves nodes around. */
+			for (ulint j = 0; j < N_FOLDS / BATCH; j++) {
+				btr0sea::remove(
+					(j * 7 % (N_FOLDS / BATCH)) * BATCH,
+					BATCH);
+			}
+		}
+
+		stop = true;
+	}
+};
+
+/** Thread that overwrites the free blocks of the buffer pool */
+class ScribblerThread : public thread::Thread {
+protected:
+	virtual void run()
+	{
+		while (!stop) {
+			buf_block_t*	block = buf_block_alloc(NULL);
+
+			memset(block->frame, 0xA5, UNIV_PAGE_SIZE);
+
+			buf_block_free(block);
+		}
+	}
+};
+
+/** Thread that looks up random fold values without the partition latch */
+class ReaderThread : public thread::Thread {
+public:
+	ReaderThread(ulint seed, bool lock_free, ulint n_lookups)
+		:
+		m_rnd(seed),
+		m_lock_free(lock_free),
+		m_n_lookups(n_lookups),
+		m_n_hits(0),
+		m_n_misses(0),
+		m_n_retries(0)
+	{}
+
+	ulint	n_hits() const { return(m_n_hits); }
+	ulint	n_misses() const { return(m_n_misses); }
+	ulint	n_retries() const { return(m_n_retries); }
+
+protected:
+	virtual void run()
+	{
+		for (ulint i = 0; m_n_lookups > 0 ? i < m_n_lookups : !stop;
+		     i++) {
+
+			m_rnd = m_rnd * 1103515245 + 12345;
+
+			const ulint	fold = (m_rnd >> 16) % N_FOLDS;
+
+			if (m_lock_free) {
+				lookup_lock_free(fold);
+			} else {
+				lookup_latched(fold);
+			}
+		}
+	}
+
+private:
+	/** Look up a fold value like btr_search_guess_lock_free().
+	@param[in]	fold	fold value */
+	void lookup_lock_free(ulint fold)
+	{
+		const rec_t*	rec;
+		ulint		version;
+
+		if (!btr_search_lookup_lock_free(0, fold, &rec, &version)
+		    || !btr_search_version_validate(0, version)) {
+			m_n_retries++;
+		} else if (rec == NULL) {
+			m_n_misses++;
+		} else {
+			EXPECT_EQ(btr0sea::rec(fold), rec);
+			m_n_hits++;
+		}
+	}
+
+	/** Look up a fold value under the partition S-latch, like
+	btr_search_guess_on_hash() without the lock-free lookup.
+	@param[in]	fold	fold value */
+	void lookup_latched(ulint fold)
+	{
+		rw_lock_s_lock(btr_search_latches[0]);
+
+		const rec_t*	rec = ha_search_and_get_data(
+			btr0sea::table(), fold);
+
+		rw_lock_s_unlock(btr_search_latches[0]);
+
+		if (rec == NULL) {
+			m_n_misses++;
+		} else {
+			EXPECT_EQ(btr0sea::rec(fold), rec);
+			m_n_hits++;
+		}
+	}
+
+	ulint		m_rnd;
+	const bool	m_lock_free;
+	const ulint	m_n_lookups;
+	ulint		m_n_hits;
+	ulint		m_n_misses;
+	ulint		m_n_retries;
+};
+
+TEST_F(btr0sea, lock_free_lookup_stress)
+{
+	std::vector<ReaderThread*>	readers;
+	WriterThread			writer;
+	ScribblerThread			scribbler;
+	ulint				n_hits = 0;
+	ulint				n_misses = 0;
+	ulint				n_retries = 0;
+
+	stop = false;
+
+	for (ulint i = 0; i < N_READERS; i++) {
+		readers.push_back(new ReaderThread(i + 1, true, 0));
+		readers.back()->start();
+	}
+
+	scribbler.start();
+	writer.start();
+
+	writer.join();
+	scribbler.join();
+
+	for (ulint i = 0; i < N_READERS; i++) {
+		readers[i]->join();
+		n_hits += readers[i]->n_hits();
+		n_misses += readers[i]->n_misses();
+		n_retries += readers[i]->n_retries();
+		delete readers[i];
+	}
+
+	printf("lock-free lookups: %lu hits, %lu misses, %lu retries\n",
+	       static_cast<ulong>(n_hits), static_cast<ulong>(n_misses),
+	       static_cast<ulong>(n_retries));
+
+	EXPECT_GT(n_hits + n_misses, 0U);
+
+	/* Everything was deleted, so the heap shrank back to its first
+	block. */
+	EXPECT_EQ(1U, UT_LIST_GET_LEN(btr0sea::table()->heap->base));
+
+	for (ulint i = 0; i < BTR_SEARCH_READER_SLOTS; i++) {
+		EXPECT_EQ(0U, btr_search_readers[i].n);
+	}
+}
+
+/** Thread that deletes all the fold values */
+class RemoverThread : public thread::Thread {
+public:
+	RemoverThread() : m_done(false) {}
+
+	bool	done() const { return(m_done); }
+
+protected:
+	virtual void run()
+	{
+		btr0sea::remove(0, N_FOLDS);
+
+		m_done = true;
+	}
+
+private:
+	volatile bool	m_done;
+};
+
+TEST_F(btr0sea, free_waits_for_readers)
+{
+	for (ulint fold = 0; fold < N_FOLDS; fold += BATCH) {
+		btr0sea::insert(fold, BATCH);
+	}
+
+	const ulint	n_blocks = UT_LIST_GET_LEN(btr0sea::table()->heap->base);
+
+	EXPECT_GT(n_blocks, 1U);
+
+	/* Pretend that a lookup is walking the hash table. No heap block
+	may be freed until it has completed. */
+	btr_search_readers_t*	slot = btr_search_reader_enter(0);
+	RemoverThread		remover;
+
+	remover.start();
+
+	os_thread_sleep(100000);
+
+	EXPECT_FALSE(remover.done());
+	EXPECT_EQ(n_blocks, UT_LIST_GET_LEN(btr0sea::table()->heap->base));
+
+	btr_search_reader_exit(slot);
+
+	remover.join();
+
+	EXPECT_TRUE(remover.done());
+	EXPECT_EQ(1U, UT_LIST_GET_LEN(btr0sea::table()->heap->base));
+}
+
+/** Run N_READERS threads performing N_LOOKUPS lookups each on a full
+hash table.
+@param[in]	lock_free	whether to look up without the latch */
+static
+void
+run_lookups(bool lock_free)
+{
+	std::vector<ReaderThread*>	readers;
+	ulint				n_hits = 0;
+
+	const ulonglong	start = my_micro_time();
+
+	for (ulint i = 0; i < N_READERS; i++) {
+		readers.push_back(new ReaderThread(i + 1, lock_free,
+						   N_LOOKUPS));
+		readers.back()->start();
+	}
+
+	for (ulint i = 0; i < N_READERS; i++) {
+		readers[i]->join();
+		n_hits += readers[i]->n_hits();
+		delete readers[i];
+	}
+
+	const ulonglong	usecs = my_micro_time() - start + 1;
+
+	printf("%s: %lu lookups by %lu threads in %llu us,"
+	       " %.0f lookups/s\n",
+	       lock_free ? "lock-free" : "S-latched",
+	       static_cast<ulong>(N_READERS * N_LOOKUPS),
+	       static_cast<ulong>(N_READERS), usecs,
+	       N_READERS * N_LOOKUPS * 1000000.0 / usecs);
+
+	EXPECT_EQ(N_READERS * N_LOOKUPS, n_hits);
+}
+
+TEST_F(btr0sea, DISABLED_lookup_benchmark)
+{
+	for (ulint fold = 0; fold < N_FOLDS; fold += BATCH) {
+		btr0sea::insert(fold, BATCH);
+	}
+
+	run_lookups(false);
+	run_lookups(true);
+
+	btr0sea::remove(0, N_FOLDS);
+}
+
+}
@@ -0,0 +1,331 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "buf0buf.h"
+#include "buf0flu.h"
+#include "log0log.h"
+#include "os0event.h"
+#include "srv0srv.h"
+#include "sync0sync.h"
+#include "ut0mem.h"
+
+namespace innodb_buf0flu_unittest {
+
+/* Test of the mini-transaction commit protocol that adds dirty pages to
+the flush lists of many buffer pool instances: either serialized on
+log_flush_order_mutex, or in the relaxed order of
+innodb_flush_list_relaxed_order through log_flush_order_reserve(),
+log_flush_order_wait() and log_flush_order_complete(), bounded by
+LOG_FLUSH_ORDER_LAG. The threads commit like mtr_t::Command::execute()
+on the real log_sys. The resulting flush lists are checked for the lag
+bound and with buf_flush_list_oldest_lsn(). The commit rates of both
+protocols are printed. */
+
+/** Number of buffer pool instances */
+static const ulint	N_INSTANCES = 64;
+
+/** Number of committing threads */
+static const ulint	N_THREADS = 16;
+
+/** Number of commits per thread. Increase for actual benchmarking! */
+static const ulint	N_COMMITS = 20000;
+
+/** Number of pages that each mini-transaction makes dirty */
+static const ulint	N_PAGES = 2;
+
+/** Redo log bytes written by each mini-transaction. Big enough for
+N_THREADS mini-transactions to span more than LOG_FLUSH_ORDER_LAG, so that
+they wait in log_flush_order_wait(). */
+static const lsn_t	MTR_LEN = 64 * 1024;
+
+class buf0flu : public ::testing::Test {
+protected:
+	static
+	void
+	SetUpTestCase()
+	{
+		/* The committing threads wait for the mutexes. */
+		srv_max_n_threads = srv_sync_array_size * (N_THREADS + 1);
+		os_event_global_init();
+		sync_check_init();
+	}
+
+	static
+	void
+	TearDownTestCase()
+	{
+		sync_check_close();
+		os_event_global_destroy();
+	}
+
+	virtual
+	void
+	SetUp()
+	{
+		srv_log_buffer_size = 16;
+		log_init();
+
+		for (ulint i = 0; i < N_INSTANCES; i++) {
+			buf_pool_t*	buf_pool = static_cast<buf_pool_t*>(
+				ut_zalloc_nokey(sizeof(buf_pool_t)));
+
+			mutex_create(LATCH_ID_FLUSH_LIST,
+				     &buf_pool->flush_list_mutex);
+			UT_LIST_INIT(buf_pool->flush_list, &buf_page_t::list);
+
+			m_pools[i] = buf_pool;
+		}
+
+		m_pages = static_cast<buf_page_t*>(
+			ut_zalloc_nokey(N_THREADS * N_COMMITS * N_PAGES
+					* sizeof(buf_page_t)));
+	}
+
+	virtual
+	void
+	TearDown()
+	{
+		ut_free(m_pages);
+
+		for (ulint i = 0; i < N_INSTANCES; i++) {
+			mutex_free(&m_pools[i]->flush_list_mutex);
+			ut_free(m_pools[i]);
+		}
+
+		log_shutdown();
+		log_mem_free();
+
+		srv_flush_list_relaxed_order = FALSE;
+	}
+
+	/** Run N_THREADS threads committing N_COMMITS mini-transactions
+	each, and validate the resulting flush lists.
+	@param[in]	relaxed	whether to use the relaxed flush list order */
+	void run_commits(bool relaxed);
+
+	/** Check that every page was added to its flush list less than
+	LOG_FLUSH_ORDER_LAG behind any page that was added before it, and
+	that buf_flush_list_oldest_lsn() finds the oldest page from any
+	starting point. */
+	void validate() const;
+
+	buf_pool_t*	m_pools[N_INSTANCES];
+
+	/** The page descriptors, N_COMMITS * N_PAGES for each thread */
+	buf_page_t*	m_pages;
+};
+
+class CommitThread : public thread::Thread {
+public:
+	CommitThread(
+		buf_pool_t**	pools,
+		buf_page_t*	pages,
+		ulint		seed)
+		:
+		m_pools(pools),
+		m_pages(pages),
+		m_rnd(seed)
+	{}
+
+protected:
+	virtual void run()
+	{
+		for (ulint i = 0; i < N_COMMITS; i++) {
+			commit(&m_pages[i * N_PAGES]);
+		}
+	}
+
+private:
+	/** Commit a mini-transaction that dirties N_PAGES pages,
+	like mtr_t::Command::execute().
+	@param[in,out]	pages	N_PAGES page descriptors */
+	void commit(buf_page_t* pages)
+	{
+		const bool	relaxed = srv_flush_list_relaxed_order;
+		ib_uint64_t	ticket = 0;
+
+		log_mutex_enter();
+
+		const lsn_t	start_lsn = log_sys->lsn;
+
+		log_sys->lsn += MTR_LEN;
+
+		if (relaxed) {
+			ticket = log_flush_order_reserve(start_lsn);
+		} else {
+			log_flush_order_mutex_enter();
+		}
+
+		log_mutex_exit();
+
+		if (relaxed) {
+			log_flush_order_wait(start_lsn);
+		}
+
+		for (ulint i = 0; i < N_PAGES; i++) {
+			m_rnd = m_rnd * 1103515245 + 12345;
+
+			buf_pool_t*	buf_pool = m_pools[
+				(m_rnd >> 16) % N_INSTANCES];
+			buf_page_t*	bpage = &pages[i];
+
+			bpage->id.reset(1, 0);
+			bpage->oldest_modification = start_lsn;
+
+			buf_flush_list_mutex_enter(buf_pool);
+			ut_d(bpage->in_flush_list = TRUE);
+			UT_LIST_ADD_FIRST(buf_pool->flush_list, bpage);
+			buf_flush_list_mutex_exit(buf_pool);
+		}
+
+		if (relaxed) {
+			log_flush_order_complete(ticket);
+		} else {
+			log_flush_order_mutex_exit();
+		}
+	}
+
+	buf_pool_t**	m_pools;
+	buf_page_t*	m_pages;
+	ulint		m_rnd;
+};
+
+void
+buf0flu::run_commits(bool relaxed)
+{
+	srv_flush_list_relaxed_order = relaxed;
+
+	std::vector<CommitThread*>	threads;
+
+	const ulonglong	start = my_micro_time();
+
+	for (ulint i = 0; i < N_THREADS; i++) {
+		threads.push_back(new CommitThread(
+			m_pools, &m_pages[i * N_COMMITS * N_PAGES], i + 1));
+		threads.back()->start();
+	}
+
+	for (ulint i = 0; i < N_THREADS; i++) {
+		threads[i]->join();
+		delete threads[i];
+	}
+
+	const ulonglong	usecs = my_micro_time() - start + 1;
+
+	printf("%s flush order: %lu commits to %lu instances by %lu threads"
+	       " in %llu us, %.0f commits/s\n",
+	       relaxed ? "relaxed" : "strict",
+	       static_cast<ulong>(N_THREADS * N_COMMITS),
+	       static_cast<ulong>(N_INSTANCES),
+	       static_cast<ulong>(N_THREADS), usecs,
+	       N_THREADS * N_COMMITS * 1000000.0 / usecs);
+
+	validate();
+
+	if (relaxed) {
+		/* All the registered mini-transactions have completed,
+		so the order slots must all be free again. */
+		for (ulint i = 0; i < LOG_ORDER_SLOTS; i++) {
+			EXPECT_EQ(0U, log_sys->order_slots[i]);
+		}
+
+		EXPECT_EQ(0U, log_sys->order_n_waiters);
+	}
+}
+
+void
+buf0flu::validate() const
+{
+	const lsn_t	lag = srv_flush_list_relaxed_order
+		? LOG_FLUSH_ORDER_LAG : 1;
+	ulint		n_pages = 0;
+
+	for (ulint i = 0; i < N_INSTANCES; i++) {
+		buf_pool_t*	buf_pool = m_pools[i];
+		lsn_t		newest = 0;
+		ulint		j = 0;
+
+		buf_flush_list_mutex_enter(buf_pool);
+
+		/* The tail of the flush list was added first. */
+		for (const buf_page_t* bpage
+			     = UT_LIST_GET_LAST(buf_pool->flush_list);
+		     bpage != NULL;
+		     bpage = UT_LIST_GET_PREV(list, bpage), j++) {
+
+			EXPECT_GT(bpage->oldest_modification + lag, newest);
+			newest = std::max(newest, bpage->oldest_modification);
+
+			if (j % 97 != 0) {
+				continue;
+			}
+
+			lsn_t	oldest = bpage->oldest_modification;
+
+			for (const buf_page_t* prev = UT_LIST_GET_PREV(
+				     list, bpage);
+			     prev != NULL;
+			     prev = UT_LIST_GET_PREV(list, prev)) {
+
+				oldest = std::min(
+					oldest, prev->oldest_modification);
+			}
+
+			EXPECT_EQ(oldest,
+				  buf_flush_list_oldest_lsn(buf_pool, bpage));
+		}
+
+		buf_flush_list_mutex_exit(buf_pool);
+
+		n_pages += j;
+	}
+
+	EXPECT_EQ(N_THREADS * N_COMMITS * N_PAGES, n_pages);
+}
+
+TEST_F(buf0flu, strict_order)
+{
+	run_commits(false);
+}
+
+TEST_F(buf0flu, relaxed_order)
+{
+	run_commits(true);
+}
+
+}
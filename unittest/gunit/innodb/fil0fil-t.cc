@@ -0,0 +1,261 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "buf0buf.h"
+#include "fil0fil.h"
+#include "os0event.h"
+#include "os0file.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "sync0sync.h"
+#include "ut0mem.h"
+
+namespace innodb_fil0fil_unittest {
+
+/* Microbenchmark of the tablespace memory cache: create many single-page
+tablespaces, open and touch each of them with a synchronous fil_io() read
+of page 0, and then read random tablespaces from several threads. When
+there are more tablespaces than open files allowed, the threads also
+exercise the LRU of open files. The test is disabled; run it with
+--gtest_also_run_disabled_tests. The files are created in
+$INNODB_BENCH_DIR, by default /dev/shm. $INNODB_BENCH_N_SPACES and
+$INNODB_BENCH_MAX_OPEN override the number of tablespaces and the limit
+of open files; for example 500000 tablespaces need 8 GiB. */
+
+/** Number of tablespaces. Increase for actual benchmarking! */
+static const ulint	N_SPACES = 2000;
+
+/** Maximum number of open files, below the usual ulimit -n */
+static const ulint	MAX_OPEN = 500;
+
+/** Number of reading threads */
+static const ulint	N_THREADS = 8;
+
+/** Number of reads per thread */
+static const ulint	N_READS = 100000;
+
+/** The first tablespace id */
+static const ulint	FIRST_SPACE_ID = 1;
+
+/** Read an unsigned number from the environment.
+@param[in]	name	name of the environment variable
+@param[in]	dflt	value if the variable is not set
+@return the value */
+static
+ulint
+getenv_ulint(const char* name, ulint dflt)
+{
+	const char*	value = getenv(name);
+
+	return(value != NULL ? strtoul(value, NULL, 10) : dflt);
+}
+
+/** A thread that reads page 0 of random tablespaces */
+class ReadThread : public thread::Thread {
+public:
+	ReadThread(ulint n_spaces, ulint seed)
+		:
+		m_n_spaces(n_spaces),
+		m_rnd(seed)
+	{}
+
+protected:
+	virtual void run()
+	{
+		byte*	buf_unaligned = static_cast<byte*>(
+			ut_malloc_nokey(2 * UNIV_PAGE_SIZE));
+		byte*	buf = static_cast<byte*>(
+			ut_align(buf_unaligned, UNIV_PAGE_SIZE));
+
+		for (ulint i = 0; i < N_READS; i++) {
+			m_rnd = m_rnd * 1103515245 + 12345;
+
+			const page_id_t	page_id(
+				FIRST_SPACE_ID + (m_rnd >> 16) % m_n_spaces, 0);
+
+			dberr_t	err = fil_io(
+				IORequestRead, true, page_id, univ_page_size,
+				0, UNIV_PAGE_SIZE, buf, NULL);
+
+			ut_a(err == DB_SUCCESS);
+		}
+
+		ut_free(buf_unaligned);
+	}
+
+private:
+	ulint	m_n_spaces;
+	ulint	m_rnd;
+};
+
+class fil0fil : public ::testing::Test {
+protected:
+	static
+	void
+	SetUpTestCase()
+	{
+		srv_max_n_threads = srv_sync_array_size + 1;
+		os_event_global_init();
+		sync_check_init();
+	}
+
+	static
+	void
+	TearDownTestCase()
+	{
+		sync_check_close();
+		os_event_global_destroy();
+	}
+};
+
+TEST_F(fil0fil, DISABLED_open_and_read_tablespaces)
+{
+	const char*	dir = getenv("INNODB_BENCH_DIR");
+	const std::string	prefix = std::string(dir != NULL
+						     ? dir : "/dev/shm")
+		+ "/ib_fil0fil_bench_";
+	const ulint	n_spaces = getenv_ulint(
+		"INNODB_BENCH_N_SPACES", N_SPACES);
+	const ulint	max_open = getenv_ulint(
+		"INNODB_BENCH_MAX_OPEN", MAX_OPEN);
+
+	ASSERT_GT(n_spaces, 0U);
+	ASSERT_GT(max_open, 0U);
+
+	srv_use_native_aio = FALSE;
+	srv_startup_is_before_trx_rollback_phase = false;
+	srv_shutdown_state = SRV_SHUTDOWN_NONE;
+
+	ASSERT_TRUE(os_aio_init(1, 1, 100));
+
+	fil_init(n_spaces, max_open);
+	fil_set_max_space_id_if_bigger(FIRST_SPACE_ID + n_spaces);
+
+	std::vector<std::string>	names(n_spaces);
+
+	ulonglong	start = my_micro_time();
+
+	for (ulint i = 0; i < n_spaces; i++) {
+		char	suffix[32];
+		bool	success;
+
+		snprintf(suffix, sizeof suffix, "%lu.ibd",
+			 static_cast<ulong>(i));
+
+		names[i] = prefix + suffix;
+
+		os_file_delete_if_exists(
+			innodb_data_file_key, names[i].c_str(), NULL);
+
+		pfs_os_file_t	file = os_file_create(
+			innodb_data_file_key, names[i].c_str(),
+			OS_FILE_CREATE, OS_FILE_NORMAL, OS_DATA_FILE, false,
+			&success);
+		ASSERT_TRUE(success);
+
+		ASSERT_TRUE(os_file_set_size(
+			names[i].c_str(), file, UNIV_PAGE_SIZE, false));
+
+		os_file_close(file);
+
+		fil_space_t*	space = fil_space_create(
+			names[i].c_str(), FIRST_SPACE_ID + i, 0,
+			FIL_TYPE_TABLESPACE);
+		ASSERT_TRUE(space != NULL);
+
+		ASSERT_TRUE(fil_node_create(
+			names[i].c_str(), 1, space, false, false) != NULL);
+	}
+
+	const ulonglong	create_usecs = my_micro_time() - start;
+
+	byte*	buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey(2 * UNIV_PAGE_SIZE));
+	byte*	buf = static_cast<byte*>(
+		ut_align(buf_unaligned, UNIV_PAGE_SIZE));
+
+	start = my_micro_time();
+
+	for (ulint i = 0; i < n_spaces; i++) {
+		dberr_t	err = fil_io(
+			IORequestRead, true, page_id_t(FIRST_SPACE_ID + i, 0),
+			univ_page_size, 0, UNIV_PAGE_SIZE, buf, NULL);
+
+		ASSERT_EQ(DB_SUCCESS, err);
+	}
+
+	const ulonglong	touch_usecs = my_micro_time() - start;
+
+	ut_free(buf_unaligned);
+
+	std::vector<ReadThread*>	threads;
+
+	start = my_micro_time();
+
+	for (ulint i = 0; i < N_THREADS; i++) {
+		threads.push_back(new ReadThread(n_spaces, i + 1));
+		threads.back()->start();
+	}
+
+	for (ulint i = 0; i < N_THREADS; i++) {
+		threads[i]->join();
+		delete threads[i];
+	}
+
+	const ulonglong	read_usecs = my_micro_time() - start;
+
+	printf("%lu tablespaces, at most %lu open files:"
+	       " created in %llu ms, opened and touched in %llu ms,"
+	       " %lu threads did %.0f reads per second\n",
+	       static_cast<ulong>(n_spaces), static_cast<ulong>(max_open),
+	       create_usecs / 1000, touch_usecs / 1000,
+	       static_cast<ulong>(N_THREADS),
+	       N_THREADS * N_READS * 1000000.0 / (read_usecs + 1));
+
+	fil_close_all_files();
+	fil_close();
+
+	for (ulint i = 0; i < n_spaces; i++) {
+		os_file_delete(innodb_data_file_key, names[i].c_str());
+	}
+
+	os_aio_free();
+}
+
+}
@@ -0,0 +1,241 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+
+#include "univ.i"
+
+#include "fts0types.h"
+
+namespace innodb_fts0vlc_unittest {
+
+/** An ilist, as stored in the FTS auxiliary index tables */
+typedef std::vector<byte>	ilist_t;
+
+/** A simple linear congruential generator, so that the lists are the same
+in every run.
+@param[in,out]	rnd	state
+@return a random number */
+static
+ulint
+next_rnd(ulint* rnd)
+{
+	*rnd = *rnd * 1103515245 + 12345;
+
+	return((*rnd >> 16) & 0x7FFFFFFF);
+}
+
+/** Append an integer to an ilist.
+@param[in,out]	ilist	ilist
+@param[in]	val	value to encode */
+static
+void
+append_int(ilist_t* ilist, ulint val)
+{
+	byte	buf[8];
+	ulint	len = fts_encode_int(val, buf);
+
+	ilist->insert(ilist->end(), buf, buf + len);
+}
+
+/** Generate an ilist of documents with random positions. The position
+deltas are of every encoded length, including ones with 0 bytes inside.
+@param[in]	n_docs		number of documents
+@param[in]	max_positions	maximum number of positions per document
+@param[in,out]	rnd		random number generator state
+@param[out]	ilist		ilist
+@param[out]	counts		number of positions of each document */
+static
+void
+generate_ilist(
+	ulint			n_docs,
+	ulint			max_positions,
+	ulint*			rnd,
+	ilist_t*		ilist,
+	std::vector<ulint>*	counts)
+{
+	static const ulint	max_delta[] = {
+		127, 16383, 2097151, 268435455, 0xFFFFFFFFUL
+	};
+
+	for (ulint i = 0; i < n_docs; i++) {
+		append_int(ilist, 1 + next_rnd(rnd) % 100);
+
+		const ulint	n = next_rnd(rnd) % (max_positions + 1);
+
+		for (ulint j = 0; j < n; j++) {
+			ulint	delta = next_rnd(rnd)
+				% max_delta[next_rnd(rnd) % 5];
+
+			/* A delta of 16384 encodes as 0x01 0x00 0x80 */
+			if (next_rnd(rnd) % 8 == 0) {
+				delta = 16384;
+			}
+
+			append_int(ilist, delta);
+		}
+
+		ilist->push_back(0);
+		counts->push_back(n);
+	}
+}
+
+/** Skip the positions of a document by decoding them one at a time.
+@param[in,out]	ptr	the first position; on return, the byte after the
+end of word position marker
+@return number of positions */
+static
+ulint
+skip_positions_by_decoding(byte** ptr)
+{
+	ulint	n = 0;
+
+	while (**ptr) {
+		fts_decode_vlc(ptr);
+		++n;
+	}
+
+	++*ptr;
+
+	return(n);
+}
+
+/* Test that fts_skip_vlc_positions() agrees with decoding the positions,
+wherever the documents start relative to an 8-byte word. */
+TEST(fts0vlc, skip_vlc_positions)
+{
+	ulint	rnd = 1;
+
+	for (ulint max_positions = 0; max_positions < 40; max_positions++) {
+		ilist_t			ilist;
+		std::vector<ulint>	counts;
+
+		generate_ilist(50, max_positions, &rnd, &ilist, &counts);
+
+		byte*		ptr = &ilist[0];
+		byte*		ref = &ilist[0];
+		const byte*	end = &ilist[0] + ilist.size();
+
+		for (ulint i = 0; i < counts.size(); i++) {
+			fts_decode_vlc(&ptr);
+			fts_decode_vlc(&ref);
+
+			EXPECT_EQ(counts[i], fts_skip_vlc_positions(&ptr, end));
+			EXPECT_EQ(counts[i], skip_positions_by_decoding(&ref));
+			ASSERT_EQ(ref, ptr);
+		}
+
+		EXPECT_EQ(end, ptr);
+	}
+}
+
+/* Microbenchmark of the evaluation of single-word queries, as
+fts_query_filter_doc_ids() does it when the positions are not needed:
+generate posting lists for a corpus whose word frequencies follow
+Zipf's law and count the documents and word occurrences of random
+words. The test is disabled; run it with --gtest_also_run_disabled_tests. */
+
+/** Number of documents in the corpus */
+static const ulint	N_DOCS = 100000;
+
+/** Number of different words in the corpus */
+static const ulint	N_WORDS = 1000;
+
+/** Number of queries to run */
+static const ulint	N_QUERIES = 20000;
+
+/** Evaluate single-word queries.
+@param[in]	ilists		posting list of each word
+@param[in]	by_decoding	whether to decode the positions one at a
+time instead of calling fts_skip_vlc_positions()
+@return total number of word occurrences found */
+static
+ulint
+run_queries(
+	const std::vector<ilist_t>&	ilists,
+	bool				by_decoding)
+{
+	ulint	rnd = 1;
+	ulint	n = 0;
+
+	for (ulint i = 0; i < N_QUERIES; i++) {
+		const ilist_t&	ilist = ilists[next_rnd(&rnd) % ilists.size()];
+		byte*		ptr = const_cast<byte*>(&ilist[0]);
+		const byte*	end = &ilist[0] + ilist.size();
+
+		while (ptr < end) {
+			fts_decode_vlc(&ptr);
+
+			n += by_decoding
+				? skip_positions_by_decoding(&ptr)
+				: fts_skip_vlc_positions(&ptr, end);
+		}
+	}
+
+	return(n);
+}
+
+TEST(fts0vlc, DISABLED_query_posting_lists)
+{
+	std::vector<ilist_t>	ilists(N_WORDS);
+	ulint			rnd = 1;
+	ulint			size = 0;
+
+	for (ulint i = 0; i < N_WORDS; i++) {
+		std::vector<ulint>	counts;
+
+		/* The i-th most frequent word is in about
+		N_DOCS / (i + 1) documents. */
+		generate_ilist(N_DOCS / (i + 1), 8, &rnd, &ilists[i],
+			       &counts);
+
+		size += ilists[i].size();
+	}
+
+	ulonglong	start = my_micro_time();
+	const ulint	n_decoded = run_queries(ilists, true);
+	const ulonglong	decode_usecs = my_micro_time() - start;
+
+	start = my_micro_time();
+	const ulint	n_skipped = run_queries(ilists, false);
+	const ulonglong	skip_usecs = my_micro_time() - start;
+
+	EXPECT_EQ(n_decoded, n_skipped);
+
+	printf("%lu words, %lu bytes of posting lists: %.0f queries per"
+	       " second decoding the positions, %.0f skipping them\n",
+	       static_cast<ulong>(N_WORDS), static_cast<ulong>(size),
+	       N_QUERIES * 1000000.0 / (decode_usecs + 1),
+	       N_QUERIES * 1000000.0 / (skip_usecs + 1));
+}
+
+}
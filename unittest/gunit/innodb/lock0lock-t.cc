@@ -0,0 +1,683 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "buf0buf.h"
+#include "dict0mem.h"
+#include "hash0hash.h"
+#include "lock0lock.h"
+#include "os0event.h"
+#include "page0page.h"
+#include "que0que.h"
+#include "rem0rec.h"
+#include "srv0srv.h"
+#include "sync0sync.h"
+#include "trx0sys.h"
+#include "trx0trx.h"
+
+namespace innodb_lock0lock_unittest {
+
+/* Tests of the record lock queues, on a lock system without a buffer pool
+or tablespaces. The records are X-locked in fake secondary index pages,
+like lock_sec_rec_read_check_and_lock() does for SELECT ... FOR UPDATE,
+by transactions that are started and committed in memory only.
+
+One test checks that the schedule weight that a waiting transaction adds
+to the transactions that it waits for, directly or along a chain of waits,
+is taken back when the wait ends: when the lock is granted, or when the
+wait is cancelled. Weight that was added to a transaction that has since
+committed must not be taken from the next transaction that uses the same
+trx_t object.
+
+The stress test lets threads run transactions that lock random records in
+ascending order, so that there are lock waits but no deadlocks. The locks
+are released at commit under the shared lock_sys->latch, see
+lock_release_rec_locks(). In the end, no record locks may remain and no
+schedule weight may be left over.
+
+The disabled benchmark compares the latency of transactions when waiting
+record locks are granted first come first served and when they are granted
+to the transactions that block the most others first (CATS). Run it with
+--gtest_also_run_disabled_tests. */
+
+/** Tablespace of the fake index pages */
+static const ulint	SPACE = 1000;
+
+/** Number of fake index pages */
+static const ulint	N_PAGES = 4;
+
+/** Number of user records on each page */
+static const ulint	N_RECS = 16;
+
+/** Number of records that can be locked */
+static const ulint	N_RECORDS = N_PAGES * N_RECS;
+
+/** Number of records that a transaction locks */
+static const ulint	N_LOCKS = 4;
+
+/** Number of threads in the stress test */
+static const ulint	N_THREADS = 8;
+
+/** Number of transactions per thread in the stress test */
+static const ulint	N_TRXS = 200;
+
+/** Number of threads in the benchmark */
+static const ulint	N_BENCH_THREADS = 16;
+
+/** Number of transactions per thread in the benchmark. Increase for
+actual benchmarking! */
+static const ulint	N_BENCH_TRXS = 1000;
+
+/** Number of cells in the lock hash tables */
+static const ulint	LOCK_HASH_SIZE = 1024;
+
+class lock0lock : public ::testing::Test {
+protected:
+	static
+	void
+	SetUpTestCase()
+	{
+		/* The threads wait for record locks. */
+		srv_max_n_threads = srv_sync_array_size * 64;
+		os_event_global_init();
+		sync_check_init();
+
+		trx_pool_init();
+
+		/* No page is newer than the oldest active read-write
+		transaction, so that lock_sec_rec_read_check_and_lock() does
+		not look for implicit locks. */
+		trx_sys_create();
+		trx_sys->max_trx_id = 1;
+
+		/* Do not create lock_latest_err_file. */
+		srv_read_only_mode = true;
+		lock_sys_create(LOCK_HASH_SIZE);
+		srv_read_only_mode = false;
+
+		s_table = dict_mem_table_create(
+			"test/t", SPACE, 1, 0, DICT_TF_COMPACT, 0);
+		s_table->id = 1000;
+		s_table->can_be_evicted = false;
+
+		dict_mem_table_add_col(
+			s_table, NULL, NULL, DATA_INT, DATA_NOT_NULL, 4);
+
+		s_index = dict_mem_index_create("test/t", "a", SPACE, 0, 1);
+		dict_mem_index_add_field(s_index, "a", 0);
+
+		dict_field_t*	field = dict_index_get_nth_field(s_index, 0);
+
+		field->col = dict_table_get_nth_col(s_table, 0);
+		field->fixed_len = 4;
+
+		s_index->table = s_table;
+		s_index->n_uniq = 1;
+		s_index->n_nullable = 0;
+		s_index->id = 1000;
+
+		for (ulint i = 0; i < N_PAGES; i++) {
+			s_pages[i] = create_page(i);
+		}
+	}
+
+	static
+	void
+	TearDownTestCase()
+	{
+		for (ulint i = 0; i < N_PAGES; i++) {
+			ut_free(s_frames[i]);
+			ut_free(s_pages[i]);
+		}
+
+		dict_mem_index_free(s_index);
+		dict_mem_table_free(s_table);
+
+		lock_sys_close();
+
+		/* Like the end of trx_sys_close(), which would also free the
+		doublewrite buffer and the rollback segments. */
+		UT_DELETE(trx_sys->mvcc);
+
+		mutex_free(&trx_sys->mutex);
+
+		trx_sys->rw_trx_ids.~trx_ids_t();
+
+		for (ulint i = 0; i < TRX_SYS_N_SHARDS; ++i) {
+			trx_sys_shard_t*	shard = &trx_sys->rw_trx_shards[i];
+
+			shard->rw_trx_set.~TrxIdSet();
+
+			mutex_free(&shard->mutex);
+		}
+
+		trx_sys->rw_trx_active.~TrxIdRegistry();
+
+		ut_free(trx_sys);
+
+		trx_sys = NULL;
+
+		trx_pool_close();
+
+		sync_check_close();
+		os_event_global_destroy();
+	}
+
+	/** Create a fake secondary index leaf page in the compact format,
+	with N_RECS records in the heap.
+	@param[in]	page_no	page number
+	@return the page */
+	static
+	buf_block_t*
+	create_page(ulint page_no)
+	{
+		buf_block_t*	block = static_cast<buf_block_t*>(
+			ut_zalloc_nokey(sizeof(*block)));
+
+		s_frames[page_no] = static_cast<byte*>(
+			ut_zalloc_nokey(2 * UNIV_PAGE_SIZE));
+
+		block->frame = static_cast<byte*>(
+			ut_align(s_frames[page_no], UNIV_PAGE_SIZE));
+
+		block->page.id.reset(SPACE, page_no);
+		block->page.state = BUF_BLOCK_FILE_PAGE;
+		block->lock_hash_val = lock_rec_hash(SPACE, page_no);
+
+		mach_write_to_2(block->frame + PAGE_HEADER + PAGE_N_HEAP,
+				0x8000 | (PAGE_HEAP_NO_USER_LOW + N_RECS));
+
+		for (ulint i = 0; i < N_RECS; i++) {
+			rec_t*	rec = rec_at(block, i);
+
+			rec_set_heap_no_new(rec, PAGE_HEAP_NO_USER_LOW + i);
+			rec_set_status(rec, REC_STATUS_ORDINARY);
+		}
+
+		return(block);
+	}
+
+	/** Get a user record of a fake page.
+	@param[in]	block	page
+	@param[in]	i	record number, less than N_RECS
+	@return the record */
+	static
+	rec_t*
+	rec_at(const buf_block_t* block, ulint i)
+	{
+		return(block->frame + PAGE_NEW_SUPREMUM_END
+		       + i * 16 + REC_N_NEW_EXTRA_BYTES);
+	}
+
+	/** @return whether no record locks are left in the hash table */
+	static
+	bool
+	rec_hash_empty()
+	{
+		for (ulint i = 0; i < hash_get_n_cells(lock_sys->rec_hash);
+		     i++) {
+
+			if (hash_get_nth_cell(lock_sys->rec_hash, i)->node
+			    != NULL) {
+
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
+public:
+	/** Transaction with the dummy query thread that the MySQL
+	interface uses for waiting */
+	class Trx {
+	public:
+		Trx()
+			:
+			m_trx(trx_allocate_for_background()),
+			m_heap(mem_heap_create(512))
+		{
+			que_fork_t*	fork = que_fork_create(
+				NULL, NULL, QUE_FORK_MYSQL_INTERFACE, m_heap);
+
+			fork->trx = m_trx;
+			fork->state = QUE_FORK_ACTIVE;
+
+			m_thr = que_thr_create(fork, m_heap, NULL);
+		}
+
+		~Trx()
+		{
+			trx_free_for_background(m_trx);
+			mem_heap_free(m_heap);
+		}
+
+		trx_t*	trx() const { return(m_trx); }
+
+		/** @return the schedule weight of the transaction */
+		ulint	weight() const
+		{
+			return(m_trx->lock.schedule_weight);
+		}
+
+		/** @return whether the transaction is waiting for a lock */
+		bool	waiting() const
+		{
+			return(m_trx->lock.wait_lock != NULL);
+		}
+
+		/** Start the transaction and the statement, and lock the
+		table in IX mode. The transaction is read-only, so that it
+		needs no rollback segment. */
+		void	begin()
+		{
+			m_trx->read_only = true;
+			m_trx->will_lock = 1;
+			m_trx->state = TRX_STATE_ACTIVE;
+
+			que_thr_move_to_run_state_for_mysql(m_thr, m_trx);
+
+			ASSERT_EQ(DB_SUCCESS,
+				  lock_table(0, s_table, LOCK_IX, m_thr));
+		}
+
+		/** Request an X-lock on a record.
+		@param[in]	n	record number, less than N_RECORDS
+		@return DB_SUCCESS, DB_SUCCESS_LOCKED_REC or DB_LOCK_WAIT */
+		dberr_t	request(ulint n)
+		{
+			const buf_block_t*	block = s_pages[n / N_RECS];
+			const rec_t*		rec = rec_at(block, n % N_RECS);
+			mem_heap_t*		heap = NULL;
+			ulint			offsets_[REC_OFFS_NORMAL_SIZE];
+			rec_offs_init(offsets_);
+
+			const ulint*	offsets = rec_get_offsets(
+				rec, s_index, offsets_, ULINT_UNDEFINED,
+				&heap);
+
+			return(lock_sec_rec_read_check_and_lock(
+				       0, block, rec, s_index, offsets,
+				       LOCK_X, LOCK_REC_NOT_GAP, m_thr));
+		}
+
+		/** X-lock a record, and suspend the thread until the lock
+		is granted if another transaction holds a conflicting lock,
+		like row_search_mvcc() does.
+		@param[in]	n	record number, less than N_RECORDS
+		@return whether the thread was suspended */
+		bool	lock(ulint n)
+		{
+			dberr_t	err = request(n);
+
+			if (err != DB_LOCK_WAIT) {
+				EXPECT_TRUE(err == DB_SUCCESS
+					    || err == DB_SUCCESS_LOCKED_REC);
+				return(false);
+			}
+
+			que_thr_stop_for_mysql(m_thr);
+
+			m_thr->lock_state = QUE_THR_LOCK_ROW;
+
+			lock_wait_suspend_thread(m_thr);
+
+			m_thr->lock_state = QUE_THR_LOCK_NOLOCK;
+
+			/* There is no lock wait timeout thread, so the lock
+			was granted, even if the wait took long enough to be
+			reported as a timeout. Because the records are
+			locked in ascending order, there are no deadlocks. */
+			EXPECT_TRUE(m_trx->error_state == DB_SUCCESS
+				    || m_trx->error_state
+				    == DB_LOCK_WAIT_TIMEOUT);
+			EXPECT_FALSE(waiting());
+
+			m_trx->error_state = DB_SUCCESS;
+
+			return(true);
+		}
+
+		/** Cancel the lock wait of the transaction, like
+		row_search_mvcc() does when the statement is killed. */
+		void	cancel()
+		{
+			EXPECT_EQ(DB_LOCK_WAIT, lock_trx_handle_wait(m_trx));
+			EXPECT_FALSE(waiting());
+		}
+
+		/** Commit the transaction in memory, and release its locks,
+		like trx_commit_in_memory(). */
+		void	commit()
+		{
+			que_thr_stop_for_mysql_no_error(m_thr, m_trx);
+
+			lock_trx_release_locks(m_trx);
+
+			EXPECT_EQ(0U, m_trx->lock.schedule_weight);
+			EXPECT_EQ(0U, m_trx->lock.n_schedule_debts);
+
+			m_trx->state = TRX_STATE_NOT_STARTED;
+			m_trx->will_lock = 0;
+			m_trx->read_only = false;
+		}
+
+	private:
+		trx_t*		m_trx;
+		mem_heap_t*	m_heap;
+		que_thr_t*	m_thr;
+	};
+
+	/** Set the lock schedule algorithm
+	@param[in]	algorithm	LOCK_SCHEDULE_FCFS or LOCK_SCHEDULE_CATS */
+	static
+	void
+	set_algorithm(ulong algorithm)
+	{
+		innobase_lock_schedule_algorithm = algorithm;
+	}
+
+	/** Check that no locks are left */
+	static
+	void
+	check_no_locks()
+	{
+		EXPECT_EQ(0U, s_table->n_rec_locks);
+		EXPECT_EQ(0U, UT_LIST_GET_LEN(s_table->locks));
+		EXPECT_TRUE(rec_hash_empty());
+	}
+
+private:
+	/** The table of the index */
+	static dict_table_t*	s_table;
+
+	/** The secondary index of the fake pages */
+	static dict_index_t*	s_index;
+
+	/** The fake pages */
+	static buf_block_t*	s_pages[N_PAGES];
+
+	/** Memory of the frames of the fake pages */
+	static byte*		s_frames[N_PAGES];
+};
+
+dict_table_t*	lock0lock::s_table;
+dict_index_t*	lock0lock::s_index;
+buf_block_t*	lock0lock::s_pages[N_PAGES];
+byte*		lock0lock::s_frames[N_PAGES];
+
+TEST_F(lock0lock, schedule_weight)
+{
+	set_algorithm(LOCK_SCHEDULE_CATS);
+
+	lock0lock::Trx	t1;
+	lock0lock::Trx	t2;
+	lock0lock::Trx	t3;
+	lock0lock::Trx	t4;
+
+	/* A cancelled wait takes back its weight. */
+	t1.begin();
+	t2.begin();
+
+	EXPECT_EQ(DB_SUCCESS_LOCKED_REC, t1.request(0));
+	EXPECT_EQ(DB_LOCK_WAIT, t2.request(0));
+	EXPECT_EQ(1U, t1.weight());
+
+	t2.cancel();
+	EXPECT_EQ(0U, t1.weight());
+
+	t2.commit();
+	t1.commit();
+
+	/* t3 waits for t2, which waits for t1. */
+	t1.begin();
+	t2.begin();
+	t3.begin();
+
+	EXPECT_EQ(DB_SUCCESS_LOCKED_REC, t1.request(0));
+	EXPECT_EQ(DB_SUCCESS_LOCKED_REC, t2.request(N_RECS));
+	EXPECT_EQ(DB_LOCK_WAIT, t2.request(0));
+	EXPECT_EQ(1U, t1.weight());
+
+	EXPECT_EQ(DB_LOCK_WAIT, t3.request(N_RECS));
+	EXPECT_EQ(1U, t2.weight());
+	EXPECT_EQ(2U, t1.weight());
+
+	/* The wait of t2 ends and takes back its weight from t1. The
+	weight that t3 added to t1 is reset when t1 commits. */
+	t1.commit();
+	EXPECT_FALSE(t2.waiting());
+	EXPECT_TRUE(t3.waiting());
+	EXPECT_EQ(1U, t2.weight());
+
+	/* t4 waits for the next transaction of t1. */
+	t1.begin();
+	t4.begin();
+
+	EXPECT_EQ(DB_SUCCESS_LOCKED_REC, t1.request(1));
+	EXPECT_EQ(DB_LOCK_WAIT, t4.request(1));
+	EXPECT_EQ(1U, t1.weight());
+
+	/* The wait of t3 ends. It must not take back the weight that it
+	added to the previous transaction of t1. */
+	t2.commit();
+	EXPECT_FALSE(t3.waiting());
+	EXPECT_EQ(1U, t1.weight());
+
+	t1.commit();
+	EXPECT_FALSE(t4.waiting());
+
+	t3.commit();
+	t4.commit();
+
+	check_no_locks();
+
+	set_algorithm(LOCK_SCHEDULE_FCFS);
+}
+
+/** Thread that runs transactions that X-lock N_LOCKS random records in
+ascending order, and measures their latency */
+class TrxThread : public thread::Thread {
+public:
+	TrxThread(ulint n_trxs, ulint seed)
+		:
+		m_n_trxs(n_trxs),
+		m_rnd(seed),
+		m_n_waits(0)
+	{}
+
+	/** @return the latencies of the transactions, in microseconds */
+	const std::vector<ulonglong>& latencies() const
+	{
+		return(m_latencies);
+	}
+
+	/** @return the number of lock waits */
+	ulint	n_waits() const { return(m_n_waits); }
+
+protected:
+	virtual void run()
+	{
+		lock0lock::Trx	trx;
+
+		m_latencies.reserve(m_n_trxs);
+
+		for (ulint i = 0; i < m_n_trxs; i++) {
+			const ulonglong	start = my_micro_time();
+
+			execute(trx);
+
+			m_latencies.push_back(my_micro_time() - start);
+		}
+	}
+
+private:
+	/** Run a transaction.
+	@param[in,out]	trx	transaction */
+	void execute(lock0lock::Trx& trx)
+	{
+		ulint	recs[N_LOCKS];
+
+		/* The records at the start are hot. */
+		for (ulint i = 0; i < N_LOCKS; i++) {
+			m_rnd = m_rnd * 1103515245 + 12345;
+
+			const ulint	r = (m_rnd >> 16) % N_RECORDS;
+
+			recs[i] = r * r / N_RECORDS;
+		}
+
+		std::sort(recs, recs + N_LOCKS);
+
+		trx.begin();
+
+		for (ulint i = 0; i < N_LOCKS; i++) {
+			if (trx.lock(recs[i])) {
+				m_n_waits++;
+			}
+
+			/* Let other transactions run while we hold the
+			lock. */
+			os_thread_yield();
+		}
+
+		trx.commit();
+	}
+
+	const ulint		m_n_trxs;
+	ulint			m_rnd;
+	ulint			m_n_waits;
+	std::vector<ulonglong>	m_latencies;
+};
+
+/** Run transactions in threads.
+@param[in]	n_threads	number of threads
+@param[in]	n_trxs		number of transactions per thread
+@param[out]	latencies	sorted latencies of the transactions
+@return number of lock waits */
+static
+ulint
+run_trxs(
+	ulint			n_threads,
+	ulint			n_trxs,
+	std::vector<ulonglong>&	latencies)
+{
+	std::vector<TrxThread*>	threads;
+	ulint			n_waits = 0;
+
+	for (ulint i = 0; i < n_threads; i++) {
+		threads.push_back(new TrxThread(n_trxs, i + 1));
+		threads.back()->start();
+	}
+
+	for (ulint i = 0; i < n_threads; i++) {
+		threads[i]->join();
+		latencies.insert(latencies.end(),
+				 threads[i]->latencies().begin(),
+				 threads[i]->latencies().end());
+		n_waits += threads[i]->n_waits();
+		delete threads[i];
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	return(n_waits);
+}
+
+TEST_F(lock0lock, release_stress)
+{
+	static const ulong	algorithms[] = {
+		LOCK_SCHEDULE_FCFS, LOCK_SCHEDULE_CATS
+	};
+
+	for (ulint i = 0; i < 2; i++) {
+		std::vector<ulonglong>	latencies;
+
+		set_algorithm(algorithms[i]);
+
+		const ulint	n_waits = run_trxs(N_THREADS, N_TRXS, latencies);
+
+		printf("%s: %lu transactions, %lu lock waits\n",
+		       algorithms[i] == LOCK_SCHEDULE_CATS ? "CATS" : "FCFS",
+		       static_cast<ulong>(latencies.size()),
+		       static_cast<ulong>(n_waits));
+
+		EXPECT_EQ(N_THREADS * N_TRXS, latencies.size());
+
+		check_no_locks();
+	}
+
+	set_algorithm(LOCK_SCHEDULE_FCFS);
+}
+
+TEST_F(lock0lock, DISABLED_schedule_latency)
+{
+	static const ulong	algorithms[] = {
+		LOCK_SCHEDULE_FCFS, LOCK_SCHEDULE_CATS
+	};
+
+	for (ulint i = 0; i < 2; i++) {
+		std::vector<ulonglong>	latencies;
+
+		set_algorithm(algorithms[i]);
+
+		const ulonglong	start = my_micro_time();
+
+		const ulint	n_waits = run_trxs(
+			N_BENCH_THREADS, N_BENCH_TRXS, latencies);
+
+		const ulonglong	usecs = my_micro_time() - start + 1;
+		const ulint	n = latencies.size();
+
+		printf("%s: %lu transactions by %lu threads in %llu us,"
+		       " %.0f trx/s, %lu lock waits;"
+		       " latency p50 %llu us, p99 %llu us, max %llu us\n",
+		       algorithms[i] == LOCK_SCHEDULE_CATS ? "CATS" : "FCFS",
+		       static_cast<ulong>(n),
+		       static_cast<ulong>(N_BENCH_THREADS), usecs,
+		       n * 1000000.0 / usecs, static_cast<ulong>(n_waits),
+		       latencies[n / 2], latencies[n * 99 / 100],
+		       latencies[n - 1]);
+
+		check_no_locks();
+	}
+
+	set_algorithm(LOCK_SCHEDULE_FCFS);
+}
+
+}
@@ -0,0 +1,380 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "os0atomic.h"
+#include "os0event.h"
+#include "os0file.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "sync0sync.h"
+#include "ut0mem.h"
+
+namespace innodb_os0file_unittest {
+
+#ifdef LINUX_NATIVE_AIO
+
+/* Microbenchmark of the Linux asynchronous i/o backends of os0file, libaio
+and io_uring: random 16 KiB reads or writes through os_aio() with a fixed
+number of requests in flight, reaped by i/o handler threads that call
+os_aio_handler() like io_handler_thread(). It reports IOPS and the average
+and 99th percentile latency. The tests are disabled; run them with
+--gtest_also_run_disabled_tests. The file is created in $INNODB_BENCH_DIR,
+by default /dev/shm; point it to a real device to measure the disk. */
+
+/** Number of read segments */
+static const ulint	N_READERS = 4;
+
+/** Number of write segments */
+static const ulint	N_WRITERS = 4;
+
+/** Number of requests in flight */
+static const ulint	QUEUE_DEPTH = 64;
+
+/** Number of requests. Increase for actual benchmarking! */
+static const ulint	N_REQUESTS = 100000;
+
+/** Size of each request */
+static const ulint	REQUEST_SIZE = 16384;
+
+/** Size of the file */
+static const os_offset_t	FILE_SIZE = 256 * 1024 * 1024;
+
+/** A request in flight. There are QUEUE_DEPTH of these; when one
+completes, the next request is posted with the same buffer. */
+struct Request {
+	/** Position of the buffer of the request */
+	ulint		lane;
+
+	/** Random state for the offsets */
+	ulint		rnd;
+
+	/** Time when the request was posted, in microseconds */
+	ulonglong	start;
+};
+
+class Benchmark {
+public:
+	Benchmark(bool write)
+		:
+		m_write(write),
+		m_n_issued(),
+		m_n_done(),
+		m_latencies(N_REQUESTS)
+	{
+		const char*	dir = getenv("INNODB_BENCH_DIR");
+
+		m_name = std::string(dir != NULL ? dir : "/dev/shm")
+			+ "/ib_os0file_bench";
+
+		m_buf_unaligned = static_cast<byte*>(
+			ut_malloc_nokey((QUEUE_DEPTH + 1) * REQUEST_SIZE));
+		m_buf = static_cast<byte*>(
+			ut_align(m_buf_unaligned, REQUEST_SIZE));
+		memset(m_buf, 0x0, QUEUE_DEPTH * REQUEST_SIZE);
+
+		for (ulint i = 0; i < QUEUE_DEPTH; i++) {
+			m_requests[i].lane = i;
+			m_requests[i].rnd = i + 1;
+		}
+	}
+
+	~Benchmark()
+	{
+		ut_free(m_buf_unaligned);
+	}
+
+	/** Create the file. */
+	void create()
+	{
+		bool	success;
+
+		os_file_delete_if_exists(
+			innodb_data_file_key, m_name.c_str(), NULL);
+
+		m_file = os_file_create(
+			innodb_data_file_key, m_name.c_str(),
+			OS_FILE_CREATE, OS_FILE_AIO, OS_DATA_FILE, false,
+			&success);
+		ASSERT_TRUE(success);
+
+		ASSERT_TRUE(os_file_set_size(
+			m_name.c_str(), m_file, FILE_SIZE, false));
+
+		/* Like the buffer pool chunks */
+		const ulint	size = QUEUE_DEPTH * REQUEST_SIZE;
+
+		os_aio_register_buffers(&m_buf, &size, 1);
+	}
+
+	/** Close and remove the file. */
+	void destroy()
+	{
+		os_aio_unregister_buffers();
+
+		os_file_close(m_file);
+		os_file_delete(innodb_data_file_key, m_name.c_str());
+	}
+
+	/** Post the first QUEUE_DEPTH requests as one batch and wait
+	until N_REQUESTS requests have completed. */
+	void run()
+	{
+		for (ulint i = 0; i < QUEUE_DEPTH; i++) {
+			post(&m_requests[i], false);
+		}
+
+		os_aio_simulated_wake_handler_threads();
+
+		while (m_n_done < N_REQUESTS) {
+			os_thread_sleep(1000);
+		}
+	}
+
+	/** Complete a request and post the next one, if any.
+	@param[in,out]	req	the completed request */
+	void complete(Request* req)
+	{
+		ulint	seq = os_atomic_increment_ulint(&m_n_done, 1) - 1;
+
+		ut_a(seq < N_REQUESTS);
+
+		m_latencies[seq] = my_micro_time() - req->start;
+
+		post(req, true);
+	}
+
+	/** Print the results.
+	@param[in]	usecs	elapsed time in microseconds */
+	void report(ulonglong usecs)
+	{
+		ulonglong	sum = 0;
+
+		for (ulint i = 0; i < N_REQUESTS; i++) {
+			sum += m_latencies[i];
+		}
+
+		std::vector<ulonglong>::iterator	p99 = m_latencies.begin()
+			+ N_REQUESTS * 99 / 100;
+
+		std::nth_element(m_latencies.begin(), p99, m_latencies.end());
+
+		printf("%s %s: %lu requests of %lu bytes, queue depth %lu,"
+		       " %.0f IOPS, average latency %llu us,"
+		       " p99 latency %llu us\n",
+		       srv_use_io_uring ? "io_uring" : "libaio",
+		       m_write ? "random writes" : "random reads",
+		       static_cast<ulong>(N_REQUESTS),
+		       static_cast<ulong>(REQUEST_SIZE),
+		       static_cast<ulong>(QUEUE_DEPTH),
+		       N_REQUESTS * 1000000.0 / (usecs + 1),
+		       sum / N_REQUESTS, *p99);
+	}
+
+private:
+	/** Post a request at a random offset, unless N_REQUESTS
+	requests have been posted.
+	@param[in,out]	req	the request
+	@param[in]	wake	false to leave the submission to
+				os_aio_simulated_wake_handler_threads() */
+	void post(Request* req, bool wake)
+	{
+		if (os_atomic_increment_ulint(&m_n_issued, 1) > N_REQUESTS) {
+			return;
+		}
+
+		IORequest	type((m_write ? IORequest::WRITE : IORequest::READ)
+				 | (wake ? 0 : IORequest::DO_NOT_WAKE));
+
+		req->rnd = req->rnd * 1103515245 + 12345;
+
+		os_offset_t	offset = static_cast<os_offset_t>(
+			(req->rnd >> 16) % (FILE_SIZE / REQUEST_SIZE)) * REQUEST_SIZE;
+
+		req->start = my_micro_time();
+
+		dberr_t	err = os_aio(
+			type, OS_AIO_NORMAL, m_name.c_str(), m_file,
+			m_buf + req->lane * REQUEST_SIZE, offset, REQUEST_SIZE,
+			false, NULL, req);
+
+		ut_a(err == DB_SUCCESS);
+	}
+
+	const bool		m_write;
+	std::string		m_name;
+	pfs_os_file_t		m_file;
+	byte*			m_buf_unaligned;
+	byte*			m_buf;
+	Request			m_requests[QUEUE_DEPTH];
+	ulint			m_n_issued;
+	ulint			m_n_done;
+	std::vector<ulonglong>	m_latencies;
+};
+
+/** An i/o handler thread of one segment */
+class HandlerThread : public thread::Thread {
+public:
+	HandlerThread(Benchmark* bench, ulint segment)
+		:
+		m_bench(bench),
+		m_segment(segment)
+	{}
+
+protected:
+	virtual void run()
+	{
+		while (srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+			fil_node_t*	m1;
+			void*		m2;
+			IORequest	type;
+
+			dberr_t	err = os_aio_handler(
+				m_segment, &m1, &m2, &type);
+
+			if (m2 != NULL) {
+				ut_a(err == DB_SUCCESS);
+				m_bench->complete(static_cast<Request*>(m2));
+			}
+		}
+	}
+
+private:
+	Benchmark*	m_bench;
+	ulint		m_segment;
+};
+
+class os0file : public ::testing::Test {
+protected:
+	static
+	void
+	SetUpTestCase()
+	{
+		srv_max_n_threads = srv_sync_array_size + 1;
+		os_event_global_init();
+		sync_check_init();
+	}
+
+	static
+	void
+	TearDownTestCase()
+	{
+		sync_check_close();
+		os_event_global_destroy();
+	}
+};
+
+/** Run the benchmark with one of the backends.
+@param[in]	io_uring	true for io_uring, false for libaio
+@param[in]	write		true for writes, false for reads */
+static
+void
+run_benchmark(bool io_uring, bool write)
+{
+	/* The ibuf and log segments come before the read segments */
+	const ulint	n_segments = 2 + N_READERS + N_WRITERS;
+
+	srv_use_native_aio = TRUE;
+	srv_use_io_uring = io_uring;
+	srv_shutdown_state = SRV_SHUTDOWN_NONE;
+
+	ASSERT_TRUE(os_aio_init(N_READERS, N_WRITERS, 100));
+
+	if (io_uring && !srv_use_io_uring) {
+		printf("io_uring is not supported, using libaio\n");
+	}
+
+	Benchmark*			bench = new Benchmark(write);
+	std::vector<HandlerThread*>	threads;
+
+	bench->create();
+
+	for (ulint i = 0; i < n_segments; i++) {
+		threads.push_back(new HandlerThread(bench, i));
+		threads.back()->start();
+	}
+
+	const ulonglong	start = my_micro_time();
+
+	bench->run();
+
+	const ulonglong	usecs = my_micro_time() - start;
+
+	srv_shutdown_state = SRV_SHUTDOWN_EXIT_THREADS;
+	os_aio_wake_all_threads_at_shutdown();
+
+	for (ulint i = 0; i < n_segments; i++) {
+		threads[i]->join();
+		delete threads[i];
+	}
+
+	bench->report(usecs);
+	bench->destroy();
+
+	delete bench;
+
+	os_aio_free();
+
+	srv_shutdown_state = SRV_SHUTDOWN_NONE;
+	srv_use_io_uring = FALSE;
+}
+
+TEST_F(os0file, DISABLED_libaio_random_reads)
+{
+	run_benchmark(false, false);
+}
+
+TEST_F(os0file, DISABLED_libaio_random_writes)
+{
+	run_benchmark(false, true);
+}
+
+TEST_F(os0file, DISABLED_io_uring_random_reads)
+{
+	run_benchmark(true, false);
+}
+
+TEST_F(os0file, DISABLED_io_uring_random_writes)
+{
+	run_benchmark(true, true);
+}
+
+#endif /* LINUX_NATIVE_AIO */
+
+}
@@ -0,0 +1,375 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "univ.i"
+
+#include "page0zip.h"
+#include "ut0rnd.h"
+#include "ut0ut.h"
+#include "zlib.h"
+
+namespace innodb_page0zip_unittest {
+
+/* The codecs of ROW_FORMAT=COMPRESSED pages, modelled on
+page_zip_compress() and page_zip_decompress_low(): zlib deflates the
+records directly, while the other codecs compress a deflate stream of
+stored blocks with page_zip_codec_pack(). */
+
+/** Uncompressed page size */
+static const ulint	PAGE_SIZE = 16384;
+
+/** Size of the deflate stream buffer of the other codecs */
+static const ulint	STAGE_SIZE = 2 * PAGE_SIZE;
+
+/** Number of pages per measurement. Increase for actual benchmarking! */
+static const ulint	N_PAGES = 512;
+
+/** Fill a buffer with data that resembles the records of a clustered
+index leaf page: an ascending key, the system columns and a text column
+drawn from a small vocabulary, with some random digits.
+@param[out]	buf	buffer
+@param[in]	len	length of buf
+@param[in]	seed	seed of the page */
+static
+void
+fill(
+	byte*	buf,
+	ulint	len,
+	ulint	seed)
+{
+	static const char*	words[] = {
+		"customer", "order", "shipped", "pending", "invoice",
+		"street", "avenue", "London", "Paris", "Berlin",
+		"red", "green", "blue", "total", "discount", "note"
+	};
+	static const ulint	n_words = UT_ARR_SIZE(words);
+
+	ulint	rnd = seed * 1103515245 + 12345;
+	ulint	key = seed * 1000;
+	byte*	end = buf + len;
+
+	while (buf + 40 < end) {
+		/* Record header, key, DB_TRX_ID and DB_ROLL_PTR */
+		mach_write_to_2(buf, 0x0010);
+		mach_write_to_4(buf + 2, static_cast<ulint>(key++));
+		mach_write_to_6(buf + 6, 0x1234 + (seed << 4));
+		mach_write_to_7(buf + 12, (ib_uint64_t(1) << 55) | key);
+		buf += 19;
+
+		for (ulint n = 2 + rnd % 5; n-- && buf + 12 < end; ) {
+			rnd = ut_rnd_gen_next_ulint(rnd);
+
+			const char*	w = words[rnd % n_words];
+			ulint		w_len = strlen(w);
+
+			memcpy(buf, w, w_len);
+			buf += w_len;
+
+			if (rnd & 0x100) {
+				*buf++ = static_cast<byte>('0' + (rnd >> 9) % 10);
+			}
+
+			*buf++ = ' ';
+		}
+	}
+
+	memset(buf, 0, end - buf);
+}
+
+/** Compress a page payload like page_zip_compress() does.
+@param[in]	codec	codec
+@param[in]	in	page payload
+@param[in]	in_len	length of the payload
+@param[out]	out	compressed page payload
+@param[in]	out_len	space available for the compressed payload
+@param[out]	stage	buffer of STAGE_SIZE bytes for the deflate stream
+@return compressed length, or 0 if it did not fit in out_len */
+static
+ulint
+pack(
+	page_zip_codec_t	codec,
+	const byte*		in,
+	ulint			in_len,
+	byte*			out,
+	ulint			out_len,
+	byte*			stage)
+{
+	z_stream	c_stream;
+	int		err;
+
+	memset(&c_stream, 0, sizeof c_stream);
+
+	if (codec == PAGE_ZIP_CODEC_ZLIB) {
+		err = deflateInit2(&c_stream, 6, Z_DEFLATED, 14,
+				   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+		c_stream.next_out = out;
+		c_stream.avail_out = static_cast<uInt>(out_len);
+	} else {
+		err = deflateInit2(&c_stream, Z_NO_COMPRESSION, Z_DEFLATED,
+				   -14, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+		c_stream.next_out = stage;
+		c_stream.avail_out = static_cast<uInt>(STAGE_SIZE);
+	}
+
+	EXPECT_EQ(Z_OK, err);
+
+	c_stream.next_in = const_cast<byte*>(in);
+	c_stream.avail_in = static_cast<uInt>(in_len);
+
+	err = deflate(&c_stream, Z_FINISH);
+
+	ulint	len = c_stream.total_out;
+
+	deflateEnd(&c_stream);
+
+	if (err != Z_STREAM_END) {
+		return(0);
+	}
+
+	if (codec != PAGE_ZIP_CODEC_ZLIB) {
+		len = page_zip_codec_pack(codec, stage, len, out, out_len);
+	}
+
+	return(len);
+}
+
+/** Decompress a page payload like page_zip_decompress_low() does.
+@param[in]	in	compressed page payload
+@param[in]	in_len	length of in
+@param[out]	out	page payload
+@param[in]	out_len	length of the page payload
+@param[out]	stage	buffer of STAGE_SIZE bytes for the deflate stream
+@return whether the payload was decompressed */
+static
+bool
+unpack(
+	const byte*	in,
+	ulint		in_len,
+	byte*		out,
+	ulint		out_len,
+	byte*		stage)
+{
+	z_stream	d_stream;
+	int		err;
+
+	memset(&d_stream, 0, sizeof d_stream);
+
+	d_stream.next_in = const_cast<byte*>(in);
+	d_stream.avail_in = static_cast<uInt>(in_len);
+
+	if (page_zip_codec_get(in) == PAGE_ZIP_CODEC_ZLIB) {
+		err = inflateInit2(&d_stream, 14);
+	} else {
+		ulint	used;
+		ulint	len = page_zip_codec_unpack(
+			in, in_len, stage, STAGE_SIZE, &used);
+
+		if (len == 0) {
+			return(false);
+		}
+
+		d_stream.next_in = stage;
+		d_stream.avail_in = static_cast<uInt>(len);
+		err = inflateInit2(&d_stream, -14);
+	}
+
+	EXPECT_EQ(Z_OK, err);
+
+	d_stream.next_out = out;
+	d_stream.avail_out = static_cast<uInt>(out_len);
+
+	err = inflate(&d_stream, Z_FINISH);
+
+	inflateEnd(&d_stream);
+
+	return(err == Z_STREAM_END && d_stream.total_out == out_len);
+}
+
+/* Test the round trip of the codecs and the detection of the codec. */
+TEST(page0zip, codec)
+{
+	byte*	page = new byte[PAGE_SIZE];
+	byte*	zip = new byte[PAGE_SIZE];
+	byte*	copy = new byte[PAGE_SIZE];
+	byte*	stage = new byte[STAGE_SIZE];
+
+	fill(page, PAGE_SIZE, 1);
+
+	ulint	len = pack(PAGE_ZIP_CODEC_ZLIB, page, PAGE_SIZE,
+			   zip, PAGE_SIZE, stage);
+
+	ASSERT_TRUE(len > 0);
+	EXPECT_EQ(PAGE_ZIP_CODEC_ZLIB, page_zip_codec_get(zip));
+	EXPECT_TRUE(unpack(zip, len, copy, PAGE_SIZE, stage));
+	EXPECT_EQ(0, memcmp(page, copy, PAGE_SIZE));
+
+	len = pack(PAGE_ZIP_CODEC_LZ4, page, PAGE_SIZE,
+		   zip, PAGE_SIZE, stage);
+
+	ASSERT_TRUE(len > PAGE_ZIP_CODEC_HEADER);
+	EXPECT_EQ(PAGE_ZIP_CODEC_LZ4, page_zip_codec_get(zip));
+	EXPECT_EQ(len - PAGE_ZIP_CODEC_HEADER, mach_read_from_2(zip + 1));
+
+	/* The modification log follows the codec output. */
+	memset(copy, 0, PAGE_SIZE);
+	EXPECT_TRUE(unpack(zip, PAGE_SIZE, copy, PAGE_SIZE, stage));
+	EXPECT_EQ(0, memcmp(page, copy, PAGE_SIZE));
+
+	/* The output does not fit. */
+	EXPECT_EQ(0U, pack(PAGE_ZIP_CODEC_LZ4, page, PAGE_SIZE,
+			   zip, len - 1, stage));
+
+	/* The codec output is truncated. */
+	EXPECT_FALSE(unpack(zip, len - 1, copy, PAGE_SIZE, stage));
+
+	/* Unknown codec */
+	zip[0] = 0xFF;
+	EXPECT_FALSE(unpack(zip, len, copy, PAGE_SIZE, stage));
+
+	delete[] stage;
+	delete[] copy;
+	delete[] zip;
+	delete[] page;
+}
+
+/** Report one measurement.
+@param[in]	codec		name of the codec
+@param[in]	zip_size	compressed page size
+@param[in]	fill_len	length of the payload of each page
+@param[in]	n_fail		number of pages that did not fit
+@param[in]	zip_bytes	total compressed length of the other pages
+@param[in]	c_us		microseconds spent compressing
+@param[in]	d_us		microseconds spent decompressing */
+static
+void
+report(
+	const char*		codec,
+	ulint			zip_size,
+	ulint			fill_len,
+	ulint			n_fail,
+	ulint			zip_bytes,
+	ib_time_monotonic_us_t	c_us,
+	ib_time_monotonic_us_t	d_us)
+{
+	const ulint	n_ok = N_PAGES - n_fail;
+	const double	n_bytes = double(N_PAGES) * fill_len;
+
+	fprintf(stderr,
+		"%5s %6lu %6lu: ratio %5.2f, compress %7.1f MB/s,"
+		" decompress %7.1f MB/s, failures %5.1f%%\n",
+		codec, zip_size, fill_len,
+		n_ok ? double(n_ok) * fill_len / zip_bytes : 0.0,
+		n_bytes / std::max<ib_time_monotonic_us_t>(c_us, 1),
+		n_ok ? double(n_ok) * fill_len
+		/ std::max<ib_time_monotonic_us_t>(d_us, 1) : 0.0,
+		100.0 * n_fail / N_PAGES);
+}
+
+/* Microbenchmark of the codecs of ROW_FORMAT=COMPRESSED pages for each
+KEY_BLOCK_SIZE and a few fill factors of the uncompressed page: the
+compression ratio, the compression and decompression throughput and the
+rate of compression failures, which make InnoDB split the page. Run
+with --gtest_also_run_disabled_tests. */
+TEST(page0zip, DISABLED_codecs)
+{
+	static const page_zip_codec_t	codecs[] = {
+		PAGE_ZIP_CODEC_ZLIB, PAGE_ZIP_CODEC_LZ4
+	};
+	static const char*		names[] = { "zlib", "lz4" };
+
+	byte*	pages = new byte[N_PAGES * PAGE_SIZE];
+	byte*	zips = new byte[N_PAGES * PAGE_SIZE];
+	ulint*	lens = new ulint[N_PAGES];
+	byte*	copy = new byte[PAGE_SIZE];
+	byte*	stage = new byte[STAGE_SIZE];
+
+	for (ulint i = 0; i < N_PAGES; i++) {
+		fill(pages + i * PAGE_SIZE, PAGE_SIZE, i);
+	}
+
+	for (ulint zip_size = 1024; zip_size <= 8192; zip_size <<= 1) {
+		for (ulint f = 1; f <= 4; f++) {
+			const ulint	fill_len = f * PAGE_SIZE / 4;
+
+			for (ulint c = 0; c < UT_ARR_SIZE(codecs); c++) {
+				ulint	n_fail = 0;
+				ulint	zip_bytes = 0;
+
+				ib_time_monotonic_us_t	start
+					= ut_time_monotonic_us();
+
+				for (ulint i = 0; i < N_PAGES; i++) {
+					lens[i] = pack(
+						codecs[c],
+						pages + i * PAGE_SIZE,
+						fill_len,
+						zips + i * PAGE_SIZE,
+						zip_size - PAGE_DATA,
+						stage);
+
+					if (lens[i] == 0) {
+						n_fail++;
+					}
+
+					zip_bytes += lens[i];
+				}
+
+				ib_time_monotonic_us_t	c_us
+					= ut_time_monotonic_us() - start;
+
+				start = ut_time_monotonic_us();
+
+				for (ulint i = 0; i < N_PAGES; i++) {
+					if (lens[i] != 0) {
+						EXPECT_TRUE(unpack(
+							zips + i * PAGE_SIZE,
+							lens[i], copy,
+							fill_len, stage));
+					}
+				}
+
+				report(names[c], zip_size, fill_len, n_fail,
+				       zip_bytes, c_us,
+				       ut_time_monotonic_us() - start);
+			}
+		}
+	}
+
+	delete[] stage;
+	delete[] copy;
+	delete[] lens;
+	delete[] zips;
+	delete[] pages;
+}
+
+}
@@ -0,0 +1,357 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_sys.h"
+#include "thr_mutex.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "os0atomic.h"
+#include "trx0types.h"
+
+namespace innodb_read0read_unittest {
+
+/* Stress test of the snapshots that ReadView::prepare() takes from
+TrxIdRegistry without trx_sys->mutex, while many threads run short
+read-write transactions. The model follows trx_sys_get_new_rw_trx_id(),
+trx_erase_lists() and ReadView::prepare_lock_free(). */
+
+/** Number of threads running transactions */
+static const ulint	N_WRITERS = 8;
+
+/** Number of transactions per writer thread */
+static const ulint	N_TRX = 5000;
+
+/** Number of threads taking snapshots */
+static const ulint	N_READERS = 4;
+
+/** Number of the most recent ids whose state is checked in a snapshot */
+static const ulint	N_CHECK = 256;
+
+/** Attempts to take a snapshot without the mutex */
+static const ulint	N_RETRIES = 8;
+
+class TrxSysModel {
+public:
+	TrxSysModel()
+		:
+		m_max_trx_id(1),
+		m_commit_seq(0),
+		m_n_snapshots(0),
+		m_n_fallbacks(0),
+		m_done(false)
+	{
+		native_mutex_init(&m_mutex, NULL);
+
+		m_commit_no = new ib_uint64_t[N_WRITERS * N_TRX + 1];
+
+		for (ulint i = 0; i <= N_WRITERS * N_TRX; i++) {
+			m_commit_no[i] = 0;
+		}
+	}
+
+	~TrxSysModel()
+	{
+		delete[] m_commit_no;
+
+		native_mutex_destroy(&m_mutex);
+	}
+
+	/** Start a read-write transaction.
+	@return transaction id */
+	trx_id_t begin()
+	{
+		native_mutex_lock(&m_mutex);
+
+		trx_id_t	id = m_max_trx_id;
+
+		m_ids.insert(id);
+
+		os_wmb;
+
+		m_max_trx_id = id + 1;
+
+		native_mutex_unlock(&m_mutex);
+
+		return(id);
+	}
+
+	/** Commit a read-write transaction.
+	@param[in]	id	transaction id */
+	void commit(trx_id_t id)
+	{
+		native_mutex_lock(&m_mutex);
+
+		m_commit_no[id] = ++m_commit_seq;
+
+		m_ids.erase(id);
+
+		native_mutex_unlock(&m_mutex);
+	}
+
+	/** Take a snapshot and check that it is consistent: every recent
+	id that it sees as committed has committed before any of the ids
+	that it sees as active.
+	@param[in,out]	ids	buffer for the active ids */
+	void snapshot(std::vector<trx_id_t>* ids)
+	{
+		trx_id_t	limit = 0;
+		ulint		n = ULINT_UNDEFINED;
+
+		for (ulint i = 0; i < N_RETRIES && n == ULINT_UNDEFINED; i++) {
+			ulint	version = m_ids.read_begin();
+
+			if (version == ULINT_UNDEFINED) {
+				continue;
+			}
+
+			limit = m_max_trx_id;
+
+			os_rmb;
+
+			ids->resize(std::max(ids->size(), m_ids.size() + 1));
+
+			n = m_ids.copy(&(*ids)[0], ids->size(), limit, 0);
+
+			if (n == ULINT_UNDEFINED) {
+				ids->resize(ids->size() * 2);
+			} else if (!m_ids.read_validate(version)) {
+				n = ULINT_UNDEFINED;
+			}
+		}
+
+		if (n == ULINT_UNDEFINED) {
+			/* Like ReadView::prepare_low(). */
+			native_mutex_lock(&m_mutex);
+
+			limit = m_max_trx_id;
+
+			ids->resize(m_ids.size() + 1);
+
+			n = m_ids.copy(&(*ids)[0], ids->size(), limit, 0);
+
+			native_mutex_unlock(&m_mutex);
+
+			os_atomic_increment_ulint(&m_n_fallbacks, 1);
+		}
+
+		os_atomic_increment_ulint(&m_n_snapshots, 1);
+
+		ASSERT_NE(ULINT_UNDEFINED, n);
+
+		std::sort(ids->begin(), ids->begin() + n);
+
+		os_rmb;
+
+		ib_uint64_t	max_visible = 0;
+
+		for (trx_id_t id = limit > N_CHECK ? limit - N_CHECK : 1;
+		     id < limit;
+		     id++) {
+
+			if (std::binary_search(ids->begin(),
+					       ids->begin() + n, id)) {
+				continue;
+			}
+
+			/* Not active, so it must have committed. */
+			ib_uint64_t	no = m_commit_no[id];
+
+			ASSERT_NE(0U, no);
+
+			max_visible = std::max(max_visible, no);
+		}
+
+		for (ulint i = 0; i < n; i++) {
+			ASSERT_LT((*ids)[i], limit);
+
+			ib_uint64_t	no = m_commit_no[(*ids)[i]];
+
+			EXPECT_TRUE(no == 0 || no > max_visible);
+		}
+	}
+
+	/** Check that all the transactions have committed */
+	void validate() const
+	{
+		EXPECT_EQ(0U, m_ids.size());
+		EXPECT_FALSE(m_ids.overflowed());
+		EXPECT_EQ(N_WRITERS * N_TRX + 1,
+			  static_cast<trx_id_t>(m_max_trx_id));
+	}
+
+	TrxIdRegistry			m_ids;
+	native_mutex_t			m_mutex;
+	volatile trx_id_t		m_max_trx_id;
+	ib_uint64_t			m_commit_seq;
+	volatile ib_uint64_t*		m_commit_no;
+	ulint				m_n_snapshots;
+	ulint				m_n_fallbacks;
+	volatile bool			m_done;
+};
+
+class WriterThread : public thread::Thread {
+public:
+	explicit WriterThread(TrxSysModel* model) : m_model(model) {}
+
+protected:
+	virtual void run()
+	{
+		for (ulint i = 0; i < N_TRX; i++) {
+			trx_id_t	id = m_model->begin();
+
+			if (i % 7 == 0) {
+				my_thread_yield();
+			}
+
+			m_model->commit(id);
+		}
+	}
+
+private:
+	TrxSysModel*	m_model;
+};
+
+class ReaderThread : public thread::Thread {
+public:
+	explicit ReaderThread(TrxSysModel* model) : m_model(model) {}
+
+protected:
+	virtual void run()
+	{
+		std::vector<trx_id_t>	ids;
+
+		while (!m_model->m_done) {
+			m_model->snapshot(&ids);
+		}
+	}
+
+private:
+	TrxSysModel*	m_model;
+};
+
+/* Thousands of concurrent short transactions with concurrent snapshots */
+TEST(read0read, concurrent_snapshots)
+{
+	TrxSysModel*			model = new TrxSysModel();
+	std::vector<WriterThread*>	writers;
+	std::vector<ReaderThread*>	readers;
+
+	const ulonglong	start = my_micro_time();
+
+	for (ulint i = 0; i < N_READERS; i++) {
+		readers.push_back(new ReaderThread(model));
+		readers.back()->start();
+	}
+
+	for (ulint i = 0; i < N_WRITERS; i++) {
+		writers.push_back(new WriterThread(model));
+		writers.back()->start();
+	}
+
+	for (ulint i = 0; i < N_WRITERS; i++) {
+		writers[i]->join();
+		delete writers[i];
+	}
+
+	model->m_done = true;
+
+	for (ulint i = 0; i < N_READERS; i++) {
+		readers[i]->join();
+		delete readers[i];
+	}
+
+	const ulonglong	usecs = my_micro_time() - start + 1;
+
+	printf("%lu transactions by %lu threads, %lu snapshots"
+	       " (%lu under the mutex) by %lu threads in %llu us\n",
+	       static_cast<ulong>(N_WRITERS * N_TRX),
+	       static_cast<ulong>(N_WRITERS),
+	       static_cast<ulong>(model->m_n_snapshots),
+	       static_cast<ulong>(model->m_n_fallbacks),
+	       static_cast<ulong>(N_READERS), usecs);
+
+	model->validate();
+
+	delete model;
+}
+
+/* Ids that do not fit into the slots are counted as overflow */
+TEST(read0read, overflow)
+{
+	TrxIdRegistry*		reg = new TrxIdRegistry();
+	const ulint		n_slots = TrxIdRegistry::N_SHARDS
+		* TrxIdRegistry::N_SLOTS;
+	std::vector<trx_id_t>	ids(n_slots + 100);
+
+	for (trx_id_t id = 1; id <= n_slots + 10; id++) {
+		reg->insert(id);
+	}
+
+	EXPECT_TRUE(reg->overflowed());
+	EXPECT_EQ(n_slots + 10, reg->size());
+
+	EXPECT_EQ(n_slots, reg->copy(&ids[0], ids.size(), TRX_ID_MAX, 0));
+	EXPECT_EQ(ULINT_UNDEFINED, reg->copy(&ids[0], 10, TRX_ID_MAX, 0));
+
+	for (trx_id_t id = 1; id <= n_slots + 10; id += 2) {
+		reg->erase(id);
+	}
+
+	/* The overflowed even ids are still active. */
+	EXPECT_TRUE(reg->overflowed());
+	EXPECT_EQ((n_slots + 10) / 2, reg->size());
+
+	ulint	n = reg->copy(&ids[0], ids.size(), 1000, 500);
+
+	EXPECT_EQ(498U, n);
+
+	for (ulint i = 0; i < n; i++) {
+		EXPECT_EQ(0U, ids[i] % 2);
+		EXPECT_NE(500U, ids[i]);
+		EXPECT_LT(ids[i], 1000U);
+	}
+
+	for (trx_id_t id = 2; id <= n_slots + 10; id += 2) {
+		reg->erase(id);
+	}
+
+	EXPECT_FALSE(reg->overflowed());
+	EXPECT_EQ(0U, reg->size());
+	EXPECT_EQ(0U, reg->copy(&ids[0], ids.size(), TRX_ID_MAX, 0));
+
+	delete reg;
+}
+
+}
@@ -26,6 +26,7 @@
 #include "my_config.h"
 
 #include <string.h>
+#include <algorithm>
 
 #include <gtest/gtest.h>
 
@@ -33,6 +34,7 @@
 
 #include "ut0crc32.h"
 #include "ut0dbg.h"
+#include "ut0ut.h"
 
 namespace innodb_ut0crc32_unittest {
 
@@ -2227,4 +2229,152 @@ TEST(ut0crc32, perf)
 	delete[] p;
 }
 
+/* test that ut_crc32(), which interleaves three streams when carry-less
+multiplication is available, and ut_crc32_serial() agree with
+ut_crc32_byte_by_byte() around the stream boundaries */
+TEST(ut0crc32, interleaved)
+{
+	init();
+
+	fprintf(stderr, "Carry-less multiplication is %savailable\n",
+		ut_crc32_pclmul_enabled ? "" : "not ");
+
+	static const size_t	max_len = 4 * page_size;
+
+	byte*	buf = new byte[max_len + 7];
+
+	for (size_t i = 0; i < max_len + 7; i++) {
+		buf[i] = page[(i * 7919) % page_size];
+	}
+
+	for (int i = 0; i < 8; i++) {
+		const byte*	p = buf + i;
+
+		for (size_t len = 0; len <= max_len;
+		     len += len < 8192 ? 1 : 509) {
+
+			const uint32_t	crc = ut_crc32_byte_by_byte(p, len);
+
+			ASSERT_EQ(crc, ut_crc32(p, len));
+			ASSERT_EQ(crc, ut_crc32_serial(p, len));
+		}
+	}
+
+	delete[] buf;
+}
+
+/* test ut_crc32_batch() */
+TEST(ut0crc32, batch)
+{
+	init();
+
+	static const size_t	n_bufs = 8;
+
+	byte*		buf = new byte[n_bufs * (page_size + 8)];
+	const byte*	bufs[n_bufs];
+	uint32_t	crcs[n_bufs];
+
+	/* Give the buffers different contents and alignments. */
+	for (size_t i = 0; i < n_bufs; i++) {
+		byte*	p = buf + i * (page_size + 8) + i % 8;
+
+		memcpy(p, page, page_size);
+		p[i * 100] ^= 0xFF;
+		bufs[i] = p;
+	}
+
+	for (size_t n = 0; n <= n_bufs; n++) {
+		for (size_t len = 0; len <= page_size;
+		     len += len < 64 ? 1 : 1021) {
+
+			ut_crc32_batch(bufs, n, len, crcs);
+
+			for (size_t i = 0; i < n; i++) {
+				ASSERT_EQ(ut_crc32_byte_by_byte(bufs[i], len),
+					  crcs[i]);
+			}
+		}
+	}
+
+	ut_crc32_batch(bufs, 1, page_size, crcs);
+	EXPECT_EQ(ut_crc32(bufs[0], page_size), crcs[0]);
+
+	delete[] buf;
+}
+
+/** Report the throughput of a checksum run.
+@param[in]	name		name of the implementation
+@param[in]	n_bytes		number of bytes checksummed
+@param[in]	start		ut_time_monotonic_us() at the start */
+static
+void
+report(
+	const char*		name,
+	size_t			n_bytes,
+	ib_time_monotonic_us_t	start)
+{
+	const ib_time_monotonic_us_t	us = std::max<ib_time_monotonic_us_t>(
+		ut_time_monotonic_us() - start, 1);
+
+	fprintf(stderr, "%12s: %6.2f GB/s\n",
+		name, static_cast<double>(n_bytes) / us / 1000);
+}
+
+/* Microbenchmark of the page checksum in one thread: the serial
+ut_crc32 kernel, the three-stream kernel and ut_crc32_batch() over
+groups of pages. Run with --gtest_also_run_disabled_tests. */
+TEST(ut0crc32, DISABLED_throughput)
+{
+	init();
+
+	static const size_t	n_pages = 64;
+	static const size_t	n_rounds = 4096;
+	static const size_t	n_bytes = n_rounds * n_pages * page_size;
+
+	byte*		p = new byte[n_pages * page_size];
+	const byte*	pages[n_pages];
+	uint32_t	crcs[n_pages];
+	uint32_t	sum = 0;
+
+	for (size_t i = 0; i < n_pages; i++) {
+		memcpy(p + i * page_size, page, page_size);
+		pages[i] = p + i * page_size;
+	}
+
+	ib_time_monotonic_us_t	start = ut_time_monotonic_us();
+
+	for (size_t n = 0; n < n_rounds; n++) {
+		for (size_t i = 0; i < n_pages; i++) {
+			sum ^= ut_crc32_serial(pages[i], page_size);
+		}
+	}
+
+	report("serial", n_bytes, start);
+
+	start = ut_time_monotonic_us();
+
+	for (size_t n = 0; n < n_rounds; n++) {
+		for (size_t i = 0; i < n_pages; i++) {
+			sum ^= ut_crc32(pages[i], page_size);
+		}
+	}
+
+	report("interleaved", n_bytes, start);
+
+	start = ut_time_monotonic_us();
+
+	for (size_t n = 0; n < n_rounds; n++) {
+		ut_crc32_batch(pages, n_pages, page_size, crcs);
+		sum ^= crcs[n % n_pages];
+	}
+
+	report("batch", n_bytes, start);
+
+	/* All the pages are equal, and there is an even number of
+	checksums of each kind. */
+	EXPECT_EQ(0U, sum);
+
+	delete[] p;
+}
+
 }